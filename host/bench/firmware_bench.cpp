@@ -0,0 +1,31 @@
+// Host run of the firmware micro-benchmark suite (diagnostics/Benchmark.h): the same
+// cases, started through startBenchmarks() in the same task as the Bench telecommand
+// on the board. Times come from the host clock (ns per cycle), allocations from the
+// heap counter of the host platform.
+//
+// The flash append case writes to FIRMWARE_FS_DIR (default ./spiffs).
+
+#include <Arduino.h>
+#include "diagnostics/Benchmark.h"
+#include "display.h"
+#include "hardware/storage.h"
+
+int main()
+{
+  setvbuf(stdout, NULL, _IOLBF, 0);
+
+  if (!initStorage()) {
+    return 1;
+  }
+  // The draw cases run in the display task.
+  displayInit();
+  startDisplayTask(TABLE_MODE);
+
+  if (!startBenchmarks(Serial)) {
+    return 1;
+  }
+  while (benchmarksRunning()) {
+    delay(10);
+  }
+  return 0;
+}
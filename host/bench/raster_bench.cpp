@@ -0,0 +1,174 @@
+// Host benchmark of the 1bpp raster kernel against the Adafruit_GFX path it replaced,
+// both drawing into the same 128x64 SSD1306 frame buffer.
+//
+// Each workload is a batch of shapes like the ones the display modes draw. It is
+// drawn set and then cleared, so every pass leaves the buffer as it found it.
+// Throughput is pixels covered per microsecond, best of BENCH_RUNS runs; "diff"
+// counts the pixels where the two paths disagree (edge rules of fills and lines).
+
+#include "hardware/Raster.h"
+#include <Adafruit_SSD1306.h>
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_RUNS 5
+#define BENCH_PASSES 2000
+#define WIDTH 128
+#define HEIGHT 64
+#define BUFFER_BYTES (WIDTH * HEIGHT / 8)
+
+static double nowNs() {
+  return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint16_t gfxColor(RasterOp op) {
+  return op == RASTER_SET ? SSD1306_WHITE : SSD1306_BLACK;
+}
+
+// ---------------------------------------------------------------------------
+// Workloads
+// ---------------------------------------------------------------------------
+
+// Table and plot rules: one long horizontal span per row.
+static void hspansRaster(const RasterTarget& t, RasterOp op) {
+  for (int y = 0; y < HEIGHT; y++) rasterHSpan(t, 3, 124, y, op);
+}
+static void hspansGfx(Adafruit_SSD1306& d, RasterOp op) {
+  for (int y = 0; y < HEIGHT; y++) d.drawFastHLine(3, y, 122, gfxColor(op));
+}
+
+// Plot columns: one vertical span per column, starting mid-page.
+static void vspansRaster(const RasterTarget& t, RasterOp op) {
+  for (int x = 0; x < WIDTH; x++) rasterVSpan(t, x, 5, 58, op);
+}
+static void vspansGfx(Adafruit_SSD1306& d, RasterOp op) {
+  for (int x = 0; x < WIDTH; x++) d.drawFastVLine(x, 5, 54, gfxColor(op));
+}
+
+// Filled panel.
+static void rectRaster(const RasterTarget& t, RasterOp op) {
+  rasterFillRect(t, 7, 5, 113, 50, op);
+}
+static void rectGfx(Adafruit_SSD1306& d, RasterOp op) {
+  d.fillRect(7, 5, 113, 50, gfxColor(op));
+}
+
+// Plot traces and horizon lines: a fan of sloped lines.
+static void linesRaster(const RasterTarget& t, RasterOp op) {
+  for (int i = 0; i < 16; i++) {
+    rasterLine(t, 0, i * 4, WIDTH - 1, HEIGHT - 1 - i * 4, op);
+    rasterLine(t, i * 8, 0, WIDTH - 1 - i * 8, HEIGHT - 1, op);
+  }
+}
+static void linesGfx(Adafruit_SSD1306& d, RasterOp op) {
+  for (int i = 0; i < 16; i++) {
+    d.drawLine(0, i * 4, WIDTH - 1, HEIGHT - 1 - i * 4, gfxColor(op));
+    d.drawLine(i * 8, 0, WIDTH - 1 - i * 8, HEIGHT - 1, gfxColor(op));
+  }
+}
+
+// Horizon ground: a tilted quadrilateral clipped at the screen edges (two triangles
+// on the GFX path).
+static const int16_t groundX[4] = {-20, 148, 148, -20};
+static const int16_t groundY[4] = {22, 44, 90, 90};
+static void groundRaster(const RasterTarget& t, RasterOp op) {
+  rasterFillPolygon(t, groundX, groundY, 4, op);
+}
+static void groundGfx(Adafruit_SSD1306& d, RasterOp op) {
+  d.fillTriangle(groundX[0], groundY[0], groundX[1], groundY[1], groundX[2], groundY[2], gfxColor(op));
+  d.fillTriangle(groundX[0], groundY[0], groundX[2], groundY[2], groundX[3], groundY[3], gfxColor(op));
+}
+
+// Table values and tick labels.
+static const char* const numberLines[] = {"-123.45 678", "3.90 4.55", "1013.2 22", "-0.98 12.5"};
+static void digitsRaster(const RasterTarget& t, RasterOp op) {
+  for (int i = 0; i < 4; i++) rasterNumber(t, 0, i * 16, numberLines[i], op);
+}
+static void digitsGfx(Adafruit_SSD1306& d, RasterOp op) {
+  d.setTextSize(1);
+  d.setTextColor(gfxColor(op));
+  for (int i = 0; i < 4; i++) {
+    d.setCursor(0, i * 16);
+    d.print(numberLines[i]);
+  }
+}
+
+struct Workload {
+  const char* name;
+  void (*raster)(const RasterTarget&, RasterOp);
+  void (*gfx)(Adafruit_SSD1306&, RasterOp);
+};
+
+static const Workload workloads[] = {
+  {"hspans", hspansRaster, hspansGfx},
+  {"vspans", vspansRaster, vspansGfx},
+  {"fill rect", rectRaster, rectGfx},
+  {"lines", linesRaster, linesGfx},
+  {"ground polygon", groundRaster, groundGfx},
+  {"digits", digitsRaster, digitsGfx},
+};
+
+// ---------------------------------------------------------------------------
+// Measurement
+// ---------------------------------------------------------------------------
+
+static int countPixels(const uint8_t* buffer) {
+  int n = 0;
+  for (int i = 0; i < BUFFER_BYTES; i++) n += __builtin_popcount(buffer[i]);
+  return n;
+}
+
+static int countDiff(const uint8_t* a, const uint8_t* b) {
+  int n = 0;
+  for (int i = 0; i < BUFFER_BYTES; i++) n += __builtin_popcount(a[i] ^ b[i]);
+  return n;
+}
+
+// Best ns per set-and-clear pass of one path.
+template <typename Draw>
+static double measure(Draw draw) {
+  double best = 1e30;
+  for (int run = 0; run < BENCH_RUNS; run++) {
+    double t0 = nowNs();
+    for (int pass = 0; pass < BENCH_PASSES; pass++) {
+      draw(RASTER_SET);
+      draw(RASTER_CLEAR);
+    }
+    double ns = (nowNs() - t0) / BENCH_PASSES;
+    if (ns < best) best = ns;
+  }
+  return best;
+}
+
+int main() {
+  Adafruit_SSD1306 display(WIDTH, HEIGHT);
+  if (!display.begin()) {
+    fprintf(stderr, "frame buffer allocation failed\n");
+    return 1;
+  }
+  const RasterTarget target = {display.getBuffer(), WIDTH, HEIGHT};
+  uint8_t rasterFrame[BUFFER_BYTES];
+
+  printf("# pixels per microsecond (set + clear), best of %d runs of %d passes\n", BENCH_RUNS, BENCH_PASSES);
+  printf("%-16s %8s %12s %12s %9s %6s\n", "workload", "pixels", "raster", "gfx", "speedup", "diff");
+  for (const Workload& w : workloads) {
+    display.clearDisplay();
+    w.raster(target, RASTER_SET);
+    memcpy(rasterFrame, display.getBuffer(), BUFFER_BYTES);
+    display.clearDisplay();
+    w.gfx(display, RASTER_SET);
+    const int pixels = countPixels(rasterFrame);
+    const int diff = countDiff(rasterFrame, display.getBuffer());
+    display.clearDisplay();
+
+    const double rasterNs = measure([&](RasterOp op) { w.raster(target, op); });
+    const double gfxNs = measure([&](RasterOp op) { w.gfx(display, op); });
+    const double touched = 2.0 * pixels;   // set and cleared
+    printf("%-16s %8d %12.1f %12.1f %8.1fx %6d\n", w.name, pixels,
+           touched / (rasterNs / 1000.0), touched / (gfxNs / 1000.0), gfxNs / rasterNs, diff);
+  }
+  return 0;
+}
@@ -0,0 +1,138 @@
+// Host benchmark of the rolling plot history: RollingWindow against the shifting
+// array with per-frame rescans it replaced, at history sizes far above PLOT_HISTORY.
+//
+// Per history size it reports the cost of one insert, of one axis range query
+// (minimum and maximum) and of one render pass that maps every sample to a plot
+// column. Times are nanoseconds per operation, best of BENCH_RUNS runs.
+
+#include "RollingWindow.h"
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_RUNS 5
+#define PLOT_COLUMNS 106
+
+static volatile float sink;
+
+static double nowNs() {
+  return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Deterministic noise so every run and variant sees the same samples.
+static uint32_t lcg = 1;
+static float nextSample() {
+  lcg = lcg * 1664525u + 1013904223u;
+  return (float)(lcg >> 8) * (1.0f / 16777216.0f);
+}
+
+// The previous implementation: shift left by one once full, rescan for the range.
+template <size_t N>
+struct ShiftWindow {
+  float data[N];
+  size_t count = 0;
+
+  void push(float value) {
+    if (count == N) {
+      memmove(data, data + 1, (N - 1) * sizeof(float));
+      data[N - 1] = value;
+    } else {
+      data[count++] = value;
+    }
+  }
+  float minimum() const {
+    float m = data[0];
+    for (size_t i = 1; i < count; i++) if (data[i] < m) m = data[i];
+    return m;
+  }
+  float maximum() const {
+    float m = data[0];
+    for (size_t i = 1; i < count; i++) if (data[i] > m) m = data[i];
+    return m;
+  }
+  float operator[](size_t i) const { return data[i]; }
+  size_t size() const { return count; }
+};
+
+// Maps every sample to the plot column of its index and keeps the top row per column.
+template <typename W>
+static void renderPass(const W& w, float lo, float hi) {
+  int8_t top[PLOT_COLUMNS];
+  memset(top, 127, sizeof(top));
+  float span = (hi > lo) ? hi - lo : 1.0f;
+  size_t n = w.size();
+  for (size_t i = 0; i < n; i++) {
+    int x = (int)(i * (PLOT_COLUMNS - 1) / (n - 1));
+    int8_t y = (int8_t)((w[i] - lo) / span * 41.0f);
+    if (y < top[x]) top[x] = y;
+  }
+  sink = top[0] + top[PLOT_COLUMNS - 1];
+}
+
+struct Result {
+  double insertNs;
+  double rangeNs;
+  double renderNs;
+};
+
+template <typename W>
+static Result measure(W& w, size_t history) {
+  Result best = {1e30, 1e30, 1e30};
+  for (int run = 0; run < BENCH_RUNS; run++) {
+    lcg = 1;
+    for (size_t i = 0; i < history; i++) w.push(nextSample());
+
+    // Steady state: the window is full and every insert evicts a sample.
+    size_t inserts = history < 4096 ? 4096 : history;
+    double t0 = nowNs();
+    for (size_t i = 0; i < inserts; i++) w.push(nextSample());
+    double insertNs = (nowNs() - t0) / inserts;
+
+    const size_t queries = 256;
+    float acc = 0;
+    t0 = nowNs();
+    for (size_t i = 0; i < queries; i++) {
+      acc += w.minimum() + w.maximum();
+      w.push(nextSample());   // defeat hoisting of the query out of the loop
+    }
+    double rangeNs = (nowNs() - t0) / queries - insertNs;
+    sink = acc;
+
+    const size_t frames = 16;
+    t0 = nowNs();
+    for (size_t i = 0; i < frames; i++) renderPass(w, w.minimum(), w.maximum());
+    double renderNs = (nowNs() - t0) / frames;
+
+    if (insertNs < best.insertNs) best.insertNs = insertNs;
+    if (rangeNs < best.rangeNs) best.rangeNs = rangeNs;
+    if (renderNs < best.renderNs) best.renderNs = renderNs;
+  }
+  if (best.rangeNs < 0) best.rangeNs = 0;
+  return best;
+}
+
+template <size_t N>
+static void benchSize() {
+  static RollingWindow<float, N> ring;
+  static ShiftWindow<N> shift;
+  Result r = measure(ring, N);
+  Result s = measure(shift, N);
+  printf("%8zu %12.1f %12.1f %12.1f %12.1f %14.0f %14.0f\n", N,
+         r.insertNs, s.insertNs, r.rangeNs, s.rangeNs, r.renderNs, s.renderNs);
+}
+
+int main() {
+  printf("# ns per operation, best of %d runs\n", BENCH_RUNS);
+  printf("%8s %12s %12s %12s %12s %14s %14s\n", "history",
+         "insert ring", "insert shift", "range ring", "range rescan",
+         "render ring", "render shift");
+  benchSize<128>();
+  benchSize<512>();
+  benchSize<2048>();
+  benchSize<8192>();
+  benchSize<32768>();
+  benchSize<65536>();
+  return 0;
+}
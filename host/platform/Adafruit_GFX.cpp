@@ -0,0 +1,409 @@
+// Host copy of the Adafruit_GFX drawing core (see Adafruit_GFX.h).
+#include <Adafruit_GFX.h>
+#include <stdlib.h>
+
+#define FIRST_GLYPH 0x20
+#define LAST_GLYPH  0x7E
+
+// Classic 5x7 font, printable ASCII, one byte per column (LSB at the top).
+static const uint8_t font[(LAST_GLYPH - FIRST_GLYPH + 1) * 5] = {
+  0x00, 0x00, 0x00, 0x00, 0x00,  // ' '
+  0x00, 0x00, 0x5F, 0x00, 0x00,  // '!'
+  0x00, 0x07, 0x00, 0x07, 0x00,  // '"'
+  0x14, 0x7F, 0x14, 0x7F, 0x14,  // '#'
+  0x24, 0x2A, 0x7F, 0x2A, 0x12,  // '$'
+  0x23, 0x13, 0x08, 0x64, 0x62,  // '%'
+  0x36, 0x49, 0x56, 0x20, 0x50,  // '&'
+  0x00, 0x08, 0x07, 0x03, 0x00,  // '''
+  0x00, 0x1C, 0x22, 0x41, 0x00,  // '('
+  0x00, 0x41, 0x22, 0x1C, 0x00,  // ')'
+  0x2A, 0x1C, 0x7F, 0x1C, 0x2A,  // '*'
+  0x08, 0x08, 0x3E, 0x08, 0x08,  // '+'
+  0x00, 0x80, 0x70, 0x30, 0x00,  // ','
+  0x08, 0x08, 0x08, 0x08, 0x08,  // '-'
+  0x00, 0x00, 0x60, 0x60, 0x00,  // '.'
+  0x20, 0x10, 0x08, 0x04, 0x02,  // '/'
+  0x3E, 0x51, 0x49, 0x45, 0x3E,  // '0'
+  0x00, 0x42, 0x7F, 0x40, 0x00,  // '1'
+  0x72, 0x49, 0x49, 0x49, 0x46,  // '2'
+  0x21, 0x41, 0x49, 0x4D, 0x33,  // '3'
+  0x18, 0x14, 0x12, 0x7F, 0x10,  // '4'
+  0x27, 0x45, 0x45, 0x45, 0x39,  // '5'
+  0x3C, 0x4A, 0x49, 0x49, 0x31,  // '6'
+  0x41, 0x21, 0x11, 0x09, 0x07,  // '7'
+  0x36, 0x49, 0x49, 0x49, 0x36,  // '8'
+  0x46, 0x49, 0x49, 0x29, 0x1E,  // '9'
+  0x00, 0x00, 0x14, 0x00, 0x00,  // ':'
+  0x00, 0x40, 0x34, 0x00, 0x00,  // ';'
+  0x00, 0x08, 0x14, 0x22, 0x41,  // '<'
+  0x14, 0x14, 0x14, 0x14, 0x14,  // '='
+  0x00, 0x41, 0x22, 0x14, 0x08,  // '>'
+  0x02, 0x01, 0x59, 0x09, 0x06,  // '?'
+  0x3E, 0x41, 0x5D, 0x59, 0x4E,  // '@'
+  0x7C, 0x12, 0x11, 0x12, 0x7C,  // 'A'
+  0x7F, 0x49, 0x49, 0x49, 0x36,  // 'B'
+  0x3E, 0x41, 0x41, 0x41, 0x22,  // 'C'
+  0x7F, 0x41, 0x41, 0x41, 0x3E,  // 'D'
+  0x7F, 0x49, 0x49, 0x49, 0x41,  // 'E'
+  0x7F, 0x09, 0x09, 0x09, 0x01,  // 'F'
+  0x3E, 0x41, 0x41, 0x51, 0x73,  // 'G'
+  0x7F, 0x08, 0x08, 0x08, 0x7F,  // 'H'
+  0x00, 0x41, 0x7F, 0x41, 0x00,  // 'I'
+  0x20, 0x40, 0x41, 0x3F, 0x01,  // 'J'
+  0x7F, 0x08, 0x14, 0x22, 0x41,  // 'K'
+  0x7F, 0x40, 0x40, 0x40, 0x40,  // 'L'
+  0x7F, 0x02, 0x1C, 0x02, 0x7F,  // 'M'
+  0x7F, 0x04, 0x08, 0x10, 0x7F,  // 'N'
+  0x3E, 0x41, 0x41, 0x41, 0x3E,  // 'O'
+  0x7F, 0x09, 0x09, 0x09, 0x06,  // 'P'
+  0x3E, 0x41, 0x51, 0x21, 0x5E,  // 'Q'
+  0x7F, 0x09, 0x19, 0x29, 0x46,  // 'R'
+  0x26, 0x49, 0x49, 0x49, 0x32,  // 'S'
+  0x03, 0x01, 0x7F, 0x01, 0x03,  // 'T'
+  0x3F, 0x40, 0x40, 0x40, 0x3F,  // 'U'
+  0x1F, 0x20, 0x40, 0x20, 0x1F,  // 'V'
+  0x3F, 0x40, 0x38, 0x40, 0x3F,  // 'W'
+  0x63, 0x14, 0x08, 0x14, 0x63,  // 'X'
+  0x03, 0x04, 0x78, 0x04, 0x03,  // 'Y'
+  0x61, 0x59, 0x49, 0x4D, 0x43,  // 'Z'
+  0x00, 0x7F, 0x41, 0x41, 0x41,  // '['
+  0x02, 0x04, 0x08, 0x10, 0x20,  // '\'
+  0x00, 0x41, 0x41, 0x41, 0x7F,  // ']'
+  0x04, 0x02, 0x01, 0x02, 0x04,  // '^'
+  0x40, 0x40, 0x40, 0x40, 0x40,  // '_'
+  0x00, 0x03, 0x07, 0x08, 0x00,  // '`'
+  0x20, 0x54, 0x54, 0x78, 0x40,  // 'a'
+  0x7F, 0x28, 0x44, 0x44, 0x38,  // 'b'
+  0x38, 0x44, 0x44, 0x44, 0x28,  // 'c'
+  0x38, 0x44, 0x44, 0x28, 0x7F,  // 'd'
+  0x38, 0x54, 0x54, 0x54, 0x18,  // 'e'
+  0x00, 0x08, 0x7E, 0x09, 0x02,  // 'f'
+  0x18, 0xA4, 0xA4, 0x9C, 0x78,  // 'g'
+  0x7F, 0x08, 0x04, 0x04, 0x78,  // 'h'
+  0x00, 0x44, 0x7D, 0x40, 0x00,  // 'i'
+  0x20, 0x40, 0x40, 0x3D, 0x00,  // 'j'
+  0x7F, 0x10, 0x28, 0x44, 0x00,  // 'k'
+  0x00, 0x41, 0x7F, 0x40, 0x00,  // 'l'
+  0x7C, 0x04, 0x78, 0x04, 0x78,  // 'm'
+  0x7C, 0x08, 0x04, 0x04, 0x78,  // 'n'
+  0x38, 0x44, 0x44, 0x44, 0x38,  // 'o'
+  0xFC, 0x18, 0x24, 0x24, 0x18,  // 'p'
+  0x18, 0x24, 0x24, 0x18, 0xFC,  // 'q'
+  0x7C, 0x08, 0x04, 0x04, 0x08,  // 'r'
+  0x48, 0x54, 0x54, 0x54, 0x24,  // 's'
+  0x04, 0x04, 0x3F, 0x44, 0x24,  // 't'
+  0x3C, 0x40, 0x40, 0x20, 0x7C,  // 'u'
+  0x1C, 0x20, 0x40, 0x20, 0x1C,  // 'v'
+  0x3C, 0x40, 0x30, 0x40, 0x3C,  // 'w'
+  0x44, 0x28, 0x10, 0x28, 0x44,  // 'x'
+  0x4C, 0x90, 0x90, 0x90, 0x7C,  // 'y'
+  0x44, 0x64, 0x54, 0x4C, 0x44,  // 'z'
+  0x00, 0x08, 0x36, 0x41, 0x00,  // '{'
+  0x00, 0x00, 0x77, 0x00, 0x00,  // '|'
+  0x00, 0x41, 0x36, 0x08, 0x00,  // '}'
+  0x02, 0x01, 0x02, 0x04, 0x02,  // '~'
+};
+
+// Drawn for codes outside the host font.
+static const uint8_t missingGlyph[5] = {0x7F, 0x41, 0x41, 0x41, 0x7F};
+
+static void swapInt16(int16_t& a, int16_t& b)
+{
+  int16_t t = a;
+  a = b;
+  b = t;
+}
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h)
+{
+  _width = WIDTH;
+  _height = HEIGHT;
+  cursor_y = cursor_x = 0;
+  textsize_x = textsize_y = 1;
+  textcolor = textbgcolor = 0xFFFF;
+  wrap = true;
+  _cp437 = false;
+}
+
+// Bresenham's algorithm
+void Adafruit_GFX::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+  int16_t steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) {
+    swapInt16(x0, y0);
+    swapInt16(x1, y1);
+  }
+  if (x0 > x1) {
+    swapInt16(x0, x1);
+    swapInt16(y0, y1);
+  }
+
+  int16_t dx = x1 - x0;
+  int16_t dy = abs(y1 - y0);
+  int16_t err = dx / 2;
+  int16_t ystep = (y0 < y1) ? 1 : -1;
+
+  for (; x0 <= x1; x0++) {
+    if (steep) {
+      writePixel(y0, x0, color);
+    } else {
+      writePixel(x0, y0, color);
+    }
+    err -= dy;
+    if (err < 0) {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  startWrite();
+  writeLine(x, y, x, y + h - 1, color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  startWrite();
+  writeLine(x, y, x + w - 1, y, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  startWrite();
+  for (int16_t i = x; i < x + w; i++) {
+    writeFastVLine(i, y, h, color);
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+  // Update in subclasses if desired!
+  if (x0 == x1) {
+    if (y0 > y1) swapInt16(y0, y1);
+    drawFastVLine(x0, y0, y1 - y0 + 1, color);
+  } else if (y0 == y1) {
+    if (x0 > x1) swapInt16(x0, x1);
+    drawFastHLine(x0, y0, x1 - x0 + 1, color);
+  } else {
+    startWrite();
+    writeLine(x0, y0, x1, y1, color);
+    endWrite();
+  }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  startWrite();
+  writeFastHLine(x, y, w, color);
+  writeFastHLine(x, y + h - 1, w, color);
+  writeFastVLine(x, y, h, color);
+  writeFastVLine(x + w - 1, y, h, color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
+{
+  int16_t f = 1 - r;
+  int16_t ddF_x = 1;
+  int16_t ddF_y = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+
+  startWrite();
+  writePixel(x0, y0 + r, color);
+  writePixel(x0, y0 - r, color);
+  writePixel(x0 + r, y0, color);
+  writePixel(x0 - r, y0, color);
+
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+
+    writePixel(x0 + x, y0 + y, color);
+    writePixel(x0 - x, y0 + y, color);
+    writePixel(x0 + x, y0 - y, color);
+    writePixel(x0 - x, y0 - y, color);
+    writePixel(x0 + y, y0 + x, color);
+    writePixel(x0 - y, y0 + x, color);
+    writePixel(x0 + y, y0 - x, color);
+    writePixel(x0 - y, y0 - x, color);
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
+{
+  startWrite();
+  writeFastVLine(x0, y0 - r, 2 * r + 1, color);
+  fillCircleHelper(x0, y0, r, 3, 0, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color)
+{
+  int16_t f = 1 - r;
+  int16_t ddF_x = 1;
+  int16_t ddF_y = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+  int16_t px = x;
+  int16_t py = y;
+
+  delta++;   // Avoid some +1's in the loop
+
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    // These checks avoid double-drawing certain lines, important for the SSD1306
+    // library which has an INVERT drawing mode.
+    if (x < (y + 1)) {
+      if (corners & 1) writeFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+      if (corners & 2) writeFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+    }
+    if (y != py) {
+      if (corners & 1) writeFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+      if (corners & 2) writeFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+      py = y;
+    }
+    px = x;
+  }
+}
+
+void Adafruit_GFX::drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color)
+{
+  drawLine(x0, y0, x1, y1, color);
+  drawLine(x1, y1, x2, y2, color);
+  drawLine(x2, y2, x0, y0, color);
+}
+
+void Adafruit_GFX::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color)
+{
+  int16_t a, b, y, last;
+
+  // Sort coordinates by Y order (y2 >= y1 >= y0)
+  if (y0 > y1) {
+    swapInt16(y0, y1);
+    swapInt16(x0, x1);
+  }
+  if (y1 > y2) {
+    swapInt16(y2, y1);
+    swapInt16(x2, x1);
+  }
+  if (y0 > y1) {
+    swapInt16(y0, y1);
+    swapInt16(x0, x1);
+  }
+
+  startWrite();
+  if (y0 == y2) {   // all on the same line
+    a = b = x0;
+    if (x1 < a) a = x1;
+    else if (x1 > b) b = x1;
+    if (x2 < a) a = x2;
+    else if (x2 > b) b = x2;
+    writeFastHLine(a, y0, b - a + 1, color);
+    endWrite();
+    return;
+  }
+
+  int16_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0, dx12 = x2 - x1, dy12 = y2 - y1;
+  int32_t sa = 0, sb = 0;
+
+  // Upper part: scanlines y0 to y1 (y1 itself too if the lower part is flat).
+  last = (y1 == y2) ? y1 : y1 - 1;
+  for (y = y0; y <= last; y++) {
+    a = x0 + sa / dy01;
+    b = x0 + sb / dy02;
+    sa += dx01;
+    sb += dx02;
+    if (a > b) swapInt16(a, b);
+    writeFastHLine(a, y, b - a + 1, color);
+  }
+
+  // Lower part: scanlines y1 to y2.
+  sa = (int32_t)dx12 * (y - y1);
+  sb = (int32_t)dx02 * (y - y0);
+  for (; y <= y2; y++) {
+    a = x1 + sa / dy12;
+    b = x0 + sb / dy02;
+    sa += dx12;
+    sb += dx02;
+    if (a > b) swapInt16(a, b);
+    writeFastHLine(a, y, b - a + 1, color);
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size)
+{
+  drawChar(x, y, c, color, bg, size, size);
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t sizeX, uint8_t sizeY)
+{
+  if ((x >= _width) || (y >= _height) || ((x + 6 * sizeX - 1) < 0) || ((y + 8 * sizeY - 1) < 0)) {
+    return;
+  }
+  const uint8_t* glyph = (c >= FIRST_GLYPH && c <= LAST_GLYPH) ? &font[(c - FIRST_GLYPH) * 5] : missingGlyph;
+
+  startWrite();
+  for (int8_t i = 0; i < 5; i++) {
+    uint8_t line = glyph[i];
+    for (int8_t j = 0; j < 8; j++, line >>= 1) {
+      if (line & 1) {
+        if (sizeX == 1 && sizeY == 1) {
+          writePixel(x + i, y + j, color);
+        } else {
+          writeFillRect(x + i * sizeX, y + j * sizeY, sizeX, sizeY, color);
+        }
+      } else if (bg != color) {
+        if (sizeX == 1 && sizeY == 1) {
+          writePixel(x + i, y + j, bg);
+        } else {
+          writeFillRect(x + i * sizeX, y + j * sizeY, sizeX, sizeY, bg);
+        }
+      }
+    }
+  }
+  if (bg != color) {   // If opaque, draw vertical line for last column
+    if (sizeX == 1 && sizeY == 1) {
+      writeFastVLine(x + 5, y, 8, bg);
+    } else {
+      writeFillRect(x + 5 * sizeX, y, sizeX, 8 * sizeY, bg);
+    }
+  }
+  endWrite();
+}
+
+size_t Adafruit_GFX::write(uint8_t c)
+{
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y += textsize_y * 8;
+  } else if (c != '\r') {
+    if (wrap && ((cursor_x + textsize_x * 6) > _width)) {
+      cursor_x = 0;
+      cursor_y += textsize_y * 8;
+    }
+    drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+    cursor_x += textsize_x * 6;
+  }
+  return 1;
+}
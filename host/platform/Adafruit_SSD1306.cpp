@@ -0,0 +1,150 @@
+// Host copy of the SSD1306 frame buffer drawing (see Adafruit_SSD1306.h).
+#include <Adafruit_SSD1306.h>
+#include <stdlib.h>
+#include <string.h>
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t rstPin, uint32_t clkDuring,
+                                   uint32_t clkAfter)
+    : Adafruit_GFX(w, h), buffer(NULL)
+{
+  (void)twi;
+  (void)rstPin;
+  (void)clkDuring;
+  (void)clkAfter;
+}
+
+Adafruit_SSD1306::~Adafruit_SSD1306(void)
+{
+  free(buffer);
+}
+
+bool Adafruit_SSD1306::begin(uint8_t switchvcc, uint8_t i2caddr, bool reset, bool periphBegin)
+{
+  (void)switchvcc;
+  (void)i2caddr;
+  (void)reset;
+  (void)periphBegin;
+  if ((!buffer) && !(buffer = (uint8_t*)malloc(WIDTH * ((HEIGHT + 7) / 8)))) {
+    return false;
+  }
+  clearDisplay();
+  return true;
+}
+
+void Adafruit_SSD1306::clearDisplay(void)
+{
+  memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+  if ((x >= 0) && (x < width()) && (y >= 0) && (y < height())) {
+    switch (color) {
+      case SSD1306_WHITE: buffer[x + (y / 8) * WIDTH] |= (1 << (y & 7)); break;
+      case SSD1306_BLACK: buffer[x + (y / 8) * WIDTH] &= ~(1 << (y & 7)); break;
+      case SSD1306_INVERSE: buffer[x + (y / 8) * WIDTH] ^= (1 << (y & 7)); break;
+    }
+  }
+}
+
+bool Adafruit_SSD1306::getPixel(int16_t x, int16_t y)
+{
+  if ((x >= 0) && (x < width()) && (y >= 0) && (y < height())) {
+    return (buffer[x + (y / 8) * WIDTH] & (1 << (y & 7)));
+  }
+  return false;
+}
+
+void Adafruit_SSD1306::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  if ((y >= 0) && (y < HEIGHT)) {   // Y coord in bounds?
+    if (x < 0) {                    // Clip left
+      w += x;
+      x = 0;
+    }
+    if ((x + w) > WIDTH) {          // Clip right
+      w = (WIDTH - x);
+    }
+    if (w > 0) {
+      uint8_t* pBuf = &buffer[(y / 8) * WIDTH + x];
+      uint8_t mask = 1 << (y & 7);
+      switch (color) {
+        case SSD1306_WHITE:
+          while (w--) *pBuf++ |= mask;
+          break;
+        case SSD1306_BLACK:
+          mask = ~mask;
+          while (w--) *pBuf++ &= mask;
+          break;
+        case SSD1306_INVERSE:
+          while (w--) *pBuf++ ^= mask;
+          break;
+      }
+    }
+  }
+}
+
+void Adafruit_SSD1306::drawFastVLine(int16_t x, int16_t __y, int16_t __h, uint16_t color)
+{
+  if ((x >= 0) && (x < WIDTH)) {    // X coord in bounds?
+    if (__y < 0) {                  // Clip top
+      __h += __y;
+      __y = 0;
+    }
+    if ((__y + __h) > HEIGHT) {     // Clip bottom
+      __h = (HEIGHT - __y);
+    }
+    if (__h > 0) {
+      uint8_t y = __y, h = __h;
+      uint8_t* pBuf = &buffer[(y / 8) * WIDTH + x];
+
+      // Partial first byte
+      uint8_t mod = (y & 7);
+      if (mod) {
+        mod = 8 - mod;
+        static const uint8_t premask[8] = {0x00, 0x80, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC, 0xFE};
+        uint8_t mask = premask[mod];
+        if (h < mod) mask &= (0xFF >> (mod - h));
+        switch (color) {
+          case SSD1306_WHITE: *pBuf |= mask; break;
+          case SSD1306_BLACK: *pBuf &= ~mask; break;
+          case SSD1306_INVERSE: *pBuf ^= mask; break;
+        }
+        pBuf += WIDTH;
+      }
+
+      if (h >= mod) {   // More to go?
+        h -= mod;
+        // Whole bytes
+        if (h >= 8) {
+          if (color == SSD1306_INVERSE) {
+            do {
+              *pBuf ^= 0xFF;
+              pBuf += WIDTH;
+              h -= 8;
+            } while (h >= 8);
+          } else {
+            uint8_t val = (color != SSD1306_BLACK) ? 255 : 0;
+            do {
+              *pBuf = val;
+              pBuf += WIDTH;
+              h -= 8;
+            } while (h >= 8);
+          }
+        }
+
+        // Partial last byte
+        if (h) {
+          mod = h & 7;
+          static const uint8_t postmask[8] = {0x00, 0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F};
+          uint8_t mask = postmask[mod];
+          switch (color) {
+            case SSD1306_WHITE: *pBuf |= mask; break;
+            case SSD1306_BLACK: *pBuf &= ~mask; break;
+            case SSD1306_INVERSE: *pBuf ^= mask; break;
+          }
+        }
+      }
+    }
+  }
+}
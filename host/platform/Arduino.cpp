@@ -0,0 +1,243 @@
+// Host Arduino core: time, board I/O, Serial and chip information (see Arduino.h).
+#include <Arduino.h>
+#include <Wire.h>
+#include <esp_heap_caps.h>
+#include "host_clock.h"
+#include <mutex>
+
+HardwareSerial Serial;
+EspClass ESP;
+TwoWire Wire;
+
+// Touch reading of an untouched pad (ESP32-S3 counts rise when touched).
+#define TOUCH_IDLE_READING 25000
+
+// Voltage on the ADC pins: VBAT (GPIO7) through its 4.133 divider at 3.9 V, USB
+// (GPIO3) through its 1.468 divider at 5.0 V.
+#define VBAT_ADC_PIN 7
+#define USB_ADC_PIN  3
+#define VBAT_PIN_VOLTS (3.9f / 4.133f)
+#define USB_PIN_VOLTS  (5.0f / 1.468f)
+
+#define PIN_COUNT 49
+
+static uint8_t pinModes[PIN_COUNT];
+static uint8_t pinLevels[PIN_COUNT];
+static adc_attenuation_t pinAttenuation[PIN_COUNT];
+static uint8_t adcBits = 12;
+
+//------------------
+// Time
+//------------------
+unsigned long millis()
+{
+  return (unsigned long)(uint32_t)(hostNanos() / 1000000u);
+}
+
+unsigned long micros()
+{
+  return (unsigned long)(uint32_t)(hostNanos() / 1000u);
+}
+
+void delay(uint32_t ms)
+{
+  vTaskDelay(ms / portTICK_PERIOD_MS);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+  uint64_t end = hostNanos() + (uint64_t)us * 1000u;
+  while (hostNanos() < end) {
+  }
+}
+
+void yield()
+{
+  vPortYield();
+}
+
+//------------------
+// GPIO
+//------------------
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  if (pin >= PIN_COUNT) return;
+  pinModes[pin] = mode;
+  if (mode != OUTPUT) {
+    // Nothing drives the inputs: they sit at their pull level.
+    pinLevels[pin] = (mode & PULLUP) ? HIGH : LOW;
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  if (pin < PIN_COUNT && pinModes[pin] == OUTPUT) {
+    pinLevels[pin] = value ? HIGH : LOW;
+  }
+}
+
+int digitalRead(uint8_t pin)
+{
+  return pin < PIN_COUNT ? pinLevels[pin] : LOW;
+}
+
+// Nothing changes the inputs, so the interrupts never fire.
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode) { (void)pin; (void)isr; (void)mode; }
+void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode) { (void)pin; (void)isr; (void)arg; (void)mode; }
+void detachInterrupt(uint8_t pin) { (void)pin; }
+
+//------------------
+// ADC
+//------------------
+static float attenuationFullScale(adc_attenuation_t attenuation)
+{
+  switch (attenuation) {
+    case ADC_0db: return 0.95f;
+    case ADC_2_5db: return 1.25f;
+    case ADC_6db: return 1.75f;
+    default: return 3.10f;
+  }
+}
+
+uint16_t analogRead(uint8_t pin)
+{
+  if (pin >= PIN_COUNT) return 0;
+  float volts = (pin == VBAT_ADC_PIN) ? VBAT_PIN_VOLTS : (pin == USB_ADC_PIN) ? USB_PIN_VOLTS : 0.0f;
+  uint32_t max = (1u << adcBits) - 1;
+  float raw = volts / attenuationFullScale(pinAttenuation[pin]) * max;
+  return (uint16_t)(raw >= max ? max : raw);
+}
+
+void analogReadResolution(uint8_t bits)
+{
+  adcBits = (bits >= 9 && bits <= 12) ? bits : 12;
+}
+
+void analogSetPinAttenuation(uint8_t pin, adc_attenuation_t attenuation)
+{
+  if (pin < PIN_COUNT) pinAttenuation[pin] = attenuation;
+}
+
+//------------------
+// Touch pads
+//------------------
+touch_value_t touchRead(uint8_t pin)
+{
+  (void)pin;
+  return TOUCH_IDLE_READING;
+}
+
+void touchAttachInterrupt(uint8_t pin, void (*isr)(void), touch_value_t threshold) { (void)pin; (void)isr; (void)threshold; }
+void touchAttachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, touch_value_t threshold) { (void)pin; (void)isr; (void)arg; (void)threshold; }
+void touchDetachInterrupt(uint8_t pin) { (void)pin; }
+
+//------------------
+// LEDC and tone
+//------------------
+double ledcSetup(uint8_t channel, double freq, uint8_t resolutionBits) { (void)channel; (void)resolutionBits; return freq; }
+void ledcAttachPin(uint8_t pin, uint8_t channel) { (void)pin; (void)channel; }
+void ledcDetachPin(uint8_t pin) { (void)pin; }
+void ledcWrite(uint8_t channel, uint32_t duty) { (void)channel; (void)duty; }
+double ledcWriteTone(uint8_t channel, double freq) { (void)channel; return freq; }
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) { (void)pin; (void)frequency; (void)duration; }
+void noTone(uint8_t pin) { (void)pin; }
+
+//------------------
+// Random numbers
+//------------------
+static std::mutex randomLock;
+static uint32_t randomState = 0x12345678u;
+
+static uint32_t nextRandom()
+{
+  std::lock_guard<std::mutex> guard(randomLock);
+  // xorshift32
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return randomState;
+}
+
+long random(long howBig)
+{
+  return howBig > 0 ? (long)(nextRandom() % (uint32_t)howBig) : 0;
+}
+
+long random(long howSmall, long howBig)
+{
+  return howSmall >= howBig ? howSmall : howSmall + random(howBig - howSmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+  if (seed != 0) {
+    std::lock_guard<std::mutex> guard(randomLock);
+    randomState = (uint32_t)seed;
+  }
+}
+
+//------------------
+// Chip
+//------------------
+uint32_t getCpuFrequencyMhz()
+{
+  return 1000;   // ESP.getCycleCount() counts nanoseconds
+}
+
+uint32_t EspClass::getCycleCount()
+{
+  return (uint32_t)hostNanos();
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+  return (uint32_t)heap_caps_get_free_size(MALLOC_CAP_8BIT);
+}
+
+uint32_t EspClass::getMinFreeHeap()
+{
+  return (uint32_t)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+}
+
+uint32_t EspClass::getMaxAllocHeap()
+{
+  return (uint32_t)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+}
+
+void EspClass::restart()
+{
+  fflush(stdout);
+  _Exit(0);
+}
+
+//------------------
+// Serial
+//------------------
+size_t HardwareSerial::write(uint8_t c)
+{
+  return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size)
+{
+  return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush()
+{
+  fflush(stdout);
+}
+
+//------------------
+// C library
+//------------------
+extern "C" size_t strlcpy(char* dst, const char* src, size_t size)
+{
+  size_t length = strlen(src);
+  if (size > 0) {
+    size_t n = length < size - 1 ? length : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return length;
+}
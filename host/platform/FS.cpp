@@ -0,0 +1,159 @@
+// Host file system: SPIFFS files are files in a host directory (see SPIFFS.h).
+#include <FS.h>
+#include <SPIFFS.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <errno.h>
+
+fs::SPIFFSFS SPIFFS;
+
+namespace fs {
+
+//------------------
+// File
+//------------------
+size_t File::write(uint8_t c)
+{
+  return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buffer, size_t size)
+{
+  return file ? fwrite(buffer, 1, size, file.get()) : 0;
+}
+
+int File::available()
+{
+  if (!file) return 0;
+  long pos = ftell(file.get());
+  return pos < 0 ? 0 : (int)(size() - (size_t)pos);
+}
+
+int File::read()
+{
+  return file ? fgetc(file.get()) : -1;
+}
+
+int File::peek()
+{
+  if (!file) return -1;
+  int c = fgetc(file.get());
+  if (c != EOF) ungetc(c, file.get());
+  return c;
+}
+
+size_t File::read(uint8_t* buffer, size_t size)
+{
+  return file ? fread(buffer, 1, size, file.get()) : 0;
+}
+
+void File::flush()
+{
+  if (file) fflush(file.get());
+}
+
+bool File::seek(uint32_t pos)
+{
+  return file && fseek(file.get(), (long)pos, SEEK_SET) == 0;
+}
+
+size_t File::position() const
+{
+  long pos = file ? ftell(file.get()) : -1;
+  return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const
+{
+  if (!file) return 0;
+  fflush(file.get());
+  struct stat st;
+  if (fstat(fileno(file.get()), &st) != 0) return 0;
+  return (size_t)st.st_size;
+}
+
+//------------------
+// FS
+//------------------
+String FS::hostPath(const char* path) const
+{
+  String host = root;
+  if (path[0] != '/') host += "/";
+  host += path;
+  return host;
+}
+
+File FS::open(const char* path, const char* mode, bool create)
+{
+  (void)create;
+  if (root.isEmpty()) {
+    return File();   // not mounted
+  }
+  // Binary data is written through these handles, and "r"/"w"/"a" map directly.
+  FILE* f = fopen(hostPath(path).c_str(), mode);
+  return f != NULL ? File(f) : File();
+}
+
+bool FS::exists(const char* path)
+{
+  struct stat st;
+  return !root.isEmpty() && stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path)
+{
+  return !root.isEmpty() && ::remove(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo)
+{
+  return !root.isEmpty() && ::rename(hostPath(pathFrom).c_str(), hostPath(pathTo).c_str()) == 0;
+}
+
+//------------------
+// SPIFFS
+//------------------
+bool SPIFFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel)
+{
+  (void)formatOnFail;
+  (void)basePath;
+  (void)maxOpenFiles;
+  (void)partitionLabel;
+  const char* dir = getenv("FIRMWARE_FS_DIR");
+  String path = (dir != NULL && dir[0] != '\0') ? dir : "spiffs";
+  if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+    return false;
+  }
+  root = path;
+  return true;
+}
+
+bool SPIFFSFS::format()
+{
+  DIR* dir = opendir(root.c_str());
+  if (dir == NULL) return false;
+  while (struct dirent* entry = readdir(dir)) {
+    if (entry->d_type == DT_REG) {
+      ::remove(hostPath(entry->d_name).c_str());
+    }
+  }
+  closedir(dir);
+  return true;
+}
+
+size_t SPIFFSFS::usedBytes()
+{
+  size_t used = 0;
+  DIR* dir = opendir(root.c_str());
+  if (dir == NULL) return 0;
+  while (struct dirent* entry = readdir(dir)) {
+    struct stat st;
+    if (entry->d_type == DT_REG && stat(hostPath(entry->d_name).c_str(), &st) == 0) {
+      used += (size_t)st.st_size;
+    }
+  }
+  closedir(dir);
+  return used;
+}
+
+} // namespace fs
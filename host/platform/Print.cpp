@@ -0,0 +1,129 @@
+// Host copy of Arduino's Print (number formatting as in Arduino-ESP32).
+#include <Print.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+size_t Print::write(const uint8_t* buffer, size_t size)
+{
+  size_t n = 0;
+  while (size--) {
+    if (write(*buffer++)) {
+      n++;
+    } else {
+      break;
+    }
+  }
+  return n;
+}
+
+size_t Print::printf(const char* format, ...)
+{
+  char local[64];
+  char* temp = local;
+  va_list arg;
+  va_start(arg, format);
+  va_list copy;
+  va_copy(copy, arg);
+  int len = vsnprintf(temp, sizeof(local), format, copy);
+  va_end(copy);
+  if (len < 0) {
+    va_end(arg);
+    return 0;
+  }
+  if ((size_t)len >= sizeof(local)) {
+    temp = (char*)malloc(len + 1);
+    if (temp == NULL) {
+      va_end(arg);
+      return 0;
+    }
+    len = vsnprintf(temp, len + 1, format, arg);
+  }
+  va_end(arg);
+  len = write((const uint8_t*)temp, len);
+  if (temp != local) {
+    free(temp);
+  }
+  return len;
+}
+
+size_t Print::print(long n, int base)
+{
+  if (base == 10 && n < 0) {
+    int t = print('-');
+    return printNumber((unsigned long long)(-(long long)n), 10) + t;
+  }
+  return base == 10 ? printNumber((unsigned long)n, 10) : printNumber((unsigned long)n, base);
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+  return printNumber(n, base);
+}
+
+size_t Print::print(long long n, int base)
+{
+  if (base == 10 && n < 0) {
+    int t = print('-');
+    return printNumber((unsigned long long)(-n), 10) + t;
+  }
+  return printNumber((unsigned long long)n, base);
+}
+
+size_t Print::print(unsigned long long n, int base)
+{
+  return printNumber(n, base);
+}
+
+size_t Print::printNumber(unsigned long long n, uint8_t base)
+{
+  char buf[8 * sizeof(n) + 1];
+  char* str = &buf[sizeof(buf) - 1];
+  *str = '\0';
+  if (base < 2) {
+    base = 10;
+  }
+  do {
+    char c = n % base;
+    n /= base;
+    *--str = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+  return write(str);
+}
+
+size_t Print::printFloat(double number, uint8_t digits)
+{
+  size_t n = 0;
+  if (isnan(number)) return print("nan");
+  if (isinf(number)) return print("inf");
+  if (number > 4294967040.0) return print("ovf");
+  if (number < -4294967040.0) return print("-ovf");
+
+  if (number < 0.0) {
+    n += print('-');
+    number = -number;
+  }
+
+  // Round correctly so that print(1.999, 2) prints as "2.00"
+  double rounding = 0.5;
+  for (uint8_t i = 0; i < digits; ++i) {
+    rounding /= 10.0;
+  }
+  number += rounding;
+
+  unsigned long intPart = (unsigned long)number;
+  double remainder = number - (double)intPart;
+  n += print(intPart);
+
+  if (digits > 0) {
+    n += print(".");
+  }
+  while (digits-- > 0) {
+    remainder *= 10.0;
+    unsigned int toPrint = (unsigned int)remainder;
+    n += print(toPrint);
+    remainder -= toPrint;
+  }
+  return n;
+}
@@ -0,0 +1,26 @@
+// Host copy of Arduino's Stream (reads stop at the end of the data, no timeout).
+#include <Stream.h>
+
+size_t Stream::readBytes(uint8_t* buffer, size_t length)
+{
+  size_t count = 0;
+  while (count < length) {
+    int c = read();
+    if (c < 0) {
+      break;
+    }
+    buffer[count++] = (uint8_t)c;
+  }
+  return count;
+}
+
+String Stream::readStringUntil(char terminator)
+{
+  String ret;
+  int c = read();
+  while (c >= 0 && c != terminator) {
+    ret += (char)c;
+    c = read();
+  }
+  return ret;
+}
@@ -0,0 +1,316 @@
+// Host copy of Arduino's String (see WString.h).
+#include <WString.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Formats an integer in the given base into buf (at least 66 bytes).
+static const char* formatInteger(char* buf, unsigned long long value, bool negative, unsigned char base)
+{
+  if (base < 2 || base > 36) {
+    base = 10;
+  }
+  char* p = buf + 65;
+  *p = '\0';
+  do {
+    unsigned digit = (unsigned)(value % base);
+    *--p = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+    value /= base;
+  } while (value != 0);
+  if (negative) {
+    *--p = '-';
+  }
+  return p;
+}
+
+#define STRING_INIT buffer(NULL), capacity(SSO_CAPACITY), len(0), sso{0}
+
+String::String(const char* cstr) : STRING_INIT
+{
+  if (cstr != NULL) copy(cstr, strlen(cstr));
+}
+
+String::String(const char* cstr, unsigned int length) : STRING_INIT
+{
+  if (cstr != NULL) copy(cstr, length);
+}
+
+String::String(const String& str) : STRING_INIT
+{
+  *this = str;
+}
+
+String::String(String&& str) noexcept : STRING_INIT
+{
+  *this = static_cast<String&&>(str);
+}
+
+String::String(char c) : STRING_INIT
+{
+  copy(&c, 1);
+}
+
+#define STRING_FROM_INTEGER(type, unsignedType)                                        \
+  String::String(type value, unsigned char base) : STRING_INIT                         \
+  {                                                                                    \
+    char buf[66];                                                                      \
+    bool negative = base == 10 && value < 0;                                           \
+    unsigned long long magnitude = negative ? 0ULL - (unsigned long long)value         \
+                                            : (unsigned long long)(unsignedType)value; \
+    *this = formatInteger(buf, magnitude, negative, base);                             \
+  }
+
+STRING_FROM_INTEGER(unsigned char, unsigned char)
+STRING_FROM_INTEGER(int, unsigned int)
+STRING_FROM_INTEGER(unsigned int, unsigned int)
+STRING_FROM_INTEGER(long, unsigned long)
+STRING_FROM_INTEGER(unsigned long, unsigned long)
+STRING_FROM_INTEGER(long long, unsigned long long)
+STRING_FROM_INTEGER(unsigned long long, unsigned long long)
+#undef STRING_FROM_INTEGER
+
+String::String(float value, unsigned int decimalPlaces) : String((double)value, decimalPlaces)
+{
+}
+
+String::String(double value, unsigned int decimalPlaces) : STRING_INIT
+{
+  char buf[330];
+  snprintf(buf, sizeof(buf), "%.*f", (int)decimalPlaces, value);
+  *this = buf;
+}
+
+String::~String()
+{
+  free(buffer);
+}
+
+void String::invalidate()
+{
+  free(buffer);
+  buffer = NULL;
+  capacity = SSO_CAPACITY;
+  len = 0;
+  sso[0] = '\0';
+}
+
+bool String::reserve(unsigned int size)
+{
+  if (size <= capacity) {
+    return true;
+  }
+  char* grown = (char*)realloc(buffer, size + 1);
+  if (grown == NULL) {
+    return false;
+  }
+  if (buffer == NULL) {
+    memcpy(grown, sso, len + 1);   // leaving the inline storage
+  }
+  buffer = grown;
+  capacity = size;
+  return true;
+}
+
+bool String::copy(const char* cstr, unsigned int length)
+{
+  if (!reserve(length)) {
+    invalidate();
+    return false;
+  }
+  char* d = data();
+  memmove(d, cstr, length);
+  d[length] = '\0';
+  len = length;
+  return true;
+}
+
+String& String::operator=(const String& rhs)
+{
+  if (this != &rhs) {
+    copy(rhs.data(), rhs.len);
+  }
+  return *this;
+}
+
+String& String::operator=(String&& rhs) noexcept
+{
+  if (this == &rhs) {
+    return *this;
+  }
+  if (rhs.buffer != NULL) {
+    free(buffer);
+    buffer = rhs.buffer;
+    capacity = rhs.capacity;
+    len = rhs.len;
+    rhs.buffer = NULL;
+    rhs.capacity = SSO_CAPACITY;
+    rhs.len = 0;
+    rhs.sso[0] = '\0';
+  } else {
+    copy(rhs.sso, rhs.len);
+  }
+  return *this;
+}
+
+String& String::operator=(const char* cstr)
+{
+  if (cstr != NULL) {
+    copy(cstr, strlen(cstr));
+  } else {
+    invalidate();
+  }
+  return *this;
+}
+
+bool String::concat(const char* cstr, unsigned int length)
+{
+  if (cstr == NULL) {
+    return false;
+  }
+  if (length == 0) {
+    return true;
+  }
+  unsigned int newLen = len + length;
+  const char* old = data();
+  if (cstr >= old && cstr < old + len) {
+    // Appending (part of) itself; the buffer may move.
+    size_t offset = cstr - old;
+    if (!reserve(newLen)) return false;
+    cstr = data() + offset;
+  } else if (!reserve(newLen)) {
+    return false;
+  }
+  char* d = data();
+  memmove(d + len, cstr, length);
+  len = newLen;
+  d[len] = '\0';
+  return true;
+}
+
+bool String::concat(const char* cstr)
+{
+  return cstr != NULL && concat(cstr, strlen(cstr));
+}
+
+String operator+(const String& lhs, const String& rhs)
+{
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, const char* rhs)
+{
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const char* lhs, const String& rhs)
+{
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, char rhs)
+{
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+int String::compareTo(const String& s) const
+{
+  return strcmp(data(), s.data());
+}
+
+bool String::equals(const String& s) const
+{
+  return len == s.len && compareTo(s) == 0;
+}
+
+bool String::equals(const char* cstr) const
+{
+  return strcmp(data(), cstr != NULL ? cstr : "") == 0;
+}
+
+bool String::startsWith(const String& prefix) const
+{
+  return len >= prefix.len && strncmp(data(), prefix.data(), prefix.len) == 0;
+}
+
+bool String::endsWith(const String& suffix) const
+{
+  return len >= suffix.len && strcmp(data() + len - suffix.len, suffix.data()) == 0;
+}
+
+int String::indexOf(char c, unsigned int fromIndex) const
+{
+  if (fromIndex >= len) return -1;
+  const char* found = strchr(data() + fromIndex, c);
+  return found != NULL ? (int)(found - data()) : -1;
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const
+{
+  if (fromIndex >= len) return -1;
+  const char* found = strstr(data() + fromIndex, str.data());
+  return found != NULL ? (int)(found - data()) : -1;
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const
+{
+  if (beginIndex > endIndex) {
+    unsigned int temp = endIndex;
+    endIndex = beginIndex;
+    beginIndex = temp;
+  }
+  if (beginIndex >= len) return String();
+  if (endIndex > len) endIndex = len;
+  return String(data() + beginIndex, endIndex - beginIndex);
+}
+
+void String::remove(unsigned int index)
+{
+  remove(index, (unsigned int)-1);
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+  if (index >= len || count == 0) return;
+  if (count > len - index) count = len - index;
+  char* d = data();
+  memmove(d + index, d + index + count, len - index - count);
+  len -= count;
+  d[len] = '\0';
+}
+
+void String::trim()
+{
+  if (len == 0) return;
+  char* d = data();
+  char* begin = d;
+  while (isspace((unsigned char)*begin)) begin++;
+  char* end = d + len - 1;
+  while (end >= begin && isspace((unsigned char)*end)) end--;
+  len = end + 1 - begin;
+  if (begin > d) memmove(d, begin, len);
+  d[len] = '\0';
+}
+
+long String::toInt() const
+{
+  return atol(data());
+}
+
+float String::toFloat() const
+{
+  return (float)toDouble();
+}
+
+double String::toDouble() const
+{
+  return atof(data());
+}
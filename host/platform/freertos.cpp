@@ -0,0 +1,799 @@
+// FreeRTOS on POSIX threads, see freertos/FreeRTOS.h.
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "host_clock.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+
+// Host stacks are much larger than the configured depth: host code (and the
+// sanitizers) need more, and the high-water mark is measured against the configured
+// depth at the top of the stack.
+#define HOST_STACK_BYTES  (1024 * 1024)
+#define STACK_PAINT       0xA5
+#define MAX_TASKS         48
+
+// Arduino-ESP32 runs setup() and loop() in this task.
+#define LOOP_TASK_NAME    "loopTask"
+#define LOOP_TASK_DEPTH   8192
+#define LOOP_TASK_CORE    1
+
+using Clock = std::chrono::steady_clock;
+
+struct tskTaskControlBlock {
+  TaskFunction_t code;
+  void* param;
+  char name[configMAX_TASK_NAME_LEN];
+  UBaseType_t priority;
+  std::atomic<UBaseType_t> number;
+  BaseType_t core;
+  bool dynamic;                 ///< TCB allocated by xTaskCreate*.
+  uint32_t depth;               ///< Configured stack depth in bytes.
+  uint8_t* stackTop;            ///< Host stack end (NULL: not measured).
+  clockid_t cpuClock;
+  std::atomic<int> state;       ///< eTaskState.
+
+  std::mutex lock;              ///< Guards the fields below.
+  std::condition_variable wake;
+  uint32_t notifyValue;
+  bool notifyPending;
+  bool suspended;
+  bool deleteRequested;
+};
+static_assert(sizeof(tskTaskControlBlock) <= sizeof(StaticTask_t), "StaticTask_t too small");
+
+struct QueueDefinition {
+  std::mutex lock;
+  std::condition_variable notEmpty;
+  std::condition_variable notFull;
+  uint8_t* storage;             ///< length * itemSize bytes; NULL for semaphores.
+  UBaseType_t length;
+  UBaseType_t itemSize;
+  UBaseType_t count;
+  UBaseType_t head;
+  bool dynamic;
+};
+static_assert(sizeof(QueueDefinition) <= sizeof(StaticQueue_t), "StaticQueue_t too small");
+
+static std::mutex registryLock;
+static tskTaskControlBlock* registry[MAX_TASKS];
+static UBaseType_t registryCount = 0;
+
+static thread_local tskTaskControlBlock* currentTask = nullptr;
+static thread_local uint32_t threadId = 0;
+static std::atomic<uint32_t> nextThreadId{1};
+
+static StaticTask_t loopTaskStorage;
+
+Clock::time_point hostStartTime()
+{
+  static const Clock::time_point start = Clock::now();
+  return start;
+}
+
+//------------------
+// Task registry
+//------------------
+static void registerTask(tskTaskControlBlock* task)
+{
+  std::lock_guard<std::mutex> guard(registryLock);
+  if (registryCount == MAX_TASKS) {
+    fprintf(stderr, "FreeRTOS host: more than %d tasks\n", MAX_TASKS);
+    abort();
+  }
+  registry[registryCount++] = task;
+}
+
+static void unregisterTask(tskTaskControlBlock* task)
+{
+  std::lock_guard<std::mutex> guard(registryLock);
+  for (UBaseType_t i = 0; i < registryCount; i++) {
+    if (registry[i] == task) {
+      registry[i] = registry[--registryCount];
+      break;
+    }
+  }
+}
+
+static tskTaskControlBlock* newTcb(void* storage, TaskFunction_t code, const char* name, uint32_t depth,
+                                   void* param, UBaseType_t priority, BaseType_t core)
+{
+  tskTaskControlBlock* task = new (storage) tskTaskControlBlock();
+  task->code = code;
+  task->param = param;
+  strncpy(task->name, name != NULL ? name : "", configMAX_TASK_NAME_LEN - 1);
+  task->name[configMAX_TASK_NAME_LEN - 1] = '\0';
+  task->priority = priority;
+  task->number = 0;
+  task->core = core;
+  task->dynamic = false;
+  task->depth = depth;
+  task->stackTop = NULL;
+  task->state = eReady;
+  task->notifyValue = 0;
+  task->notifyPending = false;
+  task->suspended = false;
+  task->deleteRequested = false;
+  return task;
+}
+
+// The thread that runs main() is the loop task.
+__attribute__((constructor(101))) static void attachLoopTask()
+{
+  hostStartTime();
+  tskTaskControlBlock* task = newTcb(&loopTaskStorage, NULL, LOOP_TASK_NAME, LOOP_TASK_DEPTH, NULL, 1, LOOP_TASK_CORE);
+  pthread_getcpuclockid(pthread_self(), &task->cpuClock);
+  task->state = eRunning;
+  currentTask = task;
+  registerTask(task);
+}
+
+static uint32_t currentThreadId()
+{
+  if (threadId == 0) {
+    threadId = nextThreadId.fetch_add(1);
+  }
+  return threadId;
+}
+
+//------------------
+// Blocking
+//------------------
+static Clock::time_point tickTime(TickType_t tick)
+{
+  return hostStartTime() + std::chrono::milliseconds(tick);
+}
+
+// Waits on cv until ready() or the timeout; returns ready().
+template <typename Ready>
+static bool waitFor(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, TickType_t timeout, Ready ready)
+{
+  if (ready() || timeout == 0) {
+    return ready();
+  }
+  tskTaskControlBlock* self = currentTask;
+  if (self != nullptr) self->state = eBlocked;
+  bool result;
+  if (timeout == portMAX_DELAY) {
+    cv.wait(lock, ready);
+    result = true;
+  } else {
+    result = cv.wait_until(lock, Clock::now() + std::chrono::milliseconds(timeout), ready);
+  }
+  if (self != nullptr) self->state = eRunning;
+  return result;
+}
+
+// Called after every blocking call: parks the task while it is suspended and
+// ends it if it was deleted.
+static void checkpoint()
+{
+  tskTaskControlBlock* self = currentTask;
+  if (self == nullptr) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(self->lock);
+  while (self->suspended && !self->deleteRequested) {
+    self->state = eSuspended;
+    self->wake.wait(lock);
+  }
+  self->state = eRunning;
+  if (self->deleteRequested) {
+    lock.unlock();
+    vTaskDelete(NULL);
+  }
+}
+
+//------------------
+// Critical sections
+//------------------
+void vPortEnterCritical(portMUX_TYPE* mux)
+{
+  uint32_t self = currentThreadId();
+  if (__atomic_load_n(&mux->owner, __ATOMIC_RELAXED) == self) {
+    mux->count++;
+    return;
+  }
+  uint32_t expected = 0;
+  int spins = 0;
+  while (!__atomic_compare_exchange_n(&mux->owner, &expected, self, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+    expected = 0;
+    if (++spins > 100) {
+      sched_yield();
+    }
+  }
+  mux->count = 1;
+}
+
+void vPortExitCritical(portMUX_TYPE* mux)
+{
+  if (--mux->count == 0) {
+    __atomic_store_n(&mux->owner, 0, __ATOMIC_RELEASE);
+  }
+}
+
+void vPortYield(void)
+{
+  sched_yield();
+}
+
+//------------------
+// Tasks
+//------------------
+static void* taskEntry(void* arg)
+{
+  tskTaskControlBlock* task = (tskTaskControlBlock*)arg;
+  currentTask = task;
+  pthread_setname_np(pthread_self(), task->name);
+  task->state = eRunning;
+  task->code(task->param);
+  fprintf(stderr, "FreeRTOS host: task %s returned\n", task->name);
+  abort();
+}
+
+static tskTaskControlBlock* startTask(tskTaskControlBlock* task)
+{
+  // Own stack, so the high-water mark can be read from the painted top.
+  long page = sysconf(_SC_PAGESIZE);
+  size_t size = HOST_STACK_BYTES;
+  uint8_t* mapping = (uint8_t*)mmap(NULL, size + page, PROT_READ | PROT_WRITE,
+                                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+  if (mapping == MAP_FAILED) {
+    perror("FreeRTOS host: task stack");
+    abort();
+  }
+  mprotect(mapping, page, PROT_NONE);   // guard page
+  uint8_t* stack = mapping + page;
+  task->stackTop = stack + size;
+  size_t painted = task->depth < size ? task->depth : size;
+  memset(task->stackTop - painted, STACK_PAINT, painted);
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstack(&attr, stack, size);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  pthread_t thread;
+  int rc = pthread_create(&thread, &attr, taskEntry, task);
+  pthread_attr_destroy(&attr);
+  if (rc != 0) {
+    fprintf(stderr, "FreeRTOS host: cannot start task %s: %s\n", task->name, strerror(rc));
+    abort();
+  }
+  pthread_getcpuclockid(thread, &task->cpuClock);
+  registerTask(task);
+  return task;
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                                           void* param, UBaseType_t priority, StackType_t* stack,
+                                           StaticTask_t* tcb, BaseType_t core)
+{
+  (void)stack;   // too small for host code, see HOST_STACK_BYTES
+  if (tcb == NULL) {
+    return NULL;
+  }
+  return startTask(newTcb(tcb, code, name, stackDepth, param, priority, core));
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t code, const char* name, uint32_t stackDepth, void* param,
+                               UBaseType_t priority, StackType_t* stack, StaticTask_t* tcb)
+{
+  return xTaskCreateStaticPinnedToCore(code, name, stackDepth, param, priority, stack, tcb, tskNO_AFFINITY);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* created,
+                                   BaseType_t core)
+{
+  void* storage = malloc(sizeof(StaticTask_t));
+  if (storage == NULL) {
+    return pdFAIL;
+  }
+  tskTaskControlBlock* task = newTcb(storage, code, name, stackDepth, param, priority, core);
+  task->dynamic = true;
+  startTask(task);
+  if (created != NULL) {
+    *created = task;
+  }
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* created)
+{
+  return xTaskCreatePinnedToCore(code, name, stackDepth, param, priority, created, tskNO_AFFINITY);
+}
+
+// The TCB and stack of a deleted task are not reclaimed; tasks of the firmware
+// never end.
+void vTaskDelete(TaskHandle_t task)
+{
+  if (task == NULL || task == currentTask) {
+    tskTaskControlBlock* self = currentTask;
+    if (self == nullptr) {
+      return;
+    }
+    self->state = eDeleted;
+    unregisterTask(self);
+    pthread_exit(NULL);
+  }
+  std::lock_guard<std::mutex> guard(task->lock);
+  task->deleteRequested = true;
+  task->wake.notify_all();
+}
+
+void vTaskSuspend(TaskHandle_t task)
+{
+  if (task == NULL) {
+    task = currentTask;
+    if (task == nullptr) {
+      return;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> guard(task->lock);
+    task->suspended = true;
+  }
+  if (task == currentTask) {
+    checkpoint();
+  }
+}
+
+void vTaskResume(TaskHandle_t task)
+{
+  if (task == NULL) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(task->lock);
+  task->suspended = false;
+  task->wake.notify_all();
+}
+
+//------------------
+// Time
+//------------------
+TickType_t xTaskGetTickCount(void)
+{
+  return (TickType_t)(hostNanos() / 1000000u);
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+  return xTaskGetTickCount();
+}
+
+static void sleepUntil(TickType_t tick)
+{
+  tskTaskControlBlock* self = currentTask;
+  if (self != nullptr) self->state = eBlocked;
+  Clock::time_point until = tickTime(tick);
+  struct timespec ts;
+  std::chrono::nanoseconds since = until.time_since_epoch();
+  ts.tv_sec = (time_t)(since.count() / 1000000000);
+  ts.tv_nsec = (long)(since.count() % 1000000000);
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+  }
+  if (self != nullptr) self->state = eRunning;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+  if (ticks == 0) {
+    sched_yield();
+  } else {
+    sleepUntil(xTaskGetTickCount() + ticks);
+  }
+  checkpoint();
+}
+
+BaseType_t xTaskDelayUntil(TickType_t* previousWake, TickType_t increment)
+{
+  TickType_t wake = *previousWake + increment;
+  TickType_t now = xTaskGetTickCount();
+  // Not yet due if the wake time lies in the window (previous, previous + increment].
+  bool due = (TickType_t)(now - *previousWake) >= increment;
+  *previousWake = wake;
+  if (!due) {
+    sleepUntil(wake);
+  }
+  checkpoint();
+  return due ? pdFALSE : pdTRUE;
+}
+
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t increment)
+{
+  xTaskDelayUntil(previousWake, increment);
+}
+
+//------------------
+// Notifications
+//------------------
+static bool notify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+  if (task == NULL) {
+    return false;
+  }
+  std::lock_guard<std::mutex> guard(task->lock);
+  switch (action) {
+    case eNoAction: break;
+    case eSetBits: task->notifyValue |= value; break;
+    case eIncrement: task->notifyValue++; break;
+    case eSetValueWithOverwrite: task->notifyValue = value; break;
+    case eSetValueWithoutOverwrite:
+      if (task->notifyPending) {
+        return false;
+      }
+      task->notifyValue = value;
+      break;
+  }
+  task->notifyPending = true;
+  task->wake.notify_all();
+  return true;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+  return notify(task, value, action) ? pdPASS : pdFAIL;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t* woken)
+{
+  bool sent = notify(task, value, action);
+  if (woken != NULL && sent) *woken = pdTRUE;
+  return sent ? pdPASS : pdFAIL;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+  notify(task, 0, eIncrement);
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken)
+{
+  notify(task, 0, eIncrement);
+  if (woken != NULL) *woken = pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t timeout)
+{
+  tskTaskControlBlock* self = currentTask;
+  if (self == nullptr) {
+    return 0;
+  }
+  uint32_t value;
+  {
+    std::unique_lock<std::mutex> lock(self->lock);
+    waitFor(lock, self->wake, timeout, [self] { return self->notifyValue != 0 || self->deleteRequested; });
+    value = self->notifyValue;
+    if (value != 0) {
+      self->notifyValue = clearOnExit ? 0 : value - 1;
+    }
+    self->notifyPending = false;
+  }
+  checkpoint();
+  return value;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t* value, TickType_t timeout)
+{
+  tskTaskControlBlock* self = currentTask;
+  if (self == nullptr) {
+    return pdFALSE;
+  }
+  bool received;
+  {
+    std::unique_lock<std::mutex> lock(self->lock);
+    if (!self->notifyPending) {
+      self->notifyValue &= ~clearOnEntry;
+    }
+    received = waitFor(lock, self->wake, timeout, [self] { return self->notifyPending || self->deleteRequested; })
+               && self->notifyPending;
+    if (value != NULL) {
+      *value = self->notifyValue;
+    }
+    if (received) {
+      self->notifyValue &= ~clearOnExit;
+      self->notifyPending = false;
+    }
+  }
+  checkpoint();
+  return received ? pdTRUE : pdFALSE;
+}
+
+//------------------
+// Task information
+//------------------
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+  return currentTask;
+}
+
+const char* pcTaskGetName(TaskHandle_t task)
+{
+  if (task == NULL) task = currentTask;
+  return task != NULL ? task->name : "";
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task)
+{
+  if (task == NULL) task = currentTask;
+  return task != NULL ? task->priority : 0;
+}
+
+UBaseType_t uxTaskGetTaskNumber(TaskHandle_t task)
+{
+  return task != NULL ? task->number.load(std::memory_order_relaxed) : 0;
+}
+
+void vTaskSetTaskNumber(TaskHandle_t task, UBaseType_t number)
+{
+  if (task != NULL) {
+    task->number.store(number, std::memory_order_relaxed);
+  }
+}
+
+// Bytes of the configured depth, at the top of the host stack, never written.
+static uint32_t stackHighWaterMark(const tskTaskControlBlock* task)
+{
+  if (task->stackTop == NULL) {
+    return task->depth;   // the loop task's stack is not painted
+  }
+  const uint8_t* p = task->stackTop - task->depth;
+  uint32_t unused = 0;
+  while (unused < task->depth && p[unused] == STACK_PAINT) {
+    unused++;
+  }
+  return unused;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+  if (task == NULL) task = currentTask;
+  return task != NULL ? stackHighWaterMark(task) : 0;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks(void)
+{
+  std::lock_guard<std::mutex> guard(registryLock);
+  return registryCount;
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t* status, UBaseType_t size, uint32_t* totalRunTime)
+{
+  std::lock_guard<std::mutex> guard(registryLock);
+  if (size < registryCount) {
+    return 0;   // like FreeRTOS: the array must hold every task
+  }
+  for (UBaseType_t i = 0; i < registryCount; i++) {
+    tskTaskControlBlock* task = registry[i];
+    struct timespec cpu = {0, 0};
+    clock_gettime(task->cpuClock, &cpu);
+    TaskStatus_t& s = status[i];
+    s.xHandle = task;
+    s.pcTaskName = task->name;
+    s.xTaskNumber = task->number.load(std::memory_order_relaxed);
+    s.eCurrentState = (task == currentTask) ? eRunning : (eTaskState)task->state.load();
+    s.uxCurrentPriority = task->priority;
+    s.uxBasePriority = task->priority;
+    s.ulRunTimeCounter = (uint32_t)((uint64_t)cpu.tv_sec * 1000000u + cpu.tv_nsec / 1000);
+    s.pxStackBase = task->stackTop != NULL ? task->stackTop - task->depth : NULL;
+    s.usStackHighWaterMark = stackHighWaterMark(task);
+    s.xCoreID = task->core;
+  }
+  if (totalRunTime != NULL) {
+    *totalRunTime = (uint32_t)(hostNanos() / 1000u);
+  }
+  return registryCount;
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+  tskTaskControlBlock* self = currentTask;
+  return (self != nullptr && self->core >= 0 && self->core < portNUM_PROCESSORS) ? self->core : 0;
+}
+
+//------------------
+// Queues
+//------------------
+static QueueDefinition* newQueue(void* storage, UBaseType_t length, UBaseType_t itemSize, uint8_t* items)
+{
+  QueueDefinition* queue = new (storage) QueueDefinition();
+  queue->storage = items;
+  queue->length = length;
+  queue->itemSize = itemSize;
+  queue->count = 0;
+  queue->head = 0;
+  queue->dynamic = false;
+  return queue;
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize, uint8_t* storage, StaticQueue_t* queue)
+{
+  if (queue == NULL || length == 0 || (itemSize > 0 && storage == NULL)) {
+    return NULL;
+  }
+  return newQueue(queue, length, itemSize, itemSize > 0 ? storage : NULL);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+  if (length == 0) {
+    return NULL;
+  }
+  // One block, as in FreeRTOS.
+  uint8_t* block = (uint8_t*)malloc(sizeof(StaticQueue_t) + (size_t)length * itemSize);
+  if (block == NULL) {
+    return NULL;
+  }
+  QueueDefinition* queue = newQueue(block, length, itemSize, itemSize > 0 ? block + sizeof(StaticQueue_t) : NULL);
+  queue->dynamic = true;
+  return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+  if (queue == NULL) {
+    return;
+  }
+  bool dynamic = queue->dynamic;
+  queue->~QueueDefinition();
+  if (dynamic) {
+    free(queue);
+  }
+}
+
+static uint8_t* slot(QueueHandle_t queue, UBaseType_t index)
+{
+  return queue->storage + (size_t)(index % queue->length) * queue->itemSize;
+}
+
+static BaseType_t send(QueueHandle_t queue, const void* item, TickType_t timeout, bool front)
+{
+  if (queue == NULL) {
+    return pdFAIL;
+  }
+  bool sent;
+  {
+    std::unique_lock<std::mutex> lock(queue->lock);
+    sent = waitFor(lock, queue->notFull, timeout, [queue] { return queue->count < queue->length; });
+    if (sent) {
+      if (front) {
+        queue->head = (queue->head + queue->length - 1) % queue->length;
+      }
+      if (queue->itemSize > 0) {
+        memcpy(front ? slot(queue, queue->head) : slot(queue, queue->head + queue->count), item, queue->itemSize);
+      }
+      queue->count++;
+      queue->notEmpty.notify_one();
+    }
+  }
+  if (timeout != 0) {
+    checkpoint();
+  }
+  return sent ? pdPASS : errQUEUE_FULL;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t timeout)
+{
+  return send(queue, item, timeout, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item, TickType_t timeout)
+{
+  return send(queue, item, timeout, true);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* woken)
+{
+  BaseType_t sent = send(queue, item, 0, false);
+  if (woken != NULL && sent == pdPASS) *woken = pdTRUE;
+  return sent;
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item)
+{
+  if (queue == NULL) {
+    return pdFAIL;
+  }
+  std::lock_guard<std::mutex> guard(queue->lock);
+  if (queue->itemSize > 0) {
+    memcpy(slot(queue, queue->head), item, queue->itemSize);
+  }
+  queue->count = 1;
+  queue->notEmpty.notify_one();
+  return pdPASS;
+}
+
+static BaseType_t receive(QueueHandle_t queue, void* item, TickType_t timeout, bool remove)
+{
+  if (queue == NULL) {
+    return pdFAIL;
+  }
+  bool received;
+  {
+    std::unique_lock<std::mutex> lock(queue->lock);
+    received = waitFor(lock, queue->notEmpty, timeout, [queue] { return queue->count > 0; });
+    if (received) {
+      if (queue->itemSize > 0 && item != NULL) {
+        memcpy(item, slot(queue, queue->head), queue->itemSize);
+      }
+      if (remove) {
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        queue->notFull.notify_one();
+      } else {
+        queue->notEmpty.notify_one();   // pass the wake-up on to the next reader
+      }
+    }
+  }
+  if (timeout != 0) {
+    checkpoint();
+  }
+  return received ? pdPASS : errQUEUE_EMPTY;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t timeout)
+{
+  return receive(queue, item, timeout, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t timeout)
+{
+  return receive(queue, item, timeout, false);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+  std::lock_guard<std::mutex> guard(queue->lock);
+  return queue->count;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+  std::lock_guard<std::mutex> guard(queue->lock);
+  queue->count = 0;
+  queue->head = 0;
+  queue->notFull.notify_all();
+  return pdPASS;
+}
+
+//------------------
+// Semaphores
+//------------------
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t* semaphore)
+{
+  return xQueueCreateStatic(1, 0, NULL, semaphore);   // created empty
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+  return xQueueCreate(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* semaphore)
+{
+  SemaphoreHandle_t mutex = xQueueCreateStatic(1, 0, NULL, semaphore);
+  if (mutex != NULL) mutex->count = 1;   // created available
+  return mutex;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+  SemaphoreHandle_t mutex = xQueueCreate(1, 0);
+  if (mutex != NULL) mutex->count = 1;
+  return mutex;
+}
@@ -0,0 +1,160 @@
+// Host heap: counts live bytes for the heap_caps statistics and calls the IDF heap
+// hooks (esp_heap_trace_alloc_hook / esp_heap_trace_free_hook), as the board's heap
+// does with CONFIG_HEAP_USE_HOOKS.
+//
+// malloc, calloc, realloc and free are wrapped at link time (-Wl,--wrap=...), and
+// operator new/delete are replaced to go through them, so allocations of the
+// firmware, the host shims and the C++ library are all seen. Memory the C library
+// allocates internally is not.
+#include <esp_heap_caps.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <new>
+
+#define DEFAULT_HEAP_BYTES (320 * 1024)
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+// Defaults for a build without the firmware's AllocCounter hooks.
+__attribute__((weak)) void esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps)
+{
+  (void)ptr;
+  (void)size;
+  (void)caps;
+}
+
+__attribute__((weak)) void esp_heap_trace_free_hook(void* ptr)
+{
+  (void)ptr;
+}
+}
+
+static int64_t liveBytes = 0;
+static int64_t peakBytes = 0;
+
+static int64_t heapBytes()
+{
+  static int64_t bytes = 0;
+  if (bytes == 0) {
+    const char* env = getenv("FIRMWARE_HEAP_BYTES");
+    int64_t value = env != NULL ? atoll(env) : 0;
+    bytes = value > 0 ? value : DEFAULT_HEAP_BYTES;
+  }
+  return bytes;
+}
+
+static void noteAlloc(void* ptr, size_t size)
+{
+  int64_t live = __atomic_add_fetch(&liveBytes, (int64_t)malloc_usable_size(ptr), __ATOMIC_RELAXED);
+  int64_t peak = __atomic_load_n(&peakBytes, __ATOMIC_RELAXED);
+  while (live > peak && !__atomic_compare_exchange_n(&peakBytes, &peak, live, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+  esp_heap_trace_alloc_hook(ptr, size, MALLOC_CAP_DEFAULT | MALLOC_CAP_8BIT);
+}
+
+static void noteFree(void* ptr)
+{
+  __atomic_sub_fetch(&liveBytes, (int64_t)malloc_usable_size(ptr), __ATOMIC_RELAXED);
+  esp_heap_trace_free_hook(ptr);
+}
+
+extern "C" void __wrap_free(void* ptr);
+
+extern "C" void* __wrap_malloc(size_t size)
+{
+  void* ptr = __real_malloc(size);
+  if (ptr != NULL) noteAlloc(ptr, size);
+  return ptr;
+}
+
+extern "C" void* __wrap_calloc(size_t count, size_t size)
+{
+  void* ptr = __real_calloc(count, size);
+  if (ptr != NULL) noteAlloc(ptr, count * size);
+  return ptr;
+}
+
+extern "C" void* __wrap_realloc(void* ptr, size_t size)
+{
+  if (ptr == NULL) {
+    return __wrap_malloc(size);
+  }
+  if (size == 0) {
+    __wrap_free(ptr);   // glibc's realloc(ptr, 0)
+    return NULL;
+  }
+  size_t before = malloc_usable_size(ptr);
+  void* moved = __real_realloc(ptr, size);
+  if (moved == NULL) {
+    return NULL;   // the block is unchanged
+  }
+  __atomic_sub_fetch(&liveBytes, (int64_t)before, __ATOMIC_RELAXED);
+  esp_heap_trace_free_hook(ptr);
+  noteAlloc(moved, size);
+  return moved;
+}
+
+extern "C" void __wrap_free(void* ptr)
+{
+  if (ptr == NULL) {
+    return;
+  }
+  noteFree(ptr);
+  __real_free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+  (void)caps;
+  int64_t free = heapBytes() - __atomic_load_n(&liveBytes, __ATOMIC_RELAXED);
+  return free > 0 ? (size_t)free : 0;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+  (void)caps;
+  int64_t free = heapBytes() - __atomic_load_n(&peakBytes, __ATOMIC_RELAXED);
+  return free > 0 ? (size_t)free : 0;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+  return heap_caps_get_free_size(caps);
+}
+
+//------------------
+// operator new / delete
+//------------------
+void* operator new(size_t size)
+{
+  void* ptr = malloc(size != 0 ? size : 1);
+  if (ptr == NULL) throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+  return malloc(size != 0 ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+  return malloc(size != 0 ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { free(ptr); }
@@ -0,0 +1,22 @@
+/**
+ * @file host_clock.h
+ * @brief Time base shared by the host platform (not part of the board API).
+ */
+
+#ifndef HOST_CLOCK_H
+#define HOST_CLOCK_H
+
+#include <stdint.h>
+#include <chrono>
+
+/// @brief Program start; tick 0, millis() 0 and micros() 0.
+std::chrono::steady_clock::time_point hostStartTime();
+
+/// @brief Nanoseconds since program start.
+inline uint64_t hostNanos()
+{
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - hostStartTime()).count();
+}
+
+#endif // HOST_CLOCK_H
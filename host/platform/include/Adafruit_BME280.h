@@ -0,0 +1,61 @@
+/**
+ * @file Adafruit_BME280.h
+ * @brief Host stand-in for the BME280 driver: 22 °C, 1013.25 hPa, 40 % relative humidity.
+ */
+
+#ifndef HOST_ADAFRUIT_BME280_H
+#define HOST_ADAFRUIT_BME280_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+/**
+ * @brief Temperature, pressure and humidity sensor.
+ */
+class Adafruit_BME280 {
+public:
+  enum sensor_sampling {
+    SAMPLING_NONE = 0b000,
+    SAMPLING_X1 = 0b001,
+    SAMPLING_X2 = 0b010,
+    SAMPLING_X4 = 0b011,
+    SAMPLING_X8 = 0b100,
+    SAMPLING_X16 = 0b101
+  };
+  enum sensor_mode {
+    MODE_SLEEP = 0b00,
+    MODE_FORCED = 0b01,
+    MODE_NORMAL = 0b11
+  };
+  enum sensor_filter {
+    FILTER_OFF = 0b000,
+    FILTER_X2 = 0b001,
+    FILTER_X4 = 0b010,
+    FILTER_X8 = 0b011,
+    FILTER_X16 = 0b100
+  };
+  enum standby_duration {
+    STANDBY_MS_0_5 = 0b000,
+    STANDBY_MS_10 = 0b110,
+    STANDBY_MS_20 = 0b111,
+    STANDBY_MS_62_5 = 0b001,
+    STANDBY_MS_125 = 0b010,
+    STANDBY_MS_250 = 0b011,
+    STANDBY_MS_500 = 0b100,
+    STANDBY_MS_1000 = 0b101
+  };
+
+  bool begin(uint8_t addr = 0x77, TwoWire* wire = &Wire) { (void)addr; (void)wire; return true; }
+  void setSampling(sensor_mode mode = MODE_NORMAL, sensor_sampling tempSampling = SAMPLING_X16,
+                   sensor_sampling pressSampling = SAMPLING_X16, sensor_sampling humSampling = SAMPLING_X16,
+                   sensor_filter filter = FILTER_OFF, standby_duration duration = STANDBY_MS_0_5)
+  {
+    (void)mode; (void)tempSampling; (void)pressSampling; (void)humSampling; (void)filter; (void)duration;
+  }
+
+  float readTemperature() { return 22.0f; }   ///< °C
+  float readPressure() { return 101325.0f; }  ///< Pa
+  float readHumidity() { return 40.0f; }      ///< %
+};
+
+#endif // HOST_ADAFRUIT_BME280_H
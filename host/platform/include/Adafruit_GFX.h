@@ -0,0 +1,84 @@
+/**
+ * @file Adafruit_GFX.h
+ * @brief Host copy of the Adafruit_GFX drawing core (the parts the firmware uses).
+ *
+ * Same algorithms and text semantics as the library: primitives end in writePixel()
+ * or the fast line calls a display overrides, text uses the classic 6x8 cell. The
+ * host font holds the printable ASCII glyphs; other codes draw an empty box.
+ */
+
+#ifndef HOST_ADAFRUIT_GFX_H
+#define HOST_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Base class of the displays: drawing primitives and text.
+ */
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t w, int16_t h);
+
+  // Implemented by the display.
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  // Transaction calls; a display may override them.
+  virtual void startWrite(void) {}
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+  virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { fillRect(x, y, w, h, color); }
+  virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { drawFastVLine(x, y, h, color); }
+  virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { drawFastHLine(x, y, w, color); }
+  virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  virtual void endWrite(void) {}
+
+  // Primitives with generic implementations; a display may override them.
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+  virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+  void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+  void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+  void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+  void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t sizeX, uint8_t sizeY);
+  void setTextSize(uint8_t s) { setTextSize(s, s); }
+  void setTextSize(uint8_t sx, uint8_t sy) { textsize_x = sx > 0 ? sx : 1; textsize_y = sy > 0 ? sy : 1; }
+  void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+  /// Text color with a transparent background.
+  void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+  /// Text color with an opaque background.
+  void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+  void setTextWrap(bool w) { wrap = w; }
+  void cp437(bool x = true) { _cp437 = x; }
+
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+  int16_t width(void) const { return _width; }
+  int16_t height(void) const { return _height; }
+  int16_t getCursorX(void) const { return cursor_x; }
+  int16_t getCursorY(void) const { return cursor_y; }
+
+protected:
+  void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color);
+
+  int16_t WIDTH;          ///< Physical width.
+  int16_t HEIGHT;         ///< Physical height.
+  int16_t _width;
+  int16_t _height;
+  int16_t cursor_x;
+  int16_t cursor_y;
+  uint16_t textcolor;
+  uint16_t textbgcolor;
+  uint8_t textsize_x;
+  uint8_t textsize_y;
+  bool wrap;
+  bool _cp437;
+};
+
+#endif // HOST_ADAFRUIT_GFX_H
@@ -0,0 +1,74 @@
+/**
+ * @file Adafruit_LSM6DS.h
+ * @brief Host stand-in for the LSM6DS IMU driver: a sensor at rest, z axis up, at 30 °C.
+ */
+
+#ifndef HOST_ADAFRUIT_LSM6DS_H
+#define HOST_ADAFRUIT_LSM6DS_H
+
+#include <Arduino.h>
+#include <Adafruit_Sensor.h>
+
+typedef enum {
+  LSM6DS_RATE_SHUTDOWN,
+  LSM6DS_RATE_12_5_HZ,
+  LSM6DS_RATE_26_HZ,
+  LSM6DS_RATE_52_HZ,
+  LSM6DS_RATE_104_HZ,
+  LSM6DS_RATE_208_HZ,
+  LSM6DS_RATE_416_HZ,
+  LSM6DS_RATE_833_HZ,
+  LSM6DS_RATE_1_66K_HZ,
+  LSM6DS_RATE_3_33K_HZ,
+  LSM6DS_RATE_6_66K_HZ
+} lsm6ds_data_rate_t;
+
+typedef enum {
+  LSM6DS_ACCEL_RANGE_2_G,
+  LSM6DS_ACCEL_RANGE_16_G,
+  LSM6DS_ACCEL_RANGE_4_G,
+  LSM6DS_ACCEL_RANGE_8_G
+} lsm6ds_accel_range_t;
+
+typedef enum {
+  LSM6DS_GYRO_RANGE_125_DPS = 0b0010,
+  LSM6DS_GYRO_RANGE_250_DPS = 0b0000,
+  LSM6DS_GYRO_RANGE_500_DPS = 0b0100,
+  LSM6DS_GYRO_RANGE_1000_DPS = 0b1000,
+  LSM6DS_GYRO_RANGE_2000_DPS = 0b1100
+} lsm6ds_gyro_range_t;
+
+/**
+ * @brief 6-axis IMU.
+ */
+class Adafruit_LSM6DS {
+public:
+  bool begin_SPI(uint8_t csPin, int8_t sckPin = -1, int8_t misoPin = -1, int8_t mosiPin = -1, int32_t sensorId = 0)
+  {
+    (void)csPin; (void)sckPin; (void)misoPin; (void)mosiPin; (void)sensorId;
+    return true;
+  }
+  void setAccelRange(lsm6ds_accel_range_t range) { (void)range; }
+  void setGyroRange(lsm6ds_gyro_range_t range) { (void)range; }
+  void setAccelDataRate(lsm6ds_data_rate_t rate) { (void)rate; }
+  void setGyroDataRate(lsm6ds_data_rate_t rate) { (void)rate; }
+
+  bool getEvent(sensors_event_t* accel, sensors_event_t* gyro, sensors_event_t* temp)
+  {
+    int32_t now = (int32_t)millis();
+    *accel = sensors_event_t();
+    accel->type = SENSOR_TYPE_ACCELEROMETER;
+    accel->timestamp = now;
+    accel->acceleration.z = SENSORS_GRAVITY_STANDARD;
+    *gyro = sensors_event_t();
+    gyro->type = SENSOR_TYPE_GYROSCOPE;
+    gyro->timestamp = now;
+    *temp = sensors_event_t();
+    temp->type = SENSOR_TYPE_AMBIENT_TEMPERATURE;
+    temp->timestamp = now;
+    temp->temperature = 30.0f;
+    return true;
+  }
+};
+
+#endif // HOST_ADAFRUIT_LSM6DS_H
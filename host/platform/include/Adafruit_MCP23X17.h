@@ -0,0 +1,32 @@
+/**
+ * @file Adafruit_MCP23X17.h
+ * @brief Host stand-in for the MCP23017 I/O expander: keeps the port state only.
+ */
+
+#ifndef HOST_ADAFRUIT_MCP23X17_H
+#define HOST_ADAFRUIT_MCP23X17_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+/**
+ * @brief 16-bit I/O expander (port A: bits 0-7, port B: bits 8-15).
+ */
+class Adafruit_MCP23X17 {
+public:
+  bool begin_I2C(uint8_t addr = 0x20, TwoWire* wire = &Wire) { (void)addr; (void)wire; return true; }
+  void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+  void digitalWrite(uint8_t pin, uint8_t value)
+  {
+    uint16_t bit = (uint16_t)(1u << pin);
+    gpio = value ? (uint16_t)(gpio | bit) : (uint16_t)(gpio & ~bit);
+  }
+  uint8_t digitalRead(uint8_t pin) { return (gpio >> pin) & 1; }
+  void writeGPIOAB(uint16_t value) { gpio = value; }
+  uint16_t readGPIOAB() { return gpio; }
+
+private:
+  uint16_t gpio = 0;
+};
+
+#endif // HOST_ADAFRUIT_MCP23X17_H
@@ -0,0 +1,49 @@
+/**
+ * @file Adafruit_SSD1306.h
+ * @brief Host copy of the SSD1306 driver: the frame buffer and its drawing calls.
+ *
+ * The buffer has the panel's page layout and the fast lines are the library's
+ * byte-wise versions, so the GFX drawing path costs what it does on the board.
+ * display() has no panel to send to; the frame stays in the buffer.
+ */
+
+#ifndef HOST_ADAFRUIT_SSD1306_H
+#define HOST_ADAFRUIT_SSD1306_H
+
+#include <Adafruit_GFX.h>
+#include <Wire.h>
+
+#define SSD1306_BLACK   0
+#define SSD1306_WHITE   1
+#define SSD1306_INVERSE 2
+
+#define SSD1306_EXTERNALVCC  0x01
+#define SSD1306_SWITCHCAPVCC 0x02
+
+/**
+ * @brief 128x64 (or smaller) monochrome OLED.
+ */
+class Adafruit_SSD1306 : public Adafruit_GFX {
+public:
+  Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rstPin = -1,
+                   uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL);
+  ~Adafruit_SSD1306(void);
+
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0, bool reset = true,
+             bool periphBegin = true);
+  void display(void) {}
+  void clearDisplay(void);
+  void invertDisplay(bool i) { (void)i; }
+  void dim(bool dim) { (void)dim; }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  bool getPixel(int16_t x, int16_t y);
+  uint8_t* getBuffer(void) { return buffer; }
+
+private:
+  uint8_t* buffer;
+};
+
+#endif // HOST_ADAFRUIT_SSD1306_H
@@ -0,0 +1,55 @@
+/**
+ * @file Adafruit_Sensor.h
+ * @brief Host copy of the Adafruit unified sensor event types.
+ */
+
+#ifndef HOST_ADAFRUIT_SENSOR_H
+#define HOST_ADAFRUIT_SENSOR_H
+
+#include <stdint.h>
+
+#define SENSORS_GRAVITY_STANDARD 9.80665F
+
+typedef enum {
+  SENSOR_TYPE_ACCELEROMETER = 1,
+  SENSOR_TYPE_GYROSCOPE = 4,
+  SENSOR_TYPE_PRESSURE = 6,
+  SENSOR_TYPE_RELATIVE_HUMIDITY = 12,
+  SENSOR_TYPE_AMBIENT_TEMPERATURE = 13
+} sensors_type_t;
+
+typedef struct {
+  union {
+    float v[3];
+    struct {
+      float x;
+      float y;
+      float z;
+    };
+    struct {
+      float roll;
+      float pitch;
+      float heading;
+    };
+  };
+  int8_t status;
+  uint8_t reserved[3];
+} sensors_vec_t;
+
+typedef struct {
+  int32_t version;
+  int32_t sensor_id;
+  int32_t type;
+  int32_t reserved0;
+  int32_t timestamp;   ///< millis() of the reading.
+  union {
+    float data[4];
+    sensors_vec_t acceleration;   ///< m/s^2
+    sensors_vec_t gyro;           ///< rad/s
+    float temperature;            ///< °C
+    float pressure;               ///< hPa
+    float relative_humidity;      ///< %
+  };
+} sensors_event_t;
+
+#endif // HOST_ADAFRUIT_SENSOR_H
@@ -0,0 +1,154 @@
+/**
+ * @file Arduino.h
+ * @brief Host (Linux) stand-in for the Arduino-ESP32 core, as used by the firmware.
+ *
+ * millis()/micros() count from program start on CLOCK_MONOTONIC and Serial writes to
+ * stdout. The board I/O reads a board at rest: inputs at their idle level, untouched
+ * pads, a 3.9 V battery on USB power. LEDC and tone output is accepted and ignored.
+ * Varying sensor data comes from the firmware's own synthetic source (SensorSource.h).
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+
+#define ESP_ARDUINO_VERSION_MAJOR 2
+#define ESP_ARDUINO_VERSION_MINOR 0
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define LOW            0x0
+#define HIGH           0x1
+
+#define INPUT          0x01
+#define OUTPUT         0x03
+#define PULLUP         0x04
+#define INPUT_PULLUP   0x05
+#define PULLDOWN       0x08
+#define INPUT_PULLDOWN 0x09
+
+#define RISING         0x01
+#define FALLING        0x02
+#define CHANGE         0x03
+
+#define PI          3.1415926535897932384626433832795
+#define HALF_PI     1.5707963267948966192313216916398
+#define TWO_PI      6.283185307179586476925286766559
+#define DEG_TO_RAD  0.017453292519943295769236907684886
+#define RAD_TO_DEG  57.295779513082320876798154814105
+
+using std::min;
+using std::max;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+extern "C" size_t strlcpy(char* dst, const char* src, size_t size);
+
+// Time
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// GPIO
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+#define digitalPinToInterrupt(pin) (pin)
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+
+// ADC
+typedef enum {
+  ADC_0db,
+  ADC_2_5db,
+  ADC_6db,
+  ADC_11db
+} adc_attenuation_t;
+
+uint16_t analogRead(uint8_t pin);
+void analogReadResolution(uint8_t bits);
+void analogSetPinAttenuation(uint8_t pin, adc_attenuation_t attenuation);
+
+// Touch pads
+typedef uint32_t touch_value_t;
+touch_value_t touchRead(uint8_t pin);
+void touchAttachInterrupt(uint8_t pin, void (*isr)(void), touch_value_t threshold);
+void touchAttachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, touch_value_t threshold);
+void touchDetachInterrupt(uint8_t pin);
+
+// LEDC and tone (no output on the host)
+double ledcSetup(uint8_t channel, double freq, uint8_t resolutionBits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcDetachPin(uint8_t pin);
+void ledcWrite(uint8_t channel, uint32_t duty);
+double ledcWriteTone(uint8_t channel, double freq);
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+// Random numbers
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+uint32_t getCpuFrequencyMhz();
+
+/**
+ * @brief Serial port; the host writes to stdout and reads nothing.
+ */
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  void end() {}
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  void flush() override;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+/**
+ * @brief Chip information. The host cycle counter counts nanoseconds, at a nominal
+ *        getCpuFrequencyMhz() of 1000.
+ */
+class EspClass {
+public:
+  uint32_t getCycleCount();
+  uint32_t getCpuFreqMHz() { return getCpuFrequencyMhz(); }
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+  void restart();
+};
+
+extern EspClass ESP;
+
+// Sketch entry points (src/main.cpp).
+void setup(void);
+void loop(void);
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,68 @@
+/**
+ * @file FS.h
+ * @brief Host stand-in for the Arduino-ESP32 file system API, backed by host files.
+ */
+
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+#include <Arduino.h>
+#include <memory>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+/**
+ * @brief Open file; copies share the same host file, which closes with the last copy.
+ */
+class File : public Stream {
+public:
+  File() {}
+  explicit File(FILE* f) : file(f, fclose) {}
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t read(uint8_t* buffer, size_t size);
+  void flush() override;
+  bool seek(uint32_t pos);
+  size_t position() const;
+  size_t size() const;
+  void close() { file.reset(); }
+  operator bool() const { return file != nullptr; }
+
+private:
+  std::shared_ptr<FILE> file;
+};
+
+/**
+ * @brief File system rooted at a host directory.
+ */
+class FS {
+public:
+  File open(const char* path, const char* mode = FILE_READ, bool create = false);
+  File open(const String& path, const char* mode = FILE_READ, bool create = false) { return open(path.c_str(), mode, create); }
+  bool exists(const char* path);
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool rename(const char* pathFrom, const char* pathTo);
+
+protected:
+  String root;   ///< Host directory holding the files; set by begin() of the subclass.
+
+  String hostPath(const char* path) const;
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+
+#endif // HOST_FS_H
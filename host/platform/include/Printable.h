@@ -0,0 +1,22 @@
+/**
+ * @file Printable.h
+ * @brief Host copy of the Arduino Printable interface.
+ */
+
+#ifndef HOST_PRINTABLE_H
+#define HOST_PRINTABLE_H
+
+#include <stddef.h>
+
+class Print;
+
+/**
+ * @brief Object that can print itself to a Print.
+ */
+class Printable {
+public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print& p) const = 0;
+};
+
+#endif // HOST_PRINTABLE_H
@@ -0,0 +1,85 @@
+/**
+ * @file PubSubClient.h
+ * @brief Host stand-in for the PubSubClient MQTT library (MQTT 3.1.1, QoS 0).
+ *
+ * Two back ends, chosen when connecting:
+ * - FIRMWARE_MQTT_BROKER=<host>[:<port>] (environment) speaks MQTT over TCP to that
+ *   broker (default port 1883), in place of the broker passed to setServer().
+ * - Otherwise an in-process loopback stands in for the broker: every publish is
+ *   printed to stdout as "MQTT > <topic> <payload>", and telecommands are read line
+ *   by line from the file named by FIRMWARE_TELECOMMANDS, or from stdin. A line
+ *   "+<ms> <payload>" is delivered <ms> after the previous one (the first after the
+ *   first connect); empty lines and lines
+ *   starting with '#' are skipped. loop() delivers at most one message per call to
+ *   the callback, on the first subscribed topic, like a message from the broker.
+ */
+
+#ifndef HOST_PUBSUBCLIENT_H
+#define HOST_PUBSUBCLIENT_H
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+
+#define MQTT_VERSION_3_1_1   4
+#define MQTT_MAX_PACKET_SIZE 256
+#define MQTT_KEEPALIVE       15
+#define MQTT_SOCKET_TIMEOUT  15
+
+#define MQTT_CONNECTION_TIMEOUT     -4
+#define MQTT_CONNECTION_LOST        -3
+#define MQTT_CONNECT_FAILED         -2
+#define MQTT_DISCONNECTED           -1
+#define MQTT_CONNECTED               0
+#define MQTT_CONNECT_BAD_PROTOCOL    1
+#define MQTT_CONNECT_BAD_CLIENT_ID   2
+#define MQTT_CONNECT_UNAVAILABLE     3
+#define MQTT_CONNECT_BAD_CREDENTIALS 4
+#define MQTT_CONNECT_UNAUTHORIZED    5
+
+#define MQTT_CALLBACK_SIGNATURE void (*callback)(char*, uint8_t*, unsigned int)
+
+/**
+ * @brief MQTT client.
+ */
+class PubSubClient {
+public:
+  explicit PubSubClient(WiFiClientSecure& client);
+  ~PubSubClient();
+
+  PubSubClient& setServer(const char* domain, uint16_t port);
+  PubSubClient& setCallback(MQTT_CALLBACK_SIGNATURE);
+  bool setBufferSize(uint16_t size);
+  uint16_t getBufferSize() { return bufferSize; }
+
+  bool connect(const char* id, const char* user, const char* pass);
+  void disconnect();
+  bool publish(const char* topic, const char* payload);
+  bool publish(const char* topic, const uint8_t* payload, unsigned int length);
+  bool subscribe(const char* topic);
+  bool loop();
+  bool connected();
+  int state() { return connectionState; }
+
+private:
+  WiFiClientSecure* client;
+  uint8_t* buffer;
+  uint16_t bufferSize;
+  void (*callback)(char*, uint8_t*, unsigned int);
+  String domain;
+  uint16_t port;
+  String subscription;     ///< Topic telecommands are delivered on (loopback).
+  bool loopback;
+  int connectionState;
+  uint16_t nextPacketId;
+  unsigned long lastOutActivity;
+  unsigned long lastInActivity;
+  bool pingOutstanding;
+
+  bool sendPacket(uint8_t header, size_t length);
+  bool readByte(uint8_t* byte);
+  size_t readPacket(uint8_t* header);
+  size_t writeString(const char* s, size_t pos);
+  void deliverLoopback();
+};
+
+#endif // HOST_PUBSUBCLIENT_H
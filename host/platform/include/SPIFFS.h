@@ -0,0 +1,28 @@
+/**
+ * @file SPIFFS.h
+ * @brief Host stand-in for SPIFFS: the files live in the directory named by the
+ *        environment variable FIRMWARE_FS_DIR (default ./spiffs), created on begin().
+ */
+
+#ifndef HOST_SPIFFS_H
+#define HOST_SPIFFS_H
+
+#include "FS.h"
+
+namespace fs {
+
+class SPIFFSFS : public FS {
+public:
+  bool begin(bool formatOnFail = false, const char* basePath = "/spiffs", uint8_t maxOpenFiles = 10,
+             const char* partitionLabel = NULL);
+  bool format();
+  size_t totalBytes() { return 1408 * 1024; }
+  size_t usedBytes();
+  void end() {}
+};
+
+} // namespace fs
+
+extern fs::SPIFFSFS SPIFFS;
+
+#endif // HOST_SPIFFS_H
@@ -0,0 +1,28 @@
+/**
+ * @file Stream.h
+ * @brief Host copy of the Arduino Stream class (readable Print).
+ */
+
+#ifndef HOST_STREAM_H
+#define HOST_STREAM_H
+
+#include "Print.h"
+
+/**
+ * @brief Print that can also be read from.
+ */
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  size_t readBytes(uint8_t* buffer, size_t length);
+
+  /**
+   * @brief Reads up to (not including) the terminator or the end of the data.
+   */
+  String readStringUntil(char terminator);
+};
+
+#endif // HOST_STREAM_H
@@ -0,0 +1,106 @@
+/**
+ * @file WString.h
+ * @brief Host copy of the Arduino String class (the subset the firmware uses).
+ *
+ * Like Arduino-ESP32's String, up to 11 characters are kept inside the object and
+ * longer strings on the heap, grown with realloc(), so allocation counts match the
+ * board's.
+ */
+
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Heap-allocated, NUL-terminated string.
+ */
+class String {
+public:
+  String(const char* cstr = "");
+  String(const char* cstr, unsigned int length);
+  String(const String& str);
+  String(String&& str) noexcept;
+  explicit String(char c);
+  explicit String(unsigned char value, unsigned char base = 10);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(long long value, unsigned char base = 10);
+  explicit String(unsigned long long value, unsigned char base = 10);
+  explicit String(float value, unsigned int decimalPlaces = 2);
+  explicit String(double value, unsigned int decimalPlaces = 2);
+  ~String();
+
+  String& operator=(const String& rhs);
+  String& operator=(String&& rhs) noexcept;
+  String& operator=(const char* cstr);
+
+  bool reserve(unsigned int size);
+  unsigned int length() const { return len; }
+  bool isEmpty() const { return len == 0; }
+  const char* c_str() const { return data(); }
+
+  bool concat(const char* cstr, unsigned int length);
+  bool concat(const char* cstr);
+  bool concat(const String& str) { return concat(str.c_str(), str.len); }
+  bool concat(char c) { return concat(&c, 1); }
+
+  String& operator+=(const String& rhs) { concat(rhs); return *this; }
+  String& operator+=(const char* cstr) { concat(cstr); return *this; }
+  String& operator+=(char c) { concat(c); return *this; }
+  String& operator+=(int n) { concat(String(n)); return *this; }
+  String& operator+=(unsigned int n) { concat(String(n)); return *this; }
+  String& operator+=(long n) { concat(String(n)); return *this; }
+  String& operator+=(unsigned long n) { concat(String(n)); return *this; }
+  String& operator+=(float n) { concat(String(n)); return *this; }
+  String& operator+=(double n) { concat(String(n)); return *this; }
+
+  friend String operator+(const String& lhs, const String& rhs);
+  friend String operator+(const String& lhs, const char* rhs);
+  friend String operator+(const char* lhs, const String& rhs);
+  friend String operator+(const String& lhs, char rhs);
+
+  int compareTo(const String& s) const;
+  bool equals(const String& s) const;
+  bool equals(const char* cstr) const;
+  bool operator==(const String& rhs) const { return equals(rhs); }
+  bool operator==(const char* cstr) const { return equals(cstr); }
+  bool operator!=(const String& rhs) const { return !equals(rhs); }
+  bool operator!=(const char* cstr) const { return !equals(cstr); }
+  bool operator<(const String& rhs) const { return compareTo(rhs) < 0; }
+  bool startsWith(const String& prefix) const;
+  bool endsWith(const String& suffix) const;
+
+  char charAt(unsigned int index) const { return index < len ? data()[index] : 0; }
+  char operator[](unsigned int index) const { return charAt(index); }
+  int indexOf(char c, unsigned int fromIndex = 0) const;
+  int indexOf(const String& str, unsigned int fromIndex = 0) const;
+  String substring(unsigned int beginIndex) const { return substring(beginIndex, len); }
+  String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+  void remove(unsigned int index);
+  void remove(unsigned int index, unsigned int count);
+  void trim();
+
+  long toInt() const;
+  float toFloat() const;
+  double toDouble() const;
+
+private:
+  static const unsigned int SSO_CAPACITY = 11;
+
+  char* buffer;                   ///< Heap buffer, or NULL while the string is inline.
+  unsigned int capacity;          ///< Characters that fit without growing.
+  unsigned int len;
+  char sso[SSO_CAPACITY + 1];     ///< Inline storage.
+
+  const char* data() const { return buffer != NULL ? buffer : sso; }
+  char* data() { return buffer != NULL ? buffer : sso; }
+  void invalidate();
+  bool copy(const char* cstr, unsigned int length);
+};
+
+#endif // HOST_WSTRING_H
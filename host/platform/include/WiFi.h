@@ -0,0 +1,52 @@
+/**
+ * @file WiFi.h
+ * @brief Host stand-in for the Arduino-ESP32 WiFi API: the host network is always
+ *        connected, with a fixed RSSI.
+ */
+
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include <Arduino.h>
+
+typedef enum {
+  WL_IDLE_STATUS   = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED     = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_DISCONNECTED  = 6
+} wl_status_t;
+
+typedef enum {
+  WIFI_OFF = 0,
+  WIFI_STA = 1
+} wifi_mode_t;
+
+/**
+ * @brief IPv4 address.
+ */
+class IPAddress : public Printable {
+public:
+  IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : bytes{a, b, c, d} {}
+  size_t printTo(Print& p) const override;
+
+private:
+  uint8_t bytes[4];
+};
+
+/**
+ * @brief WiFi station.
+ */
+class WiFiClass {
+public:
+  wl_status_t begin(const char* ssid, const char* passphrase = NULL);
+  wl_status_t status() { return WL_CONNECTED; }
+  bool disconnect(bool wifiOff = false) { (void)wifiOff; return true; }
+  bool mode(wifi_mode_t mode) { (void)mode; return true; }
+  IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+  int8_t RSSI() { return -55; }
+};
+
+extern WiFiClass WiFi;
+
+#endif // HOST_WIFI_H
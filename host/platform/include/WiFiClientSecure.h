@@ -0,0 +1,42 @@
+/**
+ * @file WiFiClientSecure.h
+ * @brief Host stand-in for the TLS client: a plain TCP connection.
+ *
+ * The host build talks to a local test broker without TLS; setCACert() is accepted
+ * and ignored.
+ */
+
+#ifndef HOST_WIFICLIENTSECURE_H
+#define HOST_WIFICLIENTSECURE_H
+
+#include <Arduino.h>
+
+/**
+ * @brief TCP client socket.
+ */
+class WiFiClientSecure : public Stream {
+public:
+  ~WiFiClientSecure() { stop(); }
+
+  void setCACert(const char* rootCA) { (void)rootCA; }
+
+  /**
+   * @brief Connects to host:port; returns 1 on success, 0 on failure.
+   */
+  int connect(const char* host, uint16_t port);
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+  int read(uint8_t* buffer, size_t size);
+  void stop();
+  uint8_t connected();
+
+private:
+  int fd = -1;
+  int peeked = -1;   ///< Byte read ahead by peek(), or -1.
+};
+
+#endif // HOST_WIFICLIENTSECURE_H
@@ -0,0 +1,22 @@
+/**
+ * @file Wire.h
+ * @brief Host stand-in for the Arduino I2C bus; the host devices need no bus traffic.
+ */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+/**
+ * @brief I2C bus (no-op).
+ */
+class TwoWire {
+public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) { (void)sda; (void)scl; (void)frequency; return true; }
+  bool setClock(uint32_t frequency) { (void)frequency; return true; }
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
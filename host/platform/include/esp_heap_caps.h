@@ -0,0 +1,25 @@
+/**
+ * @file esp_heap_caps.h
+ * @brief Host stand-in for the ESP-IDF heap statistics.
+ *
+ * The host heap (platform/heap.cpp) counts the live bytes of every allocation and
+ * reports them against a nominal internal heap of FIRMWARE_HEAP_BYTES (environment,
+ * default 320 KiB), so free and minimum-free sizes move as they would on the board.
+ * There is no fragmentation model: the largest free block is the free size.
+ */
+
+#ifndef HOST_ESP_HEAP_CAPS_H
+#define HOST_ESP_HEAP_CAPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT  (1 << 12)
+
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+
+#endif // HOST_ESP_HEAP_CAPS_H
@@ -0,0 +1,19 @@
+/**
+ * @file esp_wpa2.h
+ * @brief Host stand-in for the WPA2 enterprise API (the host network is always up).
+ */
+
+#ifndef HOST_ESP_WPA2_H
+#define HOST_ESP_WPA2_H
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+
+static inline esp_err_t esp_wifi_sta_wpa2_ent_set_identity(const uint8_t*, int) { return ESP_OK; }
+static inline esp_err_t esp_wifi_sta_wpa2_ent_set_username(const uint8_t*, int) { return ESP_OK; }
+static inline esp_err_t esp_wifi_sta_wpa2_ent_set_password(const uint8_t*, int) { return ESP_OK; }
+static inline esp_err_t esp_wifi_sta_wpa2_ent_enable(void) { return ESP_OK; }
+
+#endif // HOST_ESP_WPA2_H
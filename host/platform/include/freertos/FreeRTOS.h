@@ -0,0 +1,80 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host (Linux) port of the FreeRTOS API used by the firmware.
+ *
+ * Every task is a POSIX thread, one tick is one millisecond of CLOCK_MONOTONIC.
+ * Queues, semaphores, task notifications and delays keep their FreeRTOS semantics.
+ * Priorities are recorded but not enforced (the Linux scheduler decides), and
+ * vTaskSuspend() on another task takes effect at that task's next blocking call.
+ * Critical sections are a recursive spinlock shared by both "cores".
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint8_t  StackType_t;   // stack depths are in bytes, as on the ESP32 port
+
+typedef struct tskTaskControlBlock* TaskHandle_t;
+typedef struct QueueDefinition*     QueueHandle_t;
+typedef QueueHandle_t               SemaphoreHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+/// @brief Storage for a statically created task (opaque, holds the host TCB).
+typedef struct { alignas(16) uint8_t storage[512]; } StaticTask_t;
+
+/// @brief Storage for a statically created queue or semaphore (opaque).
+typedef struct { alignas(16) uint8_t storage[256]; } StaticQueue_t;
+typedef StaticQueue_t StaticSemaphore_t;
+
+/// @brief Critical section lock: owning thread (0 = free) and nesting count.
+typedef struct {
+  uint32_t owner;
+  uint32_t count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0, 0}
+#define portMUX_INITIALIZE(mux) do { (mux)->owner = 0; (mux)->count = 0; } while (0)
+
+void vPortEnterCritical(portMUX_TYPE* mux);
+void vPortExitCritical(portMUX_TYPE* mux);
+void vPortYield(void);
+
+#define portENTER_CRITICAL(mux)     vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)      vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux)  vPortExitCritical(mux)
+#define portYIELD_FROM_ISR(woken)   do { if (woken) vPortYield(); } while (0)
+#define taskYIELD()                 vPortYield()
+
+#define portMAX_DELAY       ((TickType_t)0xffffffffUL)
+#define configTICK_RATE_HZ  1000
+#define portTICK_PERIOD_MS  ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(((TickType_t)(ms) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+#define pdTICKS_TO_MS(t)    ((TickType_t)(((TickType_t)(t) * (TickType_t)1000U) / (TickType_t)configTICK_RATE_HZ))
+
+#define pdFALSE   ((BaseType_t)0)
+#define pdTRUE    ((BaseType_t)1)
+#define pdFAIL    pdFALSE
+#define pdPASS    pdTRUE
+#define errQUEUE_EMPTY ((BaseType_t)0)
+#define errQUEUE_FULL  ((BaseType_t)0)
+
+#define tskNO_AFFINITY           ((BaseType_t)0x7FFFFFFF)
+#define tskIDLE_PRIORITY         ((UBaseType_t)0U)
+#define configMAX_PRIORITIES     25
+#define configMAX_TASK_NAME_LEN  16
+#define configNUM_CORES          2
+#define portNUM_PROCESSORS       2
+#define CONFIG_FREERTOS_UNICORE  0
+
+#define configUSE_TRACE_FACILITY        1
+#define configGENERATE_RUN_TIME_STATS   1   // run time counters: thread CPU time in µs
+#define configTASKLIST_INCLUDE_COREID   1
+
+#endif // HOST_FREERTOS_H
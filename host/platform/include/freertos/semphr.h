@@ -0,0 +1,21 @@
+/**
+ * @file semphr.h
+ * @brief Host port: semaphores, built on queues of zero-size items as in FreeRTOS.
+ */
+
+#ifndef HOST_FREERTOS_SEMPHR_H
+#define HOST_FREERTOS_SEMPHR_H
+
+#include "queue.h"
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t* semaphore);
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* semaphore);
+
+#define xSemaphoreTake(sem, timeout)      xQueueReceive((sem), NULL, (timeout))
+#define xSemaphoreGive(sem)               xQueueSendToBack((sem), NULL, 0)
+#define xSemaphoreGiveFromISR(sem, woken) xQueueSendFromISR((sem), NULL, (woken))
+#define vSemaphoreDelete(sem)             vQueueDelete(sem)
+
+#endif // HOST_FREERTOS_SEMPHR_H
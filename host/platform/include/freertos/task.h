@@ -0,0 +1,79 @@
+/**
+ * @file task.h
+ * @brief Host port: task API (see freertos/FreeRTOS.h).
+ */
+
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef enum {
+  eNoAction = 0,
+  eSetBits,
+  eIncrement,
+  eSetValueWithOverwrite,
+  eSetValueWithoutOverwrite
+} eNotifyAction;
+
+typedef enum {
+  eRunning = 0,
+  eReady,
+  eBlocked,
+  eSuspended,
+  eDeleted,
+  eInvalid
+} eTaskState;
+
+typedef struct {
+  TaskHandle_t xHandle;
+  const char* pcTaskName;
+  UBaseType_t xTaskNumber;
+  eTaskState eCurrentState;
+  UBaseType_t uxCurrentPriority;
+  UBaseType_t uxBasePriority;
+  uint32_t ulRunTimeCounter;        ///< Thread CPU time in µs.
+  StackType_t* pxStackBase;
+  uint32_t usStackHighWaterMark;    ///< Bytes of the configured depth never used.
+  BaseType_t xCoreID;
+} TaskStatus_t;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* created,
+                                   BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* created);
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                                           void* param, UBaseType_t priority, StackType_t* stack,
+                                           StaticTask_t* tcb, BaseType_t core);
+TaskHandle_t xTaskCreateStatic(TaskFunction_t code, const char* name, uint32_t stackDepth, void* param,
+                               UBaseType_t priority, StackType_t* stack, StaticTask_t* tcb);
+void vTaskDelete(TaskHandle_t task);
+
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t increment);
+BaseType_t xTaskDelayUntil(TickType_t* previousWake, TickType_t increment);
+TickType_t xTaskGetTickCount(void);
+TickType_t xTaskGetTickCountFromISR(void);
+
+void vTaskSuspend(TaskHandle_t task);
+void vTaskResume(TaskHandle_t task);
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action);
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t* woken);
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t* value, TickType_t timeout);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t timeout);
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+const char* pcTaskGetName(TaskHandle_t task);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+UBaseType_t uxTaskGetTaskNumber(TaskHandle_t task);
+void vTaskSetTaskNumber(TaskHandle_t task, UBaseType_t number);
+UBaseType_t uxTaskGetNumberOfTasks(void);
+UBaseType_t uxTaskGetSystemState(TaskStatus_t* status, UBaseType_t size, uint32_t* totalRunTime);
+BaseType_t xPortGetCoreID(void);
+
+#endif // HOST_FREERTOS_TASK_H
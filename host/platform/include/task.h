@@ -0,0 +1,2 @@
+// Arduino-ESP32 exposes the FreeRTOS headers without the freertos/ prefix as well.
+#include "freertos/task.h"
@@ -0,0 +1,28 @@
+// Entry point of the host firmware: the Arduino core's loopTask on the main thread.
+//
+// FIRMWARE_RUN_SECONDS=<s> ends the run after that many seconds (exit status 0), so
+// tests and profiling runs have a fixed length.
+#include <Arduino.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+void setup();
+void loop();
+
+int main()
+{
+  setvbuf(stdout, NULL, _IOLBF, 0);
+
+  const char* runSeconds = getenv("FIRMWARE_RUN_SECONDS");
+  uint32_t endMs = runSeconds != NULL ? (uint32_t)(atof(runSeconds) * 1000.0) : 0;
+
+  setup();
+  for (;;) {
+    loop();
+    if (endMs != 0 && millis() >= endMs) {
+      fflush(stdout);
+      _exit(0);
+    }
+    delay(1);
+  }
+}
@@ -0,0 +1,563 @@
+// Host network: WiFi (always connected), TCP client and the MQTT client with its
+// loopback broker (see PubSubClient.h).
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+#include <PubSubClient.h>
+
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+WiFiClass WiFi;
+
+//------------------
+// WiFi
+//------------------
+size_t IPAddress::printTo(Print& p) const
+{
+  size_t n = 0;
+  for (int i = 0; i < 4; i++) {
+    n += p.print(bytes[i], DEC);
+    if (i < 3) n += p.print('.');
+  }
+  return n;
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* passphrase)
+{
+  (void)ssid;
+  (void)passphrase;
+  return WL_CONNECTED;
+}
+
+//------------------
+// TCP client
+//------------------
+int WiFiClientSecure::connect(const char* host, uint16_t port)
+{
+  stop();
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  char service[8];
+  snprintf(service, sizeof(service), "%u", (unsigned)port);
+  struct addrinfo* result = NULL;
+  if (getaddrinfo(host, service, &hints, &result) != 0) {
+    return 0;
+  }
+  for (struct addrinfo* ai = result; ai != NULL && fd < 0; ai = ai->ai_next) {
+    fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd < 0) continue;
+    if (::connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(result);
+  if (fd < 0) {
+    return 0;
+  }
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  return 1;
+}
+
+size_t WiFiClientSecure::write(const uint8_t* buffer, size_t size)
+{
+  size_t sent = 0;
+  while (fd >= 0 && sent < size) {
+    ssize_t n = send(fd, buffer + sent, size - sent, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) {
+      stop();
+      break;
+    }
+    sent += (size_t)n;
+  }
+  return sent;
+}
+
+int WiFiClientSecure::available()
+{
+  if (fd < 0) return 0;
+  int pending = 0;
+  if (ioctl(fd, FIONREAD, &pending) != 0) return 0;
+  return pending + (peeked >= 0 ? 1 : 0);
+}
+
+int WiFiClientSecure::read()
+{
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClientSecure::read(uint8_t* buffer, size_t size)
+{
+  if (size == 0) return 0;
+  size_t got = 0;
+  if (peeked >= 0) {
+    buffer[got++] = (uint8_t)peeked;
+    peeked = -1;
+  }
+  if (fd >= 0 && got < size) {
+    ssize_t n = recv(fd, buffer + got, size - got, MSG_DONTWAIT);
+    if (n > 0) got += (size_t)n;
+  }
+  return got > 0 ? (int)got : -1;
+}
+
+int WiFiClientSecure::peek()
+{
+  if (peeked < 0) {
+    uint8_t c;
+    if (fd >= 0 && recv(fd, &c, 1, MSG_DONTWAIT) == 1) peeked = c;
+  }
+  return peeked;
+}
+
+void WiFiClientSecure::stop()
+{
+  if (fd >= 0) {
+    close(fd);
+    fd = -1;
+  }
+  peeked = -1;
+}
+
+uint8_t WiFiClientSecure::connected()
+{
+  if (fd < 0) return 0;
+  if (peeked >= 0) return 1;
+  struct pollfd p = {fd, POLLIN, 0};
+  if (poll(&p, 1, 0) > 0) {
+    if (p.revents & (POLLERR | POLLHUP)) {
+      stop();
+      return 0;
+    }
+    uint8_t c;
+    ssize_t n = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+      stop();   // closed by the peer
+      return 0;
+    }
+  }
+  return 1;
+}
+
+//------------------
+// Loopback broker
+//------------------
+#define LOOPBACK_SLOTS   16
+#define LOOPBACK_MSG_MAX 1024
+
+namespace {
+
+struct LoopbackMessage {
+  unsigned long dueMs;
+  size_t length;
+  uint8_t payload[LOOPBACK_MSG_MAX];
+};
+
+// Telecommands read by the console thread, in a fixed ring so the host side does
+// not show up in the firmware's allocation counts.
+struct LoopbackConsole {
+  std::mutex lock;
+  std::condition_variable space;
+  LoopbackMessage slots[LOOPBACK_SLOTS];
+  unsigned head = 0;
+  unsigned count = 0;
+};
+
+LoopbackConsole console;
+
+void consoleReader()
+{
+  const char* path = getenv("FIRMWARE_TELECOMMANDS");
+  FILE* in = (path != NULL && path[0] != '\0') ? fopen(path, "r") : stdin;
+  if (in == NULL) {
+    fprintf(stderr, "Cannot open FIRMWARE_TELECOMMANDS file %s\n", path);
+    return;
+  }
+  char line[LOOPBACK_MSG_MAX + 32];
+  unsigned long previousDue = millis();
+  while (fgets(line, sizeof(line), in) != NULL) {
+    size_t length = strcspn(line, "\r\n");
+    line[length] = '\0';
+    const char* payload = line;
+    unsigned long delayMs = 0;
+    if (payload[0] == '+') {
+      char* end;
+      delayMs = strtoul(payload + 1, &end, 10);
+      payload = end;
+      while (*payload == ' ') payload++;
+    }
+    if (payload[0] == '\0' || payload[0] == '#') {
+      continue;
+    }
+    unsigned long now = millis();
+    unsigned long due = previousDue + delayMs;
+    if ((long)(now - due) > 0 && delayMs == 0) due = now;   // typed lines go out when typed
+    previousDue = due;
+
+    std::unique_lock<std::mutex> lock(console.lock);
+    console.space.wait(lock, [] { return console.count < LOOPBACK_SLOTS; });
+    LoopbackMessage& msg = console.slots[(console.head + console.count) % LOOPBACK_SLOTS];
+    msg.dueMs = due;
+    msg.length = strlen(payload) < LOOPBACK_MSG_MAX ? strlen(payload) : LOOPBACK_MSG_MAX;
+    memcpy(msg.payload, payload, msg.length);
+    console.count++;
+  }
+  if (in != stdin) fclose(in);
+}
+
+void startConsole()
+{
+  static std::once_flag started;
+  std::call_once(started, [] { std::thread(consoleReader).detach(); });
+}
+
+// Broker from the environment, or NULL for the loopback.
+const char* brokerOverride()
+{
+  const char* broker = getenv("FIRMWARE_MQTT_BROKER");
+  return (broker != NULL && broker[0] != '\0') ? broker : NULL;
+}
+
+} // namespace
+
+//------------------
+// MQTT client
+//------------------
+#define MQTT_HEADER_MAX 5   // fixed header: type byte and up to 4 length bytes
+
+#define MQTTCONNECT     (1 << 4)
+#define MQTTCONNACK     (2 << 4)
+#define MQTTPUBLISH     (3 << 4)
+#define MQTTSUBSCRIBE   (8 << 4)
+#define MQTTPINGREQ     (12 << 4)
+#define MQTTPINGRESP    (13 << 4)
+#define MQTTDISCONNECT  (14 << 4)
+
+PubSubClient::PubSubClient(WiFiClientSecure& client)
+    : client(&client), buffer(NULL), bufferSize(0), callback(NULL), port(0), loopback(false),
+      connectionState(MQTT_DISCONNECTED), nextPacketId(1), lastOutActivity(0), lastInActivity(0),
+      pingOutstanding(false)
+{
+  setBufferSize(MQTT_MAX_PACKET_SIZE);
+}
+
+PubSubClient::~PubSubClient()
+{
+  free(buffer);
+}
+
+PubSubClient& PubSubClient::setServer(const char* domain, uint16_t port)
+{
+  const char* broker = brokerOverride();
+  if (broker != NULL) {
+    String address = broker;
+    int colon = address.indexOf(':');
+    this->domain = colon >= 0 ? address.substring(0, colon) : address;
+    this->port = colon >= 0 ? (uint16_t)address.substring(colon + 1).toInt() : 1883;
+  } else {
+    this->domain = domain;
+    this->port = port;
+  }
+  return *this;
+}
+
+PubSubClient& PubSubClient::setCallback(void (*callback)(char*, uint8_t*, unsigned int))
+{
+  this->callback = callback;
+  return *this;
+}
+
+bool PubSubClient::setBufferSize(uint16_t size)
+{
+  if (size == 0) return false;
+  uint8_t* grown = (uint8_t*)realloc(buffer, size);
+  if (grown == NULL) return false;
+  buffer = grown;
+  bufferSize = size;
+  return true;
+}
+
+size_t PubSubClient::writeString(const char* s, size_t pos)
+{
+  size_t length = strlen(s);
+  if (pos + 2 + length > bufferSize) {
+    return 0;
+  }
+  buffer[pos++] = (uint8_t)(length >> 8);
+  buffer[pos++] = (uint8_t)length;
+  memcpy(buffer + pos, s, length);
+  return pos + length;
+}
+
+// Sends the packet whose variable part is buffer[MQTT_HEADER_MAX, MQTT_HEADER_MAX + length).
+bool PubSubClient::sendPacket(uint8_t header, size_t length)
+{
+  uint8_t lengthBytes[4];
+  size_t count = 0;
+  size_t remaining = length;
+  do {
+    uint8_t digit = remaining % 128;
+    remaining /= 128;
+    if (remaining > 0) digit |= 0x80;
+    lengthBytes[count++] = digit;
+  } while (remaining > 0 && count < 4);
+  uint8_t* start = buffer + MQTT_HEADER_MAX - 1 - count;
+  start[0] = header;
+  memcpy(start + 1, lengthBytes, count);
+  size_t total = 1 + count + length;
+  lastOutActivity = millis();
+  return client->write(start, total) == total;
+}
+
+bool PubSubClient::readByte(uint8_t* byte)
+{
+  unsigned long start = millis();
+  while (!client->available()) {
+    if (!client->connected() || millis() - start >= MQTT_SOCKET_TIMEOUT * 1000UL) {
+      return false;
+    }
+    delay(1);
+  }
+  *byte = (uint8_t)client->read();
+  return true;
+}
+
+// Reads one packet into the buffer; returns its total length, or 0 if it failed or
+// did not fit (then it is skipped). *header gets the length of the fixed header.
+size_t PubSubClient::readPacket(uint8_t* header)
+{
+  uint8_t type;
+  if (!readByte(&type)) return 0;
+  buffer[0] = type;
+  size_t length = 0;
+  size_t multiplier = 1;
+  size_t pos = 1;
+  uint8_t digit;
+  do {
+    if (pos == 5 || !readByte(&digit)) return 0;   // malformed length
+    buffer[pos++] = digit;
+    length += (digit & 127) * multiplier;
+    multiplier *= 128;
+  } while (digit & 128);
+  *header = (uint8_t)pos;
+
+  bool fits = pos + length <= bufferSize;
+  for (size_t i = 0; i < length; i++) {
+    if (!readByte(&digit)) return 0;
+    if (fits) buffer[pos + i] = digit;
+  }
+  return fits ? pos + length : 0;
+}
+
+bool PubSubClient::connect(const char* id, const char* user, const char* pass)
+{
+  if (connected()) {
+    return true;
+  }
+  loopback = brokerOverride() == NULL;
+  if (loopback) {
+    startConsole();
+    connectionState = MQTT_CONNECTED;
+    return true;
+  }
+  if (!client->connect(domain.c_str(), port)) {
+    connectionState = MQTT_CONNECT_FAILED;
+    return false;
+  }
+  nextPacketId = 1;
+  size_t pos = MQTT_HEADER_MAX;
+  static const uint8_t protocol[] = {0x00, 0x04, 'M', 'Q', 'T', 'T', MQTT_VERSION_3_1_1};
+  memcpy(buffer + pos, protocol, sizeof(protocol));
+  pos += sizeof(protocol);
+  uint8_t flags = 0x02;   // clean session
+  if (user != NULL) flags |= 0x80;
+  if (user != NULL && pass != NULL) flags |= 0x40;
+  buffer[pos++] = flags;
+  buffer[pos++] = (uint8_t)(MQTT_KEEPALIVE >> 8);
+  buffer[pos++] = (uint8_t)MQTT_KEEPALIVE;
+  pos = writeString(id, pos);
+  if (pos != 0 && user != NULL) pos = writeString(user, pos);
+  if (pos != 0 && user != NULL && pass != NULL) pos = writeString(pass, pos);
+  if (pos == 0 || !sendPacket(MQTTCONNECT, pos - MQTT_HEADER_MAX)) {
+    client->stop();
+    connectionState = MQTT_CONNECT_FAILED;
+    return false;
+  }
+
+  uint8_t header;
+  size_t length = readPacket(&header);
+  if (length == 0) {
+    client->stop();
+    connectionState = MQTT_CONNECTION_TIMEOUT;
+    return false;
+  }
+  if ((buffer[0] & 0xF0) != MQTTCONNACK || length < (size_t)header + 2 || buffer[header + 1] != 0) {
+    connectionState = (length >= (size_t)header + 2) ? buffer[header + 1] : MQTT_CONNECT_FAILED;
+    client->stop();
+    return false;
+  }
+  lastInActivity = lastOutActivity = millis();
+  pingOutstanding = false;
+  connectionState = MQTT_CONNECTED;
+  return true;
+}
+
+void PubSubClient::disconnect()
+{
+  if (!loopback && client->connected()) {
+    static const uint8_t packet[] = {MQTTDISCONNECT, 0x00};
+    client->write(packet, sizeof(packet));
+  }
+  client->stop();
+  connectionState = MQTT_DISCONNECTED;
+  lastInActivity = lastOutActivity = millis();
+}
+
+bool PubSubClient::connected()
+{
+  if (loopback) {
+    return connectionState == MQTT_CONNECTED;
+  }
+  if (client->connected()) {
+    return true;
+  }
+  if (connectionState == MQTT_CONNECTED) {
+    connectionState = MQTT_CONNECTION_LOST;
+    client->stop();
+  }
+  return false;
+}
+
+bool PubSubClient::publish(const char* topic, const char* payload)
+{
+  return publish(topic, (const uint8_t*)payload, payload != NULL ? strlen(payload) : 0);
+}
+
+bool PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int length)
+{
+  if (!connected()) {
+    return false;
+  }
+  size_t topicLength = strlen(topic);
+  if (MQTT_HEADER_MAX + 2 + topicLength + length > bufferSize) {
+    return false;   // too long for the buffer, as in the library
+  }
+  if (loopback) {
+    printf("MQTT > %s %.*s\n", topic, (int)length, (const char*)payload);
+    return true;
+  }
+  size_t pos = writeString(topic, MQTT_HEADER_MAX);
+  memcpy(buffer + pos, payload, length);
+  return sendPacket(MQTTPUBLISH, pos + length - MQTT_HEADER_MAX);
+}
+
+bool PubSubClient::subscribe(const char* topic)
+{
+  if (!connected()) {
+    return false;
+  }
+  subscription = topic;
+  if (loopback) {
+    return true;
+  }
+  size_t pos = MQTT_HEADER_MAX;
+  uint16_t id = nextPacketId++;
+  if (nextPacketId == 0) nextPacketId = 1;
+  buffer[pos++] = (uint8_t)(id >> 8);
+  buffer[pos++] = (uint8_t)id;
+  pos = writeString(topic, pos);
+  if (pos == 0 || pos + 1 > bufferSize) {
+    return false;
+  }
+  buffer[pos++] = 0;   // QoS 0
+  return sendPacket(MQTTSUBSCRIBE | 0x02, pos - MQTT_HEADER_MAX);
+}
+
+void PubSubClient::deliverLoopback()
+{
+  size_t length = 0;
+  {
+    std::lock_guard<std::mutex> guard(console.lock);
+    if (console.count == 0 || (long)(millis() - console.slots[console.head].dueMs) < 0) {
+      return;
+    }
+    LoopbackMessage& msg = console.slots[console.head];
+    size_t topicLength = subscription.length();
+    if (callback != NULL && MQTT_HEADER_MAX + 2 + topicLength + 1 + msg.length <= bufferSize) {
+      // Topic and payload laid out in the buffer as the library hands them over.
+      memcpy(buffer, subscription.c_str(), topicLength + 1);
+      memcpy(buffer + topicLength + 1, msg.payload, msg.length);
+      length = msg.length;
+    }
+    console.head = (console.head + 1) % LOOPBACK_SLOTS;
+    console.count--;
+    console.space.notify_one();
+  }
+  if (length > 0) {
+    callback((char*)buffer, buffer + subscription.length() + 1, length);
+  }
+}
+
+bool PubSubClient::loop()
+{
+  if (!connected()) {
+    return false;
+  }
+  if (loopback) {
+    deliverLoopback();
+    return true;
+  }
+  unsigned long now = millis();
+  const unsigned long keepAliveMs = MQTT_KEEPALIVE * 1000UL;
+  if (now - lastInActivity > keepAliveMs || now - lastOutActivity > keepAliveMs) {
+    if (pingOutstanding) {
+      connectionState = MQTT_CONNECTION_TIMEOUT;
+      client->stop();
+      return false;
+    }
+    static const uint8_t ping[] = {MQTTPINGREQ, 0x00};
+    client->write(ping, sizeof(ping));
+    lastOutActivity = lastInActivity = now;
+    pingOutstanding = true;
+  }
+  if (client->available()) {
+    uint8_t header;
+    size_t length = readPacket(&header);
+    if (length > 0) {
+      lastInActivity = millis();
+      uint8_t type = buffer[0] & 0xF0;
+      if (type == MQTTPUBLISH && callback != NULL && length >= (size_t)header + 2) {
+        // Move the topic one byte down to terminate it in place (QoS 0: no packet id).
+        size_t topicLength = ((size_t)buffer[header] << 8) | buffer[header + 1];
+        if (header + 2 + topicLength <= length) {
+          memmove(buffer + header + 1, buffer + header + 2, topicLength);
+          buffer[header + 1 + topicLength] = '\0';
+          char* topic = (char*)buffer + header + 1;
+          uint8_t* payload = buffer + header + 2 + topicLength;
+          callback(topic, payload, (unsigned int)(length - header - 2 - topicLength));
+        }
+      } else if (type == MQTTPINGREQ) {
+        static const uint8_t pong[] = {MQTTPINGRESP, 0x00};
+        client->write(pong, sizeof(pong));
+      } else if (type == MQTTPINGRESP) {
+        pingOutstanding = false;
+      }
+    } else if (!connected()) {
+      return false;
+    }
+  }
+  return true;
+}
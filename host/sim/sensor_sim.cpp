@@ -0,0 +1,200 @@
+// Host harness: drives the sensor sample hooks, and with them the mode 1 and mode 2
+// alarms, from a synthetic scenario or a recording in virtual time, as fast as the
+// host runs.
+//
+//   sensor_sim synth <scenario> <seconds> [imu Hz] [--record <file>]
+//   sensor_sim replay <recording>
+//
+// Samples go through sensorFeedRecord(), the path of the on-board replay, with their
+// own timestamps instead of the clock, so a run gives the same alarm transitions every
+// time. Scenarios are numbered as for the Synth telecommand; the BME280 and voltages
+// are sampled at their task periods. --record also writes the samples as a recording
+// (SensorLog format, like the Record telecommand) that `replay` feeds back.
+//
+// Prints every alarm transition with its virtual time, then the samples fed and the
+// speed-up over real time.
+
+#include <Arduino.h>
+#include "TaskTable.h"
+#include "alarms/AlarmEngine.h"
+#include "modes/mode1.h"
+#include "modes/mode2.h"
+#include "sensors/SensorSource.h"
+#include "state/StateRegistry.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define DEFAULT_IMU_HZ 1000
+
+static unsigned long samplesFed = 0;
+static uint32_t virtualMs = 0;
+static FILE* recordFile = NULL;
+static uint32_t recordLastMs = 0;
+
+static void printAlarmEvents() {
+  AlarmEvent event;
+  while (alarmPollEvent(&event)) {
+    printf("%9.3f s  %s %s (%.2f)\n", event.timestampMs / 1000.0,
+           alarmName(event.id), alarmStateName(event.state), event.value);
+  }
+}
+
+static void feed(const SensorRecord& rec) {
+  sensorFeedRecord(rec);
+  samplesFed++;
+  virtualMs = rec.timestampMs;
+  printAlarmEvents();
+  if (recordFile != NULL) {
+    uint8_t encoded[SENSOR_LOG_MAX_RECORD];
+    size_t length = sensorLogEncode(rec, &recordLastMs, encoded);
+    fwrite(encoded, 1, length, recordFile);
+  }
+}
+
+// Feeds the scenario's samples of every sensor in time order.
+static bool runSynth(SynthScenario scenario, uint32_t seconds, uint32_t imuHz) {
+  SynthGenerator gen;
+  synthStart(&gen, scenario, 0, scenario);
+
+  const uint64_t endUs = (uint64_t)seconds * 1000000;
+  const uint64_t periodUs[3] = {
+    1000000 / imuHz,
+    (uint64_t)TASK_PERIOD_MS(TASK_BME280) * 1000,
+    (uint64_t)TASK_PERIOD_MS(TASK_VOLTAGE) * 1000
+  };
+  uint64_t nextUs[3] = {0, 0, 0};
+  for (;;) {
+    int sensor = 0;
+    for (int i = 1; i < 3; i++) {
+      if (nextUs[i] < nextUs[sensor]) sensor = i;
+    }
+    const uint64_t nowUs = nextUs[sensor];
+    if (nowUs >= endUs) {
+      return true;
+    }
+    nextUs[sensor] += periodUs[sensor];
+
+    SensorRecord rec;
+    rec.timestampMs = (uint32_t)(nowUs / 1000);
+    if (sensor == 0) {
+      rec.type = SENSOR_REC_IMU;
+      synthImu(&gen, nowUs, &rec.imu);
+    } else if (sensor == 1) {
+      rec.type = SENSOR_REC_ENV;
+      synthEnv(&gen, nowUs, &rec.env);
+    } else {
+      rec.type = SENSOR_REC_POWER;
+      synthPower(&gen, nowUs, &rec.power);
+    }
+    feed(rec);
+  }
+}
+
+// Feeds every record of a recording in order.
+static bool runReplay(const char* path) {
+  FILE* f = fopen(path, "rb");
+  if (f == NULL) {
+    fprintf(stderr, "cannot read %s\n", path);
+    return false;
+  }
+  std::vector<uint8_t> data;
+  uint8_t buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+    data.insert(data.end(), buffer, buffer + n);
+  }
+  fclose(f);
+  if (data.size() < SENSOR_LOG_MAGIC_LEN ||
+      memcmp(data.data(), SENSOR_LOG_MAGIC, SENSOR_LOG_MAGIC_LEN) != 0) {
+    fprintf(stderr, "%s is not a sensor recording\n", path);
+    return false;
+  }
+
+  // The recorder starts the delta chain at its start time; the first record is taken
+  // as time zero, as the on-board replay does.
+  size_t pos = SENSOR_LOG_MAGIC_LEN;
+  uint32_t lastMs = 0;
+  bool first = true;
+  uint32_t firstMs = 0;
+  SensorRecord rec;
+  while (pos < data.size()) {
+    size_t used = sensorLogDecode(data.data() + pos, data.size() - pos, &lastMs, &rec);
+    if (used == 0) {
+      fprintf(stderr, "%s: invalid record at byte %zu\n", path, pos);
+      return false;
+    }
+    pos += used;
+    if (rec.type == SENSOR_REC_TIME) {
+      continue;
+    }
+    if (first) {
+      firstMs = rec.timestampMs;
+      first = false;
+    }
+    rec.timestampMs -= firstMs;
+    feed(rec);
+  }
+  return true;
+}
+
+static int usage(const char* argv0) {
+  fprintf(stderr, "usage: %s synth <scenario> <seconds> [imu Hz] [--record <file>]\n"
+                  "       %s replay <recording>\n", argv0, argv0);
+  return 2;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    return usage(argv[0]);
+  }
+
+  // The mode 1 and mode 2 alarms, as on entering the modes, at the registry defaults.
+  stateInit();
+  stateSetFloat(STATE_INIT_PRESSURE, 1013.25f);
+  mode1().onEnter();
+  mode2().onEnter();
+
+  const auto start = std::chrono::steady_clock::now();
+  bool ok;
+  if (strcmp(argv[1], "synth") == 0 && argc >= 4) {
+    const int scenario = atoi(argv[2]);
+    const long seconds = atol(argv[3]);
+    long imuHz = DEFAULT_IMU_HZ;
+    for (int i = 4; i < argc; i++) {
+      if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+        recordFile = fopen(argv[++i], "wb");
+        if (recordFile == NULL) {
+          fprintf(stderr, "cannot write %s\n", argv[i]);
+          return 1;
+        }
+        fwrite(SENSOR_LOG_MAGIC, 1, SENSOR_LOG_MAGIC_LEN, recordFile);
+      } else {
+        imuHz = atol(argv[i]);
+      }
+    }
+    if (scenario <= SYNTH_OFF || scenario >= SYNTH_SCENARIO_COUNT || seconds <= 0 ||
+        imuHz <= 0 || imuHz > 1000000) {
+      return usage(argv[0]);
+    }
+    ok = runSynth((SynthScenario)scenario, (uint32_t)seconds, (uint32_t)imuHz);
+    if (recordFile != NULL && fclose(recordFile) != 0) {
+      fprintf(stderr, "cannot write the recording\n");
+      ok = false;
+    }
+  } else if (strcmp(argv[1], "replay") == 0) {
+    ok = runReplay(argv[2]);
+  } else {
+    return usage(argv[0]);
+  }
+  if (!ok) {
+    return 1;
+  }
+
+  const double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("%lu samples, %.3f s of sensor time in %.3f s (%.0fx real time)\n",
+         samplesFed, virtualMs / 1000.0, wallS, wallS > 0 ? virtualMs / 1000.0 / wallS : 0.0);
+  return 0;
+}
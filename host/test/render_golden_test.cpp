@@ -0,0 +1,201 @@
+// Host render test: draws every DisplayMode from fixed display models and compares
+// the frames with the golden PBM images checked in under test/golden.
+//
+//   render_golden_test <golden dir> [--update]
+//
+// The display module runs unchanged: the models are written through its public API,
+// the display task renders them into the SSD1306 framebuffer, and each frame is taken
+// with requestDisplayFrameDump(). The comment line of a dump (render time) is not
+// compared. A frame that differs is written to the working directory as
+// <name>.actual.pbm; --update rewrites the golden images instead.
+
+#include "display.h"
+#include <atomic>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+// Lines of a frame dump: "P1", the comment, the size and one per pixel row.
+#define DUMP_LINES (3 + 64)
+#define DUMP_TIMEOUT_MS 2000
+
+static int failures = 0;
+static bool update = false;
+static std::string goldenDir;
+
+// Collects one frame dump written by the display task.
+class FrameCapture : public Print {
+public:
+  size_t write(uint8_t c) override {
+    if (c == '\r') return 1;
+    text += (char)c;
+    if (c == '\n') lines.fetch_add(1, std::memory_order_release);
+    return 1;
+  }
+
+  bool complete() const { return lines.load(std::memory_order_acquire) >= DUMP_LINES; }
+
+  // The dump without its comment lines.
+  std::string image() const {
+    std::string out;
+    size_t pos = 0;
+    while (pos < text.size()) {
+      size_t end = text.find('\n', pos);
+      if (end == std::string::npos) end = text.size() - 1;
+      if (text[pos] != '#') out.append(text, pos, end - pos + 1);
+      pos = end + 1;
+    }
+    return out;
+  }
+
+  std::string text;
+  std::atomic<int> lines{0};
+};
+
+static bool readFile(const std::string& path, std::string* content) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (f == NULL) return false;
+  char buffer[4096];
+  size_t n;
+  content->clear();
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) content->append(buffer, n);
+  fclose(f);
+  return true;
+}
+
+static bool writeFile(const std::string& path, const std::string& content) {
+  FILE* f = fopen(path.c_str(), "wb");
+  if (f == NULL) return false;
+  bool ok = fwrite(content.data(), 1, content.size(), f) == content.size();
+  return fclose(f) == 0 && ok;
+}
+
+// Pixels that differ between two P1 images of the same size.
+static int countDiffs(const std::string& a, const std::string& b) {
+  int diffs = 0;
+  for (size_t i = 0; i < a.size() && i < b.size(); i++) {
+    if (a[i] != b[i]) diffs++;
+  }
+  return diffs;
+}
+
+// Dumps the next frame and compares it with <golden dir>/<name>.pbm.
+static void checkFrame(const char* name) {
+  FrameCapture capture;
+  requestDisplayFrameDump(capture);
+  for (int waited = 0; !capture.complete() && waited < DUMP_TIMEOUT_MS; waited += 10) {
+    delay(10);
+  }
+  if (!capture.complete()) {
+    fprintf(stderr, "%s: no frame dumped within %d ms\n", name, DUMP_TIMEOUT_MS);
+    failures++;
+    return;
+  }
+
+  const std::string actual = capture.image();
+  const std::string path = goldenDir + "/" + name + ".pbm";
+  if (update) {
+    if (!writeFile(path, actual)) {
+      fprintf(stderr, "%s: cannot write %s\n", name, path.c_str());
+      failures++;
+    } else {
+      printf("%s: updated\n", name);
+    }
+    return;
+  }
+
+  std::string golden;
+  if (!readFile(path, &golden)) {
+    fprintf(stderr, "%s: cannot read %s\n", name, path.c_str());
+    failures++;
+    return;
+  }
+  if (golden != actual) {
+    const std::string actualPath = std::string(name) + ".actual.pbm";
+    writeFile(actualPath, actual);
+    fprintf(stderr, "%s: frame differs from the golden image (%d pixels, %zu/%zu bytes), see %s\n",
+            name, countDiffs(golden, actual), actual.size(), golden.size(), actualPath.c_str());
+    failures++;
+    return;
+  }
+  printf("%s: ok\n", name);
+}
+
+static void renderTable() {
+  setDisplayMode(TABLE_MODE);
+  const TableEntry entries[] = {
+    {TABLE_LABEL_MODE, 1, TABLE_UNIT_NONE},
+    {TABLE_LABEL_MAGNITUDE, 9.81f, TABLE_UNIT_ACCEL},
+    {TABLE_LABEL_INIT_PRES, 1013.25f, TABLE_UNIT_HPA},
+    {TABLE_LABEL_THRESHOLD_PRES, 1012.5f, TABLE_UNIT_HPA},
+    {TABLE_LABEL_GRAVITY_ALARM_AT, 0, TABLE_UNIT_READY},
+    {TABLE_LABEL_LED_RED, 0, TABLE_UNIT_BLINKING},
+  };
+  updateTableData(entries, sizeof(entries) / sizeof(entries[0]));
+  checkFrame("table");
+
+  const char* const lines[] = {"Alarm: pressure", "Temp 21.4 C", "Humi 43.0 %", "RSSI -55 dBm"};
+  updateTableLines(lines, sizeof(lines) / sizeof(lines[0]));
+  checkFrame("table_lines");
+}
+
+static void renderHorizon() {
+  setDisplayMode(ARTIFICIAL_HORIZON_MODE);
+  updateHorizonData(0.0f, 0.0f);
+  checkFrame("horizon_level");
+  updateHorizonData(12.0f, -30.0f);
+  checkFrame("horizon_bank");
+}
+
+// Deterministic test signals, one per channel.
+static float signal(int ch, int i) {
+  switch (ch) {
+    case 0:  return sinf(i * 0.1f) * 2.0f;
+    case 1:  return 40.0f + i * 0.02f + ((i / 25) % 2) * 3.0f;
+    default: return 25.0f + sinf(i * 0.03f) * 0.5f + (i % 7) * 0.1f;
+  }
+}
+
+static void renderPlot() {
+  setDisplayMode(ROLLING_PLOT_MODE);
+  for (int i = 0; i < 200; i++) {
+    updateRollingPlotData(signal(0, i), i * 0.2f, "Time (s)", "AccelX");
+  }
+  checkFrame("plot_single");
+
+  const char* const labels[3] = {"AccelX", "Humi", "Temp"};
+  const PlotLayout layouts[2] = {PLOT_STACKED, PLOT_OVERLAY};
+  const char* const names[2] = {"plot_stacked", "plot_overlay"};
+  for (int l = 0; l < 2; l++) {
+    configureRollingPlot(3, labels, "Time (s)", layouts[l]);
+    // More samples than the history holds, so the oldest are evicted.
+    for (int i = 0; i < 700; i++) {
+      const float values[3] = {signal(0, i), signal(1, i), signal(2, i)};
+      updateRollingPlotSamples(values, i * 0.2f);
+    }
+    checkFrame(names[l]);
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <golden dir> [--update]\n", argv[0]);
+    return 2;
+  }
+  goldenDir = argv[1];
+  update = (argc > 2 && strcmp(argv[2], "--update") == 0);
+
+  displayInit();
+  startDisplayTask(TABLE_MODE);
+
+  renderTable();
+  renderHorizon();
+  renderPlot();
+
+  if (failures != 0) {
+    fprintf(stderr, "%d frame(s) failed\n", failures);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,140 @@
+// Host test of the telecommand parser: every command form, number parsing and the
+// message hash.
+
+#include "telecommand_parser.h"
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                 \
+  do {                                                              \
+    if (!(cond)) {                                                  \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                   \
+    }                                                               \
+  } while (0)
+
+static Telecommand parse(const char* text, bool* ok = NULL) {
+  Telecommand tc;
+  bool result = parseTelecommand((const uint8_t*)text, strlen(text), &tc);
+  if (ok != NULL) *ok = result;
+  return tc;
+}
+
+static void testHash() {
+  // djb2 of "" is the seed, of "a" 5381 * 33 + 'a'.
+  CHECK(djb2Hash((const uint8_t*)"", 0) == 5381u);
+  CHECK(djb2Hash((const uint8_t*)"a", 1) == 5381u * 33u + 'a');
+  // Continuing a hash equals hashing the concatenation.
+  uint32_t part = djb2Hash((const uint8_t*)"Set", 3);
+  CHECK(djb2Hash((const uint8_t*)"Mode:1", 6, part) == djb2Hash((const uint8_t*)"SetMode:1", 9));
+  Telecommand tc = parse("SetMode:1");
+  CHECK(tc.hash == djb2Hash((const uint8_t*)"SetMode:1", 9));
+}
+
+static void testNumbers() {
+  CHECK(parse("SetMode:3").value == 3);
+  CHECK(parse("SetMode: 4 ").value == 4);
+  CHECK(parse("SetMode:-2").value == -2);
+  CHECK(parse("SetMode:+5").value == 5);
+  CHECK(parse("SetMode:").value == 0);
+  CHECK(parse("SetMode:x").value == 0);
+  CHECK(parse("SetMode:12abc").value == 12);
+  CHECK(parse("SetMode:99999999999").value == INT32_MAX);
+  // The number ends at the message length, not at a NUL.
+  Telecommand tc;
+  CHECK(parseTelecommand((const uint8_t*)"SetMode:123", 9, &tc));
+  CHECK(tc.value == 1);
+}
+
+static void testSingleValueCommands() {
+  struct { const char* text; TelecommandType type; int32_t value; } cases[] = {
+    {"SetMode:2", TC_SET_MODE, 2},
+    {"SetDefaultMode:5", TC_SET_DEFAULT_MODE, 5},
+    {"SetProfile:10", TC_SET_PROFILE, 10},
+    {"DumpFrame", TC_DUMP_FRAME, 0},
+    {"Record:30", TC_RECORD, 30},
+    {"Record:0", TC_RECORD, 0},
+    {"Replay", TC_REPLAY, 0},
+    {"Synth:2", TC_SYNTH, 2},
+    {"Bench", TC_BENCH, 0},
+    {"Trace:1", TC_TRACE, 1},
+    {"AllocGuard:1", TC_ALLOC_GUARD, 1},
+    {"SetKeyframe:10", TC_SET_KEYFRAME, 10},
+    {"Subscribe:15", TC_SUBSCRIBE, 15},
+  };
+  for (const auto& c : cases) {
+    bool ok = false;
+    Telecommand tc = parse(c.text, &ok);
+    CHECK(ok);
+    CHECK(tc.type == c.type);
+    CHECK(tc.value == c.value);
+    CHECK(tc.arg == 0);
+    CHECK(tc.data == NULL);
+    CHECK(tc.dataLength == 0);
+  }
+}
+
+static void testValueArgCommands() {
+  Telecommand tc = parse("Fault:2:500");
+  CHECK(tc.type == TC_FAULT);
+  CHECK(tc.value == 2);
+  CHECK(tc.arg == 500);
+
+  tc = parse("Fault:1");
+  CHECK(tc.type == TC_FAULT);
+  CHECK(tc.value == 1);
+  CHECK(tc.arg == 0);
+
+  tc = parse("SetRate:2:250");
+  CHECK(tc.type == TC_SET_RATE);
+  CHECK(tc.value == 2);
+  CHECK(tc.arg == 250);
+}
+
+static void testPacket() {
+  static const uint8_t msg[] = {'P', 'a', 'c', 'k', 'e', 't', 'I', 'D', ':', '7', ':', 0x00, 0xFF, ':'};
+  Telecommand tc;
+  CHECK(parseTelecommand(msg, sizeof(msg), &tc));
+  CHECK(tc.type == TC_PACKET);
+  CHECK(tc.value == 7);
+  CHECK(tc.data == msg + 11);
+  CHECK(tc.dataLength == 3);
+
+  tc = parse("PacketID:3:");
+  CHECK(tc.type == TC_PACKET);
+  CHECK(tc.dataLength == 0);
+
+  // Without the data separator the packet is malformed.
+  bool ok = true;
+  tc = parse("PacketID:3", &ok);
+  CHECK(!ok);
+  CHECK(tc.type == TC_UNKNOWN);
+}
+
+static void testUnknown() {
+  const char* cases[] = {"", "SetMode", "setmode:1", "Hello", "SetMod:1"};
+  for (const char* text : cases) {
+    bool ok = true;
+    Telecommand tc = parse(text, &ok);
+    CHECK(!ok);
+    CHECK(tc.type == TC_UNKNOWN);
+    CHECK(tc.value == 0);
+  }
+}
+
+int main() {
+  testHash();
+  testNumbers();
+  testSingleValueCommands();
+  testValueArgCommands();
+  testPacket();
+  testUnknown();
+  if (failures != 0) {
+    fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("telecommand_parser_test: all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file ChannelTable.h
+ * @brief Compile-time table of the telemetry channels.
+ *
+ * Every value the firmware reports (sensor readings, supply voltages, mode, RSSI) is
+ * declared here once with its name, group, unit, scale, precision and source. The
+ * telemetry serializer, the OLED table views and the rolling plot all take them from
+ * this table, so adding or renaming a channel is a one-line change.
+ *
+ * The JSON keys are the channel names, nested in an object per named group, in table
+ * order: {"mode":1,"voltages":{"BattVolt":4.10,...},"IMU":{...},"BME":{...},"WiFiRSSI":-60}.
+ *
+ * Each group is published at its own period and only while subscribed (registry
+ * fields STATE_PERIOD_* and STATE_TELEMETRY_GROUPS); a packet carries the groups due
+ * at that time.
+ *
+ * Report by exception: with a keyframe interval above 1, every group is sent in full
+ * (keyframe) once every interval sends of that group. In between only the channels
+ * that moved more than their deadband away from the group's last keyframe are sent,
+ * and a group without such channels is left out. "kf" holds the bit mask
+ * (1 << ChannelGroup) of the groups sent in full, and "ks" the sequence number of the
+ * latest keyframe of every group, indexed by ChannelGroup (counting from 1 and wrapping
+ * at 65536): {"kf":1,"ks":[5,2,2,2],"mode":1,...}. A receiver needs the last keyframe
+ * of each group and the current packet, so a lost delta packet does not hide a change.
+ * A lost keyframe does: the deltas are then taken against a keyframe the receiver never
+ * got. It shows as a "ks" entry that differs from the sequence number of the keyframe
+ * the receiver holds, and the channels of that group are unknown until the next one.
+ */
+
+#ifndef CHANNELTABLE_H
+#define CHANNELTABLE_H
+
+#include <Arduino.h>
+#include "display.h"   // TableUnit, TABLE_CELL_LEN
+#include "state/StateRegistry.h"
+#include "sensors/IMU.h"   // IMUEvents_t
+
+// X(id, JSON object name; NULL = top level, registry field holding the period in ms)
+#define CHANNEL_GROUP_TABLE(X) \
+  X(CH_GROUP_STATUS,   NULL, STATE_PERIOD_STATUS)\
+  X(CH_GROUP_VOLTAGES, "voltages", STATE_PERIOD_VOLTAGES)\
+  X(CH_GROUP_IMU,      "IMU", STATE_PERIOD_IMU)\
+  X(CH_GROUP_BME,      "BME",      STATE_PERIOD_BME)
+
+// X(id, name, group, unit, scale, precision, deadband, source)
+// The channel value is source(snapshot) * scale, sent and shown with `precision`
+// decimals (sources in ChannelTable.cpp). Between keyframes a channel is only sent
+// once it differs from its keyframe value by more than `deadband` (0: any change).
+// The channels of a named group must be adjacent, as they share one JSON object;
+// top-level (NULL) groups may be split, as CH_GROUP_STATUS is.
+#define CHANNEL_TABLE(X) \
+  X(CH_MODE,      "mode",     CH_GROUP_STATUS,   TABLE_UNIT_NONE,    1.0f, 0, 0.0f,  readMode)     \
+  X(CH_BATT_VOLT, "BattVolt", CH_GROUP_VOLTAGES, TABLE_UNIT_VOLT,    1.0f, 2, 0.05f, readBattVolt) \
+  X(CH_BUS_VOLT,  "BusVolt",  CH_GROUP_VOLTAGES, TABLE_UNIT_VOLT,    1.0f, 2, 0.05f, readBusVolt)  \
+  X(CH_ACCEL_X,   "AccelX",   CH_GROUP_IMU,      TABLE_UNIT_ACCEL,   1.0f, 1, 0.2f,  readAccelX)   \
+  X(CH_ACCEL_Y,   "AccelY",   CH_GROUP_IMU,      TABLE_UNIT_ACCEL,   1.0f, 1, 0.2f,  readAccelY)   \
+  X(CH_ACCEL_Z,   "AccelZ",   CH_GROUP_IMU,      TABLE_UNIT_ACCEL,   1.0f, 1, 0.2f,  readAccelZ)   \
+  X(CH_GYRO_X,    "GyroX",    CH_GROUP_IMU,      TABLE_UNIT_RATE,    1.0f, 1, 0.1f,  readGyroX)    \
+  X(CH_GYRO_Y,    "GyroY",    CH_GROUP_IMU,      TABLE_UNIT_RATE,    1.0f, 1, 0.1f,  readGyroY)    \
+  X(CH_GYRO_Z,    "GyroZ",    CH_GROUP_IMU,      TABLE_UNIT_RATE,    1.0f, 1, 0.1f,  readGyroZ)    \
+  X(CH_IMU_TEMP,  "Temp",     CH_GROUP_IMU,      TABLE_UNIT_CELSIUS, 1.0f, 0, 1.0f,  readImuTemp)  \
+  X(CH_BME_TEMP,  "Temp",     CH_GROUP_BME,      TABLE_UNIT_CELSIUS, 1.0f, 0, 1.0f,  readBmeTemp)  \
+  X(CH_PRES,      "Pres",     CH_GROUP_BME,      TABLE_UNIT_HPA,     1.0f, 1, 0.2f,  readPres)     \
+  X(CH_HUMI,      "Humi",     CH_GROUP_BME,      TABLE_UNIT_PERCENT, 1.0f, 0, 1.0f,  readHumi)     \
+  X(CH_RSSI,      "WiFiRSSI", CH_GROUP_STATUS,   TABLE_UNIT_DBM,     1.0f, 0, 3.0f,  readRssi)
+
+/**
+ * @brief Identifiers of the groups in CHANNEL_GROUP_TABLE.
+ */
+enum ChannelGroup : uint8_t {
+#define CHANNEL_GROUP_ID(id, name, period) id,
+  CHANNEL_GROUP_TABLE(CHANNEL_GROUP_ID)
+#undef CHANNEL_GROUP_ID
+  CH_GROUP_COUNT
+};
+
+/// @brief Group mask with every group set.
+#define CH_GROUP_ALL ((1u << CH_GROUP_COUNT) - 1)
+
+/**
+ * @brief Identifiers of the channels in CHANNEL_TABLE.
+ */
+enum ChannelId : uint8_t {
+#define CHANNEL_TABLE_ID(id, name, group, unit, scale, precision, deadband, source) id,
+  CHANNEL_TABLE(CHANNEL_TABLE_ID)
+#undef CHANNEL_TABLE_ID
+  CHANNEL_COUNT
+};
+
+/**
+ * @brief Static description of one channel (the source is kept in ChannelTable.cpp).
+ */
+struct ChannelSpec {
+  const char* name;       ///< JSON key and table label.
+  ChannelGroup group;     ///< Group the channel is sent in.
+  TableUnit unit;         ///< Unit shown in table views and plot labels.
+  float scale;            ///< Factor applied to the source value.
+  uint8_t precision;      ///< Decimals sent and shown.
+  float deadband;         ///< Change from the keyframe value below which it is not sent.
+};
+
+/**
+ * @brief The channel table, indexed by ChannelId.
+ */
+static constexpr ChannelSpec channelTable[CHANNEL_COUNT] = {
+#define CHANNEL_TABLE_SPEC(id, name, group, unit, scale, precision, deadband, source) \
+  {name, group, unit, scale, precision, deadband},
+  CHANNEL_TABLE(CHANNEL_TABLE_SPEC)
+#undef CHANNEL_TABLE_SPEC
+};
+
+/**
+ * @brief JSON object names of the groups, indexed by ChannelGroup (NULL = top level).
+ */
+static constexpr const char* const channelGroupName[CH_GROUP_COUNT] = {
+#define CHANNEL_GROUP_NAME(id, name, period) name,
+  CHANNEL_GROUP_TABLE(CHANNEL_GROUP_NAME)
+#undef CHANNEL_GROUP_NAME
+};
+
+/**
+ * @brief Registry fields holding the publish period of each group, indexed by ChannelGroup.
+ */
+static constexpr StateId channelGroupPeriod[CH_GROUP_COUNT] = {
+#define CHANNEL_GROUP_PERIOD(id, name, period) period,
+  CHANNEL_GROUP_TABLE(CHANNEL_GROUP_PERIOD)
+#undef CHANNEL_GROUP_PERIOD
+};
+
+/**
+ * @brief Report-by-exception state of one telemetry stream.
+ *
+ * Zero-initialized, the first send of every group is a keyframe.
+ */
+struct ChannelReporter {
+  uint32_t keyframeInterval;                ///< Sends per keyframe; 0 or 1 sends every group in full.
+  uint32_t framesToKeyframe[CH_GROUP_COUNT];///< Delta sends of each group left before its next keyframe.
+  float keyframe[CHANNEL_COUNT];            ///< Values sent in the last keyframe of their group.
+  uint16_t keyframeSeq[CH_GROUP_COUNT];     ///< Sequence number of the last keyframe of each group.
+};
+
+/**
+ * @brief Sensor samples shared by the channels read in one pass (a telemetry packet,
+ *        a table view, a plot sample).
+ *
+ * The IMU sample is taken on the first IMU channel of the pass and reused by the
+ * others, so they all come from one sample and one lock of the IMU data. Use a new
+ * snapshot for every pass.
+ */
+struct ChannelSnapshot {
+  IMUEvents_t imu;     ///< IMU sample of the pass, valid if imuTaken.
+  bool imuTaken;       ///< imu has been taken.
+
+  ChannelSnapshot() : imuTaken(false) {}
+  /// @brief Pass on a sample the caller already holds.
+  explicit ChannelSnapshot(const IMUEvents_t& sample) : imu(sample), imuTaken(true) {}
+};
+
+/**
+ * @brief Reads the current value of a channel (source value times scale) as part of
+ *        a pass over several channels.
+ */
+float channelRead(ChannelId id, ChannelSnapshot& snapshot);
+
+/**
+ * @brief Reads the current value of a single channel.
+ */
+float channelRead(ChannelId id);
+
+/**
+ * @brief Appends the channels of the given groups as JSON members, without the
+ *        enclosing braces.
+ *
+ * @param payload String to append to.
+ * @param reporter Report-by-exception state, updated; NULL sends the groups in full.
+ * @param groups Groups to send (bit 1 << ChannelGroup each).
+ */
+void appendChannelsJson(String& payload, ChannelReporter* reporter, uint32_t groups);
+
+/**
+ * @brief Formats a channel as a table line "<name>: <value> <unit>" (no heap use).
+ *
+ * @param snapshot Samples of the table view the line belongs to.
+ */
+void formatChannelCell(char cell[TABLE_CELL_LEN], ChannelId id, ChannelSnapshot& snapshot);
+
+/**
+ * @brief Shows the given channels as TABLE_MODE lines, one per channel.
+ *
+ * @param ids Channels to show.
+ * @param count Number of channels.
+ */
+void updateChannelTable(const ChannelId* ids, int count);
+
+/**
+ * @brief Formats a channel's plot label "<name> <unit>".
+ *
+ * @param label Destination buffer.
+ * @param size Size of the buffer.
+ * @param id Channel.
+ */
+void formatChannelLabel(char* label, size_t size, ChannelId id);
+
+#endif // CHANNELTABLE_H
@@ -10,8 +10,10 @@
 
 #include <Arduino.h>
 #include "arduino_secrets.h"
+#include <atomic>
 
 #define MQTT_MSG_MAX_LEN 170  // maximum payload bytes
+#define MQTT_TM_BUFFER_SIZE 1536  // MQTT packet buffer, fits the largest telemetry message
 
 /**
  * @brief Initializes WiFi, connects to MQTT broker, and starts the MQTT background task.
@@ -30,6 +32,48 @@ void initMqttTask();
 // Call this from main.cpp to publish a message via MQTT.
 void publishMqttMessage(const String &message);
 
+/**
+ * @brief Counters of the network path since boot, for soak tests and profile telemetry.
+ */
+struct MqttStats {
+  uint32_t published;        ///< Messages handed to the broker connection.
+  uint32_t publishFailed;    ///< Publish calls that failed (connection lost while sending, too large).
+  uint32_t publishDropped;   ///< Messages not sent: not connected, or connection busy for too long.
+  uint32_t publishP50Us;     ///< Median duration of a publish call, in us.
+  uint32_t publishP95Us;     ///< 95th percentile duration of a publish call, in us.
+  uint32_t publishP99Us;     ///< 99th percentile duration of a publish call, in us.
+  uint32_t publishMaxUs;     ///< Longest publish call, in us.
+  uint32_t received;         ///< Telecommands accepted.
+  uint32_t rxOversize;       ///< Telecommands rejected as longer than MQTT_MSG_MAX_LEN.
+  uint32_t rxOverrun;        ///< Telecommands dropped while the previous one was unprocessed.
+  uint32_t reconnects;       ///< Reconnections after a lost connection.
+  uint32_t reconnectMsLast;  ///< Time the connection was down before the last reconnection, in ms.
+  uint32_t reconnectMsMax;   ///< Longest time the connection was down, in ms.
+};
+
+/**
+ * @brief Returns a snapshot of the network path counters.
+ */
+MqttStats getMqttStats();
+
+/**
+ * @brief Faults that can be injected into the network path (Fault telecommand).
+ */
+enum MqttFault : uint8_t {
+  MQTT_FAULT_DISCONNECT = 1,  ///< Drops the broker connection; the MQTT task reconnects.
+  MQTT_FAULT_STALL = 2,       ///< Holds the connection, as a broker that stops answering.
+  MQTT_FAULT_OVERSIZE = 3     ///< Feeds a telecommand one byte over MQTT_MSG_MAX_LEN.
+};
+
+/**
+ * @brief Requests a fault; the MQTT task applies it on its next loop.
+ * 
+ * @param fault Fault to inject.
+ * @param durationMs Stall duration for MQTT_FAULT_STALL (max 60 s), ignored otherwise.
+ * @return false if the MQTT task is not running or the fault is unknown.
+ */
+bool mqttInjectFault(MqttFault fault, uint32_t durationMs);
+
 
 
 
@@ -68,11 +112,14 @@ extern bool mqttConnectionFailed;
 extern uint8_t inboundMessage[MQTT_MSG_MAX_LEN];
 
 /**
- * @brief True if a new inbound message has been received and is ready to process.
+ * @brief True while inboundMessage holds a message for the inbound task.
+ *
+ * Hands the buffer over between mqttCallback() and the inbound task: the callback
+ * writes the message, then stores true (release); the task loads it (acquire),
+ * processes the message and stores false (release) once it no longer reads the
+ * buffer, which the callback loads (acquire) before writing the next one.
  */
-
-// Optional flag to indicate a new message has been received
-extern bool newMessageAvailable;
+extern std::atomic<bool> newMessageAvailable;
 
 /**
  * @brief Number of bytes received in the latest inbound MQTT message.
@@ -81,4 +128,9 @@ extern bool newMessageAvailable;
 // Global variable to track the number of bytes received
 extern size_t inboundMessageLength;
 
+/**
+ * @brief micros() when the latest inbound message was received (see diagnostics/Latency.h).
+ */
+extern uint32_t inboundMessageUs;
+
 #endif // MQTTTASK_H
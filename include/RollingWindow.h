@@ -0,0 +1,113 @@
+/**
+ * @file RollingWindow.h
+ * @brief Fixed-capacity circular sample buffer with running min/max tracking.
+ *
+ * Used as the history store of the rolling plot. Inserting a sample and querying
+ * the minimum or maximum of the window are amortized O(1): two monotonic deques of
+ * sample sequence numbers are maintained alongside the ring, so the axis range never
+ * needs a rescan of the whole history.
+ */
+
+#ifndef ROLLINGWINDOW_H
+#define ROLLINGWINDOW_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Circular buffer of the last N samples with O(1) minimum() and maximum().
+ *
+ * @tparam T Sample type (must be copyable and comparable with <).
+ * @tparam N Capacity; must be a power of two so sequence numbers wrap cleanly.
+ */
+template <typename T, size_t N>
+class RollingWindow {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "RollingWindow capacity must be a power of two");
+
+public:
+  RollingWindow() { clear(); }
+
+  /**
+   * @brief Removes all samples.
+   */
+  void clear() {
+    next = 0;
+    count = 0;
+    minQ.reset();
+    maxQ.reset();
+  }
+
+  /**
+   * @brief Appends a sample, dropping the oldest one once the window is full.
+   *
+   * @param value New sample.
+   */
+  void push(const T& value) {
+    const uint32_t seq = next++;
+
+    // Drop sequence numbers that fall out of the window before their slot is reused.
+    while (!minQ.empty() && seq - minQ.front() >= N) minQ.popFront();
+    while (!maxQ.empty() && seq - maxQ.front() >= N) maxQ.popFront();
+
+    while (!minQ.empty() && !(data[minQ.back() & MASK] < value)) minQ.popBack();
+    while (!maxQ.empty() && !(value < data[maxQ.back() & MASK])) maxQ.popBack();
+
+    data[seq & MASK] = value;
+    minQ.pushBack(seq);
+    maxQ.pushBack(seq);
+    if (count < N) count++;
+  }
+
+  /// @brief Number of samples currently held (0..N).
+  size_t size() const { return count; }
+
+  /// @brief True once N samples have been pushed.
+  bool full() const { return count == N; }
+
+  /// @brief Maximum number of samples held.
+  static constexpr size_t capacity() { return N; }
+
+  /**
+   * @brief Returns a sample by age.
+   *
+   * @param i Index from 0 (oldest) to size() - 1 (newest).
+   */
+  const T& operator[](size_t i) const {
+    return data[(next - count + i) & MASK];
+  }
+
+  /// @brief Newest sample. Only valid when size() > 0.
+  const T& newest() const { return data[(next - 1) & MASK]; }
+
+  /// @brief Smallest sample in the window. Only valid when size() > 0.
+  const T& minimum() const { return data[minQ.front() & MASK]; }
+
+  /// @brief Largest sample in the window. Only valid when size() > 0.
+  const T& maximum() const { return data[maxQ.front() & MASK]; }
+
+private:
+  static constexpr uint32_t MASK = (uint32_t)(N - 1);
+
+  // Deque of sequence numbers in a circular array; never holds more than N entries.
+  struct SeqDeque {
+    uint32_t items[N];
+    uint32_t head;
+    uint32_t len;
+
+    void reset() { head = 0; len = 0; }
+    bool empty() const { return len == 0; }
+    uint32_t front() const { return items[head & MASK]; }
+    uint32_t back() const { return items[(head + len - 1) & MASK]; }
+    void popFront() { head++; len--; }
+    void popBack() { len--; }
+    void pushBack(uint32_t seq) { items[(head + len) & MASK] = seq; len++; }
+  };
+
+  T data[N];
+  uint32_t next;   // sequence number of the next sample
+  size_t count;
+  SeqDeque minQ;
+  SeqDeque maxQ;
+};
+
+#endif // ROLLINGWINDOW_H
@@ -0,0 +1,97 @@
+/**
+ * @file TaskTable.h
+ * @brief Compile-time table of all FreeRTOS tasks of the firmware.
+ * 
+ * Every task's core, priority, stack size and nominal period are declared here in one
+ * place, and all tasks are created from this table with statically allocated stacks.
+ * 
+ * Placement on the ESP32-S3:
+ * - Core 1 (APP CPU): acquisition (IMU, BME280, voltages, touch) at the highest
+ *   priorities, then alarm outputs and the mode logic, then the display.
+ * - Core 0 (PRO CPU, shared with the WiFi/lwIP stack): telemetry, telecommands and MQTT,
+ *   and the on-demand benchmarks (created on the first Bench telecommand).
+ */
+
+#ifndef TASKTABLE_H
+#define TASKTABLE_H
+
+#include <Arduino.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/// @brief Core running the WiFi stack and the network tasks.
+#define TASK_CORE_NETWORK 0
+/// @brief Core running acquisition, UI and mode logic.
+#define TASK_CORE_APP 1
+
+// X(id, name, core, priority, stack bytes, period ms; 0 = event driven)
+// TouchTask is interrupt driven; its period is the scan rate while a pad is active.
+// SensorTask samples the task profile at its period; the telemetry groups have their
+// own periods (STATE_PERIOD_* in state/StateRegistry.h).
+#define TASK_TABLE(X) \
+  X(TASK_IMU,        "IMUTask",       TASK_CORE_APP,     5, 3072, 500)  \
+  X(TASK_BME280,     "BME280Task",    TASK_CORE_APP,     5, 3072, 100)  \
+  X(TASK_VOLTAGE,    "VoltageTask",   TASK_CORE_APP,     4, 2048, 1000) \
+  X(TASK_TOUCH,      "TouchTask",     TASK_CORE_APP,     4, 2048, 10)   \
+  X(TASK_BUZZER,     "BuzzerTask",    TASK_CORE_APP,     3, 2048, 0)    \
+  X(TASK_LED,        "LedTask",       TASK_CORE_APP,     3, 3072, 0)    \
+  X(TASK_MODE,       "ModeTask",      TASK_CORE_APP,     3, 4096, 0)    \
+  X(TASK_INPUT,      "PhysicalInput", TASK_CORE_APP,     3, 3072, 0)    \
+  X(TASK_DISPLAY,    "DisplayTask",   TASK_CORE_APP,     2, 4096, 0)    \
+  X(TASK_SENSOR_LOG, "SensorLogTask", TASK_CORE_APP,     1, 4096, 0)    \
+  X(TASK_TELEMETRY,  "SensorTask",    TASK_CORE_NETWORK, 2, 6144, 1000) \
+  X(TASK_INBOUND,    "InboundTask",   TASK_CORE_NETWORK, 2, 4096, 500)  \
+  X(TASK_MQTT,       "mqttLoopTask",  TASK_CORE_NETWORK, 1, 8192, 0)    \
+  X(TASK_BENCH,      "BenchTask",     TASK_CORE_NETWORK, 1, 4096, 0)
+
+/**
+ * @brief Identifiers of the tasks in TASK_TABLE.
+ */
+enum TaskId {
+#define TASK_TABLE_ID(id, name, core, priority, stack, period) id,
+  TASK_TABLE(TASK_TABLE_ID)
+#undef TASK_TABLE_ID
+  TASK_COUNT
+};
+
+/**
+ * @brief Static description of one task.
+ */
+struct TaskSpec {
+  const char* name;       ///< Task name.
+  BaseType_t core;        ///< Core the task is pinned to.
+  UBaseType_t priority;   ///< FreeRTOS priority.
+  uint32_t stackBytes;    ///< Stack size in bytes.
+  uint32_t periodMs;      ///< Nominal period; 0 if the task is event driven.
+};
+
+/**
+ * @brief The task table, indexed by TaskId.
+ */
+static constexpr TaskSpec taskTable[TASK_COUNT] = {
+#define TASK_TABLE_SPEC(id, name, core, priority, stack, period) {name, core, priority, stack, period},
+  TASK_TABLE(TASK_TABLE_SPEC)
+#undef TASK_TABLE_SPEC
+};
+
+/// @brief Nominal period of a task in milliseconds (compile-time constant).
+#define TASK_PERIOD_MS(id) (taskTable[id].periodMs)
+
+/**
+ * @brief Creates a task from the table with its static stack and control block.
+ * 
+ * Each table entry can be created once; later calls return the existing handle.
+ * 
+ * @param id Task to create.
+ * @param function Task function.
+ * @param parameter Parameter passed to the task function.
+ * @return TaskHandle_t Handle of the task.
+ */
+TaskHandle_t createTableTask(TaskId id, TaskFunction_t function, void* parameter);
+
+/**
+ * @brief Returns the handle of a task created from the table (NULL if not created yet).
+ */
+TaskHandle_t getTableTaskHandle(TaskId id);
+
+#endif // TASKTABLE_H
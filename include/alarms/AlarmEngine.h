@@ -0,0 +1,131 @@
+/**
+ * @file AlarmEngine.h
+ * @brief Threshold alarms with hysteresis, debounce, latching and rate-limited actions.
+ *
+ * Alarms are fed every sensor sample (from the sensor tasks' sample hooks), not a
+ * mode's display snapshot. Each alarm runs a small state machine:
+ *
+ *   CLEAR -> PENDING   value crosses the threshold
+ *   PENDING -> ACTIVE  value stayed beyond the threshold for the debounce time
+ *   ACTIVE -> CLEAR    value is back past threshold +/- hysteresis (auto-clear alarms)
+ *   ACTIVE -> LATCHED  same, for latching alarms; cleared by alarmAcknowledge()
+ *
+ * While ACTIVE, the alarm action runs at most once per action interval. Every change
+ * to or from ACTIVE/LATCHED is queued as a timestamped AlarmEvent for telemetry.
+ */
+
+#ifndef ALARMENGINE_H
+#define ALARMENGINE_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Alarms known to the engine.
+ */
+enum AlarmId : uint8_t {
+  ALARM_MICROGRAVITY,    ///< Acceleration magnitude below threshold (Mode 1).
+  ALARM_PRESSURE_DROP,   ///< Cabin pressure below threshold (Mode 2).
+  ALARM_COUNT
+};
+
+/**
+ * @brief State of an alarm.
+ */
+enum AlarmState : uint8_t {
+  ALARM_STATE_CLEAR,     ///< Condition not present.
+  ALARM_STATE_PENDING,   ///< Condition present, debounce time not yet elapsed.
+  ALARM_STATE_ACTIVE,    ///< Alarm raised.
+  ALARM_STATE_LATCHED    ///< Condition gone, alarm held until acknowledged.
+};
+
+/**
+ * @brief Side of the threshold that raises the alarm.
+ */
+enum AlarmDirection : uint8_t {
+  ALARM_BELOW,           ///< Raised when value < threshold.
+  ALARM_ABOVE            ///< Raised when value > threshold.
+};
+
+/**
+ * @brief Static configuration of one alarm.
+ */
+struct AlarmConfig {
+  const char* name;               ///< Name used in telemetry.
+  AlarmDirection direction;       ///< Side of the threshold that raises the alarm.
+  float threshold;                ///< Raise threshold.
+  float hysteresis;               ///< Clears only once the value is this far back past the threshold.
+  uint16_t debounceMs;            ///< Time the condition must hold before the alarm is raised.
+  bool latch;                     ///< Hold the alarm after the condition clears, until acknowledged.
+  uint16_t actionIntervalMs;      ///< Minimum time between repeated actions while ACTIVE.
+  void (*action)(AlarmId id);     ///< Action (buzzer, LEDs); called from the feeding task.
+};
+
+/**
+ * @brief Timestamped alarm state transition, as reported in telemetry.
+ */
+struct AlarmEvent {
+  AlarmId id;
+  AlarmState state;               ///< New state (ACTIVE, LATCHED or CLEAR).
+  float value;                    ///< Sample that caused the transition.
+  uint32_t timestampMs;           ///< Sample time (millis()).
+};
+
+/**
+ * @brief Configures an alarm and resets it to CLEAR. The alarm starts disabled.
+ *
+ * Call from one task only (the mode task); the first call also creates the event queue.
+ */
+void alarmConfigure(AlarmId id, const AlarmConfig& config);
+
+/**
+ * @brief Enables or disables evaluation of an alarm.
+ *
+ * Disabling resets the alarm to CLEAR (reported if it was raised).
+ */
+void alarmEnable(AlarmId id, bool enabled);
+
+/**
+ * @brief Changes the raise threshold of an alarm without resetting its state.
+ */
+void alarmSetThreshold(AlarmId id, float threshold);
+
+/**
+ * @brief Evaluates one sample of the alarm's input signal.
+ *
+ * @param id Alarm to evaluate.
+ * @param value Sample value.
+ * @param timestampMs Sample time (millis()).
+ */
+void alarmFeed(AlarmId id, float value, uint32_t timestampMs);
+
+/**
+ * @brief Acknowledges an alarm.
+ *
+ * A LATCHED alarm clears; an ACTIVE alarm stops repeating its action until it clears.
+ */
+void alarmAcknowledge(AlarmId id);
+
+/**
+ * @brief Returns the current state of an alarm.
+ */
+AlarmState alarmGetState(AlarmId id);
+
+/**
+ * @brief Returns the configured name of an alarm ("" if not configured).
+ */
+const char* alarmName(AlarmId id);
+
+/**
+ * @brief Returns a short name for a state ("CLEAR", "ACTIVE", ...).
+ */
+const char* alarmStateName(AlarmState state);
+
+/**
+ * @brief Takes the oldest unreported alarm transition.
+ *
+ * @param event Filled with the transition.
+ * @return true if an event was returned; false if none is pending.
+ */
+bool alarmPollEvent(AlarmEvent* event);
+
+#endif // ALARMENGINE_H
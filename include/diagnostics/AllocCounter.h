@@ -0,0 +1,172 @@
+/**
+ * @file AllocCounter.h
+ * @brief Heap allocation counters per task and call site, fragmentation and a
+ *        "no allocation after boot" guard.
+ * 
+ * Counts every heap allocation and free made through the ESP-IDF heap, including
+ * malloc() from Arduino String and operator new. Relies on the IDF heap hooks
+ * (CONFIG_HEAP_USE_HOOKS); without them the counters stay at zero and
+ * allocCounterAvailable() returns false.
+ * 
+ * Typical check: read getAllocCount() before and after a number of UI ticks;
+ * an unchanged value means the steady-state path did not touch the heap.
+ * 
+ * Allocations are also attributed to the allocating table task and to the call
+ * site the task has tagged with an AllocSiteScope (allocations made from an interrupt
+ * count for the interrupted task). Once the guard is armed, every allocation is a
+ * violation: counted, with the task, site and size of the last one kept.
+ */
+
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+#include <Arduino.h>
+#include "TaskTable.h"
+
+// X(id, name)
+#define ALLOC_SITE_TABLE(X) \
+  X(ALLOC_SITE_OTHER,       "other")       \
+  X(ALLOC_SITE_PAYLOAD,     "payload")     \
+  X(ALLOC_SITE_PROFILE,     "profile")     \
+  X(ALLOC_SITE_PUBLISH,     "publish")     \
+  X(ALLOC_SITE_MQTT_LOOP,   "mqttLoop")    \
+  X(ALLOC_SITE_TELECOMMAND, "telecommand") \
+  X(ALLOC_SITE_MODE,        "mode")        \
+  X(ALLOC_SITE_DISPLAY,     "display")     \
+  X(ALLOC_SITE_SENSOR_LOG,  "sensorLog")
+
+/**
+ * @brief Call sites allocations are attributed to (see AllocSiteScope).
+ */
+enum AllocSite : uint8_t {
+#define ALLOC_SITE_ID(id, name) id,
+  ALLOC_SITE_TABLE(ALLOC_SITE_ID)
+#undef ALLOC_SITE_ID
+  ALLOC_SITE_COUNT
+};
+
+/// @brief Task slots of the per-task counters: 0 for tasks outside the table, TaskId + 1.
+#define ALLOC_TASK_SLOTS (TASK_COUNT + 1)
+
+/**
+ * @brief Attributes the allocations of the current task to a site while in scope.
+ * 
+ * Scopes nest; the enclosing site is restored when the scope ends. Only table tasks
+ * keep a site of their own, other tasks share one.
+ */
+class AllocSiteScope {
+public:
+  explicit AllocSiteScope(AllocSite site);
+  ~AllocSiteScope();
+
+private:
+  uint8_t slot;
+  AllocSite previous;
+};
+
+/**
+ * @brief Last allocation made while the guard was armed.
+ */
+struct AllocViolation {
+  uint8_t taskSlot;     ///< 0 for tasks outside the table, TaskId + 1.
+  AllocSite site;
+  uint16_t size;        ///< Requested bytes, saturated at 65535.
+};
+
+/**
+ * @brief Free heap and how fragmented it is.
+ */
+struct HeapFragmentation {
+  uint32_t freeBytes;              ///< Total free heap (8-bit capable).
+  uint32_t largestFreeBlock;       ///< Largest block that can be allocated.
+  uint16_t fragmentationPermille;  ///< 1000 - largest block / free, in 0.1 % (0 = one free block).
+};
+
+/**
+ * @brief Returns true if the heap hooks are compiled in and the counters are live.
+ */
+bool allocCounterAvailable(void);
+
+/**
+ * @brief Number of heap allocations since boot.
+ */
+uint32_t getAllocCount(void);
+
+/**
+ * @brief Number of heap frees since boot.
+ */
+uint32_t getFreeCount(void);
+
+/**
+ * @brief Total bytes requested by heap allocations since boot.
+ */
+uint32_t getAllocBytes(void);
+
+/**
+ * @brief Allocations made by a task slot since boot (see ALLOC_TASK_SLOTS).
+ */
+uint32_t getTaskAllocCount(int taskSlot);
+
+/**
+ * @brief Bytes requested by a task slot since boot.
+ */
+uint32_t getTaskAllocBytes(int taskSlot);
+
+/**
+ * @brief Allocations made at a site since boot.
+ */
+uint32_t getSiteAllocCount(AllocSite site);
+
+/**
+ * @brief Bytes requested at a site since boot.
+ */
+uint32_t getSiteAllocBytes(AllocSite site);
+
+/**
+ * @brief Name of a task slot ("other" for slot 0).
+ */
+const char* allocTaskName(int taskSlot);
+
+/**
+ * @brief Name of a site.
+ */
+const char* allocSiteName(AllocSite site);
+
+/**
+ * @brief Arms or disarms the "no allocation after boot" guard.
+ * 
+ * Arming resets the violation count. Armed at the end of setup() when the firmware is
+ * built with ALLOC_GUARD_AFTER_BOOT, otherwise with the AllocGuard telecommand.
+ */
+void allocGuardArm(bool armed);
+
+/**
+ * @brief Returns true while the guard is armed.
+ */
+bool allocGuardArmed(void);
+
+/**
+ * @brief Number of allocations since the guard was armed.
+ */
+uint32_t getAllocGuardViolations(void);
+
+/**
+ * @brief Returns the last violation (all zero if there was none).
+ */
+AllocViolation getLastAllocViolation(void);
+
+/**
+ * @brief Prints a warning if there were new violations since the previous call.
+ * 
+ * Called periodically from one task (telemetry); the heap hooks cannot print.
+ * 
+ * @param out Destination (e.g. Serial).
+ */
+void reportAllocGuardViolations(Print& out);
+
+/**
+ * @brief Returns the free heap and its fragmentation.
+ */
+HeapFragmentation getHeapFragmentation(void);
+
+#endif // ALLOCCOUNTER_H
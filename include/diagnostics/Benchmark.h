@@ -0,0 +1,90 @@
+/**
+ * @file Benchmark.h
+ * @brief Micro-benchmarks of the firmware hot paths, measured with the CPU cycle counter.
+ *
+ * Each case runs its operation a fixed number of times per measurement: once to warm
+ * up (caches, lazily created objects), then BENCH_RUNS measurements of which the
+ * fastest is kept. Times come from the cycle counter of the core the calling task is
+ * pinned to; allocations from AllocCounter.
+ *
+ * The allocation counters are global, so allocations made by other tasks during a
+ * measurement are counted too. Keeping the run with the fewest allocations filters
+ * most of them out; allocation figures are only reported with the heap hooks built in.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <Arduino.h>
+
+/// @brief Measurements per case; the fastest one is reported.
+#define BENCH_RUNS 3
+
+/**
+ * @brief Result of one benchmark case.
+ */
+struct BenchResult {
+  const char* name;       ///< Case name.
+  uint32_t iterations;    ///< Operations per measurement.
+  uint32_t nsPerOp;       ///< Time per operation, in ns.
+  float allocsPerOp;      ///< Heap allocations per operation.
+  float bytesPerOp;       ///< Heap bytes requested per operation.
+};
+
+/**
+ * @brief Operation under test; called with the argument given to benchMeasure().
+ */
+typedef void (*BenchFn)(void* arg);
+
+/**
+ * @brief Measures one operation.
+ *
+ * Runs in the calling task; the task must be pinned to a core for the cycle counts
+ * to be valid (all table tasks are).
+ *
+ * @param name Case name, stored in the result (must be a literal or static).
+ * @param fn Operation under test.
+ * @param arg Argument passed to every call of fn.
+ * @param iterations Operations per measurement (at least 1).
+ * @param result Filled with the measurement.
+ */
+void benchMeasure(const char* name, BenchFn fn, void* arg, uint32_t iterations, BenchResult* result);
+
+/**
+ * @brief Prints one result as a table row (see printBenchHeader()).
+ */
+void printBenchResult(Print& out, const BenchResult& result);
+
+/**
+ * @brief Prints the header of the results table.
+ */
+void printBenchHeader(Print& out);
+
+/**
+ * @brief Runs the whole suite in the calling task and prints the results table.
+ *
+ * Covers telemetry payload construction, djb2 hashing, telecommand parsing, rolling
+ * plot insertion (on a private plot), every display draw routine and flash appends.
+ * Takes a few seconds; meant to be run on demand, not during normal operation.
+ *
+ * @param out Destination of the results (e.g. Serial).
+ */
+void runBenchmarks(Print& out);
+
+/**
+ * @brief Starts runBenchmarks() in the benchmark task (TASK_BENCH) and returns.
+ *
+ * Used by the Bench telecommand on the board and by the host build, so both run
+ * the same suite in the same task.
+ *
+ * @param out Destination of the results; must outlive the run.
+ * @return false if a run is still in progress.
+ */
+bool startBenchmarks(Print& out);
+
+/**
+ * @brief True from startBenchmarks() until the run has printed its results.
+ */
+bool benchmarksRunning();
+
+#endif // BENCHMARK_H
@@ -0,0 +1,50 @@
+/**
+ * @file Histogram.h
+ * @brief Fixed-size streaming histogram for latency percentiles.
+ *
+ * Values are counted in log-linear buckets: exact below 4, then four buckets per
+ * power of two, so any percentile is reported within 25 % of the true value while
+ * the whole histogram stays a fixed 500 bytes, whatever the number of samples.
+ *
+ * The functions do no locking; a histogram written by one task and read by another
+ * must be copied under the owner's lock.
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+
+/// @brief Number of buckets, enough for the full uint32_t range.
+#define HISTOGRAM_BUCKETS 124
+
+/**
+ * @brief Streaming histogram of uint32_t values (typically microseconds).
+ */
+struct Histogram {
+  uint32_t buckets[HISTOGRAM_BUCKETS];
+  uint32_t count;     ///< Values recorded.
+  uint32_t max;       ///< Largest value recorded.
+};
+
+/**
+ * @brief Empties a histogram.
+ */
+void histogramReset(Histogram* hist);
+
+/**
+ * @brief Records one value.
+ */
+void histogramRecord(Histogram* hist, uint32_t value);
+
+/**
+ * @brief Returns the value below which the given share of the recorded values lie.
+ *
+ * @param hist Histogram to read.
+ * @param percent Percentile, 0 to 100 (e.g. 99 for p99).
+ * @return uint32_t Upper bound of the bucket holding the percentile (never above the
+ *         largest recorded value), or 0 if the histogram is empty.
+ */
+uint32_t histogramPercentile(const Histogram* hist, uint8_t percent);
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,82 @@
+/**
+ * @file Latency.h
+ * @brief End-to-end latency metrics: telecommand handling and telemetry data age.
+ *
+ * Telecommands are timestamped in mqttCallback() (inboundMessageUs). The time to
+ * dispatch is recorded when the inbound task starts processing the message, and the
+ * time to effect when the command has been applied; commands that are unknown, out of
+ * range or rejected have no effect and are not recorded. A SetMode is only applied once
+ * the mode task has entered the new mode, so that step is closed by
+ * latencyEffectApplied() from the mode task.
+ *
+ * The telemetry task records, per sensor, how old the sample in a frame was when
+ * the frame had been published.
+ *
+ * Each metric is a streaming histogram (diagnostics/Histogram.h). latencyTakeSummary()
+ * reports and restarts it, so every report covers the time since the previous one.
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <Arduino.h>
+
+// X(id, name)
+#define LATENCY_TABLE(X) \
+  X(LATENCY_TC_DISPATCH, "TcDispatchUs") \
+  X(LATENCY_TC_EFFECT,   "TcEffectUs")   \
+  X(LATENCY_AGE_VOLTAGE, "AgeVoltMs")    \
+  X(LATENCY_AGE_IMU,     "AgeImuMs")     \
+  X(LATENCY_AGE_BME,     "AgeBmeMs")
+
+/**
+ * @brief Recorded metrics. Telecommand steps are in microseconds, data ages in ms.
+ */
+enum LatencyMetric : uint8_t {
+#define LATENCY_ID(id, name) id,
+  LATENCY_TABLE(LATENCY_ID)
+#undef LATENCY_ID
+  LATENCY_METRIC_COUNT
+};
+
+/**
+ * @brief Percentiles of one metric over a report interval.
+ */
+struct LatencySummary {
+  uint32_t count;   ///< Values recorded.
+  uint32_t p50;
+  uint32_t p95;
+  uint32_t p99;
+  uint32_t max;
+};
+
+/**
+ * @brief Records one value of a metric; callable from any task.
+ */
+void latencyRecord(LatencyMetric metric, uint32_t value);
+
+/**
+ * @brief Marks a telecommand whose effect is applied later, by another task.
+ *
+ * Must be called before the effect is requested.
+ *
+ * @param receivedUs micros() when the telecommand was received.
+ */
+void latencyAwaitEffect(uint32_t receivedUs);
+
+/**
+ * @brief Records LATENCY_TC_EFFECT for the awaited telecommand, if any.
+ */
+void latencyEffectApplied();
+
+/**
+ * @brief Returns the summary of a metric and restarts it.
+ */
+LatencySummary latencyTakeSummary(LatencyMetric metric);
+
+/**
+ * @brief Returns the name of a metric (JSON key).
+ */
+const char* latencyName(LatencyMetric metric);
+
+#endif // LATENCY_H
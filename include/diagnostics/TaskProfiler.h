@@ -0,0 +1,64 @@
+/**
+ * @file TaskProfiler.h
+ * @brief Periodic per-task CPU load and stack usage, plus heap statistics.
+ * 
+ * sampleTaskProfile() is called once per telemetry period. It reads the FreeRTOS task
+ * list and computes each task's CPU share since the previous sample from the run-time
+ * stats counters (configGENERATE_RUN_TIME_STATS). Without run-time stats only stack and
+ * heap figures are reported, and cpuAvailable is false.
+ *
+ * When the system has more tasks than PROFILER_MAX_TASKS, FreeRTOS returns no task
+ * list at all; the profile then lists the tasks of the task table only, without CPU
+ * shares, and sets truncated.
+ */
+
+#ifndef TASKPROFILER_H
+#define TASKPROFILER_H
+
+#include <Arduino.h>
+
+/// @brief Maximum number of tasks kept in a profile.
+#define PROFILER_MAX_TASKS 32
+
+/// @brief Maximum task name length including the terminator.
+#define PROFILER_NAME_LEN 16
+
+/**
+ * @brief Figures of one task.
+ */
+struct TaskProfileEntry {
+  char name[PROFILER_NAME_LEN];  ///< Task name.
+  int8_t core;                   ///< Core the task is pinned to, -1 if unpinned.
+  uint8_t priority;              ///< Current priority.
+  uint16_t cpuPermille;          ///< Share of one core since the last sample, in 0.1 %.
+  uint32_t stackFreeBytes;       ///< Lowest free stack seen (high-water mark), in bytes.
+};
+
+/**
+ * @brief Snapshot of all tasks and the heap.
+ */
+struct SystemProfile {
+  uint32_t sampleMs;             ///< millis() at the sample.
+  bool cpuAvailable;             ///< false if the run-time stats are not compiled in.
+  bool truncated;                ///< More tasks than PROFILER_MAX_TASKS: only the task table is listed.
+  uint8_t taskCount;             ///< Valid entries in tasks[].
+  uint16_t taskTotal;            ///< Tasks in the system.
+  TaskProfileEntry tasks[PROFILER_MAX_TASKS];
+  uint32_t freeHeap;             ///< Free 8-bit heap in bytes.
+  uint32_t minFreeHeap;          ///< Lowest free 8-bit heap since boot in bytes.
+  uint32_t largestFreeBlock;     ///< Largest allocatable 8-bit block in bytes.
+};
+
+/**
+ * @brief Takes a new profile sample. Call periodically from one task.
+ */
+void sampleTaskProfile(void);
+
+/**
+ * @brief Copies the latest profile sample.
+ * 
+ * @param out Filled with the snapshot (taskCount is 0 before the first sample).
+ */
+void getTaskProfile(SystemProfile* out);
+
+#endif // TASKPROFILER_H
@@ -0,0 +1,109 @@
+/**
+ * @file Trace.h
+ * @brief Low-overhead binary event trace in per-core RAM rings.
+ *
+ * traceEvent() writes one fixed-size record (timestamp, event, task, two arguments)
+ * into the ring of the core it runs on. A slot is claimed with a single atomic
+ * increment, so writers never block or take a lock, and a record costs far less
+ * than a Serial.println(), leaving the timing under investigation intact. When a
+ * ring is full the oldest records are overwritten.
+ *
+ * The rings are dumped as text lines (over serial or MQTT) and converted on the host
+ * to Chrome/Perfetto trace JSON with tools/trace2perfetto.py.
+ *
+ * Task switches are recorded by traceTaskSwitchedIn(), which FreeRTOS calls only when
+ * it is built with
+ *   #define traceTASK_SWITCHED_IN() traceTaskSwitchedIn()
+ * in FreeRTOSConfig.h (ESP-IDF component builds); the prebuilt Arduino core does not
+ * call it, and the trace then shows only the explicit events.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+
+/// @brief Records per core ring (16 bytes each).
+#define TRACE_RING_LEN 256
+
+/**
+ * @brief Traced events. *_BEGIN / *_END pairs become duration slices in the trace.
+ */
+enum TraceEvent : uint16_t {
+  TRACE_SENSOR_READ_BEGIN,    ///< arg0: TraceSensor.
+  TRACE_SENSOR_READ_END,      ///< arg0: TraceSensor.
+  TRACE_PUBLISH_BEGIN,        ///< arg0: payload bytes.
+  TRACE_PUBLISH_END,          ///< arg0: 1 if sent.
+  TRACE_DISPLAY_FLUSH_BEGIN,  ///< arg0: DisplayMode.
+  TRACE_DISPLAY_FLUSH_END,    ///< arg0: DisplayMode.
+  TRACE_QUEUE_SEND,           ///< arg0: TraceQueue, arg1: 1 if accepted.
+  TRACE_TASK_SWITCH_IN,       ///< Task in the record's task field starts running.
+  TRACE_MARK,                 ///< Free marker for debugging; args as needed.
+  TRACE_EVENT_COUNT
+};
+
+/**
+ * @brief Sensors in TRACE_SENSOR_READ_* records.
+ */
+enum TraceSensor : uint8_t {
+  TRACE_SENSOR_IMU,
+  TRACE_SENSOR_BME280,
+  TRACE_SENSOR_VOLTAGE
+};
+
+/**
+ * @brief Queues in TRACE_QUEUE_SEND records.
+ */
+enum TraceQueue : uint8_t {
+  TRACE_QUEUE_BUTTON,
+  TRACE_QUEUE_MODE,
+  TRACE_QUEUE_BUZZER,
+  TRACE_QUEUE_SENSOR_LOG
+};
+
+/**
+ * @brief One trace record.
+ */
+struct TraceRecord {
+  uint32_t timestampUs;       ///< micros() when the event was recorded.
+  uint16_t event;             ///< TraceEvent.
+  uint16_t task;              ///< Writing task: TaskId + 1 for table tasks, 0 for others.
+  uint32_t arg0;
+  uint32_t arg1;
+};
+
+/**
+ * @brief Records an event; callable from any task, on either core.
+ *
+ * Does nothing while tracing is stopped.
+ */
+void traceEvent(TraceEvent event, uint32_t arg0 = 0, uint32_t arg1 = 0);
+
+/**
+ * @brief Task switch hook for traceTASK_SWITCHED_IN() (see the file description).
+ */
+extern "C" void traceTaskSwitchedIn(void);
+
+/**
+ * @brief Starts or stops recording. Starting empties the rings. Tracing runs from boot.
+ */
+void traceEnable(bool enabled);
+
+/**
+ * @brief Writes both rings as text, oldest record first, then empties them.
+ *
+ * Recording is paused during the dump. The format is line based:
+ *   "trace <version> <ring length>", one "task <number> <name>" line per table task,
+ *   one "rec <core> <hex>" line per group of records (raw little-endian TraceRecords),
+ *   then "end".
+ *
+ * @param out Destination (e.g. Serial).
+ */
+void traceDump(Print& out);
+
+/**
+ * @brief Same as traceDump(), publishing each line as a {"Trace":"<line>"} MQTT message.
+ */
+void traceDumpMqtt();
+
+#endif // TRACE_H
@@ -4,6 +4,10 @@
  * 
  * Provides display modes and functions for updating the OLED with tabular data,
  * artificial horizon, and real-time rolling plots. Integrates with FreeRTOS tasks.
+ *
+ * The update functions may be called from any task once displayInit() has run: they
+ * write a private copy of the display model and publish it atomically, and the display
+ * task always draws a complete, consistent snapshot.
  */
 
 #ifndef DISPLAY_H
@@ -11,6 +15,8 @@
 
 #include <Arduino.h>
 
+struct BenchResult;   // diagnostics/Benchmark.h
+
 
 /**
  * @brief Enum representing available display modes.
@@ -23,17 +29,93 @@ enum DisplayMode {
   ROLLING_PLOT_MODE
 };
 
+/// @brief Number of DisplayMode values.
+#define DISPLAY_MODE_COUNT 3
+
+
+/**
+ * @brief Maximum number of channels shown at once in ROLLING_PLOT_MODE.
+ */
+#define MAX_PLOT_CHANNELS 3
+
+/**
+ * @brief How several rolling plot channels share the plot area.
+ */
+enum PlotLayout {
+  PLOT_OVERLAY,  ///< All channels drawn over the full plot height, each auto-scaled.
+  PLOT_STACKED   ///< Plot height split into one band per channel.
+};
+
+/**
+ * @brief Interned row labels for TABLE_MODE.
+ * 
+ * The label strings live in a constant table inside the display module, so building
+ * a TableEntry never allocates. Sensor values are labelled by the channel table
+ * (ChannelTable.h) instead.
+ */
+enum TableLabel : uint8_t {
+  TABLE_LABEL_MODE,
+  TABLE_LABEL_MAGNITUDE,
+  TABLE_LABEL_INIT_PRES,
+  TABLE_LABEL_THRESHOLD_PRES,
+  TABLE_LABEL_GRAVITY_ALARM_AT,
+  TABLE_LABEL_TOUCH_BUTTON,
+  TABLE_LABEL_PUSH_BUTTON,
+  TABLE_LABEL_LED_RED,
+  TABLE_LABEL_COUNT
+};
+
+/**
+ * @brief Interned units for TABLE_MODE.
+ */
+enum TableUnit : uint8_t {
+  TABLE_UNIT_NONE,
+  TABLE_UNIT_ACCEL,       ///< m/s^2
+  TABLE_UNIT_RATE,        ///< rad/s
+  TABLE_UNIT_CELSIUS,     ///< °C
+  TABLE_UNIT_PERCENT,     ///< %
+  TABLE_UNIT_HPA,         ///< hPa
+  TABLE_UNIT_VOLT,        ///< V
+  TABLE_UNIT_DBM,         ///< dBm
+  TABLE_UNIT_READY,       ///< "ready!"
+  TABLE_UNIT_BLINKING,    ///< "Blinking"
+  TABLE_UNIT_FROM_FLASH,  ///< "FromFlash"
+  TABLE_UNIT_COUNT
+};
+
+/**
+ * @brief Length of one preformatted table line including the terminator
+ *        (21 characters fit the 128 px width at text size 1).
+ */
+#define TABLE_CELL_LEN 22
+
+/// @brief Lines shown in TABLE_MODE; further entries are ignored.
+#define MAX_TABLE_ENTRIES 10
 
 /**
  * @brief Structure representing a single table entry for display.
  * 
- * Used in TABLE_MODE to display name-value-unit triples.
+ * Used in TABLE_MODE to display name-value-unit triples. Plain data: labels and
+ * units are ids, so entries can be built every tick without heap allocation.
  */
 // Table entry structure (shared with main)
 struct TableEntry {
-  String name;
-  float  value;
-  String unit;
+  TableLabel label;
+  float      value;
+  TableUnit  unit;
+};
+
+/**
+ * @brief Counters reported by the display frame scheduler.
+ */
+struct DisplayStats {
+  uint32_t framesDrawn;       ///< Number of frames actually sent to the OLED.
+  uint32_t coalescedUpdates;  ///< Updates merged into an already pending frame.
+  uint32_t droppedUpdates;    ///< Pending content discarded because its mode was not on screen.
+  uint32_t renderMicros[DISPLAY_MODE_COUNT];     ///< Last framebuffer render time per DisplayMode, in µs.
+  uint32_t renderMicrosMax[DISPLAY_MODE_COUNT];  ///< Worst framebuffer render time per DisplayMode, in µs.
+  uint32_t flushMicros;       ///< Last framebuffer transfer time to the OLED, in µs.
+  uint32_t flushMicrosMax;    ///< Worst framebuffer transfer time to the OLED, in µs.
 };
 
 /**
@@ -62,6 +144,58 @@ void startDisplayTask(DisplayMode mode);
 // Change the display mode (can be called at runtime).
 void setDisplayMode(DisplayMode mode);
 
+/**
+ * @brief Sets the maximum redraw rate of the display task.
+ * 
+ * Updates arriving within one frame period are coalesced into a single redraw.
+ * 
+ * @param fps Target frames per second (default 20, minimum 1).
+ */
+void setDisplayTargetFps(uint8_t fps);
+
+/**
+ * @brief Requests a dump of the next drawn frame as a plain PBM (P1) image.
+ * 
+ * A frame is forced even if no content changed. The display task writes the image
+ * to @p out right after the frame is sent to the OLED, with the render time in a
+ * comment line. Captured frames can be kept as golden images and diffed as text.
+ * 
+ * @param out Destination stream (e.g. Serial); must outlive the request.
+ */
+void requestDisplayFrameDump(Print& out);
+
+/**
+ * @brief Times each draw routine on the current display model.
+ * 
+ * The display task owns the framebuffer, so the routines are run there (see
+ * benchMeasure()) while the caller waits. The screen is redrawn afterwards.
+ * 
+ * @param results Filled with one result per DisplayMode, in enum order.
+ * @param iterations Draws per measurement.
+ * @return false if the display task is not running or did not answer in time.
+ */
+bool benchmarkDisplayDraws(BenchResult results[DISPLAY_MODE_COUNT], uint32_t iterations);
+
+/**
+ * @brief Times appending a sample to a full three-channel rolling plot.
+ * 
+ * Covers the history update and the column decimation, not the model hand-over.
+ * Runs in the calling task on a private history and plot model (about 20 KB, on
+ * the heap for the duration of the call), so the live plot is left untouched.
+ * 
+ * @param result Filled with the measurement.
+ * @param iterations Inserts per measurement.
+ * @return false if the private history could not be allocated.
+ */
+bool benchmarkPlotInsert(BenchResult* result, uint32_t iterations);
+
+/**
+ * @brief Returns a snapshot of the frame scheduler counters.
+ * 
+ * @return DisplayStats Frames drawn, coalesced and dropped updates, render and flush times.
+ */
+DisplayStats getDisplayStats();
+
 /**
  * @brief Updates the OLED with new telemetry table data.
  * 
@@ -69,9 +203,43 @@ void setDisplayMode(DisplayMode mode);
  * @param count Number of entries in the array.
  */
 
-// Updates the table data (called from main.cpp). This function triggers a display update.
+// Updates the table data (called from main.cpp). This marks the table dirty for the next frame.
+// Each entry is formatted once into a fixed-size cell as "<label>: <value> <unit>".
 void updateTableData(const TableEntry* newData, int count);
 
+/**
+ * @brief Updates the OLED table with free-form, already formatted lines.
+ * 
+ * Lines longer than TABLE_CELL_LEN - 1 characters are truncated.
+ * 
+ * @param lines Array of NUL-terminated strings.
+ * @param count Number of lines.
+ */
+void updateTableLines(const char* const lines[], int count);
+
+/**
+ * @brief Formats one table line "<label>: <value> <unit>" into a cell (no heap use).
+ * 
+ * Used to mix channel rows and TableEntry rows in one updateTableLines() call.
+ * 
+ * @param cell Destination, TABLE_CELL_LEN bytes.
+ * @param label Row label.
+ * @param value Value to show.
+ * @param decimals Decimals of the value.
+ * @param unit Unit shown after the value.
+ */
+void formatTableCell(char cell[TABLE_CELL_LEN], const char* label, float value, int decimals, TableUnit unit);
+
+/**
+ * @brief Formats a TableEntry as updateTableData() does (one decimal).
+ */
+void formatTableEntry(char cell[TABLE_CELL_LEN], const TableEntry& entry);
+
+/**
+ * @brief Returns the text of a unit ("" for TABLE_UNIT_NONE).
+ */
+const char* tableUnitName(TableUnit unit);
+
 /**
  * @brief Updates the artificial horizon with new pitch and roll values.
  * 
@@ -95,6 +263,28 @@ void updateHorizonData(float pitch, float roll);
 // xLabel and yLabel: axis labels for the chart.
 void updateRollingPlotData(float newValue, float newTime, const char* xLabel, const char* yLabel);
 
+/**
+ * @brief Configures a multi-channel rolling plot.
+ * 
+ * The sample history is cleared only if the channel count, labels or layout change,
+ * so it is safe to call before every sample. Long histories are decimated to one
+ * min/max envelope per pixel column when drawn.
+ * 
+ * @param channelCount Number of channels (1 to MAX_PLOT_CHANNELS).
+ * @param yLabels Array of channelCount Y-axis labels.
+ * @param xLabel Label for the X-axis.
+ * @param layout Overlay or stacked channels.
+ */
+void configureRollingPlot(int channelCount, const char* const yLabels[], const char* xLabel, PlotLayout layout);
+
+/**
+ * @brief Appends one sample for every configured rolling plot channel.
+ * 
+ * @param values Array with one value per configured channel.
+ * @param newTime Timestamp shared by all values.
+ */
+void updateRollingPlotSamples(const float* values, float newTime);
+
 
 // // New function to reset the rolling plot data.
 // void resetRollingPlotData();
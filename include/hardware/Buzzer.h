@@ -3,6 +3,8 @@
  * @brief Interface for buzzer initialization and control on the CADSE board.
  * 
  * Provides simple functions to trigger buzzer alerts or sound patterns based on satellite events.
+ * Patterns are played asynchronously on the LEDC PWM peripheral by a sequencer task,
+ * so callers never block.
  */
 
 #ifndef BUZZER_H
@@ -11,15 +13,49 @@
 #include <Arduino.h>
 
 /**
- * @brief Initializes the buzzer hardware.
+ * @brief Sound patterns played by the buzzer sequencer.
+ */
+typedef enum {
+    BUZZER_PATTERN_BEEP,    ///< 'value' beeps of 200 ms.
+    BUZZER_PATTERN_DIGITS,  ///< 'value' spoken digit by digit, each digit as that many beeps.
+    BUZZER_PATTERN_MEOW     ///< 'value' "cat meow" frequency sweeps.
+} BuzzerPattern;
+
+/**
+ * @brief Priority of a pattern; a higher priority pre-empts the pattern playing.
+ */
+typedef enum {
+    BUZZER_PRIORITY_NOTIFY,  ///< Mode changes and other feedback.
+    BUZZER_PRIORITY_ALARM    ///< Alarms; interrupt notifications.
+} BuzzerPriority;
+
+/**
+ * @brief Initializes the buzzer hardware and starts the sequencer task.
  * 
- * Configures the required GPIO pin for output.
+ * Attaches the buzzer pin to an LEDC PWM channel.
  * Should be called once in the setup routine.
  */
 void initBuzzer(void);
 
 /**
- * @brief Perform a buzzer action based on the parameters.
+ * @brief Queues a pattern for the buzzer sequencer and returns immediately.
+ * 
+ * A request identical to one already playing or waiting (same pattern and value) is
+ * merged into it instead of being queued again. A notification replaces the
+ * notification playing or waiting. A higher-priority request interrupts the pattern
+ * playing; otherwise patterns are played in priority order.
+ * 
+ * @param pattern  Pattern to play.
+ * @param value    Repetition count, or the number to speak for BUZZER_PATTERN_DIGITS.
+ * @param priority Priority of the request.
+ * @return true if the request was queued; false if the queue is full or not initialized.
+ */
+bool buzzerPlay(BuzzerPattern pattern, uint16_t value, BuzzerPriority priority);
+
+/**
+ * @brief Perform a buzzer action based on the parameters (non-blocking).
+ * 
+ * Beeps and spoken numbers are queued as notifications, meows as alarms.
  * 
  * @param times       Number of times to beep or meow. Default = 1.
  * @param speakNumber If true, interpret 'times' as digits and beep each digit.
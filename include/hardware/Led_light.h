@@ -3,7 +3,8 @@
  * @brief LED control interface using the MCP23017 I/O expander.
  * 
  * Provides a class to manage blinking patterns for LEDs connected to an I2C-based GPIO expander,
- * used for status indication on the CADSE board.
+ * used for status indication on the CADSE board. A single engine task drives all LEDs
+ * from a fixed per-LED pattern table and writes both GPIO banks in one transaction.
  */
 #ifndef LED_LIGHT_H
 #define LED_LIGHT_H
@@ -32,16 +33,35 @@ public:
         /**
      * @brief Blinks a specific LED a number of times with a given period.
      * 
-     * @param ledPin GPIO pin (on MCP23017) to control.
+     * Non-blocking and allocation-free: the request is stored in the LED's slot and
+     * played by the engine task. If the LED is already blinking with the same period,
+     * the blink is extended rather than restarted.
+     * 
+     * @param ledPin GPIO pin (on MCP23017) to control, 7 to 15.
      * @param times Number of times the LED should blink.
      * @param period Duration of one on/off cycle in milliseconds.
      */
     void blinkLED(int ledPin, int times, int period);
 
 private:
+    /// Number of LED pins (7 to 15) on the MCP23017.
+    static const int LED_COUNT = 9;
+
+    /// Blink pattern of one LED: on for the first half of every period until endTick.
+    struct LedSlot {
+        bool active;
+        TickType_t startTick;
+        TickType_t periodTicks;
+        TickType_t endTick;
+    };
+
     Adafruit_MCP23X17 mcp;
-    void turnOn(int ledPin);
-    void turnOff(int ledPin);
+    LedSlot slots[LED_COUNT];
+    uint16_t portState;         ///< Last value written to GPIOA/GPIOB (engine task only).
+    TaskHandle_t taskHandle;
+    portMUX_TYPE slotsMux;
+
+    uint16_t computePort(TickType_t now, TickType_t& wait);
     static void ledTask(void* parameters);
 };
 
@@ -0,0 +1,119 @@
+/**
+ * @file Raster.h
+ * @brief 1bpp raster kernel for the SSD1306 page-organized framebuffer.
+ *
+ * Draws directly into the display buffer (one byte per column and 8-pixel page,
+ * LSB at the top) instead of going through per-pixel Adafruit_GFX calls.
+ * Horizontal spans are written a 32-bit word (4 columns) at a time, vertical spans
+ * a byte (8 rows) at a time. Also provides Bresenham lines, column scan-converted
+ * polygon fills, a small numeric glyph blitter, and fixed-point sine/cosine tables.
+ */
+
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Framebuffer in SSD1306 page layout: byte (x + (y / 8) * width), bit (y % 8).
+ */
+struct RasterTarget {
+  uint8_t* buffer;   ///< Framebuffer, width * height / 8 bytes, 4-byte aligned.
+  int16_t  width;    ///< Width in pixels (multiple of 4).
+  int16_t  height;   ///< Height in pixels (multiple of 8).
+};
+
+/**
+ * @brief How drawn pixels are combined with the framebuffer.
+ */
+enum RasterOp {
+  RASTER_SET,     ///< Pixel on.
+  RASTER_CLEAR,   ///< Pixel off.
+  RASTER_INVERT   ///< Pixel toggled.
+};
+
+/// @brief One full turn in fixed-point angle units (binary degrees).
+#define RASTER_ANGLE_TURN 1024
+
+/// @brief Scale of the fixed-point sine/cosine results (Q15, 1.0 = 32767).
+#define RASTER_TRIG_ONE 32767
+
+/**
+ * @brief Clears the whole framebuffer.
+ */
+void rasterClear(const RasterTarget& t);
+
+/**
+ * @brief Sets, clears or toggles a single pixel (clipped).
+ */
+void rasterPixel(const RasterTarget& t, int x, int y, RasterOp op = RASTER_SET);
+
+/**
+ * @brief Draws the horizontal span x0..x1 (inclusive) on row y, word-wide.
+ */
+void rasterHSpan(const RasterTarget& t, int x0, int x1, int y, RasterOp op = RASTER_SET);
+
+/**
+ * @brief Draws the vertical span y0..y1 (inclusive) in column x, byte-wide.
+ */
+void rasterVSpan(const RasterTarget& t, int x, int y0, int y1, RasterOp op = RASTER_SET);
+
+/**
+ * @brief Fills the rectangle with top-left corner (x, y), word-wide per page.
+ */
+void rasterFillRect(const RasterTarget& t, int x, int y, int w, int h, RasterOp op = RASTER_SET);
+
+/**
+ * @brief Draws a line with Bresenham's algorithm (axis-aligned lines use spans).
+ */
+void rasterLine(const RasterTarget& t, int x0, int y0, int x1, int y1, RasterOp op = RASTER_SET);
+
+/**
+ * @brief Fills a simple polygon (even-odd rule), clipped to the framebuffer.
+ *
+ * Scan-converted column by column so each column becomes one byte-wide vertical span.
+ *
+ * @param xs X coordinates of the vertices.
+ * @param ys Y coordinates of the vertices.
+ * @param count Number of vertices (3 to 8).
+ */
+void rasterFillPolygon(const RasterTarget& t, const int16_t* xs, const int16_t* ys, int count,
+                       RasterOp op = RASTER_SET);
+
+/**
+ * @brief Blits a column-major bitmap up to 8 pixels high (bit 0 = top row).
+ *
+ * @param columns One byte per column.
+ * @param w Number of columns.
+ */
+void rasterBlit(const RasterTarget& t, int x, int y, const uint8_t* columns, int w, RasterOp op = RASTER_SET);
+
+/**
+ * @brief Draws a numeric string with the built-in 5x7 glyphs ("0-9 + - . space").
+ *
+ * Characters outside that set are drawn as blanks. Advance is 6 pixels per character.
+ *
+ * @return int X coordinate after the last character.
+ */
+int rasterNumber(const RasterTarget& t, int x, int y, const char* text, RasterOp op = RASTER_SET);
+
+/**
+ * @brief Converts degrees to fixed-point angle units (RASTER_ANGLE_TURN per turn).
+ */
+int32_t rasterDegToAngle(float degrees);
+
+/**
+ * @brief Table-based sine in Q15 (RASTER_TRIG_ONE = 1.0).
+ *
+ * @param angle Angle in RASTER_ANGLE_TURN units per turn (any integer, wraps).
+ */
+int16_t rasterSin(int32_t angle);
+
+/**
+ * @brief Table-based cosine in Q15 (RASTER_TRIG_ONE = 1.0).
+ *
+ * @param angle Angle in RASTER_ANGLE_TURN units per turn (any integer, wraps).
+ */
+int16_t rasterCos(int32_t angle);
+
+#endif // RASTER_H
@@ -3,7 +3,11 @@
  * @brief Capacitive touch and push button input interface for CADSE board.
  * 
  * Provides initialization and task management for reading input events,
- * and defines the enum used to communicate button/touch events via a FreeRTOS queue.
+ * and defines the types used to communicate button/touch events via a FreeRTOS queue.
+ * 
+ * Input is interrupt driven: touch and GPIO interrupts wake the input task, which runs
+ * a non-blocking debounce state machine per pad and scans only while a pad is active.
+ * Touch thresholds follow an adaptive per-pad baseline instead of a fixed value.
  */
 
 #ifndef TOUCH_H
@@ -15,7 +19,7 @@
 #include <Arduino.h>
 
 /**
- * @brief Enumeration of all possible button and touch events.
+ * @brief Enumeration of all buttons and touch pads.
  */
 
 // Define an enum for each button event
@@ -29,26 +33,53 @@ typedef enum {
     BUTTON_EVENT_PUSH_16   //  Pressing => High
 } ButtonEvent_t;
 
+/**
+ * @brief What happened to a button.
+ */
+typedef enum {
+    BUTTON_ACTION_PRESS,    ///< Debounced press.
+    BUTTON_ACTION_LONG,     ///< Held for BUTTON_LONG_PRESS_MS (sent once per press).
+    BUTTON_ACTION_REPEAT,   ///< Auto-repeat while held, on pads with repeat enabled.
+    BUTTON_ACTION_RELEASE   ///< Debounced release.
+} ButtonAction_t;
+
+/**
+ * @brief Input event as delivered through buttonEventQueue.
+ */
+typedef struct {
+    ButtonEvent_t button;   ///< Button or pad.
+    ButtonAction_t action;  ///< Press, long press, repeat or release.
+    uint32_t timestampMs;   ///< millis() of the edge (start of debounce) or of the repeat.
+} ButtonEventMsg_t;
+
+/// @brief Time a pad must be stable before a press or release is reported.
+#define BUTTON_DEBOUNCE_MS 30
+/// @brief Hold time before BUTTON_ACTION_LONG, and before auto-repeat starts.
+#define BUTTON_LONG_PRESS_MS 800
+/// @brief Interval of BUTTON_ACTION_REPEAT events while held.
+#define BUTTON_REPEAT_MS 200
+
 /**
  * @brief FreeRTOS queue handle used to send button/touch events between tasks.
  * 
- * Other tasks (e.g., physicalInput) listen to this queue for input events.
+ * Carries ButtonEventMsg_t. Other tasks (e.g., physicalInput) listen to this queue.
  */
 // Externally visible queue handle where events are sent
 extern QueueHandle_t buttonEventQueue;
 
 /**
- * @brief Initializes GPIOs for capacitive touch and push button input.
+ * @brief Initializes GPIOs for push buttons and measures the touch baselines.
  * 
- * Should be called once during setup().
+ * Should be called once during setup(), with no pad being touched.
  */
 // Initializes the touch sensor & push button module
 void initTouchSensor(void);
 
 /**
- * @brief Starts the FreeRTOS task responsible for scanning all input buttons.
+ * @brief Starts the FreeRTOS task responsible for all input buttons.
  * 
- * This task detects touch and push events and pushes them into buttonEventQueue.
+ * Attaches the touch and GPIO interrupts; the task detects touch and push events
+ * and pushes them into buttonEventQueue.
  */
 // Starts the task that reads all buttons (touch and push)
 void startTouchTask(void);
@@ -30,7 +30,7 @@ bool initStorage();
 /**
  * @brief Reads the default mode from flash memory.
  * 
- * @return int Mode number (0–5), or -1 if the file was not found or read failed.
+ * @return int Mode number (0 to MODE_COUNT - 1), or -1 if the file was not found or read failed.
  */
 // Read the default mode from flash; returns -1 if not found or error.
 int readDefaultMode();
@@ -38,10 +38,10 @@ int readDefaultMode();
 /**
  * @brief Writes the given mode number as the new default startup mode.
  * 
- * @param mode The mode to write (0–5).
+ * @param mode The mode to write (0 to MODE_COUNT - 1).
  * @return true if write was successful, false otherwise.
  */
-// Write a new default mode (0 to 5) to flash.
+// Write a new default mode (0 to MODE_COUNT - 1) to flash.
 bool writeDefaultMode(int mode);
 
 /**
@@ -66,4 +66,14 @@ bool clearDataFile();
 // The parameter packetID can be used to decide if the file must be cleared first.
 bool appendPacketToFile(uint32_t packetID, const uint8_t *data, size_t length);
 
+/**
+ * @brief Appends raw bytes to a file, creating it if needed.
+ * 
+ * @param path File path (e.g. DATA_FILE_FILENAME).
+ * @param data Pointer to raw byte array to append.
+ * @param length Number of bytes to write.
+ * @return true if all bytes were written, false otherwise.
+ */
+bool appendBytesToFile(const char *path, const uint8_t *data, size_t length);
+
 #endif // STORAGE_H
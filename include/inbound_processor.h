@@ -3,18 +3,13 @@
  * @brief Interface for processing inbound telecommands and data packets from MQTT.
  * 
  * Parses and interprets MQTT messages such as SetMode, SetDefaultMode, and PacketID,
- * updating global variables and triggering corresponding actions on the CADSE board.
+ * updating the shared state registry and triggering corresponding actions on the CADSE board.
  */
 #ifndef INBOUND_PROCESSOR_H
 #define INBOUND_PROCESSOR_H
 
 #include <Arduino.h>
 
-/// @brief Current operating mode of the system (shared externally).
-extern int currentMode;
-/// @brief Default mode loaded at boot, may be updated by telecommand.
-extern int defaultModeValue;
-
 // -----------------------------
 // Telecommand State Variables
 // -----------------------------
@@ -22,11 +17,13 @@ extern int defaultModeValue;
 /**
  * @brief Type of the last received telecommand.
  * 
- * May be one of: "SetMode", "SetDefaultMode", or "PacketID".
+ * May be one of: "SetMode", "SetDefaultMode", "PacketID", "DumpFrame", "SetProfile",
+ * "Record", "Replay", "Synth", ... ("" before the first telecommand). Always points to a
+ * string literal, so it is updated and read without allocation or locking.
  */
 
 // Global variables for telecommand (tc) data
-extern String tc;           // Will hold "SetMode", "SetDefaultMode", or "PacketID"
+extern const char* tc;      // Will hold "SetMode", "SetDefaultMode", or "PacketID"
 
 /**
  * @brief Associated value of the last telecommand.
@@ -39,9 +36,9 @@ extern int tcValue;         // For SetMode/SetDefaultMode, it's the mode value;
 /**
  * @brief Validation hash of the received data (used with PacketID).
  * 
- * Calculated using djb2 hashing algorithm, stored as a hex string.
+ * Calculated using djb2 hashing algorithm over the whole message.
  */
-extern String tcHash;       // For PacketID, the computed djb2 hash (in hex string)
+extern uint32_t tcHash;     // For PacketID, the computed djb2 hash
 
 /**
  * @brief Parses and handles the latest MQTT inbound message.
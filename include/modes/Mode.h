@@ -0,0 +1,92 @@
+/**
+ * @file Mode.h
+ * @brief Common interface and registry of the satellite operation modes.
+ *
+ * Every mode (0 to MODE_COUNT - 1) is an object implementing the Mode interface.
+ * The mode task owns the active mode: it calls onExit()/onEnter() when the requested
+ * mode changes, onTick() at the period the mode declares, and onInput() for button
+ * events, all from the same task, so modes need no locking of their own state.
+ */
+
+// Mode.h
+#ifndef MODE_H
+#define MODE_H
+
+#include <Arduino.h>
+#include "hardware/Touch.h"   // For ButtonEvent_t
+
+/**
+ * @brief Number of registered modes (0 to MODE_COUNT - 1).
+ */
+#define MODE_COUNT 7
+
+/**
+ * @brief Base class of a satellite operation mode.
+ */
+class Mode {
+public:
+  /**
+   * @brief Creates a mode.
+   *
+   * @param name Short name used in log messages.
+   * @param tickPeriodMs Period between onTick() calls while the mode is active.
+   */
+  Mode(const char* name, uint16_t tickPeriodMs) : modeName(name), periodMs(tickPeriodMs) {}
+  virtual ~Mode() {}
+
+  /// @brief Called once when the mode becomes active (beep, display mode, sensor rates).
+  virtual void onEnter() {}
+
+  /// @brief Called periodically while the mode is active.
+  virtual void onTick() = 0;
+
+  /// @brief Called once when another mode takes over.
+  virtual void onExit() {}
+
+  /// @brief Called for button events other than the mode navigation (UP/DOWN).
+  virtual void onInput(ButtonEvent_t evt) { (void)evt; }
+
+  /// @brief Short name used in log messages.
+  const char* name() const { return modeName; }
+
+  /// @brief Period between onTick() calls, in milliseconds.
+  uint16_t tickPeriodMs() const { return periodMs; }
+
+private:
+  const char* modeName;
+  uint16_t periodMs;
+};
+
+/**
+ * @brief Returns the registered mode with the given number.
+ *
+ * @param index Mode number (0 to MODE_COUNT - 1).
+ * @return Mode* The mode, or NULL if the number is out of range.
+ */
+Mode* getMode(int index);
+
+/**
+ * @brief Starts the FreeRTOS task that runs the active mode.
+ *
+ * The initial mode is taken from STATE_CURRENT_MODE.
+ */
+void startModeTask();
+
+/**
+ * @brief Requests a switch to another mode.
+ *
+ * Updates STATE_CURRENT_MODE; the mode task is notified of the change and performs
+ * the switch. Out-of-range numbers are ignored.
+ *
+ * @param index Mode number (0 to MODE_COUNT - 1).
+ */
+void requestMode(int index);
+
+/**
+ * @brief Forwards a button event to the active mode (delivered via onInput()).
+ *
+ * @param evt Button or touch event.
+ */
+void postModeInput(ButtonEvent_t evt);
+
+#endif // MODE_H
@@ -12,14 +12,14 @@
 #include "modes/modegeneral.h"
 
 /**
- * @brief Executes Mode 1 functionality: microgravity detection.
+ * @brief Mode 1: microgravity detection.
  * 
- * Retrieves IMU data, calculates the acceleration magnitude, and triggers an alarm
- * if the magnitude falls below a preset threshold (`gravityAlaramAt`).
- * Updates display with acceleration values.
+ * Each tick retrieves IMU data, calculates the acceleration magnitude, and triggers an alarm
+ * if the magnitude falls below a preset threshold (`STATE_GRAVITY_ALARM_AT`).
+ * Updates display with acceleration values. LEFT/RIGHT adjust the threshold.
  */
 
-// Function prototype for executing mode 1 logic.
-void runMode1();
+// Registered Mode 1 instance.
+Mode& mode1();
 
 #endif // MODE1_H
@@ -14,14 +14,14 @@
 #include "modes/modegeneral.h"
 
 /**
- * @brief Executes Mode 2 functionality: cabin pressure monitoring.
+ * @brief Mode 2: cabin pressure monitoring.
  * 
- * Compares current pressure to `initPressure`. If the drop exceeds 10 hPa,
+ * Compares current pressure to `STATE_INIT_PRESSURE`. If the drop exceeds `STATE_DELTA_PRESSURE`,
  * triggers a warning using LEDs and optionally the buzzer.
- * Displays current pressure on the OLED.
+ * Displays current pressure on the OLED. LEFT/RIGHT adjust the allowed drop.
  */
 
-// Function prototype for executing mode 2 logic.
-void runMode2();
+// Registered Mode 2 instance.
+Mode& mode2();
 
 #endif // MODE2_H
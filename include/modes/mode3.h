@@ -13,13 +13,14 @@
 #include "modes/modegeneral.h"
 
 /**
- * @brief Executes Mode 3 functionality: artificial horizon display.
+ * @brief Mode 3: artificial horizon display.
  * 
  * Calculates roll angle from accelerometer data assuming Earth's gravity (9.81 m/s²).
- * Updates the OLED with a visual representation of the horizon line.
+ * Updates the OLED with a visual representation of the horizon line at 50 Hz;
+ * the IMU sample rate is raised while the mode is active.
  */
 
-// Function prototype for executing mode 3 logic.
-void runMode3();
+// Registered Mode 3 instance.
+Mode& mode3();
 
 #endif // MODE3_H
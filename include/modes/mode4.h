@@ -12,20 +12,22 @@
 
 #include "modes/modegeneral.h"
 
-/**
- * @brief Selects which signal source to display in the rolling plot.
- * 
- * Can be modified by user input (touch buttons) or telecommands.
- */
-extern int rollingPlotSwitch;
+/// @brief STATE_ROLLING_PLOT value showing all sources, one band each.
+#define ROLLING_PLOT_STACKED 4
+/// @brief STATE_ROLLING_PLOT value showing all sources overlaid.
+#define ROLLING_PLOT_OVERLAY 5
+/// @brief Number of selectable STATE_ROLLING_PLOT values (1 to ROLLING_PLOT_SOURCES).
+#define ROLLING_PLOT_SOURCES 5
 
 /**
- * @brief Executes Mode 4 functionality: rolling plot visualization.
+ * @brief Mode 4: rolling plot visualization.
  * 
  * Continuously plots selected sensor data over time with dynamic labels.
- * Used for visual trend monitoring of analog signals.
+ * Used for visual trend monitoring of analog signals. LEFT/RIGHT select the source
+ * (STATE_ROLLING_PLOT): 1 = acceleration X, 2 = humidity, 3 = IMU temperature,
+ * ROLLING_PLOT_STACKED / ROLLING_PLOT_OVERLAY = all three at once.
  */
-// Function prototype for executing mode 4 logic.
-void runMode4();
+// Registered Mode 4 instance.
+Mode& mode4();
 
 #endif // MODE4_H
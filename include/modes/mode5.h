@@ -15,14 +15,14 @@
 #include "modes/modegeneral.h"
 
 /**
- * @brief Executes Mode 5 functionality: telecommand and packet monitoring.
+ * @brief Mode 5: telecommand and packet monitoring.
  * 
- * On first entry, triggers a 5-beep signal via buzzer. Then, it sets the display
- * to TABLE_MODE and shows telemetry feedback such as command type (`tc`),
+ * On entry, triggers a 5-beep signal via buzzer and sets the display to TABLE_MODE.
+ * Each tick shows telemetry feedback such as command type (`tc`),
  * its numeric value (`tcValue`), and its hash (`tcHash`) for validation.
  * Used to confirm successful reception and handling of telecommands.
  */
-// Function prototype for executing mode 5 logic.
-void runMode5();
+// Registered Mode 5 instance.
+Mode& mode5();
 
 #endif // MODE5_H
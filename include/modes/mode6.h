@@ -0,0 +1,24 @@
+/**
+ * @file mode6.h
+ * @brief Mode 6 logic for the on-board diagnostics page.
+ * 
+ * Shows heap figures and, per task, its CPU share and free stack from the task
+ * profiler, so overloaded tasks or tight stacks can be spotted without telemetry.
+ */
+
+// mode6.h
+#ifndef MODE6_H
+#define MODE6_H
+
+#include "modes/modegeneral.h"
+
+/**
+ * @brief Mode 6: diagnostics page.
+ * 
+ * The first line shows free heap and the largest free block, the following lines one
+ * task each as "<name> <cpu %> <free stack>". LEFT/RIGHT scroll through the tasks.
+ */
+// Registered Mode 6 instance.
+Mode& mode6();
+
+#endif // MODE6_H
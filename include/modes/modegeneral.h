@@ -18,27 +18,19 @@
 
 // Include modules that are common to all modes
 #include "display.h"        // For setDisplayMode, updateTableData, updateHorizonData, updateRollingPlotData, etc.
+#include "ChannelTable.h"   // For the channel rows of the tables and the plot sources
 #include "hardware/Buzzer.h"         // For buzzerAction
 #include "sensors/IMU.h"            // For getIMUData and the IMUEvents_t structure
 #include "sensors/BME280Measurement.h"  // For getBMETemperature, getBMEPressure, getBMEHumidity
 #include "hardware/Led_light.h"      // For ledController
+#include "modes/Mode.h"             // For the Mode interface and registry
+#include "alarms/AlarmEngine.h"     // For the mode alarms
+#include "state/StateRegistry.h"    // For the shared state (mode, alarm parameters, plot source)
 
 // -----------------------
 // Common Global Variables
 // -----------------------
 
-// The current mode (0 to 6). Defined in main, declared here for external use.
-extern int currentMode;
-
-extern int previousMode;
-
-// Variables used for mode 2 (pressure measurement)
-extern float initPressure;
-extern float deltaPressure;
-
-// Variable used in mode 1 for IMU alarm threshold.
-extern float gravityAlaramAt;
-
 // Variable used in mode 4 for the rolling plot time axis.
 extern float modeGeneralTime;
 
@@ -46,7 +38,7 @@ extern float modeGeneralTime;
 /**
  * @brief Telecommand identifier string used in Mode 5.
  */
-extern String tc;
+extern const char* tc;
 
 /**
  * @brief Value associated with the current telecommand (Mode 5).
@@ -56,7 +48,7 @@ extern int tcValue;
 /**
  * @brief Hash used to verify telecommand authenticity (Mode 5).
  */
-extern String tcHash;
+extern uint32_t tcHash;
 
 // -----------------------
 // Common Helper Function Prototypes
@@ -19,9 +19,22 @@ void startBME280Task(void);
 // Sets the measurement period (in milliseconds). Default is 500 ms.
 void setBMEPeriod(uint32_t periodMs);
 
+// Function called by the BME280 task with every new sample (runs in that task; must not block).
+typedef void (*BMESampleHook)(float temperature, float pressure, float humidity, uint32_t timestampMs);
+
+// Installs the function called with every BME280 sample (NULL to remove).
+void setBMESampleHook(BMESampleHook hook);
+
+// Takes a sample in place of the BME280 task (replay, host harnesses): stored for the
+// getters, recorded and passed to the sample hook in the caller's task.
+void feedBMESample(float temperature, float pressure, float humidity, uint32_t timestampMs);
+
 // Getter functions for the latest sensor data.
 float getBMETemperature(void);
 float getBMEPressure(void);
 float getBMEHumidity(void);
 
+// Time (millis()) of the latest sample.
+uint32_t getBMESampleTime(void);
+
 #endif // BME280MEASUREMENT_H
@@ -13,6 +13,11 @@
 #include "task.h"
 #include <Adafruit_LSM6DS.h>
 #include <Adafruit_Sensor.h>
+#include "TaskTable.h"
+#include "sensors/SensorLog.h"
+
+/// @brief Default IMU update period in milliseconds (modes may raise the rate temporarily).
+#define IMU_DEFAULT_PERIOD_MS TASK_PERIOD_MS(TASK_IMU)
 
 // Structure to hold IMU sensor events.
 
@@ -26,6 +31,16 @@ typedef struct {
   sensors_event_t gyro;
   sensors_event_t temp;
 } IMUEvents_t;
+
+/**
+ * @brief Function called by the IMU task with every new sample.
+ * 
+ * Runs in the IMU task; must not block.
+ * 
+ * @param sample The new readings.
+ * @param timestampMs Sample time (millis()).
+ */
+typedef void (*IMUSampleHook)(const IMUEvents_t& sample, uint32_t timestampMs);
 /**
  * @brief Initializes the LSM6DS IMU sensor via SPI.
  * 
@@ -55,6 +70,15 @@ void resumeIMUTask(void);
  */
 // Sets the effective update period (in milliseconds) for the IMU update task.
 void setIMUEffectivePeriod(uint32_t periodMs);
+/**
+ * @brief Sets the period the IMU telemetry is published at.
+ * 
+ * The IMU task samples at the shorter of this and the effective period, so fast
+ * telemetry does not repeat stale samples.
+ * 
+ * @param periodMs Publish period in milliseconds, 0 if the IMU data is not published.
+ */
+void setIMUTelemetryPeriod(uint32_t periodMs);
 /**
  * @brief Retrieves the latest IMU readings from the background task.
  * 
@@ -62,5 +86,19 @@ void setIMUEffectivePeriod(uint32_t periodMs);
  */
 // Returns the latest sensor events.
 IMUEvents_t getIMUData(void);
+/**
+ * @brief Returns the time (millis()) of the latest IMU sample.
+ */
+uint32_t getIMUSampleTime(void);
+/**
+ * @brief Installs the function called with every IMU sample (NULL to remove).
+ */
+void setIMUSampleHook(IMUSampleHook hook);
+/**
+ * @brief Takes a sample in place of the IMU task (replay, host harnesses).
+ * 
+ * Stored for getIMUData(), recorded and passed to the sample hook in the caller's task.
+ */
+void feedIMUSample(const ImuSample& sample, uint32_t timestampMs);
 
 #endif // IMU_H
@@ -0,0 +1,104 @@
+/**
+ * @file SensorLog.h
+ * @brief Platform-independent sensor samples and their compact recording format.
+ * 
+ * A recording is the 4-byte header SENSOR_LOG_MAGIC followed by records. Each record
+ * is a type byte, the time since the previous record in ms (uint16, little endian) and
+ * a fixed-point payload:
+ * 
+ * | Type  | Payload                                                   | Bytes |
+ * |-------|-----------------------------------------------------------|-------|
+ * | IMU   | accel x/y/z 0.01 m/s^2, gyro x/y/z 1 mrad/s, temp 0.01 C   | 14    |
+ * | ENV   | temp 0.01 C (int16), pressure 1 Pa (uint32), humi 0.01 %  | 8     |
+ * | POWER | battery and bus voltage, 1 mV (uint16 each)               | 4     |
+ * | TIME  | absolute time in ms (uint32), before gaps over 65535 ms   | 4     |
+ * 
+ * Only depends on the C standard library, so recordings can be decoded on a host.
+ */
+
+#ifndef SENSORLOG_H
+#define SENSORLOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief File header of a recording.
+#define SENSOR_LOG_MAGIC "SNR1"
+/// @brief Size of the file header.
+#define SENSOR_LOG_MAGIC_LEN 4
+/// @brief Largest encoded record, including a preceding TIME record.
+#define SENSOR_LOG_MAX_RECORD 24
+
+/**
+ * @brief One IMU reading.
+ */
+struct ImuSample {
+  float accel[3];        ///< Acceleration x/y/z in m/s^2.
+  float gyro[3];         ///< Angular rate x/y/z in rad/s.
+  float temperature;     ///< Die temperature in C.
+};
+
+/**
+ * @brief One BME280 reading.
+ */
+struct EnvSample {
+  float temperature;     ///< C.
+  float pressure;        ///< hPa.
+  float humidity;        ///< %.
+};
+
+/**
+ * @brief One supply voltage reading.
+ */
+struct PowerSample {
+  float vbat;            ///< Battery voltage in V.
+  float usb;             ///< USB bus voltage in V.
+};
+
+/**
+ * @brief Record types.
+ */
+enum SensorRecordType : uint8_t {
+  SENSOR_REC_IMU = 1,
+  SENSOR_REC_ENV = 2,
+  SENSOR_REC_POWER = 3,
+  SENSOR_REC_TIME = 4
+};
+
+/**
+ * @brief Decoded record.
+ */
+struct SensorRecord {
+  SensorRecordType type;
+  uint32_t timestampMs;  ///< Sample time (millis() when recorded).
+  union {
+    ImuSample imu;
+    EnvSample env;
+    PowerSample power;
+  };
+};
+
+/**
+ * @brief Encodes one record.
+ * 
+ * @param rec Record to encode (IMU, ENV or POWER).
+ * @param lastMs Time of the previous record; updated. Start with the first sample's time.
+ * @param out Buffer of at least SENSOR_LOG_MAX_RECORD bytes.
+ * @return Bytes written, 0 if the record type is invalid.
+ */
+size_t sensorLogEncode(const SensorRecord& rec, uint32_t* lastMs, uint8_t* out);
+
+/**
+ * @brief Decodes one record.
+ * 
+ * TIME records are decoded too (they only update lastMs); callers skip them.
+ * 
+ * @param in Encoded bytes.
+ * @param length Bytes available.
+ * @param lastMs Time of the previous record; updated.
+ * @param rec Decoded record.
+ * @return Bytes consumed; 0 if the record is incomplete or invalid.
+ */
+size_t sensorLogDecode(const uint8_t* in, size_t length, uint32_t* lastMs, SensorRecord* rec);
+
+#endif // SENSORLOG_H
@@ -0,0 +1,113 @@
+/**
+ * @file SensorSource.h
+ * @brief Sensor recording, replay and synthetic signal sources.
+ * 
+ * The IMU, BME280 and voltage tasks take their samples from the active source:
+ * - live: the real sensors (default),
+ * - replay: a recording made with sensorRecordStart(), played back in real time; the
+ *   sensor tasks pause and every recorded sample is fed in order with its recorded
+ *   spacing (sensorFeedRecord()),
+ * - synthetic: a SignalGenerator scenario (free fall, pressure leak, ...).
+ * Getters, sample hooks and alarms see replayed and synthetic samples exactly like
+ * live ones. Whatever the source, samples can be recorded to flash (SENSOR_LOG_FILENAME)
+ * in the SensorLog format by a low-priority task.
+ */
+
+#ifndef SENSORSOURCE_H
+#define SENSORSOURCE_H
+
+#include <Arduino.h>
+#include "sensors/SensorLog.h"
+#include "sensors/SignalGenerator.h"
+
+/// @brief Recording file in SPIFFS.
+#define SENSOR_LOG_FILENAME "/sensor_log.bin"
+/// @brief Recordings stop when the file reaches this size.
+#define SENSOR_LOG_MAX_BYTES (256 * 1024)
+
+/**
+ * @brief Where the sensor tasks take their samples from.
+ */
+enum SensorSourceMode : uint8_t {
+  SENSOR_SOURCE_LIVE,
+  SENSOR_SOURCE_REPLAY,
+  SENSOR_SOURCE_SYNTHETIC
+};
+
+/**
+ * @brief What a sensor task takes as its next sample.
+ */
+enum SensorSample : uint8_t {
+  SENSOR_SAMPLE_LIVE,       ///< Read the sensor.
+  SENSOR_SAMPLE_SYNTHETIC,  ///< Take the generated sample.
+  SENSOR_SAMPLE_NONE        ///< Take none: the replay feeds the recorded samples.
+};
+
+/**
+ * @brief Creates the recorder queues and task. Call once after initStorage().
+ */
+void initSensorSource(void);
+
+/**
+ * @brief Starts recording all sensor samples, replacing the previous recording.
+ * 
+ * @param durationS Recording length in seconds; 0 stops a running recording.
+ * @return false if the recorder is not initialised or busy.
+ */
+bool sensorRecordStart(uint32_t durationS);
+
+/**
+ * @brief Replays the recording once, then returns to live sensors.
+ * 
+ * @return false if the recorder is not initialised or busy.
+ */
+bool sensorReplayStart(void);
+
+/**
+ * @brief Switches to a synthetic scenario (SYNTH_OFF returns to live sensors).
+ * 
+ * @return false if the scenario is unknown.
+ */
+bool sensorSynthStart(SynthScenario scenario);
+
+/**
+ * @brief Returns the active sample source.
+ */
+SensorSourceMode getSensorSourceMode(void);
+
+/**
+ * @brief Gets the IMU sample from the synthetic source.
+ * 
+ * Called by the IMU task before reading the sensor.
+ * 
+ * @return Whether to read the sensor, take `out` or skip the sample.
+ */
+SensorSample sensorSourceImu(uint32_t nowMs, ImuSample* out);
+
+/// @brief BME280 counterpart of sensorSourceImu().
+SensorSample sensorSourceEnv(uint32_t nowMs, EnvSample* out);
+
+/// @brief Voltage counterpart of sensorSourceImu().
+SensorSample sensorSourcePower(uint32_t nowMs, PowerSample* out);
+
+/**
+ * @brief Feeds one sample as if its sensor task had taken it at rec.timestampMs:
+ * stored for the getters, recorded and passed to the sample hook.
+ * 
+ * Used by the replay, and by host harnesses that drive the hooks and alarms faster
+ * than real time. TIME records are ignored.
+ */
+void sensorFeedRecord(const SensorRecord& rec);
+
+/**
+ * @brief Queues a sample for the recording; no-op unless recording. Never blocks.
+ */
+void sensorRecordImu(const ImuSample& sample, uint32_t timestampMs);
+
+/// @brief BME280 counterpart of sensorRecordImu().
+void sensorRecordEnv(const EnvSample& sample, uint32_t timestampMs);
+
+/// @brief Voltage counterpart of sensorRecordImu().
+void sensorRecordPower(const PowerSample& sample, uint32_t timestampMs);
+
+#endif // SENSORSOURCE_H
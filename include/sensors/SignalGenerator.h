@@ -0,0 +1,63 @@
+/**
+ * @file SignalGenerator.h
+ * @brief Deterministic synthetic sensor signals for exercising modes and alarms.
+ * 
+ * Each scenario is a function of the sample time plus seeded pseudo-random noise, so
+ * the same seed and sample times always give the same samples, at any sample rate.
+ * Times are in microseconds, so a host harness can sample well above 1 kHz.
+ * Every channel (IMU, environment, power) has its own noise state, so the sensor tasks
+ * can draw samples concurrently. Only depends on the C standard library.
+ */
+
+#ifndef SIGNALGENERATOR_H
+#define SIGNALGENERATOR_H
+
+#include "sensors/SensorLog.h"
+
+/**
+ * @brief Synthetic scenarios.
+ */
+enum SynthScenario : uint8_t {
+  SYNTH_OFF,             ///< No synthetic signal.
+  SYNTH_FREE_FALL,       ///< At rest, 1 s of free fall and an impact, every 5 s.
+  SYNTH_PRESSURE_LEAK,   ///< Pressure drops 2 hPa/s after 2 s, down to 30 hPa below start.
+  SYNTH_VIBRATION,       ///< 23.3 Hz vibration, 3 m/s^2 vertical and 1 m/s^2 lateral.
+  SYNTH_NOISE,           ///< At rest with strong noise on every channel.
+  SYNTH_SCENARIO_COUNT
+};
+
+/**
+ * @brief Generator state.
+ */
+struct SynthGenerator {
+  SynthScenario scenario;
+  uint64_t startUs;      ///< Scenario time zero.
+  uint32_t rng[3];       ///< Noise state of the IMU, environment and power channels.
+};
+
+/**
+ * @brief Starts a scenario.
+ * 
+ * @param gen Generator to (re)start.
+ * @param scenario Scenario to play.
+ * @param startUs Time of the scenario start in us.
+ * @param seed Noise seed; equal seeds give equal samples.
+ */
+void synthStart(SynthGenerator* gen, SynthScenario scenario, uint64_t startUs, uint32_t seed);
+
+/**
+ * @brief Generates the IMU sample at the given time (us).
+ */
+void synthImu(SynthGenerator* gen, uint64_t nowUs, ImuSample* out);
+
+/**
+ * @brief Generates the BME280 sample at the given time (us).
+ */
+void synthEnv(SynthGenerator* gen, uint64_t nowUs, EnvSample* out);
+
+/**
+ * @brief Generates the supply voltage sample at the given time (us).
+ */
+void synthPower(SynthGenerator* gen, uint64_t nowUs, PowerSample* out);
+
+#endif // SIGNALGENERATOR_H
@@ -10,6 +10,8 @@
 #ifndef VOLTAGEMEASUREMENT_H
 #define VOLTAGEMEASUREMENT_H
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -45,6 +47,22 @@ float getVbatVoltage(void);
  */
 float getUsbVoltage(void);
 
+/**
+ * @brief Returns the time of the latest voltage measurement.
+ * 
+ * @return uint32_t millis() when the voltages were measured.
+ */
+uint32_t getVoltageSampleTime(void);
+
+/**
+ * @brief Takes a measurement in place of the voltage task (replay, host harnesses).
+ * 
+ * @param vbat Battery voltage in volts.
+ * @param usb USB voltage in volts.
+ * @param timestampMs Measurement time (millis()).
+ */
+void feedVoltageSample(float vbat, float usb, uint32_t timestampMs);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,132 @@
+/**
+ * @file StateRegistry.h
+ * @brief Typed registry of the shared system state, with change notifications.
+ * 
+ * Every value shared between tasks (current mode, alarm parameters, plot source, last
+ * input, ...) is a field of this registry instead of a plain global. Fields are 32-bit
+ * atomics, so reads and writes are lock-free from any task. Writes are range checked,
+ * and every change bumps the field's version and calls the subscribed listeners, so
+ * consumers react immediately instead of polling.
+ */
+
+#ifndef STATEREGISTRY_H
+#define STATEREGISTRY_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Value type of a field.
+ */
+enum StateType : uint8_t {
+  STATE_INT,     ///< int32_t.
+  STATE_FLOAT    ///< float.
+};
+
+// X(id, name, type, initial, min, max)
+// Limits may use MODE_COUNT, ROLLING_PLOT_SOURCES, CH_GROUP_ALL and ButtonEvent_t
+// values; they are only evaluated in StateRegistry.cpp.
+#define STATE_TABLE(X) \
+  X(STATE_CURRENT_MODE,     "mode",          STATE_INT,   0,  0,  MODE_COUNT - 1)        \
+  X(STATE_DEFAULT_MODE,     "defaultMode",   STATE_INT,   0,  0,  MODE_COUNT - 1)        \
+  X(STATE_INIT_PRESSURE,    "initPressure",  STATE_FLOAT, 0,  0,  2000)                  \
+  X(STATE_DELTA_PRESSURE,   "deltaPressure", STATE_FLOAT, 10, 0,  200)                   \
+  X(STATE_GRAVITY_ALARM_AT, "gravityAlarm",  STATE_FLOAT, 1,  0,  20)                    \
+  X(STATE_ROLLING_PLOT,     "rollingPlot",   STATE_INT,   3,  1,  ROLLING_PLOT_SOURCES)  \
+  X(STATE_PROFILE_PERIOD,   "profilePeriod", STATE_INT,   0,  0,  3600)                  \
+  X(STATE_KEYFRAME_INTERVAL,"keyframe",      STATE_INT,   1,  1,  3600)                  \
+  X(STATE_TELEMETRY_GROUPS, "groups",        STATE_INT,   CH_GROUP_ALL, 0, CH_GROUP_ALL) \
+  X(STATE_PERIOD_STATUS,    "periodStatus",  STATE_INT,   1000, 50, 3600000)             \
+  X(STATE_PERIOD_VOLTAGES,  "periodVolt",    STATE_INT,   1000, 50, 3600000)             \
+  X(STATE_PERIOD_IMU,       "periodImu",     STATE_INT,   1000, 50, 3600000)             \
+  X(STATE_PERIOD_BME,       "periodBme",     STATE_INT,   1000, 50, 3600000)             \
+  X(STATE_LAST_TOUCH,       "touch",         STATE_INT,   -1, -1, BUTTON_EVENT_TOUCH_DOWN)\
+  X(STATE_LAST_BUTTON,      "button",        STATE_INT,   -1, -1, BUTTON_EVENT_PUSH_16)
+
+/**
+ * @brief Fields of the registry.
+ * 
+ * - STATE_CURRENT_MODE: active mode (0 to MODE_COUNT - 1), switched by the mode task.
+ * - STATE_DEFAULT_MODE: mode loaded at boot, persisted in flash.
+ * - STATE_INIT_PRESSURE: pressure at boot in hPa, reference of the Mode 2 alarm.
+ * - STATE_DELTA_PRESSURE: pressure drop in hPa that raises the Mode 2 alarm.
+ * - STATE_GRAVITY_ALARM_AT: acceleration magnitude in m/s^2 below which Mode 1 alarms.
+ * - STATE_ROLLING_PLOT: Mode 4 plot source (1 to ROLLING_PLOT_SOURCES).
+ * - STATE_PROFILE_PERIOD: task profile telemetry period in seconds (0 = off).
+ * - STATE_KEYFRAME_INTERVAL: sends of a telemetry group per full snapshot; in between
+ *   only the channels that changed beyond their deadband are sent (1 = always in full).
+ * - STATE_TELEMETRY_GROUPS: telemetry groups published (bit 1 << ChannelGroup each).
+ * - STATE_PERIOD_*: publish period of each telemetry group in ms (50 ms = 20 Hz max).
+ * - STATE_LAST_TOUCH / STATE_LAST_BUTTON: last touch pad / push button event since
+ *   the last telemetry packet (ButtonEvent_t), -1 if none.
+ */
+enum StateId : uint8_t {
+#define STATE_TABLE_ID(id, name, type, initial, min, max) id,
+  STATE_TABLE(STATE_TABLE_ID)
+#undef STATE_TABLE_ID
+  STATE_COUNT
+};
+
+/// @brief Maximum number of listeners over all fields.
+#define STATE_MAX_LISTENERS 8
+
+/**
+ * @brief Change listener.
+ * 
+ * Called in the context of the task that wrote the field, after the new value is
+ * visible. Must not block; typically it wakes or posts to the task that owns the work.
+ * 
+ * @param id Changed field.
+ * @param version Field version after the change.
+ * @param arg Argument given to stateSubscribe().
+ */
+typedef void (*StateListener)(StateId id, uint32_t version, void* arg);
+
+/**
+ * @brief Sets every field to its initial value. Call once at the start of setup().
+ */
+void stateInit(void);
+
+/**
+ * @brief Reads an integer field.
+ */
+int32_t stateGetInt(StateId id);
+
+/**
+ * @brief Reads a float field.
+ */
+float stateGetFloat(StateId id);
+
+/**
+ * @brief Writes an integer field.
+ * 
+ * @return false if the value is out of range or the field is not an integer; the
+ *         field is unchanged.
+ */
+bool stateSetInt(StateId id, int32_t value);
+
+/**
+ * @brief Writes a float field.
+ * 
+ * @return false if the value is out of range (or NaN) or the field is not a float;
+ *         the field is unchanged.
+ */
+bool stateSetFloat(StateId id, float value);
+
+/**
+ * @brief Returns the version of a field, incremented on every change.
+ */
+uint32_t stateVersion(StateId id);
+
+/**
+ * @brief Returns the name of a field, as used in telemetry.
+ */
+const char* stateName(StateId id);
+
+/**
+ * @brief Registers a listener for changes of one field.
+ * 
+ * @return false if all STATE_MAX_LISTENERS slots are taken.
+ */
+bool stateSubscribe(StateId id, StateListener listener, void* arg);
+
+#endif // STATEREGISTRY_H
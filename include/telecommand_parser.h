@@ -0,0 +1,72 @@
+/**
+ * @file telecommand_parser.h
+ * @brief Platform-independent parsing of inbound telecommands.
+ * 
+ * Only depends on the C standard library (no Arduino, FreeRTOS or ESP-IDF headers),
+ * so the parser can be compiled and exercised on a host as well as on the board.
+ * inbound_processor.cpp performs the actions; this module only decodes messages.
+ */
+
+#ifndef TELECOMMAND_PARSER_H
+#define TELECOMMAND_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Recognised telecommands.
+ */
+enum TelecommandType {
+  TC_UNKNOWN,            ///< Not a known telecommand.
+  TC_SET_MODE,           ///< "SetMode:<mode>"
+  TC_SET_DEFAULT_MODE,   ///< "SetDefaultMode:<mode>"
+  TC_PACKET,             ///< "PacketID:<id>:<data>"
+  TC_SET_PROFILE,        ///< "SetProfile:<seconds>"
+  TC_DUMP_FRAME,         ///< "DumpFrame"
+  TC_RECORD,             ///< "Record:<seconds>" (0 stops)
+  TC_REPLAY,             ///< "Replay"
+  TC_SYNTH,              ///< "Synth:<scenario>" (0 = live sensors)
+  TC_BENCH,              ///< "Bench"
+  TC_FAULT,              ///< "Fault:<kind>[:<ms>]"
+  TC_TRACE,              ///< "Trace:<action>"
+  TC_ALLOC_GUARD,        ///< "AllocGuard:<0|1>"
+  TC_SET_KEYFRAME,       ///< "SetKeyframe:<packets>"
+  TC_SET_RATE,           ///< "SetRate:<group>:<ms>"
+  TC_SUBSCRIBE           ///< "Subscribe:<group mask>"
+};
+
+/**
+ * @brief Decoded telecommand.
+ */
+struct Telecommand {
+  TelecommandType type;  ///< Command type.
+  int32_t value;         ///< Mode, packet ID, period, interval, group, scenario or fault; 0 if the command has none.
+  int32_t arg;           ///< Second number (Fault duration, SetRate period); 0 if the command has none.
+  const uint8_t* data;   ///< PacketID payload (points into the message), NULL otherwise.
+  size_t dataLength;     ///< PacketID payload length in bytes.
+  uint32_t hash;         ///< djb2 hash of the whole message.
+};
+
+/**
+ * @brief djb2 hash (hash * 33 + byte) of a buffer.
+ * 
+ * @param data Bytes to hash.
+ * @param length Number of bytes.
+ * @param seed Initial value, or a previous result to continue a hash.
+ */
+uint32_t djb2Hash(const uint8_t* data, size_t length, uint32_t seed = 5381);
+
+/**
+ * @brief Decodes a telecommand message.
+ * 
+ * Numbers are read like Arduino's String::toInt(): surrounding whitespace is ignored
+ * and a missing number reads as 0. Range checks are left to the caller.
+ * 
+ * @param msg Raw message bytes (not NUL terminated).
+ * @param length Message length.
+ * @param out Decoded command; type is TC_UNKNOWN if not recognised.
+ * @return true if the message is a recognised, well-formed telecommand.
+ */
+bool parseTelecommand(const uint8_t* msg, size_t length, Telecommand* out);
+
+#endif // TELECOMMAND_PARSER_H
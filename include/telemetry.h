@@ -0,0 +1,32 @@
+/**
+ * @file telemetry.h
+ * @brief Construction of the periodic telemetry packet.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "ChannelTable.h"
+
+/**
+ * @brief Builds the JSON telemetry packet from the latest sensor values.
+ *
+ * Contains the channels of the given groups (mode, voltages, IMU and BME280 readings,
+ * WiFi RSSI). Used by the telemetry task and by the benchmarks.
+ *
+ * @param payload Replaced with the packet.
+ * @param withAlarms Also takes the pending alarm transitions into the packet. Each
+ *        transition is reported once, so only the telemetry task passes true.
+ * @param reporter Report-by-exception state of the stream (see ChannelTable.h);
+ *        NULL for a full packet.
+ * @param groups Channel groups to include (bit 1 << ChannelGroup each).
+ */
+void buildTelemetryPayload(String& payload, bool withAlarms, ChannelReporter* reporter, uint32_t groups);
+
+/**
+ * @brief Wakes the telemetry task, so a new group period or subscription applies at once.
+ */
+void telemetryReschedule();
+
+#endif // TELEMETRY_H
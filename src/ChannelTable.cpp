@@ -0,0 +1,144 @@
+#include "ChannelTable.h"
+#include "MqttTask.h"
+#include "sensors/IMU.h"
+#include "sensors/BME280Measurement.h"
+#include "sensors/VoltageMeasurement.h"
+#include "state/StateRegistry.h"
+#include <math.h>
+
+// The IMU sample of the pass, taken on its first IMU channel.
+static const IMUEvents_t& imuSample(ChannelSnapshot& snapshot) {
+  if (!snapshot.imuTaken) {
+    snapshot.imu = getIMUData();
+    snapshot.imuTaken = true;
+  }
+  return snapshot.imu;
+}
+
+// Channel sources.
+static float readMode(ChannelSnapshot&) { return (float)stateGetInt(STATE_CURRENT_MODE); }
+static float readBattVolt(ChannelSnapshot&) { return getVbatVoltage(); }
+static float readBusVolt(ChannelSnapshot&) { return getUsbVoltage(); }
+static float readAccelX(ChannelSnapshot& s) { return imuSample(s).accel.acceleration.x; }
+static float readAccelY(ChannelSnapshot& s) { return imuSample(s).accel.acceleration.y; }
+static float readAccelZ(ChannelSnapshot& s) { return imuSample(s).accel.acceleration.z; }
+static float readGyroX(ChannelSnapshot& s) { return imuSample(s).gyro.gyro.x; }
+static float readGyroY(ChannelSnapshot& s) { return imuSample(s).gyro.gyro.y; }
+static float readGyroZ(ChannelSnapshot& s) { return imuSample(s).gyro.gyro.z; }
+static float readImuTemp(ChannelSnapshot& s) { return imuSample(s).temp.temperature; }
+static float readBmeTemp(ChannelSnapshot&) { return getBMETemperature(); }
+static float readPres(ChannelSnapshot&) { return getBMEPressure(); }
+static float readHumi(ChannelSnapshot&) { return getBMEHumidity(); }
+static float readRssi(ChannelSnapshot&) { return (float)getWiFiRSSI(); }
+
+typedef float (*ChannelSource)(ChannelSnapshot&);
+
+static ChannelSource const channelSources[CHANNEL_COUNT] = {
+#define CHANNEL_TABLE_SOURCE(id, name, group, unit, scale, precision, deadband, source) source,
+  CHANNEL_TABLE(CHANNEL_TABLE_SOURCE)
+#undef CHANNEL_TABLE_SOURCE
+};
+
+float channelRead(ChannelId id, ChannelSnapshot& snapshot) {
+  return channelSources[id](snapshot) * channelTable[id].scale;
+}
+
+float channelRead(ChannelId id) {
+  ChannelSnapshot snapshot;
+  return channelRead(id, snapshot);
+}
+
+void appendChannelsJson(String& payload, ChannelReporter* reporter, uint32_t groups) {
+  int openGroup = -1;           // named group whose object is open
+  bool firstMember = true;      // no member written yet at the current level
+  ChannelSnapshot snapshot;
+
+  // Groups sent in full. Without report by exception that is every group, and the
+  // packet carries no marker.
+  uint32_t keyframes = groups;
+  if (reporter != NULL && reporter->keyframeInterval > 1) {
+    keyframes = 0;
+    for (int group = 0; group < CH_GROUP_COUNT; group++) {
+      if ((groups & (1u << group)) == 0) continue;
+      uint32_t& left = reporter->framesToKeyframe[group];
+      if (left >= reporter->keyframeInterval) {
+        left = 0;   // interval shortened
+      }
+      if (left == 0) {
+        keyframes |= 1u << group;
+        left = reporter->keyframeInterval - 1;
+        reporter->keyframeSeq[group]++;
+      } else {
+        left--;
+      }
+    }
+    payload += "\"kf\":";
+    payload += String(keyframes);
+    // Lets the receiver tell which keyframe the deltas refer to, and so a missed one.
+    payload += ",\"ks\":[";
+    for (int group = 0; group < CH_GROUP_COUNT; group++) {
+      if (group > 0) payload += ",";
+      payload += String(reporter->keyframeSeq[group]);
+    }
+    payload += "]";
+    firstMember = false;
+  }
+
+  for (int i = 0; i < CHANNEL_COUNT; i++) {
+    const ChannelSpec& spec = channelTable[i];
+    uint32_t groupBit = 1u << spec.group;
+    if ((groups & groupBit) == 0) continue;
+    float value = channelRead((ChannelId)i, snapshot);
+    if (reporter != NULL) {
+      if (keyframes & groupBit) {
+        reporter->keyframe[i] = value;
+      } else if (fabsf(value - reporter->keyframe[i]) <= spec.deadband) {
+        continue;
+      }
+    }
+
+    if (openGroup >= 0 && spec.group != openGroup) {
+      payload += "}";
+      openGroup = -1;
+      firstMember = false;
+    }
+    if (openGroup < 0 && channelGroupName[spec.group] != NULL) {
+      payload += firstMember ? "\"" : ",\"";
+      payload += channelGroupName[spec.group];
+      payload += "\":{";
+      openGroup = spec.group;
+      firstMember = true;
+    }
+    payload += firstMember ? "\"" : ",\"";
+    payload += spec.name;
+    payload += "\":";
+    payload += String(value, (unsigned int)spec.precision);
+    firstMember = false;
+  }
+  if (openGroup >= 0) {
+    payload += "}";
+  }
+}
+
+void formatChannelCell(char cell[TABLE_CELL_LEN], ChannelId id, ChannelSnapshot& snapshot) {
+  const ChannelSpec& spec = channelTable[id];
+  formatTableCell(cell, spec.name, channelRead(id, snapshot), spec.precision, spec.unit);
+}
+
+void updateChannelTable(const ChannelId* ids, int count) {
+  char cells[MAX_TABLE_ENTRIES][TABLE_CELL_LEN];
+  const char* lines[MAX_TABLE_ENTRIES];
+  ChannelSnapshot snapshot;
+  if (count > MAX_TABLE_ENTRIES) count = MAX_TABLE_ENTRIES;
+  for (int i = 0; i < count; i++) {
+    formatChannelCell(cells[i], ids[i], snapshot);
+    lines[i] = cells[i];
+  }
+  updateTableLines(lines, count);
+}
+
+void formatChannelLabel(char* label, size_t size, ChannelId id) {
+  const ChannelSpec& spec = channelTable[id];
+  const char* unit = tableUnitName(spec.unit);
+  snprintf(label, size, unit[0] != '\0' ? "%s %s" : "%s", spec.name, unit);
+}
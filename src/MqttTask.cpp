@@ -3,9 +3,21 @@
 #include <WiFiClientSecure.h>
 #include <PubSubClient.h>
 #include <esp_wpa2.h>
+#include "TaskTable.h"
+#include "telecommand_parser.h"
+#include "diagnostics/Histogram.h"
+#include "diagnostics/Trace.h"
+#include "diagnostics/AllocCounter.h"
 #include "arduino_secrets.h"
+#include <freertos/semphr.h>
 #include <time.h>
 
+// Longest a publisher waits for the connection before the message is dropped.
+#define MQTT_PUBLISH_WAIT_MS 100
+
+// Longest MQTT_FAULT_STALL accepted.
+#define MQTT_STALL_MAX_MS 60000
+
 
 
 // Define the flag; initially, connection has not failed.
@@ -44,8 +56,9 @@ struct MqttMsg {
 
 // Define the global variables
 uint8_t inboundMessage[MQTT_MSG_MAX_LEN] = {0};
-bool newMessageAvailable = false;
+std::atomic<bool> newMessageAvailable(false);
 size_t inboundMessageLength = 0;
+uint32_t inboundMessageUs = 0;
 
 // ---------------------------------------------------------------------
 // #define MQTT_MSG_MAX_LEN 256
@@ -59,6 +72,22 @@ size_t inboundMessageLength = 0;
 
 static QueueHandle_t mqttQueue = NULL;
 
+// PubSubClient is not thread safe: publishers (telemetry task) and the MQTT loop task
+// take this mutex around every client call.
+static SemaphoreHandle_t clientMutex = NULL;
+static StaticSemaphore_t clientMutexBuffer;
+
+// Network path counters (see getMqttStats()).
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+static MqttStats stats = {};
+static Histogram publishHistogram;
+
+// Fault waiting to be applied by the MQTT loop task, 0 if none.
+static portMUX_TYPE faultMux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t pendingFault = 0;
+static uint32_t pendingFaultMs = 0;
+static TaskHandle_t mqttTaskHandle = NULL;
+
 // ---------------------------------------------------------------------
 // // TLS certificate for the MQTT broker
 // static const char tlsPublicCertificate[] = ("\
@@ -123,16 +152,35 @@ void mqttCallback(char* topic, byte *payload, unsigned int length) {
     // // Update the global inboundMessage.
     // // Note: If payload contains binary data, you might need a different approach.
 
+  // Oversize messages are rejected whole; a truncated telecommand could still parse.
+  if (length > MQTT_MSG_MAX_LEN) {
+    portENTER_CRITICAL(&statsMux);
+    stats.rxOversize++;
+    portEXIT_CRITICAL(&statsMux);
+    Serial.printf("Telecommand of %u bytes rejected (max %d)\n", length, MQTT_MSG_MAX_LEN);
+    return;
+  }
+  // The inbound task still owns the buffer: drop rather than overwrite it mid-parse.
+  // Acquire: once it is released, the task has finished reading it.
+  if (newMessageAvailable.load(std::memory_order_acquire)) {
+    portENTER_CRITICAL(&statsMux);
+    stats.rxOverrun++;
+    portEXIT_CRITICAL(&statsMux);
+    Serial.println("Telecommand dropped, previous one not processed yet");
+    return;
+  }
+
   // Update the global inboundMessage with the raw bytes
-  inboundMessageLength =  length ; // (length < MQTT_MSG_MAX_LEN) ? length : MQTT_MSG_MAX_LEN;
+  inboundMessageUs = micros();
+  inboundMessageLength = length;
   memcpy(inboundMessage, payload, inboundMessageLength);
+  portENTER_CRITICAL(&statsMux);
+  stats.received++;
+  portEXIT_CRITICAL(&statsMux);
 
 
       // Calculate a simple hash using the djb2 algorithm
-  unsigned long hash = 5381;
-  for (unsigned int i = 0; i < inboundMessageLength; i++) {
-    hash = ((hash << 5) + hash) + inboundMessage[i]; // hash * 33 + current byte
-  }
+  uint32_t hash = djb2Hash(inboundMessage, inboundMessageLength);
 
     // Print the hash in hexadecimal
     Serial.print("inboundMessage hash (djb2): 0x");
@@ -140,8 +188,8 @@ void mqttCallback(char* topic, byte *payload, unsigned int length) {
 
 
 
-    // Set a flag to indicate a new message is available (optional)
-    newMessageAvailable = true;
+    // Hand the buffer to the inbound task (release: the message is written before).
+    newMessageAvailable.store(true, std::memory_order_release);
   }
   
 
@@ -208,14 +256,20 @@ void mqttConnect() {
     Serial.print("Attempting MQTT connection to ");
     Serial.println(mqttBroker);
     Serial.print("... ");
-    if (client.connect(mqttClientId.c_str(), mqttUser, mqttPassword)) {
+    xSemaphoreTake(clientMutex, portMAX_DELAY);
+    bool connected = client.connect(mqttClientId.c_str(), mqttUser, mqttPassword);
+    if (connected) {
+      client.subscribe(mqttSubscribe.c_str());
+    }
+    int state = client.state();
+    xSemaphoreGive(clientMutex);
+    if (connected) {
       Serial.print("done using client ID ");
       Serial.println(mqttClientId);
-      client.subscribe(mqttSubscribe.c_str());
     } else {
       attempts++;
       Serial.print("failed, rc=");
-      Serial.print(client.state());
+      Serial.print(state);
       delay(3000);
     }
   }
@@ -226,13 +280,73 @@ void mqttConnect() {
 
 }
 
+// Applies a fault requested by mqttInjectFault(), from the MQTT loop task.
+static void applyPendingFault() {
+  portENTER_CRITICAL(&faultMux);
+  uint8_t fault = pendingFault;
+  uint32_t durationMs = pendingFaultMs;
+  pendingFault = 0;
+  portEXIT_CRITICAL(&faultMux);
+
+  switch (fault) {
+    case MQTT_FAULT_DISCONNECT:
+      Serial.println("Fault: dropping the MQTT connection");
+      xSemaphoreTake(clientMutex, portMAX_DELAY);
+      client.disconnect();
+      xSemaphoreGive(clientMutex);
+      break;
+    case MQTT_FAULT_STALL:
+      // Like a broker that stops answering: publishers wait and drop, inbound
+      // messages and keepalives are delayed.
+      Serial.printf("Fault: stalling the MQTT connection for %u ms\n", (unsigned)durationMs);
+      xSemaphoreTake(clientMutex, portMAX_DELAY);
+      vTaskDelay(pdMS_TO_TICKS(durationMs));
+      xSemaphoreGive(clientMutex);
+      break;
+    case MQTT_FAULT_OVERSIZE: {
+      // Goes through the same path as a message from the broker.
+      static byte oversize[MQTT_MSG_MAX_LEN + 1];
+      memset(oversize, 'X', sizeof(oversize));
+      Serial.println("Fault: oversize telecommand");
+      mqttCallback(NULL, oversize, sizeof(oversize));
+      break;
+    }
+  }
+}
+
 // FreeRTOS task that continuously runs the MQTT loop.
+// Also measures how long the connection stays lost until the broker is back.
 void mqttLoopTask(void *pvParameters) {
+  AllocSiteScope site(ALLOC_SITE_MQTT_LOOP);
+  bool lost = false;
+  uint32_t lostAt = 0;
   for (;;) {
-    if (!client.connected()) {
+    applyPendingFault();
+
+    xSemaphoreTake(clientMutex, portMAX_DELAY);
+    bool connected = client.connected();
+    xSemaphoreGive(clientMutex);
+    if (!connected) {
+      if (!lost) {
+        lost = true;
+        lostAt = millis();
+      }
       mqttConnect();
+      continue;
     }
+    if (lost) {
+      lost = false;
+      uint32_t downMs = millis() - lostAt;
+      portENTER_CRITICAL(&statsMux);
+      stats.reconnects++;
+      stats.reconnectMsLast = downMs;
+      if (downMs > stats.reconnectMsMax) stats.reconnectMsMax = downMs;
+      portEXIT_CRITICAL(&statsMux);
+    }
+
+    xSemaphoreTake(clientMutex, portMAX_DELAY);
     client.loop();
+    xSemaphoreGive(clientMutex);
     vTaskDelay(10 / portTICK_PERIOD_MS);
   }
 }
@@ -255,7 +369,10 @@ void mqttLoopTask(void *pvParameters) {
 // Public functions (declared in MqttTask.h)
 
 void initMqttTask() {
-
+  if (clientMutex == NULL) {
+    clientMutex = xSemaphoreCreateMutexStatic(&clientMutexBuffer);
+  }
+  histogramReset(&publishHistogram);
 
   // Generate board-specific MQTT topics.
   String mqttTopic = mqttPrefix + "/" + String(mqttYear) + "/" + String(mqttBoardId) + "/";
@@ -284,6 +401,7 @@ if (wifiConnectionFailed) {
 
   // Setup MQTT server and callback.
   client.setServer(mqttBroker, mqttPort);
+  client.setBufferSize(MQTT_TM_BUFFER_SIZE);
   client.setCallback(mqttCallback);
   
   // Connect to the MQTT broker.
@@ -297,25 +415,72 @@ if (mqttConnectionFailed) {
     }
     
 
-  // Create a FreeRTOS task to continuously process MQTT.
-  xTaskCreatePinnedToCore(
-    mqttLoopTask,   // Task function.
-    "mqttLoopTask", // Name of the task.
-    8192,           // Stack size in bytes. // 4096
-    NULL,           // Task input parameter.
-    1,              // Priority.
-    NULL,           // Task handle.
-    1               // Core where the task should run.
-  );
+  // Create a FreeRTOS task to continuously process MQTT (on the network core).
+  mqttTaskHandle = createTableTask(TASK_MQTT, mqttLoopTask, NULL);
 
 
 }
 
 // Publish an MQTT message (to be called from main.cpp).
+// Messages are dropped (and counted) while the connection is down or busy reconnecting.
 void publishMqttMessage(const String &message) {
-  if (client.connected()) {
-    client.publish(mqttPublish.c_str(), message.c_str());
-  } else {
+  AllocSiteScope site(ALLOC_SITE_PUBLISH);
+  if (clientMutex == NULL ||
+      xSemaphoreTake(clientMutex, pdMS_TO_TICKS(MQTT_PUBLISH_WAIT_MS)) != pdTRUE) {
+    portENTER_CRITICAL(&statsMux);
+    stats.publishDropped++;
+    portEXIT_CRITICAL(&statsMux);
+    return;
+  }
+  if (!client.connected()) {
+    xSemaphoreGive(clientMutex);
+    portENTER_CRITICAL(&statsMux);
+    stats.publishDropped++;
+    portEXIT_CRITICAL(&statsMux);
     Serial.println("MQTT client not connected; cannot publish message.");
+    return;
+  }
+  traceEvent(TRACE_PUBLISH_BEGIN, message.length());
+  uint32_t start = micros();
+  bool sent = client.publish(mqttPublish.c_str(), message.c_str());
+  uint32_t elapsed = micros() - start;
+  traceEvent(TRACE_PUBLISH_END, sent);
+  xSemaphoreGive(clientMutex);
+
+  portENTER_CRITICAL(&statsMux);
+  if (sent) {
+    stats.published++;
+    histogramRecord(&publishHistogram, elapsed);
+  } else {
+    stats.publishFailed++;
+  }
+  portEXIT_CRITICAL(&statsMux);
+}
+
+MqttStats getMqttStats() {
+  portENTER_CRITICAL(&statsMux);
+  MqttStats copy = stats;
+  copy.publishP50Us = histogramPercentile(&publishHistogram, 50);
+  copy.publishP95Us = histogramPercentile(&publishHistogram, 95);
+  copy.publishP99Us = histogramPercentile(&publishHistogram, 99);
+  copy.publishMaxUs = publishHistogram.max;
+  portEXIT_CRITICAL(&statsMux);
+  return copy;
+}
+
+bool mqttInjectFault(MqttFault fault, uint32_t durationMs) {
+  if (mqttTaskHandle == NULL) {
+    return false;
+  }
+  if (fault != MQTT_FAULT_DISCONNECT && fault != MQTT_FAULT_STALL && fault != MQTT_FAULT_OVERSIZE) {
+    return false;
+  }
+  if (durationMs > MQTT_STALL_MAX_MS) {
+    durationMs = MQTT_STALL_MAX_MS;
   }
+  portENTER_CRITICAL(&faultMux);
+  pendingFault = fault;
+  pendingFaultMs = durationMs;
+  portEXIT_CRITICAL(&faultMux);
+  return true;
 }
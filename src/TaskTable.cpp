@@ -0,0 +1,54 @@
+#include "TaskTable.h"
+#include "diagnostics/Trace.h"
+
+// One static stack per table entry (StackType_t is a byte on the ESP32 port).
+#define TASK_TABLE_STACK(id, name, core, priority, stack, period) \
+  static StackType_t id##_stack[stack];
+TASK_TABLE(TASK_TABLE_STACK)
+#undef TASK_TABLE_STACK
+
+static StackType_t* const taskStacks[TASK_COUNT] = {
+#define TASK_TABLE_STACK_PTR(id, name, core, priority, stack, period) id##_stack,
+  TASK_TABLE(TASK_TABLE_STACK_PTR)
+#undef TASK_TABLE_STACK_PTR
+};
+
+static StaticTask_t taskBuffers[TASK_COUNT];
+static TaskHandle_t taskHandles[TASK_COUNT];
+static TaskFunction_t taskFunctions[TASK_COUNT];
+static void* taskParameters[TASK_COUNT];
+
+// Entry of every table task. A task of higher priority, or pinned to the other core,
+// runs before xTaskCreateStaticPinnedToCore() returns, so the task numbers itself
+// before its first trace record or allocation (see TraceRecord::task, AllocCounter).
+static void tableTaskEntry(void* arg) {
+  TaskId id = (TaskId)(uintptr_t)arg;
+  vTaskSetTaskNumber(xTaskGetCurrentTaskHandle(), id + 1);
+  taskFunctions[id](taskParameters[id]);
+}
+
+TaskHandle_t createTableTask(TaskId id, TaskFunction_t function, void* parameter) {
+  if (id >= TASK_COUNT) {
+    return NULL;
+  }
+  if (taskHandles[id] == NULL) {
+    const TaskSpec& spec = taskTable[id];
+    taskFunctions[id] = function;
+    taskParameters[id] = parameter;
+    taskHandles[id] = xTaskCreateStaticPinnedToCore(
+      tableTaskEntry,       // Task function (calls `function`).
+      spec.name,            // Task name.
+      spec.stackBytes,      // Stack size in bytes.
+      (void*)(uintptr_t)id, // Parameter.
+      spec.priority,        // Priority.
+      taskStacks[id],       // Stack buffer.
+      &taskBuffers[id],     // Task control block.
+      spec.core             // Core ID.
+    );
+  }
+  return taskHandles[id];
+}
+
+TaskHandle_t getTableTaskHandle(TaskId id) {
+  return (id < TASK_COUNT) ? taskHandles[id] : NULL;
+}
@@ -0,0 +1,199 @@
+#include "alarms/AlarmEngine.h"
+#include "FreeRTOS.h"
+#include "queue.h"
+#include <atomic>
+
+// Transitions waiting for the next telemetry packet.
+#define ALARM_EVENT_QUEUE_LEN 16
+
+struct AlarmSlot {
+  AlarmConfig config;
+  bool configured;
+  bool enabled;
+  bool acknowledged;       // ACTIVE alarm silenced by alarmAcknowledge()
+  AlarmState state;
+  uint32_t pendingSince;   // when the condition appeared (PENDING)
+  uint32_t lastAction;     // when the action last ran (ACTIVE)
+};
+
+static AlarmSlot alarms[ALARM_COUNT];
+static portMUX_TYPE alarmMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Created by the first alarmConfigure(), polled from the telemetry task.
+static std::atomic<QueueHandle_t> alarmEventQueue(NULL);
+static StaticQueue_t alarmEventQueueBuffer;
+static uint8_t alarmEventQueueStorage[ALARM_EVENT_QUEUE_LEN * sizeof(AlarmEvent)];
+
+// Queues a transition; if telemetry has fallen behind, the oldest one is dropped.
+static void reportTransition(AlarmId id, AlarmState state, float value, uint32_t timestampMs) {
+  QueueHandle_t queue = alarmEventQueue.load(std::memory_order_acquire);
+  if (queue == NULL) {
+    return;
+  }
+  AlarmEvent event = {id, state, value, timestampMs};
+  if (xQueueSend(queue, &event, 0) != pdTRUE) {
+    AlarmEvent oldest;
+    xQueueReceive(queue, &oldest, 0);
+    xQueueSend(queue, &event, 0);
+  }
+}
+
+void alarmConfigure(AlarmId id, const AlarmConfig& config) {
+  if (id >= ALARM_COUNT) return;
+  if (alarmEventQueue.load(std::memory_order_relaxed) == NULL) {
+    alarmEventQueue.store(xQueueCreateStatic(ALARM_EVENT_QUEUE_LEN, sizeof(AlarmEvent),
+                                             alarmEventQueueStorage, &alarmEventQueueBuffer),
+                          std::memory_order_release);
+  }
+  portENTER_CRITICAL(&alarmMux);
+  AlarmSlot& slot = alarms[id];
+  slot.config = config;
+  slot.configured = true;
+  slot.enabled = false;
+  slot.acknowledged = false;
+  slot.state = ALARM_STATE_CLEAR;
+  portEXIT_CRITICAL(&alarmMux);
+}
+
+void alarmEnable(AlarmId id, bool enabled) {
+  if (id >= ALARM_COUNT) return;
+  portENTER_CRITICAL(&alarmMux);
+  AlarmSlot& slot = alarms[id];
+  bool wasRaised = slot.state == ALARM_STATE_ACTIVE || slot.state == ALARM_STATE_LATCHED;
+  slot.enabled = enabled && slot.configured;
+  if (!slot.enabled) {
+    slot.state = ALARM_STATE_CLEAR;
+    slot.acknowledged = false;
+  }
+  portEXIT_CRITICAL(&alarmMux);
+
+  if (!enabled && wasRaised) {
+    reportTransition(id, ALARM_STATE_CLEAR, NAN, millis());
+  }
+}
+
+void alarmSetThreshold(AlarmId id, float threshold) {
+  if (id >= ALARM_COUNT) return;
+  portENTER_CRITICAL(&alarmMux);
+  alarms[id].config.threshold = threshold;
+  portEXIT_CRITICAL(&alarmMux);
+}
+
+void alarmFeed(AlarmId id, float value, uint32_t timestampMs) {
+  if (id >= ALARM_COUNT) return;
+
+  bool runAction = false;
+  bool changed = false;
+  void (*action)(AlarmId) = NULL;
+
+  portENTER_CRITICAL(&alarmMux);
+  AlarmSlot& slot = alarms[id];
+  if (!slot.enabled) {
+    portEXIT_CRITICAL(&alarmMux);
+    return;
+  }
+  const AlarmConfig& cfg = slot.config;
+  bool beyond, recovered;
+  if (cfg.direction == ALARM_BELOW) {
+    beyond = value < cfg.threshold;
+    recovered = value >= cfg.threshold + cfg.hysteresis;
+  } else {
+    beyond = value > cfg.threshold;
+    recovered = value <= cfg.threshold - cfg.hysteresis;
+  }
+
+  switch (slot.state) {
+    case ALARM_STATE_CLEAR:
+      if (!beyond) break;
+      slot.state = ALARM_STATE_PENDING;
+      slot.pendingSince = timestampMs;
+      [[fallthrough]];   // a zero debounce raises on the first sample
+    case ALARM_STATE_PENDING:
+      if (!beyond) {
+        slot.state = ALARM_STATE_CLEAR;
+      } else if (timestampMs - slot.pendingSince >= cfg.debounceMs) {
+        slot.state = ALARM_STATE_ACTIVE;
+        slot.acknowledged = false;
+        slot.lastAction = timestampMs;
+        changed = true;
+        runAction = true;
+      }
+      break;
+    case ALARM_STATE_ACTIVE:
+      if (recovered) {
+        slot.state = cfg.latch ? ALARM_STATE_LATCHED : ALARM_STATE_CLEAR;
+        changed = true;
+      } else if (!slot.acknowledged && timestampMs - slot.lastAction >= cfg.actionIntervalMs) {
+        slot.lastAction = timestampMs;
+        runAction = true;
+      }
+      break;
+    case ALARM_STATE_LATCHED:
+      // Re-raised immediately, as the debounce already passed once for this latch. It
+      // is raised like a new alarm: the action runs and an earlier acknowledge is dropped.
+      if (beyond) {
+        slot.state = ALARM_STATE_ACTIVE;
+        slot.acknowledged = false;
+        slot.lastAction = timestampMs;
+        changed = true;
+        runAction = true;
+      }
+      break;
+  }
+  AlarmState newState = slot.state;
+  action = cfg.action;
+  portEXIT_CRITICAL(&alarmMux);
+
+  if (changed) {
+    reportTransition(id, newState, value, timestampMs);
+  }
+  if (runAction && action != NULL) {
+    action(id);
+  }
+}
+
+void alarmAcknowledge(AlarmId id) {
+  if (id >= ALARM_COUNT) return;
+  bool cleared = false;
+  portENTER_CRITICAL(&alarmMux);
+  AlarmSlot& slot = alarms[id];
+  if (slot.state == ALARM_STATE_LATCHED) {
+    slot.state = ALARM_STATE_CLEAR;
+    cleared = true;
+  } else if (slot.state == ALARM_STATE_ACTIVE) {
+    slot.acknowledged = true;
+  }
+  portEXIT_CRITICAL(&alarmMux);
+
+  if (cleared) {
+    reportTransition(id, ALARM_STATE_CLEAR, NAN, millis());
+  }
+}
+
+AlarmState alarmGetState(AlarmId id) {
+  if (id >= ALARM_COUNT) return ALARM_STATE_CLEAR;
+  return alarms[id].state;
+}
+
+const char* alarmName(AlarmId id) {
+  if (id >= ALARM_COUNT || !alarms[id].configured) return "";
+  return alarms[id].config.name;
+}
+
+const char* alarmStateName(AlarmState state) {
+  switch (state) {
+    case ALARM_STATE_CLEAR:   return "CLEAR";
+    case ALARM_STATE_PENDING: return "PENDING";
+    case ALARM_STATE_ACTIVE:  return "ACTIVE";
+    case ALARM_STATE_LATCHED: return "LATCHED";
+  }
+  return "";
+}
+
+bool alarmPollEvent(AlarmEvent* event) {
+  QueueHandle_t queue = alarmEventQueue.load(std::memory_order_acquire);
+  if (queue == NULL) {
+    return false;
+  }
+  return xQueueReceive(queue, event, 0) == pdTRUE;
+}
@@ -0,0 +1,194 @@
+#include "diagnostics/AllocCounter.h"
+#include <esp_heap_caps.h>
+
+// Updated from the heap hooks on both cores, hence the atomic builtins.
+static uint32_t allocCount = 0;
+static uint32_t freeCount  = 0;
+static uint32_t allocBytes = 0;
+
+static uint32_t taskAllocCount[ALLOC_TASK_SLOTS];
+static uint32_t taskAllocBytes[ALLOC_TASK_SLOTS];
+static uint32_t siteAllocCount[ALLOC_SITE_COUNT];
+static uint32_t siteAllocBytes[ALLOC_SITE_COUNT];
+
+// Current site of each task slot, set by AllocSiteScope.
+static volatile AllocSite taskSite[ALLOC_TASK_SLOTS];
+
+// Guard state. The last violation is packed (slot << 24 | site << 16 | size) so the
+// hook can store it with one write.
+static volatile bool guardArmed = false;
+static uint32_t guardViolations = 0;
+static uint32_t lastViolation = 0;
+static uint32_t reportedViolations = 0;   // reportAllocGuardViolations() only
+
+static const char* const siteNames[ALLOC_SITE_COUNT] = {
+#define ALLOC_SITE_NAME(id, name) name,
+  ALLOC_SITE_TABLE(ALLOC_SITE_NAME)
+#undef ALLOC_SITE_NAME
+};
+
+// Slot of the running task: table tasks carry TaskId + 1 as FreeRTOS task number.
+// In IRAM, as the heap hooks calling it: allocations may happen with the cache disabled.
+static uint8_t IRAM_ATTR currentTaskSlot(void)
+{
+  UBaseType_t number = uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle());
+  return (number < ALLOC_TASK_SLOTS) ? (uint8_t)number : 0;
+}
+
+AllocSiteScope::AllocSiteScope(AllocSite site) : slot(currentTaskSlot()), previous(taskSite[slot])
+{
+  taskSite[slot] = site;
+}
+
+AllocSiteScope::~AllocSiteScope()
+{
+  taskSite[slot] = previous;
+}
+
+#ifdef CONFIG_HEAP_USE_HOOKS
+
+// Called by the IDF heap after every successful allocation.
+extern "C" void IRAM_ATTR esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps)
+{
+  (void) ptr;
+  (void) caps;
+  __atomic_fetch_add(&allocCount, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&allocBytes, (uint32_t)size, __ATOMIC_RELAXED);
+
+  uint8_t slot = currentTaskSlot();
+  AllocSite site = taskSite[slot];
+  __atomic_fetch_add(&taskAllocCount[slot], 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&taskAllocBytes[slot], (uint32_t)size, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&siteAllocCount[site], 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&siteAllocBytes[site], (uint32_t)size, __ATOMIC_RELAXED);
+
+  if (guardArmed) {
+    uint32_t packed = ((uint32_t)slot << 24) | ((uint32_t)site << 16) | (size > 0xFFFF ? 0xFFFF : size);
+    __atomic_store_n(&lastViolation, packed, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&guardViolations, 1, __ATOMIC_RELAXED);
+  }
+}
+
+// Called by the IDF heap on every free.
+extern "C" void IRAM_ATTR esp_heap_trace_free_hook(void* ptr)
+{
+  (void) ptr;
+  __atomic_fetch_add(&freeCount, 1, __ATOMIC_RELAXED);
+}
+
+bool allocCounterAvailable(void)
+{
+  return true;
+}
+
+#else
+
+bool allocCounterAvailable(void)
+{
+  return false;
+}
+
+#endif // CONFIG_HEAP_USE_HOOKS
+
+uint32_t getAllocCount(void)
+{
+  return __atomic_load_n(&allocCount, __ATOMIC_RELAXED);
+}
+
+uint32_t getFreeCount(void)
+{
+  return __atomic_load_n(&freeCount, __ATOMIC_RELAXED);
+}
+
+uint32_t getAllocBytes(void)
+{
+  return __atomic_load_n(&allocBytes, __ATOMIC_RELAXED);
+}
+
+uint32_t getTaskAllocCount(int taskSlot)
+{
+  if (taskSlot < 0 || taskSlot >= ALLOC_TASK_SLOTS) return 0;
+  return __atomic_load_n(&taskAllocCount[taskSlot], __ATOMIC_RELAXED);
+}
+
+uint32_t getTaskAllocBytes(int taskSlot)
+{
+  if (taskSlot < 0 || taskSlot >= ALLOC_TASK_SLOTS) return 0;
+  return __atomic_load_n(&taskAllocBytes[taskSlot], __ATOMIC_RELAXED);
+}
+
+uint32_t getSiteAllocCount(AllocSite site)
+{
+  if (site >= ALLOC_SITE_COUNT) return 0;
+  return __atomic_load_n(&siteAllocCount[site], __ATOMIC_RELAXED);
+}
+
+uint32_t getSiteAllocBytes(AllocSite site)
+{
+  if (site >= ALLOC_SITE_COUNT) return 0;
+  return __atomic_load_n(&siteAllocBytes[site], __ATOMIC_RELAXED);
+}
+
+const char* allocTaskName(int taskSlot)
+{
+  if (taskSlot <= 0 || taskSlot >= ALLOC_TASK_SLOTS) return "other";
+  return taskTable[taskSlot - 1].name;
+}
+
+const char* allocSiteName(AllocSite site)
+{
+  return (site < ALLOC_SITE_COUNT) ? siteNames[site] : "";
+}
+
+void allocGuardArm(bool armed)
+{
+  guardArmed = false;
+  __atomic_store_n(&guardViolations, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&lastViolation, 0, __ATOMIC_RELAXED);
+  reportedViolations = 0;
+  guardArmed = armed;
+}
+
+bool allocGuardArmed(void)
+{
+  return guardArmed;
+}
+
+uint32_t getAllocGuardViolations(void)
+{
+  return __atomic_load_n(&guardViolations, __ATOMIC_RELAXED);
+}
+
+AllocViolation getLastAllocViolation(void)
+{
+  uint32_t packed = __atomic_load_n(&lastViolation, __ATOMIC_RELAXED);
+  AllocViolation violation;
+  violation.taskSlot = (uint8_t)(packed >> 24);
+  violation.site = (AllocSite)((packed >> 16) & 0xFF);
+  violation.size = (uint16_t)(packed & 0xFFFF);
+  return violation;
+}
+
+void reportAllocGuardViolations(Print& out)
+{
+  uint32_t violations = getAllocGuardViolations();
+  if (violations == reportedViolations) {
+    return;
+  }
+  AllocViolation last = getLastAllocViolation();
+  out.printf("Heap allocation after boot: %u new, %u total (last: %s / %s, %u bytes)\n",
+             (unsigned)(violations - reportedViolations), (unsigned)violations,
+             allocTaskName(last.taskSlot), allocSiteName(last.site), (unsigned)last.size);
+  reportedViolations = violations;
+}
+
+HeapFragmentation getHeapFragmentation(void)
+{
+  HeapFragmentation heap;
+  heap.freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  heap.largestFreeBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  heap.fragmentationPermille = (heap.freeBytes > 0)
+      ? (uint16_t)(1000 - (uint64_t)heap.largestFreeBlock * 1000 / heap.freeBytes)
+      : 0;
+  return heap;
+}
@@ -0,0 +1,186 @@
+#include "diagnostics/Benchmark.h"
+#include "diagnostics/AllocCounter.h"
+#include "telecommand_parser.h"
+#include "telemetry.h"
+#include "display.h"
+#include "MqttTask.h"
+#include "hardware/storage.h"
+#include "TaskTable.h"
+#include <SPIFFS.h>
+#include <string.h>
+#include <atomic>
+
+// Scratch file for the flash append case, removed afterwards.
+#define BENCH_FILE "/bench.bin"
+
+// Bytes per flash append, a typical PacketID chunk.
+#define BENCH_APPEND_LEN 128
+
+// Keeps results of the pure cases alive, so the compiler cannot drop the work.
+static volatile uint32_t benchSink;
+
+void benchMeasure(const char* name, BenchFn fn, void* arg, uint32_t iterations, BenchResult* result) {
+  if (iterations == 0) iterations = 1;
+  fn(arg);  // warm-up
+
+  uint32_t bestCycles = UINT32_MAX;
+  uint32_t bestAllocs = UINT32_MAX;
+  uint32_t bestBytes = 0;
+  for (int run = 0; run < BENCH_RUNS; run++) {
+    uint32_t allocs = getAllocCount();
+    uint32_t bytes = getAllocBytes();
+    uint32_t start = ESP.getCycleCount();
+    for (uint32_t i = 0; i < iterations; i++) {
+      fn(arg);
+    }
+    uint32_t cycles = ESP.getCycleCount() - start;
+    allocs = getAllocCount() - allocs;
+    bytes = getAllocBytes() - bytes;
+
+    if (cycles < bestCycles) bestCycles = cycles;
+    if (allocs < bestAllocs) {
+      bestAllocs = allocs;
+      bestBytes = bytes;
+    }
+  }
+
+  result->name = name;
+  result->iterations = iterations;
+  result->nsPerOp = (uint32_t)((uint64_t)bestCycles * 1000 / getCpuFrequencyMhz() / iterations);
+  result->allocsPerOp = (float)bestAllocs / iterations;
+  result->bytesPerOp = (float)bestBytes / iterations;
+}
+
+void printBenchHeader(Print& out) {
+  out.printf("%-20s %8s %10s %10s %10s\n", "case", "iter", "ns/op", "allocs/op", "bytes/op");
+}
+
+void printBenchResult(Print& out, const BenchResult& result) {
+  if (allocCounterAvailable()) {
+    out.printf("%-20s %8u %10u %10.2f %10.1f\n", result.name, (unsigned)result.iterations,
+               (unsigned)result.nsPerOp, result.allocsPerOp, result.bytesPerOp);
+  } else {
+    out.printf("%-20s %8u %10u %10s %10s\n", result.name, (unsigned)result.iterations,
+               (unsigned)result.nsPerOp, "-", "-");
+  }
+}
+
+//--------------------------------------------------
+// Cases
+//--------------------------------------------------
+
+// Raw message as received by mqttCallback().
+struct BenchMessage {
+  uint8_t data[MQTT_MSG_MAX_LEN];
+  size_t length;
+};
+
+static void benchTelemetry(void* arg) {
+  (void) arg;
+  String payload;
+  buildTelemetryPayload(payload, false, NULL, CH_GROUP_ALL);
+  benchSink = payload.length();
+}
+
+static void benchHash(void* arg) {
+  const BenchMessage* msg = (const BenchMessage*)arg;
+  benchSink = djb2Hash(msg->data, msg->length);
+}
+
+static void benchParse(void* arg) {
+  const BenchMessage* msg = (const BenchMessage*)arg;
+  Telecommand cmd;
+  parseTelecommand(msg->data, msg->length, &cmd);
+  benchSink = cmd.hash;
+}
+
+static void benchAppend(void* arg) {
+  appendBytesToFile(BENCH_FILE, ((const BenchMessage*)arg)->data, BENCH_APPEND_LEN);
+}
+
+static void fillMessage(BenchMessage* msg, const char* text, size_t length) {
+  size_t n = strlen(text);
+  memcpy(msg->data, text, n);
+  for (size_t i = n; i < length; i++) {
+    msg->data[i] = (uint8_t)(i * 7);
+  }
+  msg->length = length;
+}
+
+void runBenchmarks(Print& out) {
+  static BenchMessage setMode;
+  static BenchMessage packet;
+  fillMessage(&setMode, "SetMode:3", strlen("SetMode:3"));
+  fillMessage(&packet, "PacketID:42:", MQTT_MSG_MAX_LEN);
+
+  BenchResult result;
+  printBenchHeader(out);
+
+  benchMeasure("telemetry payload", benchTelemetry, NULL, 20, &result);
+  printBenchResult(out, result);
+
+  benchMeasure("djb2 170 B", benchHash, &packet, 1000, &result);
+  printBenchResult(out, result);
+
+  benchMeasure("parse SetMode", benchParse, &setMode, 1000, &result);
+  printBenchResult(out, result);
+
+  benchMeasure("parse PacketID", benchParse, &packet, 1000, &result);
+  printBenchResult(out, result);
+
+  if (benchmarkPlotInsert(&result, 100)) {
+    printBenchResult(out, result);
+  } else {
+    out.println("plot insert: out of memory");
+  }
+
+  BenchResult draws[DISPLAY_MODE_COUNT];
+  if (benchmarkDisplayDraws(draws, 20)) {
+    for (int i = 0; i < DISPLAY_MODE_COUNT; i++) {
+      printBenchResult(out, draws[i]);
+    }
+  } else {
+    out.println("draw: display task did not answer");
+  }
+
+  SPIFFS.remove(BENCH_FILE);
+  benchMeasure("flash append 128 B", benchAppend, &packet, 10, &result);
+  printBenchResult(out, result);
+  SPIFFS.remove(BENCH_FILE);
+}
+
+//--------------------------------------------------
+// Benchmark task
+//--------------------------------------------------
+
+static TaskHandle_t benchTaskHandle = NULL;
+// Destination of the requested run, set before the task is woken.
+static Print* benchOut = NULL;
+// Set from the request until the run has finished; further requests are refused.
+static std::atomic<bool> benchRunning(false);
+
+// FreeRTOS task: runs the suite once per request.
+static void benchTask(void* parameter) {
+  (void) parameter;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    runBenchmarks(*benchOut);
+    benchRunning.store(false, std::memory_order_release);
+  }
+}
+
+bool startBenchmarks(Print& out) {
+  if (benchRunning.exchange(true, std::memory_order_acq_rel)) {
+    return false;
+  }
+  benchOut = &out;
+  if (benchTaskHandle == NULL) {
+    benchTaskHandle = createTableTask(TASK_BENCH, benchTask, NULL);
+  }
+  xTaskNotifyGive(benchTaskHandle);
+  return true;
+}
+
+bool benchmarksRunning() {
+  return benchRunning.load(std::memory_order_acquire);
+}
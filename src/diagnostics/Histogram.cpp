@@ -0,0 +1,58 @@
+#include "diagnostics/Histogram.h"
+#include <string.h>
+
+// Bucket of a value: values 0..3 map to themselves, larger values to
+// 4 * (msb - 1) + the two bits below the most significant one.
+static int bucketOf(uint32_t value) {
+  if (value < 4) {
+    return (int)value;
+  }
+  int msb = 31 - __builtin_clz(value);
+  return 4 * (msb - 1) + (int)((value >> (msb - 2)) & 3);
+}
+
+// Largest value that falls into a bucket.
+static uint32_t bucketUpper(int bucket) {
+  if (bucket < 4) {
+    return (uint32_t)bucket;
+  }
+  int msb = bucket / 4 + 1;
+  uint32_t sub = (uint32_t)(bucket & 3);
+  uint64_t lower = ((uint64_t)(4 + sub)) << (msb - 2);
+  return (uint32_t)(lower + (1ull << (msb - 2)) - 1);
+}
+
+void histogramReset(Histogram* hist) {
+  memset(hist, 0, sizeof(*hist));
+}
+
+void histogramRecord(Histogram* hist, uint32_t value) {
+  hist->buckets[bucketOf(value)]++;
+  hist->count++;
+  if (value > hist->max) {
+    hist->max = value;
+  }
+}
+
+uint32_t histogramPercentile(const Histogram* hist, uint8_t percent) {
+  if (hist->count == 0) {
+    return 0;
+  }
+  if (percent > 100) {
+    percent = 100;
+  }
+  // Rank of the percentile, rounded up so p100 is the last value.
+  uint32_t rank = (uint32_t)(((uint64_t)hist->count * percent + 99) / 100);
+  if (rank == 0) {
+    rank = 1;
+  }
+  uint32_t seen = 0;
+  for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+    seen += hist->buckets[i];
+    if (seen >= rank) {
+      uint32_t upper = bucketUpper(i);
+      return (upper < hist->max) ? upper : hist->max;
+    }
+  }
+  return hist->max;
+}
@@ -0,0 +1,58 @@
+#include "diagnostics/Latency.h"
+#include "diagnostics/Histogram.h"
+
+static portMUX_TYPE latencyMux = portMUX_INITIALIZER_UNLOCKED;
+static Histogram histograms[LATENCY_METRIC_COUNT];
+
+// Telecommand waiting for latencyEffectApplied().
+static bool effectPending = false;
+static uint32_t effectReceivedUs = 0;
+
+static const char* const latencyNames[LATENCY_METRIC_COUNT] = {
+#define LATENCY_NAME(id, name) name,
+  LATENCY_TABLE(LATENCY_NAME)
+#undef LATENCY_NAME
+};
+
+void latencyRecord(LatencyMetric metric, uint32_t value) {
+  portENTER_CRITICAL(&latencyMux);
+  histogramRecord(&histograms[metric], value);
+  portEXIT_CRITICAL(&latencyMux);
+}
+
+void latencyAwaitEffect(uint32_t receivedUs) {
+  portENTER_CRITICAL(&latencyMux);
+  effectPending = true;
+  effectReceivedUs = receivedUs;
+  portEXIT_CRITICAL(&latencyMux);
+}
+
+void latencyEffectApplied() {
+  uint32_t now = micros();
+  portENTER_CRITICAL(&latencyMux);
+  if (effectPending) {
+    histogramRecord(&histograms[LATENCY_TC_EFFECT], now - effectReceivedUs);
+    effectPending = false;
+  }
+  portEXIT_CRITICAL(&latencyMux);
+}
+
+LatencySummary latencyTakeSummary(LatencyMetric metric) {
+  static Histogram copy;   // only used by the reporting task
+  portENTER_CRITICAL(&latencyMux);
+  copy = histograms[metric];
+  histogramReset(&histograms[metric]);
+  portEXIT_CRITICAL(&latencyMux);
+
+  LatencySummary summary;
+  summary.count = copy.count;
+  summary.p50 = histogramPercentile(&copy, 50);
+  summary.p95 = histogramPercentile(&copy, 95);
+  summary.p99 = histogramPercentile(&copy, 99);
+  summary.max = copy.max;
+  return summary;
+}
+
+const char* latencyName(LatencyMetric metric) {
+  return metric < LATENCY_METRIC_COUNT ? latencyNames[metric] : "?";
+}
@@ -0,0 +1,119 @@
+#include "diagnostics/TaskProfiler.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "TaskTable.h"
+#include <esp_heap_caps.h>
+
+// Latest snapshot, read by telemetry and the diagnostics page.
+static SystemProfile profile;
+static portMUX_TYPE profileMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Working copy filled by sampleTaskProfile() (sampling task only).
+static SystemProfile next;
+
+// Lists the tasks of the task table, without CPU shares.
+static void sampleTableTasks(SystemProfile& p) {
+  p.cpuAvailable = false;
+  p.taskCount = 0;
+  for (int id = 0; id < TASK_COUNT && p.taskCount < PROFILER_MAX_TASKS; id++) {
+    TaskHandle_t handle = getTableTaskHandle((TaskId)id);
+    if (handle == NULL) continue;
+    TaskProfileEntry& entry = p.tasks[p.taskCount++];
+    strlcpy(entry.name, taskTable[id].name, PROFILER_NAME_LEN);
+    entry.core = (int8_t)taskTable[id].core;
+    entry.priority = (uint8_t)uxTaskPriorityGet(handle);
+    entry.stackFreeBytes = uxTaskGetStackHighWaterMark(handle);
+    entry.cpuPermille = 0;
+  }
+}
+
+#if configUSE_TRACE_FACILITY
+
+static TaskStatus_t taskStatus[PROFILER_MAX_TASKS];
+
+// Run-time counters of the previous sample, matched by task handle.
+static TaskHandle_t previousHandle[PROFILER_MAX_TASKS];
+static uint32_t previousRunTime[PROFILER_MAX_TASKS];
+static uint8_t previousCount = 0;
+static uint32_t previousTotal = 0;
+
+static void sampleTasks(SystemProfile& p) {
+  uint32_t total = 0;
+  UBaseType_t count = uxTaskGetSystemState(taskStatus, PROFILER_MAX_TASKS, &total);
+  p.truncated = (count == 0);
+  if (p.truncated) {
+    // The list does not fit. The next full sample has no previous one to compare with.
+    sampleTableTasks(p);
+    previousCount = 0;
+    previousTotal = 0;
+    return;
+  }
+  uint32_t elapsed = total - previousTotal;
+
+#if configGENERATE_RUN_TIME_STATS
+  p.cpuAvailable = (previousTotal != 0 && elapsed != 0);
+#else
+  p.cpuAvailable = false;
+#endif
+
+  p.taskCount = (uint8_t)count;
+  for (UBaseType_t i = 0; i < count; i++) {
+    const TaskStatus_t& status = taskStatus[i];
+    TaskProfileEntry& entry = p.tasks[i];
+    strlcpy(entry.name, status.pcTaskName, PROFILER_NAME_LEN);
+#if configTASKLIST_INCLUDE_COREID
+    entry.core = (status.xCoreID == tskNO_AFFINITY) ? -1 : (int8_t)status.xCoreID;
+#else
+    entry.core = -1;
+#endif
+    entry.priority = (uint8_t)status.uxCurrentPriority;
+    entry.stackFreeBytes = status.usStackHighWaterMark;  // bytes on the ESP32 port
+    entry.cpuPermille = 0;
+    if (p.cpuAvailable) {
+      for (uint8_t j = 0; j < previousCount; j++) {
+        if (previousHandle[j] == status.xHandle) {
+          uint64_t delta = status.ulRunTimeCounter - previousRunTime[j];
+          uint64_t permille = delta * 1000 / elapsed;
+          entry.cpuPermille = (uint16_t)(permille > 1000 ? 1000 : permille);
+          break;
+        }
+      }
+    }
+  }
+
+  for (UBaseType_t i = 0; i < count; i++) {
+    previousHandle[i] = taskStatus[i].xHandle;
+    previousRunTime[i] = taskStatus[i].ulRunTimeCounter;
+  }
+  previousCount = (uint8_t)count;
+  previousTotal = total;
+}
+
+#else
+
+// Without the trace facility only the tasks of the task table can be listed.
+static void sampleTasks(SystemProfile& p) {
+  p.truncated = false;
+  sampleTableTasks(p);
+}
+
+#endif
+
+void sampleTaskProfile(void) {
+  next.sampleMs = millis();
+  next.taskTotal = (uint16_t)uxTaskGetNumberOfTasks();
+  sampleTasks(next);
+  next.freeHeap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  next.minFreeHeap = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+  next.largestFreeBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+
+  portENTER_CRITICAL(&profileMux);
+  profile = next;
+  portEXIT_CRITICAL(&profileMux);
+}
+
+void getTaskProfile(SystemProfile* out) {
+  portENTER_CRITICAL(&profileMux);
+  *out = profile;
+  portEXIT_CRITICAL(&profileMux);
+}
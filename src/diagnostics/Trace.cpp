@@ -0,0 +1,113 @@
+#include "diagnostics/Trace.h"
+#include "TaskTable.h"
+#include "MqttTask.h"
+#include <atomic>
+
+// Version of the dump format, checked by tools/trace2perfetto.py.
+#define TRACE_FORMAT_VERSION 1
+
+// Records per "rec" line: 512 hex characters, small enough for one MQTT message.
+#define TRACE_RECORDS_PER_LINE 16
+
+struct TraceRing {
+  std::atomic<uint32_t> head;           // records ever written; the next slot is head % TRACE_RING_LEN
+  TraceRecord records[TRACE_RING_LEN];
+};
+
+static TraceRing rings[portNUM_PROCESSORS];
+static std::atomic<bool> tracing(true);
+
+void traceEvent(TraceEvent event, uint32_t arg0, uint32_t arg1) {
+  if (!tracing.load(std::memory_order_relaxed)) {
+    return;
+  }
+  uint32_t now = micros();
+  TraceRing& ring = rings[xPortGetCoreID()];
+  // The only shared step: a writer preempted by another on the same core keeps its slot.
+  TraceRecord& rec = ring.records[ring.head.fetch_add(1, std::memory_order_relaxed) % TRACE_RING_LEN];
+  rec.timestampUs = now;
+  rec.event = event;
+  rec.task = (uint16_t)uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle());
+  rec.arg0 = arg0;
+  rec.arg1 = arg1;
+}
+
+extern "C" void traceTaskSwitchedIn(void) {
+  traceEvent(TRACE_TASK_SWITCH_IN);
+}
+
+static void clearRings() {
+  for (int core = 0; core < portNUM_PROCESSORS; core++) {
+    rings[core].head.store(0, std::memory_order_relaxed);
+  }
+}
+
+void traceEnable(bool enabled) {
+  if (enabled) {
+    tracing.store(false);
+    clearRings();
+  }
+  tracing.store(enabled);
+}
+
+// Writes records [first, first + count) of a ring as one "rec" line.
+static void dumpLine(Print& out, int core, uint32_t first, uint32_t count) {
+  static const char hexDigits[] = "0123456789abcdef";
+  char line[TRACE_RECORDS_PER_LINE * sizeof(TraceRecord) * 2 + 1];
+  size_t pos = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    const uint8_t* bytes = (const uint8_t*)&rings[core].records[(first + i) % TRACE_RING_LEN];
+    for (size_t b = 0; b < sizeof(TraceRecord); b++) {
+      line[pos++] = hexDigits[bytes[b] >> 4];
+      line[pos++] = hexDigits[bytes[b] & 0x0F];
+    }
+  }
+  line[pos] = '\0';
+  out.printf("rec %d ", core);
+  out.println(line);
+}
+
+void traceDump(Print& out) {
+  bool wasTracing = tracing.exchange(false);
+  vTaskDelay(1);   // let a writer that saw tracing on finish its record
+
+  out.printf("trace %d %d\n", TRACE_FORMAT_VERSION, TRACE_RING_LEN);
+  for (int id = 0; id < TASK_COUNT; id++) {
+    out.printf("task %d %s\n", id + 1, taskTable[id].name);
+  }
+  for (int core = 0; core < portNUM_PROCESSORS; core++) {
+    uint32_t head = rings[core].head.load();
+    uint32_t count = (head < TRACE_RING_LEN) ? head : TRACE_RING_LEN;
+    for (uint32_t done = 0; done < count; done += TRACE_RECORDS_PER_LINE) {
+      uint32_t n = count - done;
+      if (n > TRACE_RECORDS_PER_LINE) n = TRACE_RECORDS_PER_LINE;
+      dumpLine(out, core, head - count + done, n);
+    }
+  }
+  out.println("end");
+
+  clearRings();
+  tracing.store(wasTracing);
+}
+
+// Publishes every printed line as one telemetry message.
+class MqttLinePrint : public Print {
+public:
+  size_t write(uint8_t c) override {
+    if (c == '\n') {
+      publishMqttMessage("{\"Trace\":\"" + line + "\"}");
+      line = "";
+    } else if (c != '\r') {
+      line += (char)c;
+    }
+    return 1;
+  }
+
+private:
+  String line;
+};
+
+void traceDumpMqtt() {
+  MqttLinePrint out;
+  traceDump(out);
+}
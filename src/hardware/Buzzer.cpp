@@ -1,36 +1,240 @@
 #include "hardware/Buzzer.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "TaskTable.h"
+#include "diagnostics/Trace.h"
 
 // Define the buzzer GPIO pin
 #define BUZZER_PIN 14
 
+// LEDC channel driving the buzzer (Arduino-ESP32 2.x channel API).
+#define BUZZER_LEDC_CHANNEL 0
+
+// Plain beeps drive the pin steadily high, as a full-duty PWM at this setup.
+#define BUZZER_DC_PWM_HZ 5000
+#define BUZZER_DC_RESOLUTION 8
+
+// Step frequency meaning "pin steadily high" rather than a tone.
+#define BUZZER_TONE_DC 0xFFFF
+
+// Requests accepted from callers, and patterns waiting behind the one playing.
+#define BUZZER_QUEUE_LEN 8
+#define BUZZER_PENDING_LEN 4
+
+// One pattern request, as posted by buzzerPlay().
+struct BuzzerRequest {
+  BuzzerPattern pattern;
+  uint16_t value;          // beep / meow count, or the number to beep out
+  BuzzerPriority priority;
+};
+
+// One step of a pattern: a tone (or silence) held for a while.
+struct BuzzerStep {
+  uint16_t freq;           // Hz, 0 = silent, BUZZER_TONE_DC = steady high
+  uint16_t durationMs;
+};
+
+static QueueHandle_t buzzerQueue = NULL;
+static StaticQueue_t buzzerQueueBuffer;
+static uint8_t buzzerQueueStorage[BUZZER_QUEUE_LEN * sizeof(BuzzerRequest)];
+
 //--------------------------------------------------
-// Helper function: Simple beep
+// Pattern steps
 //--------------------------------------------------
-static void doBeep() {
-  digitalWrite(BUZZER_PIN, HIGH);
-  delay(200);               // Buzzer on for 200 ms
-  digitalWrite(BUZZER_PIN, LOW);
-  delay(200);               // Pause 200 ms between beeps
+// Patterns are generated step by step from their index, so nothing is expanded
+// into buffers and a request is only a few bytes in the queue.
+
+// Simple beep: 200 ms on, 200 ms pause.
+static bool beepStep(uint16_t count, uint32_t index, BuzzerStep& step) {
+  if (index >= 2u * count) return false;
+  step.freq = (index & 1) ? 0 : BUZZER_TONE_DC;
+  step.durationMs = 200;
+  return true;
+}
+
+// Cat meow: up-sweep 400 -> 700 Hz, 100 ms pause, down-sweep 700 -> 400 Hz in
+// 40 ms steps of 10 Hz, then 300 ms pause before the next meow.
+#define MEOW_SWEEP_STEPS 31
+#define MEOW_STEPS (2 * MEOW_SWEEP_STEPS + 2)
+static bool meowStep(uint16_t count, uint32_t index, BuzzerStep& step) {
+  if (index >= (uint32_t)count * MEOW_STEPS) return false;
+  uint32_t k = index % MEOW_STEPS;
+  if (k < MEOW_SWEEP_STEPS) {
+    step.freq = 400 + 10 * k;
+    step.durationMs = 40;
+  } else if (k == MEOW_SWEEP_STEPS) {
+    step.freq = 0;
+    step.durationMs = 100;
+  } else if (k < MEOW_STEPS - 1) {
+    step.freq = 700 - 10 * (k - MEOW_SWEEP_STEPS - 1);
+    step.durationMs = 40;
+  } else {
+    step.freq = 0;
+    step.durationMs = 300;
+  }
+  return true;
+}
+
+// "Speak" a number: each decimal digit as that many beeps, then a 500 ms pause.
+static bool digitsStep(uint16_t value, uint32_t index, BuzzerStep& step) {
+  char digits[6];
+  int n = snprintf(digits, sizeof(digits), "%u", (unsigned)value);
+  for (int i = 0; i < n; i++) {
+    uint32_t beeps = digits[i] - '0';
+    if (index < 2 * beeps) {
+      return beepStep(beeps, index, step);
+    }
+    index -= 2 * beeps;
+    if (index == 0) {
+      step.freq = 0;
+      step.durationMs = 500;
+      return true;
+    }
+    index--;
+  }
+  return false;
+}
+
+static bool patternStep(const BuzzerRequest& req, uint32_t index, BuzzerStep& step) {
+  switch (req.pattern) {
+    case BUZZER_PATTERN_BEEP:   return beepStep(req.value, index, step);
+    case BUZZER_PATTERN_DIGITS: return digitsStep(req.value, index, step);
+    case BUZZER_PATTERN_MEOW:   return meowStep(req.value, index, step);
+  }
+  return false;
 }
 
 //--------------------------------------------------
-// Helper function: Cat Meow (frequency sweep)
+// LEDC output
 //--------------------------------------------------
-static void catMeow() {
-  // Up-sweep (approx. 400 Hz -> 700 Hz)
-  for (int freq = 400; freq <= 700; freq += 10) {
-    tone(BUZZER_PIN, freq, 40);  // beep at 'freq' Hz for 40ms
-    delay(40);                   // short wait so tones don't overlap
+static void buzzerOutput(uint16_t freq) {
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  if (freq == BUZZER_TONE_DC) {
+    ledcChangeFrequency(BUZZER_PIN, BUZZER_DC_PWM_HZ, BUZZER_DC_RESOLUTION);
+    ledcWrite(BUZZER_PIN, (1 << BUZZER_DC_RESOLUTION) - 1);
+  } else if (freq > 0) {
+    ledcWriteTone(BUZZER_PIN, freq);
+  } else {
+    ledcWrite(BUZZER_PIN, 0);
+  }
+#else
+  if (freq == BUZZER_TONE_DC) {
+    ledcSetup(BUZZER_LEDC_CHANNEL, BUZZER_DC_PWM_HZ, BUZZER_DC_RESOLUTION);
+    ledcWrite(BUZZER_LEDC_CHANNEL, (1 << BUZZER_DC_RESOLUTION) - 1);
+  } else if (freq > 0) {
+    ledcWriteTone(BUZZER_LEDC_CHANNEL, freq);
+  } else {
+    ledcWrite(BUZZER_LEDC_CHANNEL, 0);
   }
-  delay(100);  // short pause
+#endif
+}
 
-  // Down-sweep (approx. 700 Hz -> 400 Hz)
-  for (int freq = 700; freq >= 400; freq -= 10) {
-    tone(BUZZER_PIN, freq, 40);
-    delay(40);
+//--------------------------------------------------
+// Sequencer task
+//--------------------------------------------------
+static bool sameRequest(const BuzzerRequest& a, const BuzzerRequest& b) {
+  return a.pattern == b.pattern && a.value == b.value;
+}
+
+// Plays one pattern at a time on the LEDC channel, waiting on the request queue
+// between steps. A new request:
+//  - merges with the playing or a pending request that is exactly the same,
+//  - if it is a notification, replaces the notification playing or pending (the
+//    beep count tells which mode was entered, so only the latest one is meaningful),
+//  - pre-empts the playing pattern if its priority is higher,
+//  - otherwise waits in the pending list, ordered by priority.
+static void buzzerTask(void* pvParameters) {
+  (void) pvParameters; // Unused parameter
+
+  BuzzerRequest current;
+  bool playing = false;
+  uint32_t stepIndex = 0;
+  TickType_t stepEnd = 0;
+
+  BuzzerRequest pending[BUZZER_PENDING_LEN];
+  int pendingCount = 0;
+
+  for (;;) {
+    TickType_t wait = portMAX_DELAY;
+    if (playing) {
+      TickType_t now = xTaskGetTickCount();
+      wait = ((int32_t)(stepEnd - now) > 0) ? stepEnd - now : 0;
+    }
+
+    BuzzerRequest req;
+    if (xQueueReceive(buzzerQueue, &req, wait) == pdTRUE) {
+      if (playing && sameRequest(req, current)) {
+        if (req.priority > current.priority) current.priority = req.priority;
+        continue;
+      }
+      bool merged = false;
+      for (int i = 0; i < pendingCount && !merged; i++) {
+        merged = sameRequest(req, pending[i]);
+      }
+      if (merged) {
+        continue;
+      }
+      if (req.priority == BUZZER_PRIORITY_NOTIFY) {
+        // Supersede the older notification, whether it waits or plays.
+        int kept = 0;
+        for (int i = 0; i < pendingCount; i++) {
+          if (pending[i].priority != BUZZER_PRIORITY_NOTIFY) pending[kept++] = pending[i];
+        }
+        pendingCount = kept;
+        if (playing && current.priority == BUZZER_PRIORITY_NOTIFY) {
+          current = req;
+          stepIndex = 0;
+          stepEnd = xTaskGetTickCount();
+          continue;
+        }
+      }
+      if (playing && req.priority > current.priority) {
+        // Pre-empt: the interrupted pattern is dropped, its purpose is stale.
+        current = req;
+        stepIndex = 0;
+        stepEnd = xTaskGetTickCount();
+        continue;
+      }
+      if (!playing) {
+        current = req;
+        playing = true;
+        stepIndex = 0;
+        stepEnd = xTaskGetTickCount();
+        continue;
+      }
+      // Insert by priority; when full, a request only displaces a lower-priority tail.
+      int pos = pendingCount;
+      while (pos > 0 && pending[pos - 1].priority < req.priority) pos--;
+      if (pos < BUZZER_PENDING_LEN) {
+        int last = (pendingCount < BUZZER_PENDING_LEN) ? pendingCount : BUZZER_PENDING_LEN - 1;
+        for (int i = last; i > pos; i--) pending[i] = pending[i - 1];
+        pending[pos] = req;
+        if (pendingCount < BUZZER_PENDING_LEN) pendingCount++;
+      }
+      continue;
+    }
+
+    // Step time elapsed: play the next step, or move on to the next pattern.
+    BuzzerStep step;
+    while (playing && !patternStep(current, stepIndex, step)) {
+      if (pendingCount > 0) {
+        current = pending[0];
+        for (int i = 1; i < pendingCount; i++) pending[i - 1] = pending[i];
+        pendingCount--;
+        stepIndex = 0;
+      } else {
+        playing = false;
+      }
+    }
+    if (!playing) {
+      buzzerOutput(0);
+      continue;
+    }
+    buzzerOutput(step.freq);
+    stepIndex++;
+    stepEnd = xTaskGetTickCount() + pdMS_TO_TICKS(step.durationMs);
   }
-  // Turn buzzer off
-  noTone(BUZZER_PIN);
 }
 
 //--------------------------------------------------
@@ -38,8 +242,34 @@ static void catMeow() {
 //--------------------------------------------------
 void initBuzzer(void)
 {
-  pinMode(BUZZER_PIN, OUTPUT);
-  digitalWrite(BUZZER_PIN, LOW);
+  if (buzzerQueue != NULL) {
+    return;
+  }
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  ledcAttach(BUZZER_PIN, BUZZER_DC_PWM_HZ, BUZZER_DC_RESOLUTION);
+#else
+  ledcSetup(BUZZER_LEDC_CHANNEL, BUZZER_DC_PWM_HZ, BUZZER_DC_RESOLUTION);
+  ledcAttachPin(BUZZER_PIN, BUZZER_LEDC_CHANNEL);
+#endif
+  buzzerOutput(0);
+
+  buzzerQueue = xQueueCreateStatic(BUZZER_QUEUE_LEN, sizeof(BuzzerRequest),
+                                   buzzerQueueStorage, &buzzerQueueBuffer);
+  createTableTask(TASK_BUZZER, buzzerTask, NULL);
+}
+
+//--------------------------------------------------
+// Public function: Queue a pattern
+//--------------------------------------------------
+bool buzzerPlay(BuzzerPattern pattern, uint16_t value, BuzzerPriority priority)
+{
+  if (buzzerQueue == NULL || value == 0) {
+    return false;
+  }
+  BuzzerRequest req = {pattern, value, priority};
+  bool sent = xQueueSend(buzzerQueue, &req, 0) == pdTRUE;
+  traceEvent(TRACE_QUEUE_SEND, TRACE_QUEUE_BUZZER, sent);
+  return sent;
 }
 
 //--------------------------------------------------
@@ -47,34 +277,20 @@ void initBuzzer(void)
 //--------------------------------------------------
 void buzzerAction(int times, bool speakNumber, bool meow)
 {
-  // If meow is true, we ignore speakNumber and beep times times with a cat meow
-  if (meow) {
-    for (int i = 0; i < times; i++) {
-      catMeow();
-      delay(300);  // Optional pause between meows
-    }
+  if (times <= 0) {
     return;
   }
+  if (times > UINT16_MAX) {
+    times = UINT16_MAX;
+  }
 
-  // If not meow, proceed with beep logic
-  if (!speakNumber) {
-    // beep 'times' times
-    for (int i = 0; i < times; i++) {
-      doBeep();
-    }
-  } else {
+  // If meow is true, we ignore speakNumber and meow 'times' times as an alarm
+  if (meow) {
+    buzzerPlay(BUZZER_PATTERN_MEOW, times, BUZZER_PRIORITY_ALARM);
+  } else if (speakNumber) {
     // "Speak" the integer by beeping each digit
-    String digits = String(times);  // Convert to string
-    for (unsigned int i = 0; i < digits.length(); i++) {
-      char c = digits[i];
-      // Convert char to integer digit
-      int digit = c - '0';
-      // beep 'digit' times
-      for (int j = 0; j < digit; j++) {
-        doBeep();
-      }
-      // optional: short pause between digits
-      delay(500);
-    }
+    buzzerPlay(BUZZER_PATTERN_DIGITS, times, BUZZER_PRIORITY_NOTIFY);
+  } else {
+    buzzerPlay(BUZZER_PATTERN_BEEP, times, BUZZER_PRIORITY_NOTIFY);
   }
 }
@@ -1,8 +1,18 @@
 #include "hardware/Led_light.h"
+#include "TaskTable.h"
+
+// MCP23017 pins carrying LEDs (active LOW).
+#define LED_FIRST_PIN 7
+#define LED_LAST_PIN 15
 
 LedLight ledController;  // Global LED Controller
 
-LedLight::LedLight() {}
+LedLight::LedLight() : portState(0xFFFF), taskHandle(NULL) {
+    portMUX_INITIALIZE(&slotsMux);
+    for (int i = 0; i < LED_COUNT; i++) {
+        slots[i].active = false;
+    }
+}
 
 void LedLight::begin() {
     Wire.begin();  // Start I2C
@@ -15,72 +25,93 @@ void LedLight::begin() {
 
     Serial.println("MCP23017 initialized successfully.");
 
-    // Configure GPIOs as OUTPUTs and set HIGH (LEDs OFF)
-    for (int pin = 7; pin <= 15; pin++) {
+    // Configure GPIOs as OUTPUTs, then set all of them HIGH (LEDs OFF) in one write
+    for (int pin = LED_FIRST_PIN; pin <= LED_LAST_PIN; pin++) {
         mcp.pinMode(pin, OUTPUT);
-        mcp.digitalWrite(pin, HIGH);
     }
-}
+    portState = 0xFFFF;
+    mcp.writeGPIOAB(portState);
 
-void LedLight::turnOn(int ledPin) {
-    // Serial.print("Turning ON LED at pin: ");
-    // Serial.println(ledPin);
-    mcp.digitalWrite(ledPin, LOW); // LEDs are active LOW
-}
-
-void LedLight::turnOff(int ledPin) {
-    // Serial.print("Turning OFF LED at pin: ");
-    // Serial.println(ledPin);
-    mcp.digitalWrite(ledPin, HIGH);
+    if (taskHandle == NULL) {
+        taskHandle = createTableTask(TASK_LED, ledTask, this);
+    }
 }
 
 void LedLight::blinkLED(int ledPin, int times, int period) {
-    // Serial.print("Scheduling blink for pin ");
-    // Serial.print(ledPin);
-    // Serial.print(", times: ");
-    // Serial.print(times);
-    // Serial.print(", period: ");
-    // Serial.println(period);
-
-    int* taskParams = new int[3]{ledPin, times, period};
-    xTaskCreate(ledTask, "LED Task", 2048, taskParams, 1, NULL);
-}
+    if (ledPin < LED_FIRST_PIN || ledPin > LED_LAST_PIN || times <= 0 || period <= 0) {
+        return;
+    }
 
-void LedLight::ledTask(void* parameters) {
-    int* params = (int*)parameters;
-    int ledPin = params[0];
-    int times = params[1];
-    int period = params[2];
-
-    delete[] params; // Free allocated memory
-
-    // Serial.print("Executing LED task for pin ");
-    // Serial.print(ledPin);
-    // Serial.print(", times: ");
-    // Serial.print(times);
-    // Serial.print(", period: ");
-    // Serial.println(period);
-
-    for (int i = 0; i < times; i++) {
-        // Serial.print("LED ON (");
-        // Serial.print(ledPin);
-        // Serial.println(")");
-        ledController.turnOn(ledPin);
-
-        vTaskDelay(pdMS_TO_TICKS(period / 2));
-
-        // Serial.print("LED OFF (");
-        // Serial.print(ledPin);
-        // Serial.println(")");
-        ledController.turnOff(ledPin);
-
-        vTaskDelay(pdMS_TO_TICKS(period / 2));
+    TickType_t now = xTaskGetTickCount();
+    TickType_t periodTicks = pdMS_TO_TICKS(period);
+    if (periodTicks < 2) periodTicks = 2;
+    TickType_t end = now + periodTicks * times;
+
+    // A blink on an LED that is already blinking extends it instead of restarting
+    // its phase, so repeated alarm requests keep a steady rhythm.
+    LedSlot& slot = slots[ledPin - LED_FIRST_PIN];
+    portENTER_CRITICAL(&slotsMux);
+    if (slot.active && slot.periodTicks == periodTicks) {
+        if ((int32_t)(end - slot.endTick) > 0) {
+            slot.endTick = end;
+        }
+    } else {
+        slot.active = true;
+        slot.startTick = now;
+        slot.periodTicks = periodTicks;
+        slot.endTick = end;
     }
+    portEXIT_CRITICAL(&slotsMux);
 
-    // Serial.println("Task completed, deleting...");
-    vTaskDelete(NULL); // Kill the task
+    if (taskHandle != NULL) {
+        xTaskNotifyGive(taskHandle);
+    }
 }
 
+// Computes the port state for time 'now' and the ticks until the next LED changes
+// (portMAX_DELAY if no LED is blinking).
+uint16_t LedLight::computePort(TickType_t now, TickType_t& wait) {
+    uint16_t state = 0xFFFF;
+    wait = portMAX_DELAY;
+
+    portENTER_CRITICAL(&slotsMux);
+    for (int i = 0; i < LED_COUNT; i++) {
+        LedSlot& slot = slots[i];
+        if (!slot.active) continue;
+        if ((int32_t)(now - slot.endTick) >= 0) {
+            slot.active = false;
+            continue;
+        }
+        // First half of every period on, second half off.
+        TickType_t phase = (now - slot.startTick) % slot.periodTicks;
+        TickType_t half = slot.periodTicks / 2;
+        TickType_t next;
+        if (phase < half) {
+            state &= ~(1u << (LED_FIRST_PIN + i));  // LEDs are active LOW
+            next = half - phase;
+        } else {
+            next = slot.periodTicks - phase;
+        }
+        if (next < wait) wait = next;
+    }
+    portEXIT_CRITICAL(&slotsMux);
 
+    return state;
+}
 
-
+// LED engine: one task for all LEDs. It sleeps until the next on/off edge of any
+// blinking LED (or a new blink request), computes the whole port state and writes
+// both GPIO banks in a single I2C transaction, only when something changed.
+void LedLight::ledTask(void* parameters) {
+    LedLight* self = (LedLight*)parameters;
+
+    for (;;) {
+        TickType_t wait;
+        uint16_t state = self->computePort(xTaskGetTickCount(), wait);
+        if (state != self->portState) {
+            self->mcp.writeGPIOAB(state);
+            self->portState = state;
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+}
@@ -0,0 +1,285 @@
+#include "hardware/Raster.h"
+#include <stdlib.h>
+
+// 32-bit view of the framebuffer bytes; may_alias keeps the word-wide stores legal.
+typedef uint32_t __attribute__((__may_alias__)) RasterWord;
+
+// Quarter-wave sine table, 256 steps per 90 degrees, Q15.
+static const int16_t sineTable[257] = {
+      0,   201,   402,   603,   804,  1005,  1206,  1407,  1608,  1809,  2009,  2210,
+   2410,  2611,  2811,  3012,  3212,  3412,  3612,  3811,  4011,  4210,  4410,  4609,
+   4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,  6393,  6590,  6786,  6983,
+   7179,  7375,  7571,  7767,  7962,  8157,  8351,  8545,  8739,  8933,  9126,  9319,
+   9512,  9704,  9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+  11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+  14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+  16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+  18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+  20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+  22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+  23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+  25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+  26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+  28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+  29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+  30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+  31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+  31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+  32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+  32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+  32757, 32761, 32765, 32766, 32767,
+};
+
+// 5x7 glyphs, column-major, bit 0 = top row. Order: '0'-'9', '+', '-', '.', ' '.
+static const uint8_t numberGlyphs[14][5] = {
+  {0x3E, 0x51, 0x49, 0x45, 0x3E}, // 0
+  {0x00, 0x42, 0x7F, 0x40, 0x00}, // 1
+  {0x42, 0x61, 0x51, 0x49, 0x46}, // 2
+  {0x21, 0x41, 0x45, 0x4B, 0x31}, // 3
+  {0x18, 0x14, 0x12, 0x7F, 0x10}, // 4
+  {0x27, 0x45, 0x45, 0x45, 0x39}, // 5
+  {0x3C, 0x4A, 0x49, 0x49, 0x30}, // 6
+  {0x01, 0x71, 0x09, 0x05, 0x03}, // 7
+  {0x36, 0x49, 0x49, 0x49, 0x36}, // 8
+  {0x06, 0x49, 0x49, 0x29, 0x1E}, // 9
+  {0x08, 0x08, 0x3E, 0x08, 0x08}, // +
+  {0x08, 0x08, 0x08, 0x08, 0x08}, // -
+  {0x00, 0x60, 0x60, 0x00, 0x00}, // .
+  {0x00, 0x00, 0x00, 0x00, 0x00}  // space
+};
+
+//--------------------------------------------------
+// Internal helpers
+//--------------------------------------------------
+
+static inline void applyByte(uint8_t* p, uint8_t mask, RasterOp op) {
+  switch (op) {
+    case RASTER_SET:    *p |= mask;            break;
+    case RASTER_CLEAR:  *p &= (uint8_t)~mask;  break;
+    case RASTER_INVERT: *p ^= mask;            break;
+  }
+}
+
+// Bits of one page covered by rows y0..y1 (both inside the page).
+static inline uint8_t pageMask(int y0, int y1) {
+  return (uint8_t)((0xFF << (y0 & 7)) & (0xFF >> (7 - (y1 & 7))));
+}
+
+// Applies mask to columns x0..x1 of one page row; the aligned middle goes 4 columns per store.
+static void spanRow(uint8_t* row, int x0, int x1, uint8_t mask, RasterOp op) {
+  int x = x0;
+  for (; x <= x1 && (x & 3) != 0; x++) {
+    applyByte(row + x, mask, op);
+  }
+
+  const int words = (x1 - x + 1) >> 2;
+  if (words > 0) {
+    const uint32_t wordMask = mask * 0x01010101u;
+    RasterWord* w = (RasterWord*)(row + x);
+    switch (op) {
+      case RASTER_SET:    for (int i = 0; i < words; i++) w[i] |= wordMask;  break;
+      case RASTER_CLEAR:  for (int i = 0; i < words; i++) w[i] &= ~wordMask; break;
+      case RASTER_INVERT: for (int i = 0; i < words; i++) w[i] ^= wordMask;  break;
+    }
+    x += words * 4;
+  }
+
+  for (; x <= x1; x++) {
+    applyByte(row + x, mask, op);
+  }
+}
+
+static inline void sortAscending(int32_t* v, int n) {
+  for (int i = 1; i < n; i++) {
+    int32_t key = v[i];
+    int j = i - 1;
+    while (j >= 0 && v[j] > key) {
+      v[j + 1] = v[j];
+      j--;
+    }
+    v[j + 1] = key;
+  }
+}
+
+//--------------------------------------------------
+// Public functions
+//--------------------------------------------------
+
+void rasterClear(const RasterTarget& t) {
+  RasterWord* w = (RasterWord*)t.buffer;
+  const int words = (t.width * t.height / 8) / 4;
+  for (int i = 0; i < words; i++) {
+    w[i] = 0;
+  }
+}
+
+void rasterPixel(const RasterTarget& t, int x, int y, RasterOp op) {
+  if (x < 0 || y < 0 || x >= t.width || y >= t.height) return;
+  applyByte(t.buffer + x + (y >> 3) * t.width, (uint8_t)(1 << (y & 7)), op);
+}
+
+void rasterFillRect(const RasterTarget& t, int x, int y, int w, int h, RasterOp op) {
+  int x0 = x < 0 ? 0 : x;
+  int y0 = y < 0 ? 0 : y;
+  int x1 = x + w - 1;
+  int y1 = y + h - 1;
+  if (x1 >= t.width) x1 = t.width - 1;
+  if (y1 >= t.height) y1 = t.height - 1;
+  if (x0 > x1 || y0 > y1) return;
+
+  for (int page = y0 >> 3; page <= (y1 >> 3); page++) {
+    int top = (page * 8 > y0) ? page * 8 : y0;
+    int bottom = (page * 8 + 7 < y1) ? page * 8 + 7 : y1;
+    spanRow(t.buffer + page * t.width, x0, x1, pageMask(top, bottom), op);
+  }
+}
+
+void rasterHSpan(const RasterTarget& t, int x0, int x1, int y, RasterOp op) {
+  if (y < 0 || y >= t.height) return;
+  if (x0 > x1) { int tmp = x0; x0 = x1; x1 = tmp; }
+  if (x0 < 0) x0 = 0;
+  if (x1 >= t.width) x1 = t.width - 1;
+  if (x0 > x1) return;
+  spanRow(t.buffer + (y >> 3) * t.width, x0, x1, (uint8_t)(1 << (y & 7)), op);
+}
+
+void rasterVSpan(const RasterTarget& t, int x, int y0, int y1, RasterOp op) {
+  if (x < 0 || x >= t.width) return;
+  if (y0 > y1) { int tmp = y0; y0 = y1; y1 = tmp; }
+  if (y0 < 0) y0 = 0;
+  if (y1 >= t.height) y1 = t.height - 1;
+  if (y0 > y1) return;
+
+  uint8_t* column = t.buffer + x;
+  const int firstPage = y0 >> 3;
+  const int lastPage = y1 >> 3;
+  if (firstPage == lastPage) {
+    applyByte(column + firstPage * t.width, pageMask(y0, y1), op);
+    return;
+  }
+  applyByte(column + firstPage * t.width, pageMask(y0, 7), op);
+  // Whole pages: the op is decided once, not per byte.
+  uint8_t* p = column + (firstPage + 1) * t.width;
+  uint8_t* const last = column + lastPage * t.width;
+  switch (op) {
+    case RASTER_SET:    for (; p < last; p += t.width) *p = 0xFF;  break;
+    case RASTER_CLEAR:  for (; p < last; p += t.width) *p = 0x00;  break;
+    case RASTER_INVERT: for (; p < last; p += t.width) *p ^= 0xFF; break;
+  }
+  applyByte(last, pageMask(0, y1), op);
+}
+
+void rasterLine(const RasterTarget& t, int x0, int y0, int x1, int y1, RasterOp op) {
+  if (y0 == y1) { rasterHSpan(t, x0, x1, y0, op); return; }
+  if (x0 == x1) { rasterVSpan(t, x0, y0, y1, op); return; }
+
+  const int dx = abs(x1 - x0), sx = (x0 < x1) ? 1 : -1;
+  const int dy = -abs(y1 - y0), sy = (y0 < y1) ? 1 : -1;
+  const bool xMajor = dx >= -dy;
+  int err = dx + dy;
+
+  // Bresenham, emitting each straight run as one span instead of single pixels.
+  int runX = x0, runY = y0;
+  while (x0 != x1 || y0 != y1) {
+    const int px = x0, py = y0;
+    const int e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x0 += sx; }
+    if (e2 <= dx) { err += dx; y0 += sy; }
+
+    if (xMajor ? (y0 != py) : (x0 != px)) {
+      if (xMajor) rasterHSpan(t, runX, px, py, op);
+      else        rasterVSpan(t, px, runY, py, op);
+      runX = x0;
+      runY = y0;
+    }
+  }
+  if (xMajor) rasterHSpan(t, runX, x0, y0, op);
+  else        rasterVSpan(t, x0, runY, y0, op);
+}
+
+void rasterFillPolygon(const RasterTarget& t, const int16_t* xs, const int16_t* ys, int count, RasterOp op) {
+  if (count < 3 || count > 8) return;
+
+  int minX = xs[0], maxX = xs[0];
+  for (int i = 1; i < count; i++) {
+    if (xs[i] < minX) minX = xs[i];
+    if (xs[i] > maxX) maxX = xs[i];
+  }
+  if (minX < 0) minX = 0;
+  if (maxX >= t.width) maxX = t.width - 1;
+
+  int32_t crossings[8];
+  for (int x = minX; x <= maxX; x++) {
+    // Sample each column at its pixel center (doubled coordinates avoid the 0.5).
+    const int32_t sample2 = 2 * x + 1;
+    int n = 0;
+    for (int i = 0, j = count - 1; i < count; j = i++) {
+      const int32_t xa2 = 2 * xs[j], xb2 = 2 * xs[i];
+      if ((xa2 <= sample2) == (xb2 <= sample2)) continue;
+      // Edge crossing in 24.8 fixed point.
+      crossings[n++] = (int32_t)ys[j] * 256 +
+                       ((int32_t)(ys[i] - ys[j]) * (sample2 - xa2) * 256) / (xb2 - xa2);
+    }
+    sortAscending(crossings, n);
+
+    // Rows whose centers lie inside [crossing k, crossing k+1) are filled.
+    for (int k = 0; k + 1 < n; k += 2) {
+      const int top = (crossings[k] + 127) >> 8;
+      const int bottom = ((crossings[k + 1] + 127) >> 8) - 1;
+      if (top <= bottom) {
+        rasterVSpan(t, x, top, bottom, op);
+      }
+    }
+  }
+}
+
+void rasterBlit(const RasterTarget& t, int x, int y, const uint8_t* columns, int w, RasterOp op) {
+  const int pages = t.height >> 3;
+  const int page = y >> 3;           // floor, also for negative y
+  const int shift = y & 7;
+  for (int i = 0; i < w; i++) {
+    const int cx = x + i;
+    if (cx < 0 || cx >= t.width) continue;
+    const uint16_t bits = (uint16_t)columns[i] << shift;
+    if (page >= 0 && page < pages && (bits & 0xFF) != 0) {
+      applyByte(t.buffer + page * t.width + cx, (uint8_t)bits, op);
+    }
+    if (page + 1 >= 0 && page + 1 < pages && (bits >> 8) != 0) {
+      applyByte(t.buffer + (page + 1) * t.width + cx, (uint8_t)(bits >> 8), op);
+    }
+  }
+}
+
+int rasterNumber(const RasterTarget& t, int x, int y, const char* text, RasterOp op) {
+  for (; *text != '\0'; text++) {
+    const char c = *text;
+    int glyph = 13;
+    if (c >= '0' && c <= '9') glyph = c - '0';
+    else if (c == '+') glyph = 10;
+    else if (c == '-') glyph = 11;
+    else if (c == '.') glyph = 12;
+    rasterBlit(t, x, y, numberGlyphs[glyph], 5, op);
+    x += 6;
+  }
+  return x;
+}
+
+int32_t rasterDegToAngle(float degrees) {
+  const float units = degrees * (RASTER_ANGLE_TURN / 360.0f);
+  return (int32_t)(units + (units >= 0 ? 0.5f : -0.5f));
+}
+
+int16_t rasterSin(int32_t angle) {
+  const int32_t a = angle & (RASTER_ANGLE_TURN - 1);
+  const int32_t index = a & 255;
+  switch (a >> 8) {
+    case 0:  return sineTable[index];
+    case 1:  return sineTable[256 - index];
+    case 2:  return (int16_t)-sineTable[index];
+    default: return (int16_t)-sineTable[256 - index];
+  }
+}
+
+int16_t rasterCos(int32_t angle) {
+  return rasterSin(angle + RASTER_ANGLE_TURN / 4);
+}
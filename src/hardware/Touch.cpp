@@ -1,4 +1,6 @@
 #include "hardware/Touch.h"
+#include "TaskTable.h"
+#include "diagnostics/Trace.h"
 
 //------------------
 // Pin Definitions
@@ -14,119 +16,249 @@
 #define PUSH_15_PIN      15  // Pressing => LOW
 #define PUSH_16_PIN      16  // Pressing => HIGH
 
-// Touch threshold
-static const int touchThreshold = 40000; // Updated to 40000
+// Touch detection: a pad is pressed once its reading exceeds the baseline by
+// TOUCH_PRESS_PERCENT, and released again below half that margin.
+#define TOUCH_PRESS_PERCENT   50
+#define TOUCH_MIN_MARGIN      2000
+#define TOUCH_BASELINE_SAMPLES 8
+// Baseline tracking: exponential average with weight 1 / 2^TOUCH_BASELINE_SHIFT,
+// updated while the pad is idle, at least every TOUCH_BASELINE_PERIOD_MS.
+#define TOUCH_BASELINE_SHIFT  4
+#define TOUCH_BASELINE_PERIOD_MS 1000
 
-// Debounce delay
-static const int debounceDelayMs = 200;
+// Events waiting for the input task.
+#define BUTTON_QUEUE_LEN 16
 
 // Create the event queue (declared extern in Touch.h)
 QueueHandle_t buttonEventQueue = NULL;
+static StaticQueue_t buttonQueueBuffer;
+static uint8_t buttonQueueStorage[BUTTON_QUEUE_LEN * sizeof(ButtonEventMsg_t)];
 
-/**
- * Checks a touch pin and sends an event if the reading exceeds touchThreshold.
- */
-static void checkTouchPin(int pin, ButtonEvent_t evt)
+static TaskHandle_t touchTaskHandle = NULL;
+
+enum PadKind {
+    PAD_TOUCH,
+    PAD_PUSH_ACTIVE_LOW,
+    PAD_PUSH_ACTIVE_HIGH
+};
+
+struct PadConfig {
+    uint8_t pin;
+    ButtonEvent_t button;
+    PadKind kind;
+    bool repeat;            // auto-repeat while held
+};
+
+// Mode navigation (UP/DOWN) does not repeat; LEFT/RIGHT scroll and select, so they do.
+static const PadConfig pads[] = {
+    {TOUCH_UP_PIN,    BUTTON_EVENT_TOUCH_UP,    PAD_TOUCH,            false},
+    {TOUCH_LEFT_PIN,  BUTTON_EVENT_TOUCH_LEFT,  PAD_TOUCH,            true},
+    {TOUCH_X_PIN,     BUTTON_EVENT_TOUCH_X,     PAD_TOUCH,            false},
+    {TOUCH_RIGHT_PIN, BUTTON_EVENT_TOUCH_RIGHT, PAD_TOUCH,            true},
+    {TOUCH_DOWN_PIN,  BUTTON_EVENT_TOUCH_DOWN,  PAD_TOUCH,            false},
+    {PUSH_15_PIN,     BUTTON_EVENT_PUSH_15,     PAD_PUSH_ACTIVE_LOW,  false},
+    {PUSH_16_PIN,     BUTTON_EVENT_PUSH_16,     PAD_PUSH_ACTIVE_HIGH, false},
+};
+#define PAD_COUNT (sizeof(pads) / sizeof(pads[0]))
+
+enum PadState {
+    PAD_IDLE,
+    PAD_PRESS_DEBOUNCE,     // looks pressed, not yet stable for BUTTON_DEBOUNCE_MS
+    PAD_PRESSED,
+    PAD_RELEASE_DEBOUNCE    // looks released, not yet stable for BUTTON_DEBOUNCE_MS
+};
+
+struct PadRuntime {
+    PadState state;
+    uint32_t edgeMs;        // start of the current debounce
+    uint32_t pressedMs;     // start of the press (edge time)
+    uint32_t nextRepeatMs;
+    bool longSent;
+    uint32_t baseline;      // touch pads: untouched reading
+    uint32_t armedMargin;   // touch pads: margin the interrupt is armed with
+};
+
+static PadRuntime padState[PAD_COUNT];
+
+//------------------
+// Interrupts
+//------------------
+// Touch and GPIO interrupts only wake the task; all filtering happens there.
+static void IRAM_ATTR inputIsr(void* arg)
 {
-    int touchValue = touchRead(pin);
-    if (touchValue > touchThreshold) {
-        // Send event to the queue (non-blocking)
-        xQueueSend(buttonEventQueue, &evt, 0);
-        // Debounce to avoid rapid re-trigger
-        vTaskDelay(pdMS_TO_TICKS(debounceDelayMs));
+    (void) arg;
+    BaseType_t woken = pdFALSE;
+    if (touchTaskHandle != NULL) {
+        vTaskNotifyGiveFromISR(touchTaskHandle, &woken);
     }
+    portYIELD_FROM_ISR(woken);
+}
+
+static uint32_t touchMargin(uint32_t baseline)
+{
+    uint32_t margin = baseline * TOUCH_PRESS_PERCENT / 100;
+    return (margin < TOUCH_MIN_MARGIN) ? TOUCH_MIN_MARGIN : margin;
+}
+
+// Arms the touch interrupt of a pad. On the ESP32-S3 the interrupt threshold is a
+// margin above the benchmark the touch hardware tracks itself.
+static void armTouchInterrupt(size_t i)
+{
+    PadRuntime& rt = padState[i];
+    rt.armedMargin = touchMargin(rt.baseline);
+    touchAttachInterruptArg(pads[i].pin, inputIsr, NULL, rt.armedMargin);
+}
+
+//------------------
+// Pad state machines
+//------------------
+static void sendEvent(size_t i, ButtonAction_t action, uint32_t timestampMs)
+{
+    ButtonEventMsg_t msg = {pads[i].button, action, timestampMs};
+    // Never block the scan; a full queue drops the event.
+    BaseType_t sent = xQueueSend(buttonEventQueue, &msg, 0);
+    traceEvent(TRACE_QUEUE_SEND, TRACE_QUEUE_BUTTON, sent == pdTRUE);
 }
 
-/**
- * Checks a push pin with either active-low or active-high logic.
- * @param pin: The GPIO pin to read.
- * @param evt: The event to send if triggered.
- * @param activeLow: If true, pressing => LOW. If false, pressing => HIGH.
- */
-
- ///// <<<< LOGIC I >>>>>
-// static void checkPushPin(int pin, ButtonEvent_t evt, bool activeLow)
-// {
-//     int state = digitalRead(pin);
-//     bool isPressed = (activeLow && state == LOW) || (!activeLow && state == HIGH);
-
-//     if (isPressed) {
-//         xQueueSend(buttonEventQueue, &evt, 0);
-//         vTaskDelay(pdMS_TO_TICKS(debounceDelayMs*3));
-//     }
-// }
-
-///// <<<< LOGIC II >>>>>
-static void checkPushPin(int pin, ButtonEvent_t evt, bool activeLow)
+// Reads the pad; held pads use the lower release level so the reading can dither
+// around the press level without bouncing.
+static bool readPad(size_t i, bool held)
 {
-    // Read the current state.
-    int state = digitalRead(pin);
-    bool isPressed = (activeLow && state == LOW) || (!activeLow && state == HIGH);
-
-    // If we see a press, wait 100ms and check again.
-    if (isPressed) {
-        vTaskDelay(pdMS_TO_TICKS(150));  // Wait 100 ms
-        // Check the state again.
-        int secondState = digitalRead(pin);
-        bool stillPressed = (activeLow && secondState == LOW) || (!activeLow && secondState == HIGH);
-
-        if (stillPressed) {
-            // Now we know the button was pressed continuously for 100 ms.
-            xQueueSend(buttonEventQueue, &evt, 0);
-            // (Optional) Add a debounce delay here to avoid repeated triggers.
-            vTaskDelay(pdMS_TO_TICKS(200)); 
+    const PadConfig& pad = pads[i];
+    PadRuntime& rt = padState[i];
+    if (pad.kind == PAD_TOUCH) {
+        uint32_t raw = touchRead(pad.pin);
+        uint32_t margin = touchMargin(rt.baseline);
+        bool active = raw > rt.baseline + (held ? margin / 2 : margin);
+        if (!active && rt.state == PAD_IDLE) {
+            // Follow slow drift (temperature, humidity) while untouched.
+            rt.baseline += ((int32_t)raw - (int32_t)rt.baseline) >> TOUCH_BASELINE_SHIFT;
+            uint32_t margin = touchMargin(rt.baseline);
+            uint32_t drift = (margin > rt.armedMargin) ? margin - rt.armedMargin : rt.armedMargin - margin;
+            if (drift > rt.armedMargin / 16) {
+                armTouchInterrupt(i);
+            }
         }
+        return active;
     }
+    int level = digitalRead(pad.pin);
+    return (pad.kind == PAD_PUSH_ACTIVE_LOW) ? level == LOW : level == HIGH;
 }
 
+// Advances one pad's state machine; returns true while the pad needs scanning.
+static bool updatePad(size_t i, uint32_t now)
+{
+    PadRuntime& rt = padState[i];
+    bool held = rt.state == PAD_PRESSED || rt.state == PAD_RELEASE_DEBOUNCE;
+    bool active = readPad(i, held);
+
+    switch (rt.state) {
+        case PAD_IDLE:
+            if (active) {
+                rt.state = PAD_PRESS_DEBOUNCE;
+                rt.edgeMs = now;
+            }
+            break;
+        case PAD_PRESS_DEBOUNCE:
+            if (!active) {
+                rt.state = PAD_IDLE;
+            } else if (now - rt.edgeMs >= BUTTON_DEBOUNCE_MS) {
+                rt.state = PAD_PRESSED;
+                rt.pressedMs = rt.edgeMs;
+                rt.longSent = false;
+                sendEvent(i, BUTTON_ACTION_PRESS, rt.edgeMs);
+            }
+            break;
+        case PAD_PRESSED:
+        case PAD_RELEASE_DEBOUNCE:
+            if (active) {
+                rt.state = PAD_PRESSED;   // still held, or a bounce during release
+            } else if (rt.state == PAD_PRESSED) {
+                rt.state = PAD_RELEASE_DEBOUNCE;
+                rt.edgeMs = now;
+            } else if (now - rt.edgeMs >= BUTTON_DEBOUNCE_MS) {
+                rt.state = PAD_IDLE;
+                sendEvent(i, BUTTON_ACTION_RELEASE, rt.edgeMs);
+                break;
+            }
+            // Hold timing continues during the release debounce.
+            if (!rt.longSent && now - rt.pressedMs >= BUTTON_LONG_PRESS_MS) {
+                rt.longSent = true;
+                rt.nextRepeatMs = now;
+                sendEvent(i, BUTTON_ACTION_LONG, now);
+            }
+            if (rt.longSent && pads[i].repeat && (int32_t)(now - rt.nextRepeatMs) >= 0) {
+                rt.nextRepeatMs += BUTTON_REPEAT_MS;
+                sendEvent(i, BUTTON_ACTION_REPEAT, now);
+            }
+            break;
+    }
+    return rt.state != PAD_IDLE;
+}
 
 //----------------------------------------
-// Task that reads all buttons every ~100ms
+// Input task
 //----------------------------------------
+// Sleeps until an interrupt fires, then scans all pads every TASK_PERIOD_MS(TASK_TOUCH)
+// until every pad is idle again. A held pad never delays the others.
 static void TouchTask(void *pvParameters)
 {
     (void) pvParameters; // Unused
 
+    // Armed here, after the task exists to be woken, and by the only task that
+    // updates the pad state.
+    touchTaskHandle = xTaskGetCurrentTaskHandle();
+    for (size_t i = 0; i < PAD_COUNT; i++) {
+        if (pads[i].kind == PAD_TOUCH) {
+            armTouchInterrupt(i);
+        } else {
+            attachInterruptArg(digitalPinToInterrupt(pads[i].pin), inputIsr, NULL, CHANGE);
+        }
+    }
+
     for (;;) {
-        // 1) Check each touch button
-        checkTouchPin(TOUCH_UP_PIN,     BUTTON_EVENT_TOUCH_UP);
-        checkTouchPin(TOUCH_LEFT_PIN,   BUTTON_EVENT_TOUCH_LEFT);
-        checkTouchPin(TOUCH_X_PIN,      BUTTON_EVENT_TOUCH_X);
-        checkTouchPin(TOUCH_RIGHT_PIN,  BUTTON_EVENT_TOUCH_RIGHT);
-        checkTouchPin(TOUCH_DOWN_PIN,   BUTTON_EVENT_TOUCH_DOWN);
-
-        // 2) Check each push button
-        // GPIO 15 is pull-up => pressing => LOW
-        checkPushPin(PUSH_15_PIN, BUTTON_EVENT_PUSH_15, true);
-        // GPIO 16 is reversed => pressing => HIGH
-        checkPushPin(PUSH_16_PIN, BUTTON_EVENT_PUSH_16, false);
-
-        // Wait ~100ms before checking again
-        vTaskDelay(pdMS_TO_TICKS(100));
+        uint32_t now = millis();
+        bool busy = false;
+        for (size_t i = 0; i < PAD_COUNT; i++) {
+            busy |= updatePad(i, now);
+        }
+
+        // While idle, still wake up now and then to track the touch baselines.
+        TickType_t wait = busy ? pdMS_TO_TICKS(TASK_PERIOD_MS(TASK_TOUCH))
+                               : pdMS_TO_TICKS(TOUCH_BASELINE_PERIOD_MS);
+        ulTaskNotifyTake(pdTRUE, wait);
     }
 }
 
 void initTouchSensor(void)
 {
-    // For touch pins, no pinMode() is required.
     // For push buttons:
     pinMode(PUSH_15_PIN, INPUT_PULLUP); // Pressing => LOW
-    // If you need a built-in pull-down for pin 16, you can do INPUT_PULLDOWN,
-    // but the ESP32 has limited internal pull-down support. 
-    // If the hardware externally pulls it down, do pinMode(PUSH_16_PIN, INPUT).
+    // The hardware externally pulls pin 16 down (the ESP32 has limited internal pull-down support).
     pinMode(PUSH_16_PIN, INPUT); 
+
+    // Initial touch baselines, averaged while the pads are untouched.
+    for (size_t i = 0; i < PAD_COUNT; i++) {
+        padState[i].state = PAD_IDLE;
+        if (pads[i].kind != PAD_TOUCH) {
+            continue;
+        }
+        uint32_t sum = 0;
+        for (int n = 0; n < TOUCH_BASELINE_SAMPLES; n++) {
+            sum += touchRead(pads[i].pin);
+        }
+        padState[i].baseline = sum / TOUCH_BASELINE_SAMPLES;
+    }
 }
 
 void startTouchTask(void)
 {
-    // Create the queue if it doesn't exist yet (max 10 events)
-    if (buttonEventQueue == NULL) {
-        buttonEventQueue = xQueueCreate(10, sizeof(ButtonEvent_t));
+    if (buttonEventQueue != NULL) {
+        return;
     }
+    buttonEventQueue = xQueueCreateStatic(BUTTON_QUEUE_LEN, sizeof(ButtonEventMsg_t),
+                                          buttonQueueStorage, &buttonQueueBuffer);
 
-    // Create the TouchTask
-    xTaskCreate(TouchTask, "TouchTask", 2048, NULL, 1, NULL);
+    // The task attaches the interrupts that wake it.
+    createTableTask(TASK_TOUCH, TouchTask, NULL);
 }
-
-
-
@@ -1,221 +1,676 @@
 
 #include "display.h"
+#include "RollingWindow.h"
+#include "hardware/Raster.h"
+#include "TaskTable.h"
+#include "diagnostics/Benchmark.h"
+#include "diagnostics/Trace.h"
+#include "diagnostics/AllocCounter.h"
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include <freertos/semphr.h>
-#include <math.h>  // for sin, cos functions
+#include <atomic>
+#include <new>
 
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 
+// Default redraw rate of the frame scheduler.
+#define DISPLAY_DEFAULT_FPS 20
+
+// Longest wait for the display task to finish a draw benchmark.
+#define DISPLAY_BENCH_TIMEOUT_MS 10000
+
+// Dirty flags: which part of the display model changed since the last frame.
+#define DIRTY_TABLE   (1u << 0)
+#define DIRTY_HORIZON (1u << 1)
+#define DIRTY_PLOT    (1u << 2)
+#define DIRTY_MODE    (1u << 3)
+
 // Create the OLED display object.
 static Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
 
 // -----------------------
 // TABLE_MODE variables
 // -----------------------
-static const int MAX_ENTRIES = 10;
-static TableEntry tableData[MAX_ENTRIES];
-static int currentNumEntries = 0;
-
-// -------------------------------
-// ARTIFICIAL_HORIZON_MODE variables
-// -------------------------------
-static float currentPitch = 0.0; // in degrees
-static float currentRoll = 0.0;  // in degrees
+// Interned strings for TableLabel / TableUnit ids.
+static constexpr const char* const tableLabelText[TABLE_LABEL_COUNT] = {
+  "Mode", "Magnitude", "initPres", "thresholdPres", "gravityAlarmAt",
+  "TouchButton", "PushButton", "LED RED"
+};
+static constexpr const char* const tableUnitText[TABLE_UNIT_COUNT] = {
+  "", "m/s^2", "rad/s", "°C", "%", "hPa", "V", "dBm", "ready!", "Blinking", "FromFlash"
+};
 
 // -----------------------
 // ROLLING_PLOT_MODE variables
 // -----------------------
-#define MAX_PLOT_POINTS 128
-static float rollingPlotData[MAX_PLOT_POINTS];
-static float rollingPlotTime[MAX_PLOT_POINTS];
-static int rollingPlotCount = 0;
-static String rollingPlotXLabel = "";
-static String rollingPlotYLabel = "";
+// Plot area geometry: border rectangle and the columns inside it.
+#define PLOT_X        10
+#define PLOT_Y        10
+#define PLOT_WIDTH    (SCREEN_WIDTH - 20)
+#define PLOT_HEIGHT   (SCREEN_HEIGHT - 22)
+#define PLOT_COLUMNS  (PLOT_WIDTH - 2)
+
+// History per channel; decimated to PLOT_COLUMNS when published.
+// The history is owned by the writers and never read by the display task.
+#define PLOT_HISTORY 512
+#define PLOT_LABEL_LEN 16
+
+// The history is kept as envelopes of consecutive samples (buckets), so a write only
+// updates the newest bucket and the published columns are built from at most
+// PLOT_BUCKETS envelopes instead of every sample. Buckets start with one sample and
+// are merged in pairs whenever PLOT_BUCKETS are filled, up to PLOT_BUCKET_SAMPLES
+// each; a bucket thus never covers much more than a plot column.
+#define PLOT_BUCKET_SAMPLES 4
+#define PLOT_BUCKETS (PLOT_HISTORY / PLOT_BUCKET_SAMPLES)
+
+// Samples of one bucket.
+struct PlotEnvelope {
+  float first, last;   // oldest and newest sample
+  float lo, hi;        // minimum and maximum
+};
+
+// Bucketed history of one channel or of the time stamps: the closed buckets in a
+// ring, running minimum and maximum over them (amortized O(1)), and the open bucket.
+struct PlotSeries {
+  PlotEnvelope closed[PLOT_BUCKETS];
+  RollingWindow<float, PLOT_BUCKETS> lows;    // closed[].lo, same order as closed
+  RollingWindow<float, PLOT_BUCKETS> highs;   // closed[].hi
+  uint32_t nextClosed;                        // ring position of the next closed bucket
+  PlotEnvelope open;
+
+  void clear() {
+    lows.clear();
+    highs.clear();
+    nextClosed = 0;
+  }
+
+  // Adds a sample to the open bucket, which already holds `count` samples.
+  void add(float value, int count) {
+    if (count == 0) {
+      open = {value, value, value, value};
+      return;
+    }
+    open.last = value;
+    if (value < open.lo) open.lo = value;
+    if (value > open.hi) open.hi = value;
+  }
+
+  // Moves the open bucket into the ring, dropping the oldest one once full.
+  void close() {
+    closed[nextClosed++ % PLOT_BUCKETS] = open;
+    lows.push(open.lo);
+    highs.push(open.hi);
+  }
+
+  // Merges the closed buckets in pairs. Only called on a full ring that has not
+  // wrapped since clear(), so closed[] is in age order.
+  void mergePairs() {
+    lows.clear();
+    highs.clear();
+    for (int i = 0; i < PLOT_BUCKETS / 2; i++) {
+      const PlotEnvelope& a = closed[2 * i];
+      const PlotEnvelope& b = closed[2 * i + 1];
+      closed[i] = {a.first, b.last, a.lo < b.lo ? a.lo : b.lo, a.hi > b.hi ? a.hi : b.hi};
+      lows.push(closed[i].lo);
+      highs.push(closed[i].hi);
+    }
+    nextClosed = PLOT_BUCKETS / 2;
+  }
+
+  // Bucket by age: 0 is the oldest closed one, closedCount() the open one.
+  size_t closedCount() const { return lows.size(); }
+  const PlotEnvelope& bucket(size_t i) const {
+    return (i < closedCount()) ? closed[(nextClosed - closedCount() + i) % PLOT_BUCKETS] : open;
+  }
+
+  // Range over the closed buckets and, if it holds samples, the open one.
+  float minimum(int openCount) const {
+    if (closedCount() == 0) return open.lo;
+    return (openCount > 0 && open.lo < lows.minimum()) ? open.lo : lows.minimum();
+  }
+  float maximum(int openCount) const {
+    if (closedCount() == 0) return open.hi;
+    return (openCount > 0 && open.hi > highs.maximum()) ? open.hi : highs.maximum();
+  }
+};
+
+// Bucketed history of the plot channels and their shared time stamps.
+struct PlotHistory {
+  PlotSeries series[MAX_PLOT_CHANNELS];
+  PlotSeries times;
+  int bucketSamples;       // samples per bucket, 1 to PLOT_BUCKET_SAMPLES
+  int openBucketSamples;   // samples in the open buckets (same for every series)
+  int historySamples;      // samples in the history, up to PLOT_HISTORY
 
-// Current display mode (default to TABLE_MODE).
-static DisplayMode currentMode = TABLE_MODE;
+  PlotHistory() { clear(); }
+
+  void clear() {
+    for (int ch = 0; ch < MAX_PLOT_CHANNELS; ch++) {
+      series[ch].clear();
+    }
+    times.clear();
+    bucketSamples = 1;
+    openBucketSamples = 0;
+    historySamples = 0;
+  }
+
+  // Adds one sample per channel. The sample goes into the open bucket; a full bucket
+  // closes and, once the history is full, replaces the oldest one.
+  void add(const float* values, int channels, float time) {
+    for (int ch = 0; ch < channels; ch++) {
+      series[ch].add(values[ch], openBucketSamples);
+    }
+    times.add(time, openBucketSamples);
+    if (historySamples < PLOT_HISTORY) historySamples++;
+    if (++openBucketSamples == bucketSamples) {
+      if (times.closedCount() == PLOT_BUCKETS && bucketSamples < PLOT_BUCKET_SAMPLES) {
+        for (int ch = 0; ch < channels; ch++) {
+          series[ch].mergePairs();
+        }
+        times.mergePairs();
+        bucketSamples *= 2;
+      }
+      for (int ch = 0; ch < channels; ch++) {
+        series[ch].close();
+      }
+      times.close();
+      openBucketSamples = 0;
+    }
+  }
+};
+
+// History of the rolling plot, owned by the writers.
+static PlotHistory plotHistory;
+
+// -----------------------
+// Display model
+// -----------------------
+// Rolling plot as published to the display task: one min/max envelope per column.
+// Rows are relative to the channel's band; colTop < 0 marks a column without samples.
+struct PlotModel {
+  int channelCount;
+  PlotLayout layout;
+  int sampleCount;
+  float minTime, maxTime;   // x axis range
+  float minVal, maxVal;     // range of channel 0 (Y ticks)
+  char xLabel[PLOT_LABEL_LEN];
+  char yLabels[MAX_PLOT_CHANNELS][PLOT_LABEL_LEN];
+  int8_t colTop[MAX_PLOT_CHANNELS][PLOT_COLUMNS];
+  int8_t colBottom[MAX_PLOT_CHANNELS][PLOT_COLUMNS];
+  int8_t colFirst[MAX_PLOT_CHANNELS][PLOT_COLUMNS];
+  int8_t colLast[MAX_PLOT_CHANNELS][PLOT_COLUMNS];
+};
+
+// Everything the display task needs to draw one frame.
+struct DisplayModel {
+  DisplayMode mode;
+  int numEntries;
+  char tableCells[MAX_TABLE_ENTRIES][TABLE_CELL_LEN];
+  float pitch;   // in degrees
+  float roll;    // in degrees
+  PlotModel plot;
+};
+
+// Three model buffers: the writers fill the back buffer, the display task draws the
+// front buffer, and the third slot holds the latest published frame. Publishing and
+// picking up a frame are each one atomic exchange of that slot, so the display task
+// never blocks a writer and never sees a half-updated model.
+#define MODEL_FRESH 0x80u
+static DisplayModel models[3];
+static uint32_t backIndex = 0;                  // writers only (under writerMutex)
+static uint32_t frontIndex = 1;                 // display task only
+static std::atomic<uint32_t> readyIndex(2);     // latest published, MODEL_FRESH if unread
+
+// Serializes writers against each other (never taken by the display task).
+static SemaphoreHandle_t writerMutex = NULL;
+static StaticSemaphore_t writerMutexBuffer;
 
 // FreeRTOS task handle for the display task.
 static TaskHandle_t displayTaskHandle = NULL;
 
-// Binary semaphore to signal a new data update.
-static SemaphoreHandle_t displayUpdateSemaphore = NULL;
+// -----------------------
+// Frame scheduler state
+// -----------------------
+// Updates only mark content dirty; the display task redraws at most once per
+// frame period, so several updates within one period cost a single redraw.
+static portMUX_TYPE displayMux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t dirtyFlags = 0;
+static TickType_t framePeriodTicks = pdMS_TO_TICKS(1000 / DISPLAY_DEFAULT_FPS);
+static DisplayStats stats = {};
+
+// Raster target over the SSD1306 framebuffer (valid after displayInit()).
+static RasterTarget frame = {NULL, SCREEN_WIDTH, SCREEN_HEIGHT};
 
 // Forward declarations for internal drawing functions.
-static void drawTable();
-static void drawHorizon();
-static void drawRollingPlot();
+static void dumpFrame(Print& out, DisplayMode mode);
+static void benchDraws(uint32_t iterations);
+static void drawTable(const DisplayModel& model);
+static void drawHorizon(const DisplayModel& model);
+static void drawRollingPlot(const DisplayModel& model);
+
+// Returns the dirty flag of the content shown in the given display mode.
+static uint32_t contentFlagFor(DisplayMode mode) {
+  switch (mode) {
+    case TABLE_MODE:              return DIRTY_TABLE;
+    case ARTIFICIAL_HORIZON_MODE: return DIRTY_HORIZON;
+    case ROLLING_PLOT_MODE:       return DIRTY_PLOT;
+  }
+  return 0;
+}
+
+// Display task: switches to the latest published model, if a newer one exists.
+static const DisplayModel& acquireModel() {
+  if (readyIndex.load(std::memory_order_acquire) & MODEL_FRESH) {
+    frontIndex = readyIndex.exchange(frontIndex, std::memory_order_acq_rel) & ~MODEL_FRESH;
+  }
+  return models[frontIndex];
+}
+
+// Writers: takes ownership of the back buffer.
+static DisplayModel& beginWrite() {
+  xSemaphoreTake(writerMutex, portMAX_DELAY);
+  return models[backIndex];
+}
+
+// Forward declaration; markDirty is defined below.
+static void markDirty(uint32_t flag);
+
+// Writers: publishes the back buffer with one exchange and marks the content dirty.
+// The new back buffer starts as a copy of the published one, so partial updates
+// (table only, horizon only, ...) keep the rest of the model.
+static void endWrite(uint32_t dirtyFlag) {
+  uint32_t previous = readyIndex.exchange(backIndex | MODEL_FRESH, std::memory_order_acq_rel);
+  uint32_t next = previous & ~MODEL_FRESH;
+  models[next] = models[backIndex];
+  backIndex = next;
+  xSemaphoreGive(writerMutex);
+  markDirty(dirtyFlag);
+}
+
+// Writers: releases the back buffer without publishing.
+static void abortWrite() {
+  xSemaphoreGive(writerMutex);
+}
+
+// Where the next drawn frame is dumped to, NULL if no dump is requested.
+static Print* dumpTarget = NULL;
+
+// Pending draw benchmark: draws per measurement (0 if none requested) and the task
+// waiting for the results.
+static uint32_t benchIterations = 0;
+static TaskHandle_t benchRequester = NULL;
+static BenchResult benchResults[DISPLAY_MODE_COUNT];
+
+// Marks content dirty and wakes the display task if no frame is pending yet.
+static void markDirty(uint32_t flag) {
+  bool wake;
+  portENTER_CRITICAL(&displayMux);
+  wake = (dirtyFlags == 0);
+  if (!wake) {
+    stats.coalescedUpdates++;
+  }
+  dirtyFlags |= flag;
+  portEXIT_CRITICAL(&displayMux);
+
+  if (wake && displayTaskHandle != NULL) {
+    xTaskNotifyGive(displayTaskHandle);
+  }
+}
 
-// FreeRTOS task: waits for a new update signal then refreshes the display.
+// FreeRTOS task: waits until content is marked dirty, holds the frame until the
+// frame period has elapsed (so later updates coalesce into it), then redraws once.
 static void displayTask(void* parameter) {
   (void)parameter; // Unused parameter
+  AllocSiteScope site(ALLOC_SITE_DISPLAY);
+  TickType_t lastFrame = xTaskGetTickCount() - framePeriodTicks;
+
   for (;;) {
-    if (xSemaphoreTake(displayUpdateSemaphore, portMAX_DELAY) == pdTRUE) {
-      switch (currentMode) {
-        case TABLE_MODE:
-          drawTable();
-          break;
-        case ARTIFICIAL_HORIZON_MODE:
-          drawHorizon();
-          break;
-        case ROLLING_PLOT_MODE:
-          drawRollingPlot();
-          break;
-      }
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    TickType_t elapsed = xTaskGetTickCount() - lastFrame;
+    if (elapsed < framePeriodTicks) {
+      vTaskDelay(framePeriodTicks - elapsed);
+    }
+
+    // A draw benchmark leaves its last frame in the buffer; the mode flag redraws over it.
+    portENTER_CRITICAL(&displayMux);
+    uint32_t benchRuns = benchIterations;
+    TaskHandle_t benchWaiter = benchRequester;
+    benchIterations = 0;
+    if (benchRuns > 0) {
+      dirtyFlags |= DIRTY_MODE;
     }
+    portEXIT_CRITICAL(&displayMux);
+
+    if (benchRuns > 0) {
+      benchDraws(benchRuns);
+      xTaskNotifyGive(benchWaiter);
+    }
+
+    // A dump request is taken with the flags, so the dumped frame is drawn from a model
+    // at least as new as the request.
+    portENTER_CRITICAL(&displayMux);
+    uint32_t flags = dirtyFlags;
+    dirtyFlags = 0;
+    Print* dumpOut = dumpTarget;
+    dumpTarget = NULL;
+    portEXIT_CRITICAL(&displayMux);
+
+    // Flags are taken before the model, so the model is at least as new as the flags.
+    const DisplayModel& model = acquireModel();
+    DisplayMode mode = model.mode;
+    uint32_t visible = contentFlagFor(mode) | DIRTY_MODE;
+
+    portENTER_CRITICAL(&displayMux);
+    // Content changed for a mode that is not on screen is never drawn.
+    for (uint32_t offscreen = flags & ~visible; offscreen != 0; offscreen &= offscreen - 1) {
+      stats.droppedUpdates++;
+    }
+    portEXIT_CRITICAL(&displayMux);
+
+    if ((flags & visible) == 0) {
+      continue;   // a dump request always sets the visible DIRTY_MODE
+    }
+
+    // Rendering into the framebuffer and the I2C transfer are timed separately.
+    uint32_t start = micros();
+    switch (mode) {
+      case TABLE_MODE:
+        drawTable(model);
+        break;
+      case ARTIFICIAL_HORIZON_MODE:
+        drawHorizon(model);
+        break;
+      case ROLLING_PLOT_MODE:
+        drawRollingPlot(model);
+        break;
+    }
+    uint32_t rendered = micros();
+    traceEvent(TRACE_DISPLAY_FLUSH_BEGIN, mode);
+    display.display();
+    traceEvent(TRACE_DISPLAY_FLUSH_END, mode);
+    uint32_t flushed = micros();
+
+    portENTER_CRITICAL(&displayMux);
+    stats.framesDrawn++;
+    stats.renderMicros[mode] = rendered - start;
+    if (stats.renderMicros[mode] > stats.renderMicrosMax[mode]) {
+      stats.renderMicrosMax[mode] = stats.renderMicros[mode];
+    }
+    stats.flushMicros = flushed - rendered;
+    if (stats.flushMicros > stats.flushMicrosMax) {
+      stats.flushMicrosMax = stats.flushMicros;
+    }
+    portEXIT_CRITICAL(&displayMux);
+
+    if (dumpOut != NULL) {
+      dumpFrame(*dumpOut, mode);
+    }
+    lastFrame = xTaskGetTickCount();
+  }
+}
+
+// Writes the framebuffer as a plain PBM (P1) image, one text row per pixel row,
+// so frames captured over the serial port can be diffed and viewed directly.
+static void dumpFrame(Print& out, DisplayMode mode) {
+  char row[SCREEN_WIDTH + 1];
+  out.println("P1");
+  out.print("# mode ");
+  out.print((int)mode);
+  out.print(" render_us ");
+  out.println(stats.renderMicros[mode]);
+  out.print(SCREEN_WIDTH);
+  out.print(' ');
+  out.println(SCREEN_HEIGHT);
+  for (int y = 0; y < SCREEN_HEIGHT; y++) {
+    const uint8_t* page = frame.buffer + (y / 8) * SCREEN_WIDTH;
+    const uint8_t bit = 1u << (y & 7);
+    for (int x = 0; x < SCREEN_WIDTH; x++) {
+      row[x] = (page[x] & bit) ? '1' : '0';
+    }
+    row[SCREEN_WIDTH] = '\0';
+    out.println(row);
   }
 }
 
+// Draw benchmark: every routine on the latest model, into the framebuffer only.
+static void benchDrawTable(void* arg)   { drawTable(*(const DisplayModel*)arg); }
+static void benchDrawHorizon(void* arg) { drawHorizon(*(const DisplayModel*)arg); }
+static void benchDrawPlot(void* arg)    { drawRollingPlot(*(const DisplayModel*)arg); }
+
+static void benchDraws(uint32_t iterations) {
+  void* model = (void*)&acquireModel();
+  benchMeasure("draw table", benchDrawTable, model, iterations, &benchResults[TABLE_MODE]);
+  benchMeasure("draw horizon", benchDrawHorizon, model, iterations, &benchResults[ARTIFICIAL_HORIZON_MODE]);
+  benchMeasure("draw plot", benchDrawPlot, model, iterations, &benchResults[ROLLING_PLOT_MODE]);
+}
+
 //----------------------------
 // Drawing functions
 //----------------------------
 
 // TABLE_MODE drawing.
-static void drawTable() {
+// Lines are preformatted by the writers, so a frame only copies characters to the buffer.
+static void drawTable(const DisplayModel& model) {
   display.clearDisplay();
   display.setTextSize(1);
   display.setTextColor(SSD1306_WHITE);
 
   int y = 0;
   const int lineHeight = 10;  // Adjust as needed
-  for (int i = 0; i < currentNumEntries; i++) {
-    String line = tableData[i].name + ": " +
-                  String(tableData[i].value, 1) + " " +
-                  tableData[i].unit;
+  for (int i = 0; i < model.numEntries; i++) {
     display.setCursor(0, y);
-    display.println(line);
+    display.print(model.tableCells[i]);
     y += lineHeight;
   }
-  display.display();
 }
 
 // ARTIFICIAL_HORIZON_MODE drawing.
-static void drawHorizon() {
-  display.clearDisplay();
+// The ground below the horizon is filled; roll is applied with fixed-point trig tables.
+static void drawHorizon(const DisplayModel& model) {
+  rasterClear(frame);
   
   const float maxPitch = 45.0; // Maximum expected pitch (degrees)
-  int centerX = SCREEN_WIDTH / 2;
-  int centerY = SCREEN_HEIGHT / 2;
+  const int centerX = SCREEN_WIDTH / 2;
+  const int centerY = SCREEN_HEIGHT / 2;
   
   // Compute vertical offset from pitch.
-  int offset = (int)((currentPitch / maxPitch) * (SCREEN_HEIGHT / 2));
-  int horizonY = centerY + offset;
-  
-  // Define unrotated endpoints for the horizon line.
-  int xLeft = 0;
-  int yLeft = horizonY;
-  int xRight = SCREEN_WIDTH - 1;
-  int yRight = horizonY;
+  int offset = (int)((model.pitch / maxPitch) * (SCREEN_HEIGHT / 2));
   
-  // Convert roll angle to radians.
-  float rollRad = currentRoll * DEG_TO_RAD;
+  // Roll angle as Q15 cosine/sine.
+  int32_t rollAngle = rasterDegToAngle(model.roll);
+  int32_t c = rasterCos(rollAngle);
+  int32_t s = rasterSin(rollAngle);
   
-  // Rotate endpoints about the display center.
-  int x1 = centerX + (xLeft - centerX) * cos(rollRad) - (yLeft - centerY) * sin(rollRad);
-  int y1 = centerY + (xLeft - centerX) * sin(rollRad) + (yLeft - centerY) * cos(rollRad);
-  int x2 = centerX + (xRight - centerX) * cos(rollRad) - (yRight - centerY) * sin(rollRad);
-  int y2 = centerY + (xRight - centerX) * sin(rollRad) + (yRight - centerY) * cos(rollRad);
+  // Ground polygon relative to the display center before rotation: the horizon line,
+  // extended past the screen edges, and everything below it.
+  const int reach = SCREEN_WIDTH;
+  const int localX[4] = {-reach, reach, reach, -reach};
+  const int localY[4] = {offset, offset, offset + 2 * reach, offset + 2 * reach};
+  int16_t xs[4], ys[4];
   
-  // Draw the rotated horizon line.
-  display.drawLine(x1, y1, x2, y2, SSD1306_WHITE);
-  
-  // Draw a center marker.
-  display.drawCircle(centerX, centerY, 2, SSD1306_WHITE);
+  // Rotate the corners about the display center.
+  for (int i = 0; i < 4; i++) {
+    xs[i] = (int16_t)(centerX + ((localX[i] * c - localY[i] * s) >> 15));
+    ys[i] = (int16_t)(centerY + ((localX[i] * s + localY[i] * c) >> 15));
+  }
+  rasterFillPolygon(frame, xs, ys, 4);
   
-  display.display();
+  // Draw a center marker (radius 2 ring), inverted so it shows on sky and ground.
+  rasterHSpan(frame, centerX - 1, centerX + 1, centerY - 2, RASTER_INVERT);
+  rasterHSpan(frame, centerX - 1, centerX + 1, centerY + 2, RASTER_INVERT);
+  rasterVSpan(frame, centerX - 2, centerY - 1, centerY + 1, RASTER_INVERT);
+  rasterVSpan(frame, centerX + 2, centerY - 1, centerY + 1, RASTER_INVERT);
+}
+
+// Height of one channel band inside the plot border.
+static int plotBandHeight(const PlotModel& plot) {
+  int inner = PLOT_HEIGHT - 2;
+  return (plot.layout == PLOT_STACKED) ? inner / plot.channelCount : inner;
+}
+
+// Draws one channel from its published column envelope: every column gets a vertical
+// span covering the min/max of its samples, and consecutive columns are joined, so
+// the cost is bounded by the plot width, not the history size.
+static void drawTrace(const PlotModel& plot, int ch, int bandY) {
+  int prevX = -1, prevLast = 0;
+  for (int col = 0; col < PLOT_COLUMNS; col++) {
+    if (plot.colTop[ch][col] < 0) continue;
+    int x = PLOT_X + 1 + col;
+    if (prevX >= 0) {
+      rasterLine(frame, prevX, bandY + prevLast, x, bandY + plot.colFirst[ch][col]);
+    }
+    rasterVSpan(frame, x, bandY + plot.colTop[ch][col], bandY + plot.colBottom[ch][col]);
+    prevX = x;
+    prevLast = plot.colLast[ch][col];
+  }
 }
 
 // ROLLING_PLOT_MODE drawing.
 // The plot area is defined with small margins, and the x and y axis labels are drawn inside the chart.
 // Three tick marks (at 1/3, 2/3, and 3/3 of the range) are drawn for both axes,
-// with tick labels showing one decimal digit.
-static void drawRollingPlot() {
+// with tick labels showing one decimal digit. Y ticks are only drawn for a single channel;
+// overlaid channels share the full plot height, stacked channels get one band each.
+static void drawRollingPlot(const DisplayModel& model) {
+  const PlotModel& plot = model.plot;
   display.clearDisplay();
 
-  // Define chart area margins.
-  const int marginLeft = 10;
-  const int marginRight = 10;
-  const int marginTop = 10;
-  const int marginBottom = 12;
-  
-  int plotX = marginLeft;
-  int plotY = marginTop;
-  int plotWidth = SCREEN_WIDTH - marginLeft - marginRight;
-  int plotHeight = SCREEN_HEIGHT - marginTop - marginBottom;
+  const int plotX = PLOT_X;
+  const int plotY = PLOT_Y;
+  const int plotWidth = PLOT_WIDTH;
+  const int plotHeight = PLOT_HEIGHT;
+  char tickLabel[12];
 
   // Draw the plot border (axes).
-  display.drawRect(plotX, plotY, plotWidth, plotHeight, SSD1306_WHITE);
+  rasterHSpan(frame, plotX, plotX + plotWidth - 1, plotY);
+  rasterHSpan(frame, plotX, plotX + plotWidth - 1, plotY + plotHeight - 1);
+  rasterVSpan(frame, plotX, plotY, plotY + plotHeight - 1);
+  rasterVSpan(frame, plotX + plotWidth - 1, plotY, plotY + plotHeight - 1);
 
   // If no data available, show a message.
-  if (rollingPlotCount == 0) {
+  if (plot.sampleCount == 0) {
     display.setCursor(0, 0);
     display.println("No data");
-    display.display();
     return;
   }
   
-  // Compute min and max for the y axis (data) and x axis (time).
-  float minVal = rollingPlotData[0], maxVal = rollingPlotData[0];
-  float minTime = rollingPlotTime[0], maxTime = rollingPlotTime[0];
-  for (int i = 1; i < rollingPlotCount; i++) {
-    if (rollingPlotData[i] < minVal) minVal = rollingPlotData[i];
-    if (rollingPlotData[i] > maxVal) maxVal = rollingPlotData[i];
-    if (rollingPlotTime[i] < minTime) minTime = rollingPlotTime[i];
-    if (rollingPlotTime[i] > maxTime) maxTime = rollingPlotTime[i];
-  }
-  if (maxVal == minVal) { maxVal = minVal + 1.0; }
-  if (maxTime == minTime) { maxTime = minTime + 1.0; }
+  const float minTime = plot.minTime, maxTime = plot.maxTime;
   
   // Draw tick marks and labels (three ticks each axis).
-  // Y axis ticks.
-  for (int t = 1; t <= 2; t++) {
-    float tickVal = minVal + (maxVal - minVal) * t / 3.0;
-    int yTick = plotY + plotHeight - (int)(((tickVal - minVal) / (maxVal - minVal)) * plotHeight);
-    // Draw a small tick on the left border.
-    display.drawLine(plotX - 3, yTick, plotX, yTick, SSD1306_WHITE);
-    // Draw the tick label (one decimal digit).
-    String tickLabel = String(tickVal, 1);
-    display.setCursor(0, yTick - 3);
-    display.print(tickLabel);
+  // Y axis ticks (single channel only).
+  if (plot.channelCount == 1) {
+    const float minVal = plot.minVal, maxVal = plot.maxVal;
+    for (int t = 1; t <= 2; t++) {
+      float tickVal = minVal + (maxVal - minVal) * t / 3.0;
+      int yTick = plotY + plotHeight - (int)(((tickVal - minVal) / (maxVal - minVal)) * plotHeight);
+      // Draw a small tick on the left border.
+      rasterHSpan(frame, plotX - 3, plotX, yTick);
+      // Draw the tick label (one decimal digit).
+      snprintf(tickLabel, sizeof(tickLabel), "%.1f", tickVal);
+      rasterNumber(frame, 0, yTick - 3, tickLabel);
+    }
   }
   // X axis ticks.
   for (int t = 0; t <= 3; t++) {
     float tickTime = minTime + (maxTime - minTime) * t / 3.0;
     int xTick = plotX + (int)(((tickTime - minTime) / (maxTime - minTime)) * plotWidth);
     // Draw a small tick on the bottom border.
-    display.drawLine(xTick, plotY + plotHeight, xTick, plotY + plotHeight + 3, SSD1306_WHITE);
-    // Draw the tick label (one decimal digit).
-    String tickLabel = String(tickTime, 0);
+    rasterVSpan(frame, xTick, plotY + plotHeight, plotY + plotHeight + 3);
+    // Draw the tick label (no decimal digits).
+    int labelLength = snprintf(tickLabel, sizeof(tickLabel), "%.0f", tickTime);
     // Center the tick label below the tick.
-    int16_t xOffset = tickLabel.length() * 6 / 2;
-    display.setCursor(xTick - xOffset, plotY + plotHeight + 4);
-    display.print(tickLabel);
+    int16_t xOffset = labelLength * 6 / 2;
+    rasterNumber(frame, xTick - xOffset, plotY + plotHeight + 4, tickLabel);
   }
   
-  // Draw the rolling plot line.
-  for (int i = 1; i < rollingPlotCount; i++) {
-    // Map time to x coordinate.
-    int x1 = plotX + (int)(((rollingPlotTime[i - 1] - minTime) / (maxTime - minTime)) * plotWidth);
-    int x2 = plotX + (int)(((rollingPlotTime[i] - minTime) / (maxTime - minTime)) * plotWidth);
-    // Map value to y coordinate (inverted so higher values appear at the top).
-    int y1 = plotY + plotHeight - (int)(((rollingPlotData[i - 1] - minVal) / (maxVal - minVal)) * plotHeight);
-    int y2 = plotY + plotHeight - (int)(((rollingPlotData[i] - minVal) / (maxVal - minVal)) * plotHeight);
-    display.drawLine(x1, y1, x2, y2, SSD1306_WHITE);
+  // Draw one decimated trace per channel, each auto-scaled to its own band.
+  const int bandHeight = plotBandHeight(plot);
+  for (int ch = 0; ch < plot.channelCount; ch++) {
+    int bandY = plotY + 1;
+    if (plot.layout == PLOT_STACKED) {
+      bandY = plotY + 1 + ch * bandHeight;
+      if (ch > 0) {
+        rasterHSpan(frame, plotX, plotX + plotWidth - 1, bandY - 1);
+      }
+    }
+    drawTrace(plot, ch, bandY);
   }
   
   // Draw in-chart axis labels.
-  // Y axis label: top-left corner of plot area.
-  display.setCursor(plotX + 8, plotY + 2);
-  display.print(rollingPlotYLabel);
+  // Y axis labels: top of each band (side by side when overlaid).
+  int labelX = plotX + 8;
+  for (int ch = 0; ch < plot.channelCount; ch++) {
+    display.setCursor(labelX, (plot.layout == PLOT_STACKED) ? plotY + 2 + ch * bandHeight : plotY + 2);
+    display.print(plot.yLabels[ch]);
+    if (plot.layout == PLOT_OVERLAY) {
+      labelX += (strlen(plot.yLabels[ch]) + 1) * 6;
+    }
+  }
   // X axis label: bottom-right corner inside plot area.
-  int xLabelWidth = rollingPlotXLabel.length() * 6; // approximate width at text size 1
+  int xLabelWidth = strlen(plot.xLabel) * 6; // approximate width at text size 1
   display.setCursor(plotX + plotWidth - xLabelWidth - 2, plotY + plotHeight - 8);
-  display.print(rollingPlotXLabel);
-  
-  display.display();
+  display.print(plot.xLabel);
+}
+
+// Writers: decimates the bucketed history into the plot model, one envelope per
+// column. The axes rescale with every sample, so the columns are rebuilt each time,
+// but from at most PLOT_BUCKETS + 1 bucket envelopes per channel. A bucket that
+// straddles two columns extends both.
+static void publishPlotColumns(const PlotHistory& history, PlotModel& plot) {
+  const PlotSeries& times = history.times;
+  const int openCount = history.openBucketSamples;
+  const size_t buckets = times.closedCount() + (openCount > 0 ? 1 : 0);
+  plot.sampleCount = history.historySamples;
+  if (plot.sampleCount == 0) {
+    return;
+  }
+
+  plot.minTime = times.minimum(openCount);
+  plot.maxTime = times.maximum(openCount);
+  if (plot.maxTime == plot.minTime) { plot.maxTime = plot.minTime + 1.0; }
+
+  const float xScale = (PLOT_COLUMNS - 1) / (plot.maxTime - plot.minTime);
+  const int bandHeight = plotBandHeight(plot);
+
+  for (int ch = 0; ch < plot.channelCount; ch++) {
+    const PlotSeries& values = history.series[ch];
+    float minVal = values.minimum(openCount), maxVal = values.maximum(openCount);
+    if (maxVal == minVal) { maxVal = minVal + 1.0; }
+    if (ch == 0) {
+      plot.minVal = minVal;
+      plot.maxVal = maxVal;
+    }
+    const float yScale = (bandHeight - 1) / (maxVal - minVal);
+    auto row = [&](float value) {
+      return (int8_t)(bandHeight - 1 - (int)((value - minVal) * yScale));
+    };
+
+    int8_t* top = plot.colTop[ch];
+    int8_t* bottom = plot.colBottom[ch];
+    memset(top, -1, PLOT_COLUMNS);
+
+    for (size_t i = 0; i < buckets; i++) {
+      const PlotEnvelope& time = times.bucket(i);
+      const PlotEnvelope& value = values.bucket(i);
+      const int firstCol = (int)((time.lo - plot.minTime) * xScale);
+      const int lastCol = (int)((time.hi - plot.minTime) * xScale);
+      const int8_t yHi = row(value.hi), yLo = row(value.lo);
+      for (int col = firstCol; col <= lastCol; col++) {
+        if (top[col] < 0) {
+          top[col] = yHi;
+          bottom[col] = yLo;
+          plot.colFirst[ch][col] = row(value.first);
+        } else {
+          if (yHi < top[col]) top[col] = yHi;
+          if (yLo > bottom[col]) bottom[col] = yLo;
+        }
+        plot.colLast[ch][col] = row(value.last);
+      }
+    }
+  }
 }
 
 //----------------------------
@@ -223,11 +678,15 @@ static void drawRollingPlot() {
 //----------------------------
 
 void displayInit() {
+  if (writerMutex == NULL) {
+    writerMutex = xSemaphoreCreateMutexStatic(&writerMutexBuffer);
+  }
   Wire.begin();
   if (!display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
     Serial.println("SSD1306 allocation failed");
     while (true); // Halt if initialization fails.
   }
+  frame.buffer = display.getBuffer();
   display.clearDisplay();
   display.setTextSize(1);
   display.setTextColor(SSD1306_WHITE);
@@ -238,82 +697,259 @@ void displayInit() {
 }
 
 void startDisplayTask(DisplayMode mode) {
-  currentMode = mode;
-  if (displayUpdateSemaphore == NULL) {
-    displayUpdateSemaphore = xSemaphoreCreateBinary();
-  }
+  setDisplayMode(mode);
   if (displayTaskHandle == NULL) {
-    xTaskCreatePinnedToCore(
-      displayTask,         // Task function.
-      "DisplayTask",       // Task name.
-      4096,                // Stack size.
-      NULL,                // Parameters.
-      1,                   // Priority.
-      &displayTaskHandle,  // Task handle.
-      1                    // Core ID.
-    );
+    displayTaskHandle = createTableTask(TASK_DISPLAY, displayTask, NULL);
   }
 }
 
 void setDisplayMode(DisplayMode mode) {
-  currentMode = mode;
+  DisplayModel& model = beginWrite();
+  if (mode == model.mode) {
+    abortWrite();
+    return;
+  }
+  model.mode = mode;
+  endWrite(DIRTY_MODE);
+}
+
+void setDisplayTargetFps(uint8_t fps) {
+  if (fps == 0) fps = 1;
+  TickType_t period = pdMS_TO_TICKS(1000 / fps);
+  framePeriodTicks = (period > 0) ? period : 1;
+}
+
+void requestDisplayFrameDump(Print& out) {
+  portENTER_CRITICAL(&displayMux);
+  dumpTarget = &out;
+  portEXIT_CRITICAL(&displayMux);
+  // The mode flag is always visible, so this forces a frame even without new content.
+  markDirty(DIRTY_MODE);
+}
+
+// Plot insert benchmark: a private history and plot model, filled beforehand so every
+// insert evicts the oldest sample as on a long-running plot.
+struct PlotInsertBench {
+  PlotHistory history;
+  PlotModel plot;
+  uint32_t sample;
+};
+
+static void benchPlotInsert(void* arg) {
+  PlotInsertBench* bench = (PlotInsertBench*)arg;
+  float values[MAX_PLOT_CHANNELS];
+  for (int ch = 0; ch < MAX_PLOT_CHANNELS; ch++) {
+    values[ch] = (float)((bench->sample * (ch + 3)) % 41);
+  }
+  bench->history.add(values, bench->plot.channelCount, bench->sample * 0.2f);
+  publishPlotColumns(bench->history, bench->plot);
+  bench->sample++;
+}
+
+bool benchmarkPlotInsert(BenchResult* result, uint32_t iterations) {
+  PlotInsertBench* bench = new (std::nothrow) PlotInsertBench();
+  if (bench == NULL) {
+    return false;
+  }
+  bench->plot.channelCount = MAX_PLOT_CHANNELS;
+  bench->plot.layout = PLOT_STACKED;
+  bench->sample = 0;
+  while (bench->sample < PLOT_HISTORY) {
+    benchPlotInsert(bench);
+  }
+  benchMeasure("plot insert", benchPlotInsert, bench, iterations, result);
+  delete bench;
+  return true;
+}
+
+bool benchmarkDisplayDraws(BenchResult results[DISPLAY_MODE_COUNT], uint32_t iterations) {
+  if (displayTaskHandle == NULL || iterations == 0) {
+    return false;
+  }
+  ulTaskNotifyTake(pdTRUE, 0);   // drop a late answer to an earlier request
+
+  portENTER_CRITICAL(&displayMux);
+  bool busy = (benchIterations != 0);
+  if (!busy) {
+    benchIterations = iterations;
+    benchRequester = xTaskGetCurrentTaskHandle();
+  }
+  portEXIT_CRITICAL(&displayMux);
+  if (busy) {
+    return false;
+  }
+
+  xTaskNotifyGive(displayTaskHandle);
+  if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(DISPLAY_BENCH_TIMEOUT_MS)) == 0) {
+    portENTER_CRITICAL(&displayMux);
+    benchIterations = 0;
+    portEXIT_CRITICAL(&displayMux);
+    return false;
+  }
+  for (int i = 0; i < DISPLAY_MODE_COUNT; i++) {
+    results[i] = benchResults[i];
+  }
+  return true;
+}
+
+DisplayStats getDisplayStats() {
+  portENTER_CRITICAL(&displayMux);
+  DisplayStats copy = stats;
+  portEXIT_CRITICAL(&displayMux);
+  return copy;
+}
+
+// Appends text to a cell at position pos, truncating at the cell size. Returns the new length.
+static size_t appendText(char* cell, size_t pos, const char* text) {
+  while (*text != '\0' && pos < TABLE_CELL_LEN - 1) {
+    cell[pos++] = *text++;
+  }
+  cell[pos] = '\0';
+  return pos;
+}
+
+// Formats value with the given number of decimals without printf or heap use.
+static size_t appendFixed(char* cell, size_t pos, float value, int decimals) {
+  if (isnan(value)) return appendText(cell, pos, "nan");
+  if (value < 0) {
+    pos = appendText(cell, pos, "-");
+    value = -value;
+  }
+  uint32_t scale = 1;
+  for (int i = 0; i < decimals; i++) scale *= 10;
+  if (isinf(value) || value >= 4.0e9f) return appendText(cell, pos, "inf");
+
+  // Split before scaling so large values keep their integer digits exact.
+  uint32_t whole = (uint32_t)value;
+  uint32_t frac = (uint32_t)((value - whole) * scale + 0.5f);
+  if (frac >= scale) {
+    whole++;
+    frac -= scale;
+  }
+
+  char digits[12];
+  int n = 0;
+  do {
+    digits[n++] = (char)('0' + whole % 10);
+    whole /= 10;
+  } while (whole != 0);
+  while (n > 0 && pos < TABLE_CELL_LEN - 1) {
+    cell[pos++] = digits[--n];
+  }
+  if (decimals > 0 && pos < TABLE_CELL_LEN - 1) {
+    cell[pos++] = '.';
+    for (uint32_t div = scale / 10; div > 0 && pos < TABLE_CELL_LEN - 1; div /= 10) {
+      cell[pos++] = (char)('0' + (frac / div) % 10);
+    }
+  }
+  cell[pos] = '\0';
+  return pos;
+}
+
+const char* tableUnitName(TableUnit unit) {
+  return unit < TABLE_UNIT_COUNT ? tableUnitText[unit] : "";
+}
+
+void formatTableCell(char cell[TABLE_CELL_LEN], const char* label, float value, int decimals, TableUnit unit) {
+  size_t pos = appendText(cell, 0, label);
+  pos = appendText(cell, pos, ": ");
+  pos = appendFixed(cell, pos, value, decimals);
+  pos = appendText(cell, pos, " ");
+  appendText(cell, pos, tableUnitName(unit));
+}
+
+void formatTableEntry(char cell[TABLE_CELL_LEN], const TableEntry& entry) {
+  formatTableCell(cell, entry.label < TABLE_LABEL_COUNT ? tableLabelText[entry.label] : "?",
+                  entry.value, 1, entry.unit);
 }
 
 // Update table data for TABLE_MODE.
+// Every entry is formatted into its fixed-size cell here, on the writer's side.
 void updateTableData(const TableEntry* newData, int count) {
-  if (count > MAX_ENTRIES) count = MAX_ENTRIES;
+  if (count > MAX_TABLE_ENTRIES) count = MAX_TABLE_ENTRIES;
+  DisplayModel& model = beginWrite();
   for (int i = 0; i < count; i++) {
-    tableData[i] = newData[i];
+    formatTableEntry(model.tableCells[i], newData[i]);
   }
-  currentNumEntries = count;
-  xSemaphoreGive(displayUpdateSemaphore);
+  model.numEntries = count;
+  endWrite(DIRTY_TABLE);
+}
+
+// Update TABLE_MODE with free-form lines that the caller has already formatted.
+void updateTableLines(const char* const lines[], int count) {
+  if (count > MAX_TABLE_ENTRIES) count = MAX_TABLE_ENTRIES;
+  DisplayModel& model = beginWrite();
+  for (int i = 0; i < count; i++) {
+    appendText(model.tableCells[i], 0, lines[i]);
+  }
+  model.numEntries = count;
+  endWrite(DIRTY_TABLE);
 }
 
 // Update horizon data for ARTIFICIAL_HORIZON_MODE.
 void updateHorizonData(float pitch, float roll) {
-  currentPitch = pitch;
-  currentRoll = roll;
-  xSemaphoreGive(displayUpdateSemaphore);
+  DisplayModel& model = beginWrite();
+  model.pitch = pitch;
+  model.roll = roll;
+  endWrite(DIRTY_HORIZON);
+}
+
+// Configure the rolling plot channels. The history is cleared only when the
+// configuration actually changes, so this may be called before every sample.
+void configureRollingPlot(int channelCount, const char* const yLabels[], const char* xLabel, PlotLayout layout) {
+  if (channelCount < 1) channelCount = 1;
+  if (channelCount > MAX_PLOT_CHANNELS) channelCount = MAX_PLOT_CHANNELS;
+
+  DisplayModel& model = beginWrite();
+  PlotModel& plot = model.plot;
+  bool changed = (channelCount != plot.channelCount) || (layout != plot.layout) ||
+                 strncmp(plot.xLabel, xLabel, PLOT_LABEL_LEN - 1) != 0;
+  for (int ch = 0; ch < channelCount && !changed; ch++) {
+    changed = strncmp(plot.yLabels[ch], yLabels[ch], PLOT_LABEL_LEN - 1) != 0;
+  }
+  if (!changed) {
+    abortWrite();
+    return;
+  }
+
+  plot.channelCount = channelCount;
+  plot.layout = layout;
+  strlcpy(plot.xLabel, xLabel, PLOT_LABEL_LEN);
+  for (int ch = 0; ch < channelCount; ch++) {
+    strlcpy(plot.yLabels[ch], yLabels[ch], PLOT_LABEL_LEN);
+  }
+  plotHistory.clear();
+  plot.sampleCount = 0;
+  endWrite(DIRTY_PLOT);
+}
+
+// Append one sample per configured channel, all sharing the same time stamp.
+void updateRollingPlotSamples(const float* values, float newTime) {
+  DisplayModel& model = beginWrite();
+  plotHistory.add(values, model.plot.channelCount, newTime);
+  publishPlotColumns(plotHistory, model.plot);
+  endWrite(DIRTY_PLOT);
 }
 
 // Update rolling plot data for ROLLING_PLOT_MODE.
-// Accepts a new data point and its associated time stamp, plus axis labels.
-// The new point is appended to the rolling buffer (shifting older points if necessary).
+// Single-channel shortcut: switches the plot to one channel with the given labels.
 void updateRollingPlotData(float newValue, float newTime, const char* xLabel, const char* yLabel) {
-  rollingPlotXLabel = String(xLabel);
-  rollingPlotYLabel = String(yLabel);
-  
-  if (rollingPlotCount < MAX_PLOT_POINTS) {
-    rollingPlotData[rollingPlotCount] = newValue;
-    rollingPlotTime[rollingPlotCount] = newTime;
-    rollingPlotCount++;
-  } else {
-    // Shift left if buffer is full.
-    for (int i = 0; i < MAX_PLOT_POINTS - 1; i++) {
-      rollingPlotData[i] = rollingPlotData[i + 1];
-      rollingPlotTime[i] = rollingPlotTime[i + 1];
-    }
-    rollingPlotData[MAX_PLOT_POINTS - 1] = newValue;
-    rollingPlotTime[MAX_PLOT_POINTS - 1] = newTime;
-  }
-  xSemaphoreGive(displayUpdateSemaphore);
+  configureRollingPlot(1, &yLabel, xLabel, PLOT_OVERLAY);
+  updateRollingPlotSamples(&newValue, newTime);
 }
 
 
 // // This resets the data so that a completely new set of values can be plotted.
 // void resetRollingPlotData() {
-//   rollingPlotCount = 0;
-//   // Optionally clear the arrays (not strictly necessary)
-//   for (int i = 0; i < MAX_PLOT_POINTS; i++) {
-//     rollingPlotData[i] = 0;
-//     rollingPlotTime[i] = 0;
-//   }
+//   DisplayModel& model = beginWrite();
+//   for (int ch = 0; ch < MAX_PLOT_CHANNELS; ch++) rollingPlotData[ch].clear();
+//   rollingPlotTime.clear();
+//   model.plot.sampleCount = 0;
 //   // Optionally reset axis labels.
-//   rollingPlotXLabel = "";
-//   rollingPlotYLabel = "";
+//   model.plot.xLabel[0] = '\0';
   
 //   // Force an immediate display update.
-//   xSemaphoreGive(displayUpdateSemaphore);
+//   endWrite(DIRTY_PLOT);
 // }
 
 ///////////////////////////////////////////////////////////////////
@@ -1,6 +1,7 @@
 #include "hardware/storage.h"
 #include <SPIFFS.h>
 #include <FS.h>
+#include "modes/Mode.h"   // MODE_COUNT
 
 bool initStorage() {
   if (!SPIFFS.begin(true)) { // auto-format if mount fails
@@ -19,7 +20,7 @@ int readDefaultMode() {
   String modeStr = file.readStringUntil('\n');
   file.close();
   int mode = modeStr.toInt();
-  if (mode < 0 || mode > 5) {
+  if (mode < 0 || mode >= MODE_COUNT) {
     Serial.println("Invalid default mode in file");
     return -1;
   }
@@ -27,7 +28,7 @@ int readDefaultMode() {
 }
 
 bool writeDefaultMode(int mode) {
-  if (mode < 0 || mode > 5) {
+  if (mode < 0 || mode >= MODE_COUNT) {
     Serial.println("Mode out of range");
     return false;
   }
@@ -59,10 +60,14 @@ bool appendPacketToFile(uint32_t packetID, const uint8_t *data, size_t length) {
       return false;
     }
   }
+  return appendBytesToFile(DATA_FILE_FILENAME, data, length);
+}
+
+bool appendBytesToFile(const char *path, const uint8_t *data, size_t length) {
   // Open file in append mode.
-  File file = SPIFFS.open(DATA_FILE_FILENAME, "a");
+  File file = SPIFFS.open(path, "a");
   if (!file) {
-    Serial.println("Failed to open data file for appending");
+    Serial.printf("Failed to open %s for appending\n", path);
     return false;
   }
   size_t written = file.write(data, length);
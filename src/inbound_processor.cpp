@@ -1,85 +1,209 @@
 #include "inbound_processor.h"
 #include "hardware/storage.h"   // if you need storage functions
 #include "MqttTask.h"  // if it declares inboundMessage, newMessageAvailable, etc.
+#include "display.h"
+#include "modes/Mode.h"
+#include "state/StateRegistry.h"
+#include "telecommand_parser.h"
+#include "sensors/SensorSource.h"
+#include "diagnostics/Benchmark.h"
+#include "diagnostics/Trace.h"
+#include "diagnostics/AllocCounter.h"
+#include "diagnostics/Latency.h"
+#include "ChannelTable.h"
+#include "telemetry.h"
 
 
 // Define the globals.
-String tc = "";
+const char* tc = "";
 int tcValue = 0;
-String tcHash = "";
+uint32_t tcHash = 0;
 
 void processInboundMessage() {
-  // Convert the raw bytes to a String (if appropriate) or process them as binary.
-  String msgStr = String((char*)inboundMessage, inboundMessageLength);
-  Serial.print("Processing inbound message: ");
-  Serial.println(msgStr);
-
-  unsigned long hash = 5381;
-  for (unsigned int i = 0; i < inboundMessageLength; i++) {
-    hash = ((hash << 5) + hash) + inboundMessage[i]; // hash * 33 + current byte
-  }
+  latencyRecord(LATENCY_TC_DISPATCH, micros() - inboundMessageUs);
+  bool effectDeferred = false;
+  bool applied = false;   // the command was carried out (time to effect is recorded)
 
-  tcHash = String(hash, HEX);
+  Serial.print("Processing inbound message: ");
+  Serial.write(inboundMessage, inboundMessageLength);
+  Serial.println();
 
+  // Decoding is platform independent (telecommand_parser); the actions are done here.
+  Telecommand cmd;
+  parseTelecommand(inboundMessage, inboundMessageLength, &cmd);
+  tcHash = cmd.hash;
 
-  if (msgStr.startsWith("SetMode:")) {
-    int colonIndex = msgStr.indexOf(':');
-    if (colonIndex != -1) {
-      String value = msgStr.substring(colonIndex + 1);
-      value.trim();
-      int modeVal = value.toInt();
-      if (modeVal >= 0 && modeVal <= 5) {
-        // Update current mode (assume a global variable exists)
-        currentMode = modeVal;
-        Serial.print("Updated currentMode to: ");
-        Serial.println(currentMode);
+  switch (cmd.type) {
+    case TC_SET_MODE:
+      if (cmd.value >= 0 && cmd.value < MODE_COUNT) {
+        // Switch the active mode (performed by the mode task, which closes the latency)
+        if (cmd.value != stateGetInt(STATE_CURRENT_MODE)) {
+          latencyAwaitEffect(inboundMessageUs);
+          effectDeferred = true;
+        }
+        requestMode(cmd.value);
+        Serial.print("Updated current mode to: ");
+        Serial.println(stateGetInt(STATE_CURRENT_MODE));
         tc = "SetMode:";
-        tcValue = modeVal;
-      
+        applied = true;
+        tcValue = cmd.value;
       }
-    }
-  }
-  else if (msgStr.startsWith("SetDefaultMode:")) {
-    int prefixLength = String("SetDefaultMode:").length();
-    String value = msgStr.substring(prefixLength);
-    value.trim();
-    int modeVal = value.toInt();
-    if (modeVal >= 0 && modeVal <= 5) {
-      // Update default mode and store it in flash
-      defaultModeValue = modeVal;
-      tc = "SetDefaultMode:";
-      tcValue = modeVal;           // Save mode value in tcValue.
-      
-      if (writeDefaultMode(defaultModeValue)) {
-        Serial.print("Updated defaultMode to: ");
-        Serial.println(defaultModeValue);
+      break;
+
+    case TC_SET_DEFAULT_MODE:
+      // Update default mode (range checked by the registry) and store it in flash
+      if (stateSetInt(STATE_DEFAULT_MODE, cmd.value)) {
+        tc = "SetDefaultMode:";
+        applied = true;
+        tcValue = cmd.value;           // Save mode value in tcValue.
+
+        if (writeDefaultMode(cmd.value)) {
+          Serial.print("Updated defaultMode to: ");
+          Serial.println(cmd.value);
+        }
       }
-    }
-  }
-  else if (msgStr.startsWith("PacketID:")) {
-    int firstColon = msgStr.indexOf(':');
-    int secondColon = msgStr.indexOf(':', firstColon + 1);
-    if (firstColon != -1 && secondColon != -1) {
-      String packetIDStr = msgStr.substring(firstColon + 1, secondColon);
-      packetIDStr.trim();
-      uint32_t packetID = (uint32_t)packetIDStr.toInt();
-      tcValue = packetID;   // For PacketID command, store the packet ID in tcValue.
-      tc = "PacketID";      // Set tc to "PacketID"
-      int headerLength = secondColon + 1;
-      int dataLength = inboundMessageLength - headerLength;
-      if (dataLength > 0) {
-        bool res = appendPacketToFile(packetID, inboundMessage + headerLength, dataLength);
+      break;
+
+    case TC_PACKET:
+      tcValue = cmd.value;   // For PacketID command, store the packet ID in tcValue.
+      tc = "PacketID";       // Set tc to "PacketID"
+      if (cmd.dataLength > 0) {
+        bool res = appendPacketToFile((uint32_t)cmd.value, cmd.data, cmd.dataLength);
         if (res) {
+          applied = true;
           Serial.print("Appended packet ");
-          Serial.print(packetID);
+          Serial.print((uint32_t)cmd.value);
           Serial.println(" to flash storage file.");
         }
       }
-    }
-  }
-  else {
-    Serial.println("Unknown inbound message type.");
+      break;
+
+    case TC_SET_PROFILE:
+      // Task profile telemetry period in seconds, 0 turns it off.
+      if (stateSetInt(STATE_PROFILE_PERIOD, cmd.value)) {
+        tc = "SetProfile:";
+        applied = true;
+        tcValue = cmd.value;
+      }
+      break;
+
+    case TC_DUMP_FRAME:
+      // Next OLED frame is written to the serial port as a PBM image.
+      requestDisplayFrameDump(Serial);
+      tc = "DumpFrame";
+      applied = true;
+      tcValue = 0;
+      break;
+
+    case TC_RECORD:
+      // Record all sensor samples for the given seconds (max 1 h), 0 stops.
+      if (cmd.value >= 0 && cmd.value <= 3600 && sensorRecordStart(cmd.value)) {
+        tc = "Record:";
+        applied = true;
+        tcValue = cmd.value;
+      }
+      break;
+
+    case TC_REPLAY:
+      if (sensorReplayStart()) {
+        tc = "Replay";
+        applied = true;
+        tcValue = 0;
+      }
+      break;
+
+    case TC_SYNTH:
+      // Synthetic sensor scenario, 0 returns to the live sensors.
+      if (cmd.value >= 0 && sensorSynthStart((SynthScenario)cmd.value)) {
+        tc = "Synth:";
+        applied = true;
+        tcValue = cmd.value;
+      }
+      break;
+
+    case TC_BENCH:
+      // Micro-benchmarks in their own task (a few seconds), printed to the serial port.
+      if (startBenchmarks(Serial)) {
+        tc = "Bench";
+        applied = true;
+        tcValue = 0;
+      }
+      break;
+
+    case TC_FAULT:
+      // Network fault injection for soak tests (see MqttFault).
+      if (cmd.value > 0 && cmd.arg >= 0 && mqttInjectFault((MqttFault)cmd.value, cmd.arg)) {
+        tc = "Fault:";
+        applied = true;
+        tcValue = cmd.value;
+      }
+      break;
+
+    case TC_TRACE:
+      // Event trace: 0 stop, 1 (re)start, 2 dump to serial, 3 dump over MQTT.
+      if (cmd.value >= 0 && cmd.value <= 3) {
+        if (cmd.value <= 1) {
+          traceEnable(cmd.value == 1);
+        } else if (cmd.value == 2) {
+          traceDump(Serial);
+        } else {
+          traceDumpMqtt();
+        }
+        tc = "Trace:";
+        applied = true;
+        tcValue = cmd.value;
+      }
+      break;
+
+    case TC_ALLOC_GUARD:
+      // 1 arms the "no allocation after boot" guard, 0 disarms it.
+      if (cmd.value == 0 || cmd.value == 1) {
+        allocGuardArm(cmd.value == 1);
+        tc = "AllocGuard:";
+        applied = true;
+        tcValue = cmd.value;
+      }
+      break;
+
+    case TC_SET_KEYFRAME:
+      // Telemetry packets per full snapshot (range checked by the registry).
+      if (stateSetInt(STATE_KEYFRAME_INTERVAL, cmd.value)) {
+        tc = "SetKeyframe:";
+        applied = true;
+        tcValue = cmd.value;
+      }
+      break;
+
+    case TC_SET_RATE:
+      // Publish period in ms of one telemetry group (ChannelGroup), range checked by the registry.
+      if (cmd.value >= 0 && cmd.value < CH_GROUP_COUNT &&
+          stateSetInt(channelGroupPeriod[cmd.value], cmd.arg)) {
+        telemetryReschedule();
+        tc = "SetRate:";
+        applied = true;
+        tcValue = cmd.value;
+      }
+      break;
+
+    case TC_SUBSCRIBE:
+      // Telemetry groups to publish, bit 1 << ChannelGroup each.
+      if (stateSetInt(STATE_TELEMETRY_GROUPS, cmd.value)) {
+        telemetryReschedule();
+        tc = "Subscribe:";
+        applied = true;
+        tcValue = cmd.value;
+      }
+      break;
+
+    default:
+      Serial.println("Unknown inbound message type.");
+      break;
   }
 
-  newMessageAvailable = false;
+  // Unknown, out-of-range and rejected commands had no effect to time.
+  if (applied && !effectDeferred) {
+    latencyRecord(LATENCY_TC_EFFECT, micros() - inboundMessageUs);
+  }
+  // Hand the buffer back to mqttCallback(); inboundMessage is not read after this.
+  newMessageAvailable.store(false, std::memory_order_release);
 }
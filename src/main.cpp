@@ -18,6 +18,7 @@
 
 #include <Arduino.h>
 #include "display.h"
+#include "telemetry.h"
 #include "sensors/VoltageMeasurement.h"
 #include "sensors/IMU.h"         // IMU sensor header.
 #include "FreeRTOS.h"
@@ -33,6 +34,14 @@
 #include "hardware/storage.h"
 #include <SPIFFS.h>
 #include "inbound_processor.h"
+#include "alarms/AlarmEngine.h"
+#include "TaskTable.h"
+#include "ChannelTable.h"
+#include "diagnostics/TaskProfiler.h"
+#include "diagnostics/AllocCounter.h"
+#include "diagnostics/Latency.h"
+#include "state/StateRegistry.h"
+#include "sensors/SensorSource.h"
 #include "modes/modegeneral.h"
 #include "modes/mode1.h"
 #include "modes/mode2.h"
@@ -42,56 +51,8 @@
 
 
 
-// Global variable to store the current mode (0 to 6)
-// Default mode is 0.
-
-
-/**
- * @brief Current mode of the satellite system (ranges from 0 to 5).
- */
-int currentMode = 0;
-
-/**
- * @brief Default mode loaded from flash memory at boot.
- */
-int defaultModeValue = 0;
-
-/**
- * @brief Initial pressure recorded at boot, used for pressure drop detection in Mode 2.
- */
-float initPressure = 0;
-
-/**
- * @brief Threshold difference in pressure to trigger an alarm in Mode 2.
- */
-float deltaPressure = 10;
-
-/**
- * @brief Mode selector for rolling plot display in Mode 4.
- */
-int rollingPlotSwitch = 3;
-
-/**
- * @brief Threshold for detecting microgravity in Mode 1.
- */
-float gravityAlaramAt = 1;
-
-/**
- * @brief Stores the last known mode to prevent redundant buzzer alerts.
- */
-int previousMode = -1;
- 
-/**
- * @brief Status of the last touch input (e.g., TOUCH_LEFT, TOUCH_DOWN).
- */
-
-String touchStatus = "";
-
-/**
- * @brief Status of the last push button event (e.g., PUSH_BUTTON_15).
- */
-
-String buttonStatus = "";
+// Shared state (current mode, alarm parameters, last input, ...) lives in the state
+// registry, see state/StateRegistry.h.
 
 
 /**
@@ -108,11 +69,11 @@ void processInboundMessage();
 // FreeRTOS task that checks for new inbound messages every 500 ms.
 void inboundTask(void *pvParameters) {
   for (;;) {
-    if (newMessageAvailable) {
-      processInboundMessage();
-      newMessageAvailable = false;
+    if (newMessageAvailable.load(std::memory_order_acquire)) {
+      AllocSiteScope site(ALLOC_SITE_TELECOMMAND);
+      processInboundMessage();   // releases the buffer when done
     }
-    vTaskDelay(pdMS_TO_TICKS(500));
+    vTaskDelay(pdMS_TO_TICKS(TASK_PERIOD_MS(TASK_INBOUND)));
   }
 }
 
@@ -126,63 +87,278 @@ void inboundTask(void *pvParameters) {
  * @param pvParameters Unused.
  */
 
+// ----------------- Heap Allocation Telemetry -----------------
+// Publishes the allocation counters as a separate message (the profile is near the
+// MQTT buffer size): fragmentation, the guard, and allocations since boot per task
+// and per site, leaving out the ones that never allocated.
+static void publishAllocProfile() {
+  HeapFragmentation heap = getHeapFragmentation();
+  AllocViolation last = getLastAllocViolation();
+
+  String payload = "{\"Alloc\":{";
+  payload += "\"Free\":" + String(heap.freeBytes) + ",";
+  payload += "\"MaxBlock\":" + String(heap.largestFreeBlock) + ",";
+  payload += "\"Frag\":" + String(heap.fragmentationPermille / 10.0f, 1) + ",";
+  payload += "\"Guard\":" + String(allocGuardArmed() ? 1 : 0) + ",";
+  payload += "\"Violations\":" + String(getAllocGuardViolations());
+  if (getAllocGuardViolations() > 0) {
+    payload += ",\"Last\":{\"task\":\"" + String(allocTaskName(last.taskSlot)) + "\",";
+    payload += "\"site\":\"" + String(allocSiteName(last.site)) + "\",";
+    payload += "\"size\":" + String(last.size) + "}";
+  }
+  payload += ",\"Tasks\":{";
+  bool first = true;
+  for (int slot = 0; slot < ALLOC_TASK_SLOTS; slot++) {
+    if (getTaskAllocCount(slot) == 0) continue;
+    if (!first) payload += ",";
+    payload += "\"" + String(allocTaskName(slot)) + "\":[" + String(getTaskAllocCount(slot)) + ",";
+    payload += String(getTaskAllocBytes(slot)) + "]";
+    first = false;
+  }
+  payload += "},\"Sites\":{";
+  first = true;
+  for (int site = 0; site < ALLOC_SITE_COUNT; site++) {
+    if (getSiteAllocCount((AllocSite)site) == 0) continue;
+    if (!first) payload += ",";
+    payload += "\"" + String(allocSiteName((AllocSite)site)) + "\":[";
+    payload += String(getSiteAllocCount((AllocSite)site)) + ",";
+    payload += String(getSiteAllocBytes((AllocSite)site)) + "]";
+    first = false;
+  }
+  payload += "}}}";
+
+  publishMqttMessage(payload);
+}
+
+// ----------------- Latency Telemetry -----------------
+// Publishes the latency metrics since the previous report as a separate message:
+// per metric [count, p50, p95, p99, max], leaving out the ones without values.
+static void publishLatencyProfile() {
+  String payload = "{\"Latency\":{";
+  bool first = true;
+  for (int metric = 0; metric < LATENCY_METRIC_COUNT; metric++) {
+    LatencySummary summary = latencyTakeSummary((LatencyMetric)metric);
+    if (summary.count == 0) continue;
+    if (!first) payload += ",";
+    payload += "\"" + String(latencyName((LatencyMetric)metric)) + "\":[";
+    payload += String(summary.count) + "," + String(summary.p50) + ",";
+    payload += String(summary.p95) + "," + String(summary.p99) + ",";
+    payload += String(summary.max) + "]";
+    first = false;
+  }
+  payload += "}}";
+
+  publishMqttMessage(payload);
+}
+
+// ----------------- Task Profile Telemetry -----------------
+// Publishes the latest task profile as a separate telemetry message:
+// heap figures plus, per task, core, CPU share (% of one core) and free stack bytes,
+// and the network path counters (publish times, drops, reconnections).
+static void publishTaskProfile() {
+  AllocSiteScope site(ALLOC_SITE_PROFILE);
+  static SystemProfile profile;   // only used by the sensor task
+  getTaskProfile(&profile);
+
+  String payload = "{\"Profile\":{";
+  payload += "\"t\":" + String(profile.sampleMs) + ",";
+  payload += "\"FreeHeap\":" + String(profile.freeHeap) + ",";
+  payload += "\"MinFreeHeap\":" + String(profile.minFreeHeap) + ",";
+  payload += "\"MaxBlock\":" + String(profile.largestFreeBlock) + ",";
+  payload += "\"TaskTotal\":" + String(profile.taskTotal) + ",";
+  if (profile.truncated) {
+    payload += "\"Truncated\":true,";   // Tasks lists the task table only
+  }
+  payload += "\"Tasks\":[";
+  for (int i = 0; i < profile.taskCount; i++) {
+    const TaskProfileEntry& task = profile.tasks[i];
+    if (i > 0) payload += ",";
+    payload += "{\"n\":\"" + String(task.name) + "\",";
+    payload += "\"core\":" + String(task.core) + ",";
+    if (profile.cpuAvailable) {
+      payload += "\"cpu\":" + String(task.cpuPermille / 10.0f, 1) + ",";
+    }
+    payload += "\"stack\":" + String(task.stackFreeBytes) + "}";
+  }
+  payload += "],";
+
+  // Network path since boot: publish call duration, drops and reconnections.
+  MqttStats net = getMqttStats();
+  payload += "\"Net\":{";
+  payload += "\"pub\":" + String(net.published) + ",";
+  payload += "\"pubFail\":" + String(net.publishFailed) + ",";
+  payload += "\"pubDrop\":" + String(net.publishDropped) + ",";
+  payload += "\"pubP50\":" + String(net.publishP50Us) + ",";
+  payload += "\"pubP95\":" + String(net.publishP95Us) + ",";
+  payload += "\"pubP99\":" + String(net.publishP99Us) + ",";
+  payload += "\"pubMax\":" + String(net.publishMaxUs) + ",";
+  payload += "\"rx\":" + String(net.received) + ",";
+  payload += "\"rxOversize\":" + String(net.rxOversize) + ",";
+  payload += "\"rxOverrun\":" + String(net.rxOverrun) + ",";
+  payload += "\"reconnects\":" + String(net.reconnects) + ",";
+  payload += "\"reconnectMs\":" + String(net.reconnectMsLast) + ",";
+  payload += "\"reconnectMsMax\":" + String(net.reconnectMsMax);
+  payload += "}}}";
+
+  publishMqttMessage(payload);
+  publishAllocProfile();
+  publishLatencyProfile();
+}
+
+// ----------------- Telemetry Payload -----------------
+// Composes a JSON payload with all channels of the channel table.
+void buildTelemetryPayload(String& payload, bool withAlarms, ChannelReporter* reporter, uint32_t groups) {
+  payload = "{";
+  appendChannelsJson(payload, reporter, groups);
+
+  // Alarm state transitions since the last packet, with their sample times.
+  AlarmEvent alarmEvent;
+  bool firstAlarm = true;
+  while (withAlarms && alarmPollEvent(&alarmEvent)) {
+    payload += firstAlarm ? ",\"Alarms\":[" : ",";
+    payload += "{\"id\":\"" + String(alarmName(alarmEvent.id)) + "\",";
+    payload += "\"state\":\"" + String(alarmStateName(alarmEvent.state)) + "\",";
+    payload += "\"t\":" + String(alarmEvent.timestampMs);
+    if (!isnan(alarmEvent.value)) {
+      payload += ",\"value\":" + String(alarmEvent.value, 2);
+    }
+    payload += "}";
+    firstAlarm = false;
+  }
+  if (!firstAlarm) {
+    payload += "]";
+  }
+
+  // // Touch sensor status
+  // payload += "\"Touch\":" + String(stateGetInt(STATE_LAST_TOUCH)) + ",";
+
+  // // Push button status
+  // payload += "\"Button\":" + String(stateGetInt(STATE_LAST_BUTTON));
+  
+  payload += "}";
+}
+
+// Publishes the given channel groups as one telemetry packet and records the age of
+// their sensor data at publish.
+static void publishTelemetry(uint32_t groups, ChannelReporter* reporter) {
+  // Sample times are taken before the values, so the ages are never underestimated.
+  uint32_t voltageSampleMs = getVoltageSampleTime();
+  uint32_t imuSampleMs = getIMUSampleTime();
+  uint32_t bmeSampleMs = getBMESampleTime();
+
+  String payload;
+  {
+    AllocSiteScope site(ALLOC_SITE_PAYLOAD);
+    reporter->keyframeInterval = stateGetInt(STATE_KEYFRAME_INTERVAL);
+    buildTelemetryPayload(payload, true, reporter, groups);
+  }
+
+  stateSetInt(STATE_LAST_TOUCH, -1);
+  stateSetInt(STATE_LAST_BUTTON, -1);
+
+  // Publish the JSON payload via MQTT.
+  publishMqttMessage(payload);
+
+  uint32_t publishedMs = millis();
+  if (groups & (1u << CH_GROUP_VOLTAGES)) {
+    latencyRecord(LATENCY_AGE_VOLTAGE, publishedMs - voltageSampleMs);
+  }
+  if (groups & (1u << CH_GROUP_IMU)) {
+    latencyRecord(LATENCY_AGE_IMU, publishedMs - imuSampleMs);
+  }
+  if (groups & (1u << CH_GROUP_BME)) {
+    latencyRecord(LATENCY_AGE_BME, publishedMs - bmeSampleMs);
+  }
+}
+
+void telemetryReschedule() {
+  TaskHandle_t handle = getTableTaskHandle(TASK_TELEMETRY);
+  if (handle != NULL) {
+    xTaskNotifyGive(handle);
+  }
+}
+
 // ----------------- Sensor Task -----------------
-// This task reads sensor data, updates the display, and publishes an MQTT payload every 1 second.
+// Publishes every subscribed channel group (STATE_TELEMETRY_GROUPS) at its own period
+// (STATE_PERIOD_*), the groups due together in one packet, and samples the task
+// profile every TASK_PERIOD_MS(TASK_TELEMETRY). Deadlines advance by whole periods
+// from the previous deadline, so the rates do not drift with the publish time.
 void sensorTask(void *pvParameters) {
   (void) pvParameters; // Unused parameter
-  int rssi;
+  int profileCountdown = 0;
+  uint32_t profileVersion = stateVersion(STATE_PROFILE_PERIOD);
+  static ChannelReporter reporter;   // report-by-exception state of the telemetry stream
+
+  TickType_t now = xTaskGetTickCount();
+  TickType_t profileDue = now;
+  TickType_t groupDue[CH_GROUP_COUNT];
+  uint32_t periodVersion[CH_GROUP_COUNT];
+  for (int group = 0; group < CH_GROUP_COUNT; group++) {
+    groupDue[group] = now;
+    periodVersion[group] = stateVersion(channelGroupPeriod[group]);
+  }
+  uint32_t subscribed = 0;
 
   while (1) {
-    // Retrieve the latest IMU data.
-    IMUEvents_t imuData = getIMUData();
-
-    // Compose a JSON payload with all sensor values.
-    String payload = "{";
-    payload += "\"mode\":" + String(currentMode) + ",";
-    payload += "\"voltages\":{";
-    payload += "\"BattVolt\":" + String(getVbatVoltage(), 2) + ",";
-    payload += "\"BusVolt\":"  + String(getUsbVoltage(), 2);
-    payload += "},";
-    payload += "\"IMU\":{";
-    payload += "\"AccelX\":" + String(imuData.accel.acceleration.x, 1) + ",";
-    payload += "\"AccelY\":" + String(imuData.accel.acceleration.y, 1) + ",";
-    payload += "\"AccelZ\":" + String(imuData.accel.acceleration.z, 1) + ",";
-    payload += "\"GyroX\":"  + String(imuData.gyro.gyro.x, 1) + ",";
-    payload += "\"GyroY\":"  + String(imuData.gyro.gyro.y, 1) + ",";
-    payload += "\"GyroZ\":"  + String(imuData.gyro.gyro.z, 1) + ",";
-    payload += "\"Temp\":"   + String(imuData.temp.temperature, 0);
-    payload += "},";
-    payload += "\"BME\":{";
-    payload += "\"Temp\":" + String(getBMETemperature(), 0) + ",";
-    payload += "\"Pres\":" + String(getBMEPressure(), 1) + ",";
-    payload += "\"Humi\":" + String(getBMEHumidity(), 0);
-    // payload += "}";
-    // payload += "}";
-    
-    payload += "},";
-
-    rssi= getWiFiRSSI();
-
-    // WiFi signal strength
-    payload += "\"WiFiRSSI\":" + String(rssi);
-
-    // // Touch sensor status
-    // payload += "\"Touch\":\"" + touchStatus + "\",";
-
-    // // Push button status
-    // payload += "\"Button\":\"" + buttonStatus + "\"";
-    
-    payload += "}";
+    now = xTaskGetTickCount();
+    uint32_t groups = (uint32_t)stateGetInt(STATE_TELEMETRY_GROUPS);
+    uint32_t due = 0;
+    for (int group = 0; group < CH_GROUP_COUNT; group++) {
+      uint32_t bit = 1u << group;
+      if ((groups & bit) == 0) continue;
+      // A newly subscribed group or a new period is published now and scheduled from here.
+      uint32_t version = stateVersion(channelGroupPeriod[group]);
+      if ((subscribed & bit) == 0 || version != periodVersion[group]) {
+        periodVersion[group] = version;
+        groupDue[group] = now;
+      }
+      if ((int32_t)(now - groupDue[group]) >= 0) {
+        due |= bit;
+        TickType_t period = pdMS_TO_TICKS(stateGetInt(channelGroupPeriod[group]));
+        groupDue[group] += period;
+        // After an overrun, skip the missed deadlines instead of catching up in a burst.
+        if ((int32_t)(now - groupDue[group]) >= 0) {
+          groupDue[group] = now + period;
+        }
+      }
+    }
+    subscribed = groups;
+    setIMUTelemetryPeriod((groups & (1u << CH_GROUP_IMU)) ? stateGetInt(STATE_PERIOD_IMU) : 0);
 
-   
-    touchStatus = "";
-    buttonStatus = "";
+    if (due != 0) {
+      publishTelemetry(due, &reporter);
+    }
 
-    // Publish the JSON payload via MQTT.
-    publishMqttMessage(payload);
+    if ((int32_t)(now - profileDue) >= 0) {
+      profileDue += pdMS_TO_TICKS(TASK_PERIOD_MS(TASK_TELEMETRY));
+      if ((int32_t)(now - profileDue) >= 0) {
+        profileDue = now + pdMS_TO_TICKS(TASK_PERIOD_MS(TASK_TELEMETRY));
+      }
+
+      // Sample the task profile every period; publish it only when enabled.
+      // A new period (SetProfile) restarts the countdown, so it applies right away.
+      sampleTaskProfile();
+      reportAllocGuardViolations(Serial);
+      int profilePeriod = stateGetInt(STATE_PROFILE_PERIOD);
+      if (stateVersion(STATE_PROFILE_PERIOD) != profileVersion) {
+        profileVersion = stateVersion(STATE_PROFILE_PERIOD);
+        profileCountdown = 0;
+      }
+      if (profilePeriod > 0 && --profileCountdown <= 0) {
+        publishTaskProfile();
+        profileCountdown = profilePeriod;
+      }
+    }
 
-    // Delay for 1000 ms (1 second).
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
+    // Sleep until the next deadline; telemetryReschedule() wakes the task earlier.
+    TickType_t next = profileDue;
+    for (int group = 0; group < CH_GROUP_COUNT; group++) {
+      if ((groups & (1u << group)) != 0 && (int32_t)(groupDue[group] - next) < 0) {
+        next = groupDue[group];
+      }
+    }
+    now = xTaskGetTickCount();
+    ulTaskNotifyTake(pdTRUE, ((int32_t)(next - now) > 0) ? next - now : 0);
   }
 }
 
@@ -198,185 +374,68 @@ void sensorTask(void *pvParameters) {
 
 // ----------------- Physical input Task -----------------
 
-// Task that receives button events and toggles the LED or does other actions.
+// Task that receives button events: UP/DOWN navigate between modes, everything else
+// is forwarded to the active mode. Presses and auto-repeats act; long-press and
+// release events are not used by the modes.
 static void physicalInput(void *pvParameters)
 {
     (void) pvParameters; // Unused
 
-    ButtonEvent_t evt;
+    ButtonEventMsg_t msg;
     for (;;) {
         // Wait indefinitely for an event from the queue
-        if (xQueueReceive(buttonEventQueue, &evt, portMAX_DELAY) == pdTRUE) {
+        if (xQueueReceive(buttonEventQueue, &msg, portMAX_DELAY) == pdTRUE) {
+            if (msg.action != BUTTON_ACTION_PRESS && msg.action != BUTTON_ACTION_REPEAT) {
+                continue;
+            }
+            ButtonEvent_t evt = msg.button;
             switch (evt) {
-              case BUTTON_EVENT_TOUCH_UP:
-              touchStatus = "TOUCH_UP";
-              if (currentMode < 5) {
-                  currentMode++;  // Increase mode, max is 6
-              }
-              Serial.printf("Event: TOUCH_UP -> Current Mode: %d\n", currentMode);
-              break;
+                case BUTTON_EVENT_TOUCH_UP:
+                    stateSetInt(STATE_LAST_TOUCH, evt);
+                    if (stateGetInt(STATE_CURRENT_MODE) < MODE_COUNT - 1) {
+                        requestMode(stateGetInt(STATE_CURRENT_MODE) + 1);  // Increase mode, max is MODE_COUNT - 1
+                    }
+                    Serial.printf("Event: TOUCH_UP -> Current Mode: %d\n", (int)stateGetInt(STATE_CURRENT_MODE));
+                    break;
+                case BUTTON_EVENT_TOUCH_DOWN:
+                    stateSetInt(STATE_LAST_TOUCH, evt);
+                    if (stateGetInt(STATE_CURRENT_MODE) > 0) {
+                        requestMode(stateGetInt(STATE_CURRENT_MODE) - 1);  // Decrease mode, min is 0
+                    }
+                    Serial.printf("Event: TOUCH_DOWN -> Current Mode: %d\n", (int)stateGetInt(STATE_CURRENT_MODE));
+                    break;
                 case BUTTON_EVENT_TOUCH_LEFT:
-                touchStatus = "TOUCH_LEFT";
+                    stateSetInt(STATE_LAST_TOUCH, evt);
                     Serial.println("Event: TOUCH_LEFT");
-
-              if (currentMode == 2) {
-
-                deltaPressure--;  // Increase mode, max is 6
-                }
-
-                else if (currentMode == 4) {
-                  
-                rollingPlotSwitch = (rollingPlotSwitch < 2) ?  1 : rollingPlotSwitch - 1;
-                Serial.printf("Event: TOUCH_LEFT %d\n",rollingPlotSwitch );
-
-
-                // updateTableData(std::array<TableEntry, 1>{
-                //   {
-                //     {"Mode", static_cast<float>(currentMode), "FromFlash"}
-                //   }
-                // }.data(), 1);
-                  
-
-                } 
-                else if (currentMode == 1) {
-                  gravityAlaramAt--;
-
-                }
-
+                    postModeInput(evt);
                     break;
                 case BUTTON_EVENT_TOUCH_X:
-                    touchStatus = "TOUCH_X";
+                    stateSetInt(STATE_LAST_TOUCH, evt);
                     Serial.println("Event: TOUCH_X");
+                    postModeInput(evt);
                     break;
                 case BUTTON_EVENT_TOUCH_RIGHT:
-                touchStatus = "TOUCH_RIGHT";
+                    stateSetInt(STATE_LAST_TOUCH, evt);
                     Serial.println("Event: TOUCH_RIGHT");
-                    if (currentMode == 2) {
-
-                      deltaPressure++;  // Increase mode, max is 6
-                      }
-      
-                      else if (currentMode == 4) {
-                        
-                      rollingPlotSwitch = (rollingPlotSwitch > 2) ?   1 : rollingPlotSwitch + 1;
-                      Serial.printf("Event: TOUCH_RIGHT %d\n",rollingPlotSwitch );
-                        
-      
-                      } 
-                      else if (currentMode == 1) {
-                        gravityAlaramAt++;
-
-                      }
-
-
-                    break;
-
-                case BUTTON_EVENT_TOUCH_DOWN:
-                    touchStatus = "TOUCH_DOWN";
-                    if (currentMode > 0) {
-                        currentMode--;  // Decrease mode, min is 0
-                    }
-                    Serial.printf("Event: TOUCH_DOWN -> Current Mode: %d\n", currentMode);
+                    postModeInput(evt);
                     break;
                 case BUTTON_EVENT_PUSH_15:
-                    buttonStatus = "PUSH_BUTTON_15";
+                    stateSetInt(STATE_LAST_BUTTON, evt);
                     Serial.println("Event: PUSH_BUTTON_15");
+                    postModeInput(evt);
                     break;
                 case BUTTON_EVENT_PUSH_16:
-                    buttonStatus = "PUSH_BUTTON_16";
+                    stateSetInt(STATE_LAST_BUTTON, evt);
                     Serial.println("Event: PUSH_BUTTON_16");
+                    postModeInput(evt);
                     break;
             }
-
-
-            //Serial.printf("LED toggled -> %s\n", ledState ? "ON" : "OFF");
         }
     }
 }
 
 
 
-/**
- * @brief FreeRTOS task that manages mode logic and triggers appropriate mode behavior.
- * 
- * Updates the display and calls the correct runModeX() function based on currentMode.
- * Runs every 100 ms.
- * 
- * @param pvParameters Unused.
- */
-
-
-
-// ----------------- Mode Task -----------------
-// // This task cycles the current mode between 0 and 6 every 100 ms.
-
-void modeTask(void *pvParameters) {
-  (void) pvParameters; // Unused parameter
-
-    // Static variable to keep track of the previous mode.
-    
-
-    static float t = 0.0;
-    float value = 0.0;
-
-  while (1) {
-  
-    // Cycle mode: increment and wrap around from 6 back to 0.
-    // currentMode = (currentMode + 1) % 7;
-    //currentMode = 3;
-
-
-    setDisplayMode(TABLE_MODE);
-        // Update the display with the current mode.
-        updateTableData(std::array<TableEntry, 1>{
-          {
-            {"Mode", static_cast<float>(currentMode), ""}
-          }
-        }.data(), 1);
-
-    // Execute extra code based on the current mode.
-    switch (currentMode) {
-      case 0:
-        // Only beep once when entering mode 1.
-        if (previousMode != 0) {
-        Serial.println("Case 0");
-
-         Serial.println("Beeping 0 times...");
-        //  buzzerAction(1);
-        //  delay(1000); // Ensure beep is fully executed.
-        previousMode = 0;
-        }
-        break;
-      case 1:
-        runMode1();
-      break;
-
-      case 2:
-        runMode2();
-      break;
-      case 3: 
-        runMode3();
-      break;
-
-      case 4: 
-        runMode4();
-      break;
-
-      case 5:
-        runMode5();
-      break;
-      default:
-        break;
-    }
-
-
-
-    // Delay for 100 ms.
-    vTaskDelay(100 / portTICK_PERIOD_MS);
-  }
-}
-
-
 /**
  * @brief Arduino setup function.
  * 
@@ -390,6 +449,9 @@ void setup() {
   Serial.begin(115200);
   delay(1000); // Allow time for the serial monitor to initialize
 
+  // Shared state to its initial values, before any task reads it.
+  stateInit();
+
   // Initialize the display module (also initializes the OLED).
   displayInit();
   
@@ -404,12 +466,8 @@ void setup() {
   delay(1000);
   
   // Display voltage measurement messages.
-  updateTableData(std::array<TableEntry, 2>{
-    {
-      {"BattVolt", getVbatVoltage(), "V"},
-      {"BusVolt",  getUsbVoltage(), "V"}
-    }
-  }.data(), 2);
+  static const ChannelId voltageChannels[] = {CH_BATT_VOLT, CH_BUS_VOLT};
+  updateChannelTable(voltageChannels, 2);
   
 
   // ---------- IMU Initialization ----------
@@ -419,19 +477,10 @@ void setup() {
   delay(3000);
 
     // Update the display with IMU sensor data.
-  IMUEvents_t imuData  = getIMUData();
-
-  updateTableData(std::array<TableEntry, 7>{
-  {
-    {"AccelX", imuData.accel.acceleration.x, "m/s^2"},
-    {"AccelY", imuData.accel.acceleration.y, "m/s^2"},
-    {"AccelZ", imuData.accel.acceleration.z, "m/s^2"},
-    {"GyroX",  imuData.gyro.gyro.x, "rad/s"},
-    {"GyroY",  imuData.gyro.gyro.y, "rad/s"},
-    {"GyroZ",  imuData.gyro.gyro.z, "rad/s"},
-    {"Temp",   imuData.temp.temperature, "°C"}
-  }
-}.data(), 7);
+  static const ChannelId imuChannels[] = {
+    CH_ACCEL_X, CH_ACCEL_Y, CH_ACCEL_Z, CH_GYRO_X, CH_GYRO_Y, CH_GYRO_Z, CH_IMU_TEMP
+  };
+  updateChannelTable(imuChannels, 7);
 
 
 
@@ -439,15 +488,10 @@ void setup() {
   initBME280();
   startBME280Task();
   delay(3000);
-updateTableData(std::array<TableEntry, 3>{
-  {
-    {"Temp", getBMETemperature(), "°C"},
-    {"Pres", getBMEPressure(), "hPa"},
-    {"Humi", getBMEHumidity(), "%"}
-  }
-}.data(), 3);
+static const ChannelId bmeChannels[] = {CH_BME_TEMP, CH_PRES, CH_HUMI};
+updateChannelTable(bmeChannels, 3);
 
-initPressure = getBMEPressure();
+stateSetFloat(STATE_INIT_PRESSURE, getBMEPressure());
 
 delay(1000);
 
@@ -458,8 +502,8 @@ delay(1000);
 
   updateTableData(std::array<TableEntry, 2>{
     {
-      {"TouchButton", 4, "ready!"},
-      {"PushButton", 2, "ready!"}
+      {TABLE_LABEL_TOUCH_BUTTON, 4, TABLE_UNIT_READY},
+      {TABLE_LABEL_PUSH_BUTTON, 2, TABLE_UNIT_READY}
     }
   }.data(), 2);
   
@@ -470,21 +514,21 @@ delay(1000);
    if (!initStorage()) {
     Serial.println("Storage initialization failed");
   }
+  // Sensor recording / replay (uses the storage).
+  initSensorSource();
 
   // Read default mode from flash; if not available, use 0.
   int storedDefault = readDefaultMode();
-  if (storedDefault >= 0 && storedDefault <= 5) {
-    defaultModeValue = storedDefault;
-  } else {
-    defaultModeValue = 0;
-    writeDefaultMode(defaultModeValue);
+  if (!stateSetInt(STATE_DEFAULT_MODE, storedDefault)) {
+    stateSetInt(STATE_DEFAULT_MODE, 0);
+    writeDefaultMode(0);
   }
 
-  currentMode = defaultModeValue;
+  stateSetInt(STATE_CURRENT_MODE, stateGetInt(STATE_DEFAULT_MODE));
 
   updateTableData(std::array<TableEntry, 1>{
     {
-      {"Mode", static_cast<float>(currentMode), "FromFlash"}
+      {TABLE_LABEL_MODE, static_cast<float>(stateGetInt(STATE_CURRENT_MODE)), TABLE_UNIT_FROM_FLASH}
     }
   }.data(), 1);
   delay(1000);
@@ -497,7 +541,7 @@ delay(1000);
 
   updateTableData(std::array<TableEntry, 1>{
     {
-      {"LED RED", 3, "Blinking"}
+      {TABLE_LABEL_LED_RED, 3, TABLE_UNIT_BLINKING}
     }
   }.data(), 1);
 
@@ -513,25 +557,23 @@ delay(1000);
 
 
   // Create the sensor task (runs every 1 second).
-  xTaskCreate(sensorTask, "SensorTask", 4096, NULL, 1, NULL);
+  createTableTask(TASK_TELEMETRY, sensorTask, NULL);
 
 
   // Create the FreeRTOS task to process inbound messages
-  xTaskCreate(
-    inboundTask,            // Task function.
-    "InboundTask",          // Task name.
-    4096,                   // Stack size in bytes.
-    NULL,                   // Parameter.
-    1,                      // Priority.
-    NULL                    // Task handle.
-  );
-
-  // Create the mode task (runs every 100 ms).
-  xTaskCreate(modeTask, "ModeTask", 4096, NULL, 1, NULL);
+  createTableTask(TASK_INBOUND, inboundTask, NULL);
+
+  // Start the mode task (each mode ticks at its own declared rate).
+  startModeTask();
 
   
     // Create a task that receives events and toggles the MODE
-    xTaskCreate(physicalInput, "PhysicalInput", 2048, NULL, 1, NULL);
+    createTableTask(TASK_INPUT, physicalInput, NULL);
+
+#ifdef ALLOC_GUARD_AFTER_BOOT
+  // Steady state from here on: any further heap allocation is reported.
+  allocGuardArm(true);
+#endif
 
 }
 
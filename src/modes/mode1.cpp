@@ -2,45 +2,112 @@
 #include "modes/modegeneral.h"
 #include "modes/mode1.h"
 
-void runMode1() {
-    // Static variable to ensure that the beep is triggered only once upon entering mode 1.
-    //static int previousMode1 = -1;
-    if (previousMode != 1) {
-        Serial.println("Beeping 1 times...");
-        buzzerAction(1);
-        previousMode = 1;
-    }
-    
-    // Retrieve the latest IMU data.
-    IMUEvents_t imuData = getIMUData();
-    
-    // Calculate the magnitude from the accelerometer readings.
-    float magnitude = sqrt(
+// IMU sample period while the alarm is armed (the accelerometer runs at 26 Hz).
+#define MODE1_IMU_PERIOD_MS 40
+
+static float accelMagnitude(const IMUEvents_t& imuData) {
+    return sqrt(
         (imuData.accel.acceleration.y * imuData.accel.acceleration.y) +
         (imuData.accel.acceleration.z * imuData.accel.acceleration.z) +
         (imuData.accel.acceleration.x * imuData.accel.acceleration.x)
     );
-    
-    // If the magnitude is below the threshold, trigger the gravity alarm.
-    if (magnitude < gravityAlaramAt) {
-        Serial.print("Acceleration magnitude: ");
-        Serial.println(magnitude);
-        buzzerAction(1, false, true);
-
-        ledController.blinkLED(7, 1, 400);
-        ledController.blinkLED(10, 1, 400);
-        ledController.blinkLED(13, 1, 400);
+}
+
+// Alarm action: meow and flash the red LEDs.
+static void microgravityAction(AlarmId id) {
+    (void)id;
+    buzzerAction(1, false, true);
+    ledController.blinkLED(7, 1, 400);
+    ledController.blinkLED(10, 1, 400);
+    ledController.blinkLED(13, 1, 400);
+}
+
+// Runs in the IMU task for every sample.
+static void feedMicrogravity(const IMUEvents_t& sample, uint32_t timestampMs) {
+    alarmFeed(ALARM_MICROGRAVITY, accelMagnitude(sample), timestampMs);
+}
+
+// Raised on the 2nd consecutive sample below STATE_GRAVITY_ALARM_AT (the debounce
+// spans one IMU period), cleared 0.5 m/s^2 above it;
+// the action repeats every 3 s (about one meow) while the condition lasts.
+static const AlarmConfig microgravityAlarm = {
+    "Microgravity", ALARM_BELOW, 1.0f, 0.5f, MODE1_IMU_PERIOD_MS, false, 3000, microgravityAction
+};
+
+// Applies threshold changes to the alarm as soon as they are written.
+static void thresholdChanged(StateId id, uint32_t version, void* arg) {
+    (void)version;
+    (void)arg;
+    alarmSetThreshold(ALARM_MICROGRAVITY, stateGetFloat(id));
+}
+
+class Mode1 : public Mode {
+public:
+    Mode1() : Mode("Microgravity", 100) {}
+
+    void onEnter() override {
+        Serial.println("Beeping 1 times...");
+        buzzerAction(1);
+        setDisplayMode(TABLE_MODE);
+
+        if (!subscribed) {
+            subscribed = stateSubscribe(STATE_GRAVITY_ALARM_AT, thresholdChanged, NULL);
+        }
+        AlarmConfig config = microgravityAlarm;
+        config.threshold = stateGetFloat(STATE_GRAVITY_ALARM_AT);
+        alarmConfigure(ALARM_MICROGRAVITY, config);
+        alarmEnable(ALARM_MICROGRAVITY, true);
+        setIMUEffectivePeriod(MODE1_IMU_PERIOD_MS);
+        setIMUSampleHook(feedMicrogravity);
     }
-    
-    // Update the display with sensor and mode data.
-    updateTableData(std::array<TableEntry, 6>{
-        {
-            {"Mode", 1, ""},
-            {"Magnitude", magnitude, ""},
-            {"AccelX", imuData.accel.acceleration.x, "m/s^2"},
-            {"AccelY", imuData.accel.acceleration.y, "m/s^2"},
-            {"AccelZ", imuData.accel.acceleration.z, "m/s^2"},
-            {"gravityAlarmAt", gravityAlaramAt, ""}
+
+    void onExit() override {
+        setIMUSampleHook(NULL);
+        setIMUEffectivePeriod(IMU_DEFAULT_PERIOD_MS);
+        alarmEnable(ALARM_MICROGRAVITY, false);
+    }
+
+    void onTick() override {
+        // Retrieve the latest IMU data.
+        IMUEvents_t imuData = getIMUData();
+        
+        // Calculate the magnitude from the accelerometer readings.
+        // The alarm itself is evaluated on every IMU sample by the alarm engine.
+        float magnitude = accelMagnitude(imuData);
+        
+        // Update the display with sensor and mode data.
+        // The axes are shown from the sample the magnitude was taken from.
+        ChannelSnapshot snapshot(imuData);
+        char cells[6][TABLE_CELL_LEN];
+        formatTableEntry(cells[0], {TABLE_LABEL_MODE, 1, TABLE_UNIT_NONE});
+        formatTableEntry(cells[1], {TABLE_LABEL_MAGNITUDE, magnitude, TABLE_UNIT_NONE});
+        formatChannelCell(cells[2], CH_ACCEL_X, snapshot);
+        formatChannelCell(cells[3], CH_ACCEL_Y, snapshot);
+        formatChannelCell(cells[4], CH_ACCEL_Z, snapshot);
+        formatTableEntry(cells[5], {TABLE_LABEL_GRAVITY_ALARM_AT, stateGetFloat(STATE_GRAVITY_ALARM_AT), TABLE_UNIT_NONE});
+        const char* const lines[6] = {cells[0], cells[1], cells[2], cells[3], cells[4], cells[5]};
+        updateTableLines(lines, 6);
+    }
+
+    // LEFT / RIGHT lower / raise the alarm threshold, X silences the alarm.
+    // Steps outside the registry's range are rejected.
+    void onInput(ButtonEvent_t evt) override {
+        float threshold = stateGetFloat(STATE_GRAVITY_ALARM_AT);
+        if (evt == BUTTON_EVENT_TOUCH_LEFT) {
+            stateSetFloat(STATE_GRAVITY_ALARM_AT, threshold - 1);
+        } else if (evt == BUTTON_EVENT_TOUCH_RIGHT) {
+            stateSetFloat(STATE_GRAVITY_ALARM_AT, threshold + 1);
+        } else if (evt == BUTTON_EVENT_TOUCH_X) {
+            alarmAcknowledge(ALARM_MICROGRAVITY);
         }
-    }.data(), 6);
+    }
+
+private:
+    bool subscribed = false;
+};
+
+static Mode1 instance;
+
+Mode& mode1() {
+    return instance;
 }
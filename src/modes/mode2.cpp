@@ -2,34 +2,98 @@
 #include "modes/modegeneral.h"
 #include "modes/mode2.h"
 
-void runMode2() {
-    // Static variable to ensure the beep is triggered only once upon entering mode 2.
-    
-    if (previousMode != 2) {
-        Serial.println("Beeping 1 times...");
+// Alarm action: flash the red LEDs and meow.
+static void pressureAction(AlarmId id) {
+    (void)id;
+    ledController.blinkLED(7, 1, 400);
+    ledController.blinkLED(10, 1, 400);
+    ledController.blinkLED(13, 1, 400);
+    buzzerAction(1, false, true);
+}
+
+// Runs in the BME280 task for every sample.
+static void feedPressure(float temperature, float pressure, float humidity, uint32_t timestampMs) {
+    (void)temperature;
+    (void)humidity;
+    alarmFeed(ALARM_PRESSURE_DROP, pressure, timestampMs);
+}
+
+// Raised after 0.5 s below the threshold, released 0.5 hPa above it. Latching:
+// a cabin leak stays reported until acknowledged with X.
+static const AlarmConfig pressureAlarm = {
+    "PressureDrop", ALARM_BELOW, 0.0f, 0.5f, 500, true, 3000, pressureAction
+};
+
+static float pressureThreshold() {
+    return stateGetFloat(STATE_INIT_PRESSURE) - stateGetFloat(STATE_DELTA_PRESSURE);
+}
+
+// Applies reference or allowed-drop changes to the alarm as soon as they are written.
+static void thresholdChanged(StateId id, uint32_t version, void* arg) {
+    (void)id;
+    (void)version;
+    (void)arg;
+    alarmSetThreshold(ALARM_PRESSURE_DROP, pressureThreshold());
+}
+
+class Mode2 : public Mode {
+public:
+    Mode2() : Mode("Pressure", 100) {}
+
+    void onEnter() override {
+        Serial.println("Beeping 2 times...");
         buzzerAction(2);
-        previousMode = 2;
+        // Set display to TABLE_MODE.
+        setDisplayMode(TABLE_MODE);
+
+        if (!subscribed) {
+            subscribed = stateSubscribe(STATE_DELTA_PRESSURE, thresholdChanged, NULL) &&
+                         stateSubscribe(STATE_INIT_PRESSURE, thresholdChanged, NULL);
+        }
+        AlarmConfig config = pressureAlarm;
+        config.threshold = pressureThreshold();
+        alarmConfigure(ALARM_PRESSURE_DROP, config);
+        alarmEnable(ALARM_PRESSURE_DROP, true);
+        setBMESampleHook(feedPressure);
     }
 
-    // Set display to TABLE_MODE.
-    setDisplayMode(TABLE_MODE);
-
-    // Update the display with BME280 sensor data.
-    updateTableData(std::array<TableEntry, 5>{
-        {
-            {"Temp", getBMETemperature(), "°C"},
-            {"Humi", getBMEHumidity(), "%"},
-            {"Pres", getBMEPressure(), "hPa"},
-            {"initPres", initPressure, "hPa"},
-            {"thresholdPres", initPressure - deltaPressure, "hPa"}
+    void onExit() override {
+        setBMESampleHook(NULL);
+        alarmEnable(ALARM_PRESSURE_DROP, false);
+    }
+
+    void onTick() override {
+        // Update the display with BME280 sensor data.
+        ChannelSnapshot snapshot;
+        char cells[5][TABLE_CELL_LEN];
+        formatChannelCell(cells[0], CH_BME_TEMP, snapshot);
+        formatChannelCell(cells[1], CH_HUMI, snapshot);
+        formatChannelCell(cells[2], CH_PRES, snapshot);
+        formatTableEntry(cells[3], {TABLE_LABEL_INIT_PRES, stateGetFloat(STATE_INIT_PRESSURE), TABLE_UNIT_HPA});
+        formatTableEntry(cells[4], {TABLE_LABEL_THRESHOLD_PRES, pressureThreshold(), TABLE_UNIT_HPA});
+        const char* const lines[5] = {cells[0], cells[1], cells[2], cells[3], cells[4]};
+        updateTableLines(lines, 5);
+    }
+
+    // LEFT / RIGHT lower / raise the allowed pressure drop, X acknowledges the alarm.
+    // Steps outside the registry's range are rejected.
+    void onInput(ButtonEvent_t evt) override {
+        float delta = stateGetFloat(STATE_DELTA_PRESSURE);
+        if (evt == BUTTON_EVENT_TOUCH_LEFT) {
+            stateSetFloat(STATE_DELTA_PRESSURE, delta - 1);
+        } else if (evt == BUTTON_EVENT_TOUCH_RIGHT) {
+            stateSetFloat(STATE_DELTA_PRESSURE, delta + 1);
+        } else if (evt == BUTTON_EVENT_TOUCH_X) {
+            alarmAcknowledge(ALARM_PRESSURE_DROP);
         }
-    }.data(), 5);
-
-    // Check if the current pressure is below the threshold.
-    if (getBMEPressure() < initPressure - deltaPressure) {
-        ledController.blinkLED(7, 1, 400);
-        ledController.blinkLED(10, 1, 400);
-        ledController.blinkLED(13, 1, 400);
-        buzzerAction(1, false, true);
     }
+
+private:
+    bool subscribed = false;
+};
+
+static Mode2 instance;
+
+Mode& mode2() {
+    return instance;
 }
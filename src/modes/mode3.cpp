@@ -2,35 +2,51 @@
 #include "modes/modegeneral.h"
 #include "modes/mode3.h"
 
-void runMode3() {
-    // Static variable to ensure the beep is triggered only once upon entering mode 3.
-    
-    if (previousMode != 3) {
+// IMU sample period while the horizon is shown.
+#define MODE3_IMU_PERIOD_MS 20
+
+class Mode3 : public Mode {
+public:
+    // The horizon follows the attitude at 50 Hz.
+    Mode3() : Mode("Horizon", 20) {}
+
+    void onEnter() override {
         Serial.println("Beeping 3 times...");
         buzzerAction(3);
-        previousMode = 3;
+        setIMUEffectivePeriod(MODE3_IMU_PERIOD_MS);
+        // Set the display to ARTIFICIAL_HORIZON_MODE.
+        setDisplayMode(ARTIFICIAL_HORIZON_MODE);
     }
 
-    // Retrieve the latest IMU data.
-    IMUEvents_t data = getIMUData();
+    void onTick() override {
+        // Retrieve the latest IMU data.
+        IMUEvents_t data = getIMUData();
+
+        // Calculate angles in degrees.
+        float angleX = atan2(
+            data.accel.acceleration.x, 
+            sqrt(data.accel.acceleration.y * data.accel.acceleration.y + data.accel.acceleration.z * data.accel.acceleration.z)
+        ) * 180.0 / M_PI;  // pitch is angleX
 
-    // Calculate angles in degrees.
-    float angleX = atan2(
-        data.accel.acceleration.x, 
-        sqrt(data.accel.acceleration.y * data.accel.acceleration.y + data.accel.acceleration.z * data.accel.acceleration.z)
-    ) * 180.0 / M_PI;  // pitch is angleX
+        float angleY = atan2(
+            data.accel.acceleration.y, 
+            sqrt(data.accel.acceleration.x * data.accel.acceleration.x + data.accel.acceleration.z * data.accel.acceleration.z)
+        ) * 180.0 / M_PI;  // roll is angleY
 
-    float angleY = atan2(
-        data.accel.acceleration.y, 
-        sqrt(data.accel.acceleration.x * data.accel.acceleration.x + data.accel.acceleration.z * data.accel.acceleration.z)
-    ) * 180.0 / M_PI;  // roll is angleY
+        // Update horizon display data with the calculated pitch and roll values.
+        updateHorizonData(angleX, angleY);
 
-    // Set the display to ARTIFICIAL_HORIZON_MODE.
-    setDisplayMode(ARTIFICIAL_HORIZON_MODE);
+        // Optionally, you could print the angles for debugging:
+        // Serial.printf("Pitch: %.1f, Roll: %.1f\n", angleX, angleY);
+    }
+
+    void onExit() override {
+        setIMUEffectivePeriod(IMU_DEFAULT_PERIOD_MS);
+    }
+};
 
-    // Update horizon display data with the calculated pitch and roll values.
-    updateHorizonData(angleX, angleY);
+static Mode3 instance;
 
-    // Optionally, you could print the angles for debugging:
-    // Serial.printf("Pitch: %.1f, Roll: %.1f\n", angleX, angleY);
+Mode& mode3() {
+    return instance;
 }
@@ -2,46 +2,84 @@
 #include "modes/modegeneral.h"
 #include "modes/mode4.h"
 
-void runMode4() {
-    // Static variable to ensure the beep is triggered only once upon entering mode 4.
-    
-    if (previousMode != 4) {
+// Time between plotted samples, in seconds (matches the tick period).
+#define MODE4_SAMPLE_PERIOD_S 0.2f
+
+// Plot label length, as kept by the display.
+#define MODE4_LABEL_LEN 16
+
+// Candidate sources; STATE_ROLLING_PLOT 1-3 shows one of them, 4 and 5 show all.
+// Any channel of the channel table can be listed here.
+static const ChannelId plotChannels[3] = {CH_ACCEL_X, CH_HUMI, CH_IMU_TEMP};
+
+class Mode4 : public Mode {
+public:
+    Mode4() : Mode("Rolling plot", 200) {}
+
+    void onEnter() override {
         Serial.println("Beeping 4 times...");
         buzzerAction(4);
-        previousMode = 4;
+        // Set the display mode to ROLLING_PLOT_MODE.
+        setDisplayMode(ROLLING_PLOT_MODE);
+
+        for (int i = 0; i < 3; i++) {
+            formatChannelLabel(labelText[i], MODE4_LABEL_LEN, plotChannels[i]);
+        }
     }
-    
-    // Set the display mode to ROLLING_PLOT_MODE.
-    setDisplayMode(ROLLING_PLOT_MODE);
-    
-    // Local static time variable to keep track of the elapsed time for the rolling plot.
-    static float t = 0.0;
-    float value = 0.0;
-    
-    // Retrieve the latest IMU data.
-    IMUEvents_t data = getIMUData();
-    
-    // Update the rolling plot based on the current rollingPlotSwitch value.
-    switch (rollingPlotSwitch) {
-        case 1: {
-            value = data.accel.acceleration.x;
-            updateRollingPlotData(value, t, "Time (s)", "Acc X m/s^2");
-            break;
+
+    void onTick() override {
+        float values[3];
+        ChannelSnapshot snapshot;
+        for (int i = 0; i < 3; i++) {
+            values[i] = channelRead(plotChannels[i], snapshot);
         }
-        case 2: {
-            value = getBMEHumidity();
-            updateRollingPlotData(value, t, "Time (s)", "Humi %");
-            break;
+        
+        // Update the rolling plot based on the current STATE_ROLLING_PLOT value.
+        int source = stateGetInt(STATE_ROLLING_PLOT);
+        switch (source) {
+            case 1:
+            case 2:
+            case 3: {
+                updateRollingPlotData(values[source - 1], t, "Time (s)", labels[source - 1]);
+                break;
+            }
+            case ROLLING_PLOT_STACKED:
+            case ROLLING_PLOT_OVERLAY: {
+                configureRollingPlot(3, labels, "Time (s)",
+                                     source == ROLLING_PLOT_STACKED ? PLOT_STACKED : PLOT_OVERLAY);
+                updateRollingPlotSamples(values, t);
+                break;
+            }
+            default:
+                break;
         }
-        case 3: {
-            value = data.temp.temperature;
-            updateRollingPlotData(value, t, "Time (s)", "Temp C");
-            break;
+        
+        t += MODE4_SAMPLE_PERIOD_S;
+    }
+
+    // LEFT / RIGHT step through the plot sources.
+    void onInput(ButtonEvent_t evt) override {
+        int source = stateGetInt(STATE_ROLLING_PLOT);
+        if (evt == BUTTON_EVENT_TOUCH_LEFT) {
+            source = (source < 2) ? 1 : source - 1;
+            Serial.printf("Event: TOUCH_LEFT %d\n", source);
+        } else if (evt == BUTTON_EVENT_TOUCH_RIGHT) {
+            source = (source >= ROLLING_PLOT_SOURCES) ? 1 : source + 1;
+            Serial.printf("Event: TOUCH_RIGHT %d\n", source);
         }
-        default:
-            break;
+        stateSetInt(STATE_ROLLING_PLOT, source);
     }
-    
-    // Increase time; adjust the increment as needed.
-    t += 0.2;
+
+private:
+    // Elapsed time of the rolling plot, kept across visits so the time axis stays monotonic.
+    float t = 0.0;
+    // Plot labels of the sources, "<channel> <unit>".
+    char labelText[3][MODE4_LABEL_LEN];
+    const char* labels[3] = {labelText[0], labelText[1], labelText[2]};
+};
+
+static Mode4 instance;
+
+Mode& mode4() {
+    return instance;
 }
@@ -2,24 +2,36 @@
 #include "modes/modegeneral.h"
 #include "modes/mode5.h"
 
-void runMode5() {
-    // Static variable to ensure the beep is triggered only once upon entering mode 5.
-    
-    if (previousMode != 5) {
+class Mode5 : public Mode {
+public:
+    Mode5() : Mode("Telecommand", 100) {}
+
+    void onEnter() override {
         Serial.println("Beeping 5 times...");
         buzzerAction(5);
-        previousMode = 5;
-    }
-    
-    // Set the display mode to TABLE_MODE.
-    setDisplayMode(TABLE_MODE);
-    
-    // If tc is not empty, update the display with telemetry data.
-    if (tc != "") {
+        // Set the display mode to TABLE_MODE.
+        setDisplayMode(TABLE_MODE);
         updateTableData(std::array<TableEntry, 1>{
             {
-                {tc, (float)tcValue, tcHash}
+                {TABLE_LABEL_MODE, 5, TABLE_UNIT_NONE}
             }
         }.data(), 1);
     }
+
+    void onTick() override {
+        // If tc is not empty, update the display with telemetry data.
+        // The line is formatted into a stack buffer; no String temporaries are built.
+        if (tc[0] != '\0') {
+            char line[TABLE_CELL_LEN];
+            snprintf(line, sizeof(line), "%s %d %lX", tc, tcValue, (unsigned long)tcHash);
+            const char* lines[1] = {line};
+            updateTableLines(lines, 1);
+        }
+    }
+};
+
+static Mode5 instance;
+
+Mode& mode5() {
+    return instance;
 }
@@ -0,0 +1,96 @@
+// mode6.cpp
+#include "modes/modegeneral.h"
+#include "modes/mode6.h"
+#include "diagnostics/TaskProfiler.h"
+
+// Task lines that fit below the heap line.
+#define MODE6_TASK_LINES 5
+
+// Largest figures the fixed-width lines hold; larger ones are shown clamped.
+#define MODE6_MAX_KIB 9999u
+#define MODE6_MAX_STACK 99999u
+
+static unsigned clampFigure(uint32_t value, unsigned max) {
+    return value > max ? max : (unsigned)value;
+}
+
+// Marks a line snprintf() had to cut, instead of showing it cut silently.
+static void checkLine(char* line, int length) {
+    if (length < 0) {
+        line[0] = '\0';
+    } else if (length >= TABLE_CELL_LEN) {
+        line[TABLE_CELL_LEN - 2] = '>';
+    }
+}
+
+class Mode6 : public Mode {
+public:
+    // The profile is resampled once per telemetry period, so 1 Hz is enough.
+    Mode6() : Mode("Diagnostics", 1000) {}
+
+    void onEnter() override {
+        Serial.println("Beeping 6 times...");
+        buzzerAction(6);
+        setDisplayMode(TABLE_MODE);
+        firstTask = 0;
+    }
+
+    void onTick() override {
+        getTaskProfile(&snapshot);
+
+        char text[MODE6_TASK_LINES + 1][TABLE_CELL_LEN];
+        const char* lines[MODE6_TASK_LINES + 1];
+        int count = 0;
+
+        // "Heap 9999k max 9999k": 20 characters at most.
+        int length = snprintf(text[count], TABLE_CELL_LEN, "Heap %uk max %uk",
+                              clampFigure(snapshot.freeHeap / 1024, MODE6_MAX_KIB),
+                              clampFigure(snapshot.largestFreeBlock / 1024, MODE6_MAX_KIB));
+        checkLine(text[count], length);
+        lines[count] = text[count];
+        count++;
+
+        if (firstTask >= snapshot.taskCount) {
+            firstTask = 0;
+        }
+        for (int i = firstTask; i < snapshot.taskCount && count <= MODE6_TASK_LINES; i++) {
+            const TaskProfileEntry& task = snapshot.tasks[i];
+            // Name, CPU % and free stack bytes: 19 characters at most.
+            const unsigned stack = clampFigure(task.stackFreeBytes, MODE6_MAX_STACK);
+            if (snapshot.cpuAvailable) {
+                length = snprintf(text[count], TABLE_CELL_LEN, "%-9.9s%3u%% %5u", task.name,
+                                  clampFigure((task.cpuPermille + 5) / 10, 100), stack);
+            } else {
+                length = snprintf(text[count], TABLE_CELL_LEN, "%-9.9s  - %5u", task.name, stack);
+            }
+            checkLine(text[count], length);
+            lines[count] = text[count];
+            count++;
+        }
+        updateTableLines(lines, count);
+    }
+
+    // LEFT / RIGHT scroll through the task list.
+    void onInput(ButtonEvent_t evt) override {
+        if (evt == BUTTON_EVENT_TOUCH_LEFT) {
+            firstTask = (firstTask >= MODE6_TASK_LINES) ? firstTask - MODE6_TASK_LINES : 0;
+        } else if (evt == BUTTON_EVENT_TOUCH_RIGHT) {
+            if (firstTask + MODE6_TASK_LINES < snapshot.taskCount) {
+                firstTask += MODE6_TASK_LINES;
+            }
+        } else {
+            return;
+        }
+        onTick();
+    }
+
+private:
+    int firstTask = 0;
+    SystemProfile snapshot;   // kept here rather than on the mode task stack
+};
+
+static Mode6 instance;
+
+Mode& mode6() {
+    return instance;
+}
@@ -0,0 +1,149 @@
+// modegeneral.cpp
+#include "modes/modegeneral.h"
+#include "modes/mode1.h"
+#include "modes/mode2.h"
+#include "modes/mode3.h"
+#include "modes/mode4.h"
+#include "modes/mode5.h"
+#include "modes/mode6.h"
+#include "TaskTable.h"
+#include "diagnostics/Trace.h"
+#include "diagnostics/AllocCounter.h"
+#include "diagnostics/Latency.h"
+
+// Event delivered to the mode task.
+enum ModeEventType {
+  MODE_EVENT_SWITCH,   // STATE_CURRENT_MODE changed, switch before the next tick
+  MODE_EVENT_INPUT     // button event for the active mode
+};
+
+struct ModeEvent {
+  ModeEventType type;
+  ButtonEvent_t button;
+};
+
+#define MODE_EVENT_QUEUE_LEN 8
+
+static QueueHandle_t modeEventQueue = NULL;
+static StaticQueue_t modeEventQueueBuffer;
+static uint8_t modeEventQueueStorage[MODE_EVENT_QUEUE_LEN * sizeof(ModeEvent)];
+
+// -----------------------
+// Mode 0: idle
+// -----------------------
+// Only shows the mode number; ticks slowly since nothing changes.
+class IdleMode : public Mode {
+public:
+  IdleMode() : Mode("Idle", 1000) {}
+
+  void onEnter() override {
+    Serial.println("Beeping 0 times...");
+    setDisplayMode(TABLE_MODE);
+  }
+
+  void onTick() override {
+    updateTableData(std::array<TableEntry, 1>{
+      {
+        {TABLE_LABEL_MODE, 0, TABLE_UNIT_NONE}
+      }
+    }.data(), 1);
+  }
+};
+
+static IdleMode idleMode;
+
+// -----------------------
+// Registry
+// -----------------------
+static Mode* const modes[MODE_COUNT] = {
+  &idleMode, &mode1(), &mode2(), &mode3(), &mode4(), &mode5(), &mode6()
+};
+
+Mode* getMode(int index) {
+  if (index < 0 || index >= MODE_COUNT) {
+    return NULL;
+  }
+  return modes[index];
+}
+
+// -----------------------
+// Mode task
+// -----------------------
+// Runs the active mode: switches when STATE_CURRENT_MODE changes, ticks at the period the
+// mode declares and delivers input events in between. A mode switch or input wakes
+// the task immediately, so slow modes do not delay navigation.
+static void modeTask(void* pvParameters) {
+  (void) pvParameters; // Unused parameter
+  AllocSiteScope site(ALLOC_SITE_MODE);
+
+  int activeIndex = -1;
+  Mode* active = NULL;
+  TickType_t nextTick = xTaskGetTickCount();
+
+  for (;;) {
+    int requested = stateGetInt(STATE_CURRENT_MODE);
+    if (requested != activeIndex && getMode(requested) != NULL) {
+      if (active != NULL) {
+        active->onExit();
+      }
+      active = getMode(requested);
+      activeIndex = requested;
+      Serial.printf("Mode %d (%s)\n", activeIndex, active->name());
+      active->onEnter();
+      latencyEffectApplied();   // closes a pending SetMode telecommand
+      nextTick = xTaskGetTickCount();
+    }
+
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(now - nextTick) >= 0) {
+      active->onTick();
+      nextTick += pdMS_TO_TICKS(active->tickPeriodMs());
+      // After an overrun, restart the schedule instead of catching up in a burst.
+      now = xTaskGetTickCount();
+      if ((int32_t)(now - nextTick) > 0) {
+        nextTick = now;
+      }
+    }
+
+    TickType_t wait = ((int32_t)(nextTick - now) > 0) ? nextTick - now : 0;
+    ModeEvent evt;
+    if (xQueueReceive(modeEventQueue, &evt, wait) == pdTRUE && evt.type == MODE_EVENT_INPUT) {
+      // Delivered to the mode that was active when the event arrived.
+      if (stateGetInt(STATE_CURRENT_MODE) == activeIndex) {
+        active->onInput(evt.button);
+      }
+    }
+  }
+}
+
+// Wakes the mode task on every mode change, whoever wrote it.
+static void modeChanged(StateId id, uint32_t version, void* arg) {
+  (void) id;
+  (void) version;
+  (void) arg;
+  ModeEvent evt = {MODE_EVENT_SWITCH, BUTTON_EVENT_TOUCH_UP};
+  BaseType_t sent = xQueueSend(modeEventQueue, &evt, 0);
+  traceEvent(TRACE_QUEUE_SEND, TRACE_QUEUE_MODE, sent == pdTRUE);
+}
+
+void startModeTask() {
+  if (modeEventQueue != NULL) {
+    return;
+  }
+  modeEventQueue = xQueueCreateStatic(MODE_EVENT_QUEUE_LEN, sizeof(ModeEvent),
+                                      modeEventQueueStorage, &modeEventQueueBuffer);
+  stateSubscribe(STATE_CURRENT_MODE, modeChanged, NULL);
+  createTableTask(TASK_MODE, modeTask, NULL);
+}
+
+void requestMode(int index) {
+  stateSetInt(STATE_CURRENT_MODE, index);
+}
+
+void postModeInput(ButtonEvent_t evt) {
+  if (modeEventQueue != NULL) {
+    ModeEvent modeEvt = {MODE_EVENT_INPUT, evt};
+    BaseType_t sent = xQueueSend(modeEventQueue, &modeEvt, 0);
+    traceEvent(TRACE_QUEUE_SEND, TRACE_QUEUE_MODE, sent == pdTRUE);
+  }
+}
@@ -4,6 +4,10 @@
 #include <Wire.h>
 #include "FreeRTOS.h"
 #include "task.h"
+#include "TaskTable.h"
+#include "sensors/SensorSource.h"
+#include "diagnostics/Trace.h"
+#include <atomic>
 
 // -------------------------
 // Pin definitions for I2C
@@ -17,13 +21,39 @@
 // Global BME280 object
 static Adafruit_BME280 bme;
 
-// Measured values (updated by the task)
+// Measured values (updated by the task), written and read under sampleMux so a
+// reader sees one sample.
 static float temperature = 0.0f;
 static float pressure    = 0.0f;
 static float humidity    = 0.0f;
+static uint32_t sampleTimeMs = 0;
+static portMUX_TYPE sampleMux = portMUX_INITIALIZER_UNLOCKED;
 
-// Default measurement period: 500 ms
-static uint32_t measurementPeriodMs = 100;
+// Default measurement period (from the task table)
+static std::atomic<uint32_t> measurementPeriodMs(TASK_PERIOD_MS(TASK_BME280));
+
+// Called with every sample (e.g. alarm evaluation), NULL if unused.
+static std::atomic<BMESampleHook> sampleHook(NULL);
+
+// Store a sample for the getters and pass it to the recorder.
+static void storeSample(const EnvSample& sample, uint32_t now)
+{
+    portENTER_CRITICAL(&sampleMux);
+    temperature  = sample.temperature;
+    pressure     = sample.pressure;
+    humidity     = sample.humidity;
+    sampleTimeMs = now;
+    portEXIT_CRITICAL(&sampleMux);
+    sensorRecordEnv(sample, now);
+}
+
+static void runSampleHook(const EnvSample& sample, uint32_t now)
+{
+    BMESampleHook hook = sampleHook;
+    if (hook != NULL) {
+        hook(sample.temperature, sample.pressure, sample.humidity, now);
+    }
+}
 
 // -------------------------
 // BME280 Measurement Task
@@ -34,10 +64,25 @@ static void BME280Task(void *pvParameters)
 
     for (;;)
     {
-        // Read temperature (C), pressure (Pa -> hPa), humidity (%)
-        temperature = bme.readTemperature();           // °C
-        pressure    = bme.readPressure() / 100.0F;     // hPa
-        humidity    = bme.readHumidity();              // %
+        uint32_t now = millis();
+        traceEvent(TRACE_SENSOR_READ_BEGIN, TRACE_SENSOR_BME280);
+        EnvSample sample;
+        SensorSample source = sensorSourceEnv(now, &sample);
+        if (source == SENSOR_SAMPLE_LIVE) {
+            // Read temperature (C), pressure (Pa -> hPa), humidity (%)
+            sample.temperature = bme.readTemperature();        // °C
+            sample.pressure    = bme.readPressure() / 100.0F;  // hPa
+            sample.humidity    = bme.readHumidity();           // %
+        }
+        // No sample while the replay feeds them.
+        if (source != SENSOR_SAMPLE_NONE) {
+            storeSample(sample, now);
+        }
+        traceEvent(TRACE_SENSOR_READ_END, TRACE_SENSOR_BME280);
+
+        if (source != SENSOR_SAMPLE_NONE) {
+            runSampleHook(sample, now);
+        }
 
         // Delay for the configured measurement period
         vTaskDelay(pdMS_TO_TICKS(measurementPeriodMs));
@@ -76,7 +121,22 @@ void initBME280(void)
 
 void startBME280Task(void)
 {
-    xTaskCreate(BME280Task, "BME280Task", 2048, NULL, 1, NULL);
+    createTableTask(TASK_BME280, BME280Task, NULL);
+}
+
+void setBMESampleHook(BMESampleHook hook)
+{
+    sampleHook = hook;
+}
+
+void feedBMESample(float temp, float pres, float humi, uint32_t timestampMs)
+{
+    EnvSample sample;
+    sample.temperature = temp;
+    sample.pressure    = pres;
+    sample.humidity    = humi;
+    storeSample(sample, timestampMs);
+    runSampleHook(sample, timestampMs);
 }
 
 void setBMEPeriod(uint32_t periodMs)
@@ -86,15 +146,32 @@ void setBMEPeriod(uint32_t periodMs)
 
 float getBMETemperature(void)
 {
-    return temperature;
+    portENTER_CRITICAL(&sampleMux);
+    float value = temperature;
+    portEXIT_CRITICAL(&sampleMux);
+    return value;
 }
 
 float getBMEPressure(void)
 {
-    return pressure;
+    portENTER_CRITICAL(&sampleMux);
+    float value = pressure;
+    portEXIT_CRITICAL(&sampleMux);
+    return value;
 }
 
 float getBMEHumidity(void)
 {
-    return humidity;
+    portENTER_CRITICAL(&sampleMux);
+    float value = humidity;
+    portEXIT_CRITICAL(&sampleMux);
+    return value;
+}
+
+uint32_t getBMESampleTime(void)
+{
+    portENTER_CRITICAL(&sampleMux);
+    uint32_t timeMs = sampleTimeMs;
+    portEXIT_CRITICAL(&sampleMux);
+    return timeMs;
 }
@@ -1,5 +1,8 @@
 #include "sensors/IMU.h"
+#include "sensors/SensorSource.h"
+#include "diagnostics/Trace.h"
 #include <stdio.h>
+#include <atomic>
 
 // Create the LSM6DS object.
 Adafruit_LSM6DS lsm6ds = Adafruit_LSM6DS();
@@ -10,15 +13,22 @@ Adafruit_LSM6DS lsm6ds = Adafruit_LSM6DS();
 #define SPI_SCLK 12
 #define SPI_CS   10
 
-// Global variable to hold the latest sensor events.
+// Latest sensor events and their time, written and read as one under sampleMux.
 static IMUEvents_t imuEvents;
+static uint32_t sampleTimeMs = 0;
+static portMUX_TYPE sampleMux = portMUX_INITIALIZER_UNLOCKED;
 
 // Global variable for effective update period (default = 500 ms).
-static uint32_t effectivePeriodMs = 500;
+static std::atomic<uint32_t> effectivePeriodMs(IMU_DEFAULT_PERIOD_MS);
+// Period the IMU telemetry group is published at, 0 if not published.
+static std::atomic<uint32_t> telemetryPeriodMs(0);
 
 // Global task handle for the IMU update task.
 static TaskHandle_t imuTaskHandle = NULL;
 
+// Called with every sample (e.g. alarm evaluation), NULL if unused.
+static std::atomic<IMUSampleHook> sampleHook(NULL);
+
 // Initialize the IMU sensor.
 void initIMU(void)
 {
@@ -42,16 +52,102 @@ void initIMU(void)
   lsm6ds.setGyroDataRate(LSM6DS_RATE_26_HZ);           // 104 Hz.  LSM6DS_RATE_26_HZ
 }
 
-// Update the sensor data (read sensor events).
-static void updateIMU(void)
+// Sensor events of a replayed or synthetic sample.
+static IMUEvents_t eventsFromSample(const ImuSample& sample)
+{
+  IMUEvents_t events = {};
+  events.accel.acceleration.x = sample.accel[0];
+  events.accel.acceleration.y = sample.accel[1];
+  events.accel.acceleration.z = sample.accel[2];
+  events.gyro.gyro.x = sample.gyro[0];
+  events.gyro.gyro.y = sample.gyro[1];
+  events.gyro.gyro.z = sample.gyro[2];
+  events.temp.temperature = sample.temperature;
+  return events;
+}
+
+// Store a sample for the getters and pass it to the recorder.
+static void storeSample(const IMUEvents_t& events, const ImuSample& sample, uint32_t nowMs)
+{
+  portENTER_CRITICAL(&sampleMux);
+  imuEvents = events;
+  sampleTimeMs = nowMs;
+  portEXIT_CRITICAL(&sampleMux);
+  sensorRecordImu(sample, nowMs);
+}
+
+static void runSampleHook(const IMUEvents_t& events, uint32_t nowMs)
+{
+  IMUSampleHook hook = sampleHook;
+  if (hook != NULL)
+  {
+    hook(events, nowMs);
+  }
+}
+
+// Update the sensor data (read sensor events), or take them from the synthetic
+// source. Returns false, with no sample taken, while the replay feeds the samples.
+static bool updateIMU(uint32_t nowMs, IMUEvents_t* out)
+{
+  IMUEvents_t events;
+  ImuSample sample;
+  SensorSample source = sensorSourceImu(nowMs, &sample);
+  if (source == SENSOR_SAMPLE_NONE) {
+    return false;
+  }
+  if (source == SENSOR_SAMPLE_SYNTHETIC) {
+    events = eventsFromSample(sample);
+  } else {
+    lsm6ds.getEvent(&events.accel, &events.gyro, &events.temp);
+    sample.accel[0] = events.accel.acceleration.x;
+    sample.accel[1] = events.accel.acceleration.y;
+    sample.accel[2] = events.accel.acceleration.z;
+    sample.gyro[0] = events.gyro.gyro.x;
+    sample.gyro[1] = events.gyro.gyro.y;
+    sample.gyro[2] = events.gyro.gyro.z;
+    sample.temperature = events.temp.temperature;
+  }
+  storeSample(events, sample, nowMs);
+  *out = events;
+  return true;
+}
+
+// Take a replayed sample in place of the IMU task.
+void feedIMUSample(const ImuSample& sample, uint32_t timestampMs)
 {
-  lsm6ds.getEvent(&imuEvents.accel, &imuEvents.gyro, &imuEvents.temp);
+  IMUEvents_t events = eventsFromSample(sample);
+  storeSample(events, sample, timestampMs);
+  runSampleHook(events, timestampMs);
 }
 
 // Returns the latest IMU sensor events.
 IMUEvents_t getIMUData(void)
 {
-  return imuEvents;
+  portENTER_CRITICAL(&sampleMux);
+  IMUEvents_t events = imuEvents;
+  portEXIT_CRITICAL(&sampleMux);
+  return events;
+}
+
+// Set the period the IMU data is published at.
+void setIMUTelemetryPeriod(uint32_t periodMs)
+{
+  telemetryPeriodMs = periodMs;
+}
+
+// Returns the time of the latest sample.
+uint32_t getIMUSampleTime(void)
+{
+  portENTER_CRITICAL(&sampleMux);
+  uint32_t timeMs = sampleTimeMs;
+  portEXIT_CRITICAL(&sampleMux);
+  return timeMs;
+}
+
+// Install the per-sample hook.
+void setIMUSampleHook(IMUSampleHook hook)
+{
+  sampleHook = hook;
 }
 
 // Change the effective update period.
@@ -59,7 +155,7 @@ void setIMUEffectivePeriod(uint32_t periodMs)
 {
   effectivePeriodMs = periodMs;
   Serial.print("IMU effective period set to: ");
-  Serial.print(effectivePeriodMs);
+  Serial.print(periodMs);
   Serial.println(" ms");
 }
 
@@ -71,15 +167,30 @@ static void IMUTask(void *pvParameters)
   
   for(;;)
   {
-    updateIMU();
-    vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(effectivePeriodMs));
+    uint32_t now = millis();
+    traceEvent(TRACE_SENSOR_READ_BEGIN, TRACE_SENSOR_IMU);
+    IMUEvents_t events;
+    bool sampled = updateIMU(now, &events);
+    traceEvent(TRACE_SENSOR_READ_END, TRACE_SENSOR_IMU);
+    if (sampled)
+    {
+      runSampleHook(events, now);
+    }
+    // Sample at least as fast as the IMU telemetry is published.
+    uint32_t periodMs = effectivePeriodMs;
+    uint32_t telemetryMs = telemetryPeriodMs;
+    if (telemetryMs != 0 && telemetryMs < periodMs)
+    {
+      periodMs = telemetryMs;
+    }
+    vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(periodMs));
   }
 }
 
 // Start the IMU update task.
 void startIMUTask(void)
 {
-  xTaskCreate(IMUTask, "IMUTask", 2048, NULL, 1, &imuTaskHandle);
+  imuTaskHandle = createTableTask(TASK_IMU, IMUTask, NULL);
 }
 
 // Suspend (stop) the IMU update task.
@@ -0,0 +1,137 @@
+#include "sensors/SensorLog.h"
+#include <math.h>
+
+// Fixed-point scales of the recording format.
+#define ACCEL_SCALE 100.0f     // 0.01 m/s^2
+#define GYRO_SCALE  1000.0f    // 1 mrad/s
+#define TEMP_SCALE  100.0f     // 0.01 C
+#define PRES_SCALE  100.0f     // hPa -> Pa
+#define HUMI_SCALE  100.0f     // 0.01 %
+#define VOLT_SCALE  1000.0f    // mV
+
+static void put16(uint8_t*& p, uint16_t v) {
+  *p++ = v & 0xFF;
+  *p++ = v >> 8;
+}
+
+static void put32(uint8_t*& p, uint32_t v) {
+  put16(p, v & 0xFFFF);
+  put16(p, v >> 16);
+}
+
+static uint16_t get16(const uint8_t*& p) {
+  uint16_t v = p[0] | (p[1] << 8);
+  p += 2;
+  return v;
+}
+
+static uint32_t get32(const uint8_t*& p) {
+  uint32_t lo = get16(p);
+  return lo | ((uint32_t)get16(p) << 16);
+}
+
+// Rounds and saturates to the field range.
+static int16_t toInt16(float value, float scale) {
+  float v = roundf(value * scale);
+  if (!(v > -32768.0f)) return -32768;   // also NaN
+  if (v > 32767.0f) return 32767;
+  return (int16_t)v;
+}
+
+static uint16_t toUInt16(float value, float scale) {
+  float v = roundf(value * scale);
+  if (!(v > 0.0f)) return 0;
+  if (v > 65535.0f) return 65535;
+  return (uint16_t)v;
+}
+
+static uint32_t toUInt32(float value, float scale) {
+  float v = roundf(value * scale);
+  if (!(v > 0.0f)) return 0;
+  if (v > 4294967040.0f) return 4294967040u;
+  return (uint32_t)v;
+}
+
+static size_t payloadLength(uint8_t type) {
+  switch (type) {
+    case SENSOR_REC_IMU:   return 14;
+    case SENSOR_REC_ENV:   return 8;
+    case SENSOR_REC_POWER: return 4;
+  }
+  return 0;
+}
+
+size_t sensorLogEncode(const SensorRecord& rec, uint32_t* lastMs, uint8_t* out) {
+  if (payloadLength(rec.type) == 0) {
+    return 0;
+  }
+  uint8_t* p = out;
+  uint32_t delta = rec.timestampMs - *lastMs;
+  if (delta > 0xFFFF) {
+    *p++ = SENSOR_REC_TIME;
+    put32(p, rec.timestampMs);
+    delta = 0;
+  }
+  *lastMs = rec.timestampMs;
+
+  *p++ = rec.type;
+  put16(p, (uint16_t)delta);
+  switch (rec.type) {
+    case SENSOR_REC_IMU:
+      for (int i = 0; i < 3; i++) put16(p, (uint16_t)toInt16(rec.imu.accel[i], ACCEL_SCALE));
+      for (int i = 0; i < 3; i++) put16(p, (uint16_t)toInt16(rec.imu.gyro[i], GYRO_SCALE));
+      put16(p, (uint16_t)toInt16(rec.imu.temperature, TEMP_SCALE));
+      break;
+    case SENSOR_REC_ENV:
+      put16(p, (uint16_t)toInt16(rec.env.temperature, TEMP_SCALE));
+      put32(p, toUInt32(rec.env.pressure, PRES_SCALE));
+      put16(p, toUInt16(rec.env.humidity, HUMI_SCALE));
+      break;
+    case SENSOR_REC_POWER:
+      put16(p, toUInt16(rec.power.vbat, VOLT_SCALE));
+      put16(p, toUInt16(rec.power.usb, VOLT_SCALE));
+      break;
+    default:
+      break;
+  }
+  return p - out;
+}
+
+size_t sensorLogDecode(const uint8_t* in, size_t length, uint32_t* lastMs, SensorRecord* rec) {
+  if (length < 1) {
+    return 0;
+  }
+  const uint8_t* p = in;
+  uint8_t type = *p++;
+  if (type == SENSOR_REC_TIME) {
+    if (length < 5) return 0;
+    *lastMs = get32(p);
+    rec->type = SENSOR_REC_TIME;
+    rec->timestampMs = *lastMs;
+    return p - in;
+  }
+  size_t payload = payloadLength(type);
+  if (payload == 0 || length < 3 + payload) {
+    return 0;
+  }
+  *lastMs += get16(p);
+  rec->type = (SensorRecordType)type;
+  rec->timestampMs = *lastMs;
+  switch (type) {
+    case SENSOR_REC_IMU:
+      for (int i = 0; i < 3; i++) rec->imu.accel[i] = (int16_t)get16(p) / ACCEL_SCALE;
+      for (int i = 0; i < 3; i++) rec->imu.gyro[i] = (int16_t)get16(p) / GYRO_SCALE;
+      rec->imu.temperature = (int16_t)get16(p) / TEMP_SCALE;
+      break;
+    case SENSOR_REC_ENV:
+      rec->env.temperature = (int16_t)get16(p) / TEMP_SCALE;
+      rec->env.pressure = get32(p) / PRES_SCALE;
+      rec->env.humidity = get16(p) / HUMI_SCALE;
+      break;
+    case SENSOR_REC_POWER:
+      rec->power.vbat = get16(p) / VOLT_SCALE;
+      rec->power.usb = get16(p) / VOLT_SCALE;
+      break;
+  }
+  return p - in;
+}
@@ -0,0 +1,359 @@
+#include "sensors/SensorSource.h"
+#include <SPIFFS.h>
+#include <FS.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "TaskTable.h"
+#include "diagnostics/Trace.h"
+#include "diagnostics/AllocCounter.h"
+#include "sensors/IMU.h"
+#include "sensors/BME280Measurement.h"
+#include "sensors/VoltageMeasurement.h"
+#include <atomic>
+
+// Samples waiting to be written; a full queue drops samples (counted).
+#define SENSOR_RECORD_QUEUE_LEN 32
+#define SENSOR_CONTROL_QUEUE_LEN 4
+
+// File I/O is done in chunks of this size.
+#define SENSOR_LOG_CHUNK 512
+
+// Longest wait of the task, so control commands are seen quickly.
+#define SENSOR_LOG_POLL_MS 50
+
+enum SensorLogOp : uint8_t {
+  SENSOR_LOG_RECORD,       // arg = duration in ms, 0 = stop
+  SENSOR_LOG_REPLAY
+};
+
+struct SensorLogCommand {
+  SensorLogOp op;
+  uint32_t arg;
+};
+
+static QueueHandle_t recordQueue = NULL;
+static StaticQueue_t recordQueueBuffer;
+static uint8_t recordQueueStorage[SENSOR_RECORD_QUEUE_LEN * sizeof(SensorRecord)];
+
+static QueueHandle_t controlQueue = NULL;
+static StaticQueue_t controlQueueBuffer;
+static uint8_t controlQueueStorage[SENSOR_CONTROL_QUEUE_LEN * sizeof(SensorLogCommand)];
+
+static std::atomic<SensorSourceMode> sourceMode(SENSOR_SOURCE_LIVE);
+static std::atomic<bool> recording(false);
+static std::atomic<uint32_t> recordDropped(0);
+
+// Generator of the synthetic source. sensorSynthStart() restarts it from the inbound
+// task while the sensor tasks draw samples, so both sides hold synthMux.
+static SynthGenerator synth;
+static portMUX_TYPE synthMux = portMUX_INITIALIZER_UNLOCKED;
+
+//--------------------------------------------------
+// Sensor task side
+//--------------------------------------------------
+template <typename Sample>
+static SensorSample sourceSample(void (*generate)(SynthGenerator*, uint64_t, Sample*),
+                                 uint32_t nowMs, Sample* out) {
+  SensorSourceMode mode = sourceMode;
+  if (mode == SENSOR_SOURCE_SYNTHETIC) {
+    portENTER_CRITICAL(&synthMux);
+    generate(&synth, (uint64_t)nowMs * 1000, out);
+    portEXIT_CRITICAL(&synthMux);
+    return SENSOR_SAMPLE_SYNTHETIC;
+  }
+  return (mode == SENSOR_SOURCE_REPLAY) ? SENSOR_SAMPLE_NONE : SENSOR_SAMPLE_LIVE;
+}
+
+SensorSample sensorSourceImu(uint32_t nowMs, ImuSample* out) {
+  return sourceSample(synthImu, nowMs, out);
+}
+
+SensorSample sensorSourceEnv(uint32_t nowMs, EnvSample* out) {
+  return sourceSample(synthEnv, nowMs, out);
+}
+
+SensorSample sensorSourcePower(uint32_t nowMs, PowerSample* out) {
+  return sourceSample(synthPower, nowMs, out);
+}
+
+void sensorFeedRecord(const SensorRecord& rec) {
+  switch (rec.type) {
+    case SENSOR_REC_IMU:
+      feedIMUSample(rec.imu, rec.timestampMs);
+      break;
+    case SENSOR_REC_ENV:
+      feedBMESample(rec.env.temperature, rec.env.pressure, rec.env.humidity, rec.timestampMs);
+      break;
+    case SENSOR_REC_POWER:
+      feedVoltageSample(rec.power.vbat, rec.power.usb, rec.timestampMs);
+      break;
+    default:
+      break;
+  }
+}
+
+static void queueRecord(const SensorRecord& rec) {
+  if (!recording) {
+    return;
+  }
+  bool sent = xQueueSend(recordQueue, &rec, 0) == pdTRUE;
+  traceEvent(TRACE_QUEUE_SEND, TRACE_QUEUE_SENSOR_LOG, sent);
+  if (!sent) {
+    recordDropped.fetch_add(1);
+  }
+}
+
+void sensorRecordImu(const ImuSample& sample, uint32_t timestampMs) {
+  SensorRecord rec;
+  rec.type = SENSOR_REC_IMU;
+  rec.timestampMs = timestampMs;
+  rec.imu = sample;
+  queueRecord(rec);
+}
+
+void sensorRecordEnv(const EnvSample& sample, uint32_t timestampMs) {
+  SensorRecord rec;
+  rec.type = SENSOR_REC_ENV;
+  rec.timestampMs = timestampMs;
+  rec.env = sample;
+  queueRecord(rec);
+}
+
+void sensorRecordPower(const PowerSample& sample, uint32_t timestampMs) {
+  SensorRecord rec;
+  rec.type = SENSOR_REC_POWER;
+  rec.timestampMs = timestampMs;
+  rec.power = sample;
+  queueRecord(rec);
+}
+
+//--------------------------------------------------
+// Recorder / replay task
+//--------------------------------------------------
+static File logFile;
+static uint8_t chunk[SENSOR_LOG_CHUNK];
+static size_t chunkUsed = 0;
+static size_t chunkPos = 0;    // replay: next record in the chunk
+static size_t fileBytes = 0;
+
+static void flushChunk() {
+  if (chunkUsed > 0) {
+    logFile.write(chunk, chunkUsed);
+    fileBytes += chunkUsed;
+    chunkUsed = 0;
+  }
+}
+
+static void stopRecording() {
+  if (!recording) {
+    return;
+  }
+  recording = false;
+  // Samples queued before the flag dropped are discarded with the queue.
+  xQueueReset(recordQueue);
+  flushChunk();
+  logFile.close();
+  Serial.printf("Sensor recording stopped: %u bytes, %u samples dropped\n",
+                (unsigned)fileBytes, (unsigned)recordDropped.load());
+}
+
+static bool startRecording() {
+  logFile = SPIFFS.open(SENSOR_LOG_FILENAME, "w");
+  if (!logFile) {
+    Serial.println("Failed to open sensor log for writing");
+    return false;
+  }
+  logFile.write((const uint8_t*)SENSOR_LOG_MAGIC, SENSOR_LOG_MAGIC_LEN);
+  fileBytes = SENSOR_LOG_MAGIC_LEN;
+  chunkUsed = 0;
+  recordDropped = 0;
+  xQueueReset(recordQueue);
+  recording = true;
+  return true;
+}
+
+static void stopReplay() {
+  // Back to live unless a synthetic scenario took over meanwhile.
+  SensorSourceMode expected = SENSOR_SOURCE_REPLAY;
+  sourceMode.compare_exchange_strong(expected, SENSOR_SOURCE_LIVE);
+  logFile.close();
+  Serial.println("Sensor replay finished");
+}
+
+static bool startReplay() {
+  logFile = SPIFFS.open(SENSOR_LOG_FILENAME, "r");
+  uint8_t magic[SENSOR_LOG_MAGIC_LEN];
+  if (!logFile || logFile.read(magic, sizeof(magic)) != sizeof(magic) ||
+      memcmp(magic, SENSOR_LOG_MAGIC, sizeof(magic)) != 0) {
+    Serial.println("No sensor recording to replay");
+    logFile.close();
+    return false;
+  }
+  chunkUsed = 0;
+  chunkPos = 0;
+  // The sensor tasks stop sampling; the recorded samples are fed in their place.
+  sourceMode = SENSOR_SOURCE_REPLAY;
+  return true;
+}
+
+// Reads the next sample record of the replay; false at the end of the recording.
+static bool nextReplayRecord(uint32_t* lastMs, SensorRecord* rec) {
+  for (;;) {
+    size_t used = sensorLogDecode(chunk + chunkPos, chunkUsed - chunkPos, lastMs, rec);
+    if (used > 0) {
+      chunkPos += used;
+      if (rec->type != SENSOR_REC_TIME) {
+        return true;
+      }
+      continue;
+    }
+    // Incomplete record: keep the tail and refill the chunk.
+    size_t tail = chunkUsed - chunkPos;
+    memmove(chunk, chunk + chunkPos, tail);
+    chunkPos = 0;
+    size_t got = logFile.read(chunk + tail, sizeof(chunk) - tail);
+    chunkUsed = tail + got;
+    if (got == 0) {
+      return false;
+    }
+  }
+}
+
+// Owns the log file: writes queued samples while recording, or plays the recording
+// back at its original pace, feeding every record in order. Idle otherwise.
+static void sensorLogTask(void* pvParameters) {
+  (void) pvParameters; // Unused parameter
+  AllocSiteScope site(ALLOC_SITE_SENSOR_LOG);
+
+  uint32_t recordEndMs = 0;
+  uint32_t encodeLastMs = 0;
+  bool replaying = false;
+  bool haveReplayRecord = false;
+  uint32_t replayLastMs = 0;
+  uint32_t replayFirstMs = 0;
+  uint32_t replayStartMs = 0;
+  SensorRecord replayRec;
+
+  for (;;) {
+    // How long to wait for a command: forever when idle, briefly while busy.
+    TickType_t wait = portMAX_DELAY;
+    if (recording) {
+      wait = 0;
+    } else if (replaying) {
+      int32_t due = (int32_t)(replayStartMs + (replayRec.timestampMs - replayFirstMs) - millis());
+      wait = pdMS_TO_TICKS(due <= 0 ? 0 : (due < SENSOR_LOG_POLL_MS ? due : SENSOR_LOG_POLL_MS));
+    }
+
+    SensorLogCommand cmd;
+    if (xQueueReceive(controlQueue, &cmd, wait) == pdTRUE) {
+      if (cmd.op == SENSOR_LOG_RECORD) {
+        stopRecording();
+        if (replaying) {
+          stopReplay();
+          replaying = false;
+        }
+        if (cmd.arg > 0 && startRecording()) {
+          recordEndMs = millis() + cmd.arg;
+          encodeLastMs = millis();
+          Serial.printf("Sensor recording for %u ms\n", (unsigned)cmd.arg);
+        }
+      } else if (cmd.op == SENSOR_LOG_REPLAY) {
+        stopRecording();
+        if (replaying) {
+          stopReplay();
+        }
+        replaying = startReplay();
+        replayLastMs = 0;
+        haveReplayRecord = replaying && nextReplayRecord(&replayLastMs, &replayRec);
+        replayFirstMs = replayRec.timestampMs;
+        replayStartMs = millis();
+        if (replaying && !haveReplayRecord) {
+          stopReplay();
+          replaying = false;
+        }
+      }
+      continue;
+    }
+
+    if (recording) {
+      SensorRecord rec;
+      if (xQueueReceive(recordQueue, &rec, pdMS_TO_TICKS(SENSOR_LOG_POLL_MS)) == pdTRUE) {
+        if (chunkUsed + SENSOR_LOG_MAX_RECORD > sizeof(chunk)) {
+          flushChunk();
+        }
+        chunkUsed += sensorLogEncode(rec, &encodeLastMs, chunk + chunkUsed);
+      }
+      if ((int32_t)(millis() - recordEndMs) >= 0 || fileBytes + chunkUsed >= SENSOR_LOG_MAX_BYTES) {
+        stopRecording();
+      }
+    } else if (replaying) {
+      // Feed every record that is due, then wait for the next one. The samples carry
+      // their recorded spacing, so the hooks see the same times however late they run.
+      while (haveReplayRecord && sourceMode == SENSOR_SOURCE_REPLAY) {
+        uint32_t dueMs = replayStartMs + (replayRec.timestampMs - replayFirstMs);
+        if ((int32_t)(millis() - dueMs) < 0) {
+          break;
+        }
+        replayRec.timestampMs = dueMs;
+        sensorFeedRecord(replayRec);
+        haveReplayRecord = nextReplayRecord(&replayLastMs, &replayRec);
+      }
+      // Ends with the recording, or when a synthetic scenario took over.
+      if (!haveReplayRecord || sourceMode != SENSOR_SOURCE_REPLAY) {
+        stopReplay();
+        replaying = false;
+      }
+    }
+  }
+}
+
+//--------------------------------------------------
+// Public functions
+//--------------------------------------------------
+void initSensorSource(void) {
+  if (controlQueue != NULL) {
+    return;
+  }
+  recordQueue = xQueueCreateStatic(SENSOR_RECORD_QUEUE_LEN, sizeof(SensorRecord),
+                                   recordQueueStorage, &recordQueueBuffer);
+  controlQueue = xQueueCreateStatic(SENSOR_CONTROL_QUEUE_LEN, sizeof(SensorLogCommand),
+                                    controlQueueStorage, &controlQueueBuffer);
+  createTableTask(TASK_SENSOR_LOG, sensorLogTask, NULL);
+}
+
+bool sensorRecordStart(uint32_t durationS) {
+  if (controlQueue == NULL) {
+    return false;
+  }
+  SensorLogCommand cmd = {SENSOR_LOG_RECORD, durationS * 1000};
+  return xQueueSend(controlQueue, &cmd, 0) == pdTRUE;
+}
+
+bool sensorReplayStart(void) {
+  if (controlQueue == NULL) {
+    return false;
+  }
+  SensorLogCommand cmd = {SENSOR_LOG_REPLAY, 0};
+  return xQueueSend(controlQueue, &cmd, 0) == pdTRUE;
+}
+
+bool sensorSynthStart(SynthScenario scenario) {
+  if (scenario >= SYNTH_SCENARIO_COUNT) {
+    return false;
+  }
+  // A running replay sees the mode change and stops.
+  uint64_t nowUs = (uint64_t)millis() * 1000;
+  portENTER_CRITICAL(&synthMux);
+  if (scenario != SYNTH_OFF) {
+    // Seeded with the scenario number, so every run of a scenario is identical.
+    synthStart(&synth, scenario, nowUs, scenario);
+  }
+  sourceMode = (scenario != SYNTH_OFF) ? SENSOR_SOURCE_SYNTHETIC : SENSOR_SOURCE_LIVE;
+  portEXIT_CRITICAL(&synthMux);
+  return true;
+}
+
+SensorSourceMode getSensorSourceMode(void) {
+  return sourceMode;
+}
@@ -0,0 +1,106 @@
+#include "sensors/SignalGenerator.h"
+#include <math.h>
+
+// Board at rest, as seen by the sensors.
+#define REST_GRAVITY   9.81f
+#define REST_IMU_TEMP  30.0f
+#define REST_TEMP      22.0f
+#define REST_PRESSURE  1013.25f
+#define REST_HUMIDITY  40.0f
+#define REST_VBAT      3.90f
+#define REST_USB       5.00f
+
+#define TWO_PI_F 6.2831853f
+
+// Vibration frequency. Not a multiple of half the IMU sample rates (2 Hz by default,
+// 25 Hz in mode 1), so the sensor task periods see a slow beat instead of a constant.
+#define VIBRATION_HZ 23.3
+
+enum SynthChannel { CH_IMU, CH_ENV, CH_POWER };
+
+// xorshift32; never returns to 0 from a non-zero state.
+static uint32_t nextRandom(uint32_t& state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// Approximately normal noise (sum of four uniforms), scaled to the given deviation.
+static float noise(uint32_t& state, float sigma) {
+  float sum = 0.0f;
+  for (int i = 0; i < 4; i++) {
+    sum += (nextRandom(state) >> 8) * (1.0f / 16777216.0f);
+  }
+  // Sum of 4 U(0,1): mean 2, variance 1/3.
+  return (sum - 2.0f) * 1.7320508f * sigma;
+}
+
+void synthStart(SynthGenerator* gen, SynthScenario scenario, uint64_t startUs, uint32_t seed) {
+  gen->scenario = scenario;
+  gen->startUs = startUs;
+  for (int i = 0; i < 3; i++) {
+    gen->rng[i] = (seed + 0x9E3779B9u * (i + 1)) | 1;
+  }
+}
+
+void synthImu(SynthGenerator* gen, uint64_t nowUs, ImuSample* out) {
+  uint32_t& rng = gen->rng[CH_IMU];
+  uint64_t elapsedUs = nowUs - gen->startUs;
+  float sigmaAccel = (gen->scenario == SYNTH_NOISE) ? 0.8f : 0.03f;
+  float sigmaGyro = (gen->scenario == SYNTH_NOISE) ? 0.2f : 0.005f;
+
+  float accel[3] = {0.0f, 0.0f, REST_GRAVITY};
+  float gyro[3] = {0.0f, 0.0f, 0.0f};
+  switch (gen->scenario) {
+    case SYNTH_FREE_FALL: {
+      uint32_t phaseMs = (uint32_t)((elapsedUs / 1000) % 5000);
+      if (phaseMs >= 2000 && phaseMs < 3000) {
+        accel[2] = 0.0f;                       // falling
+      } else if (phaseMs >= 3000 && phaseMs < 3050) {
+        accel[2] = 4.0f * REST_GRAVITY;        // impact
+      }
+      break;
+    }
+    case SYNTH_VIBRATION: {
+      // Phase from the elapsed cycles in double, so it stays exact over hours.
+      double cycles = elapsedUs * (VIBRATION_HZ / 1e6);
+      float phase = TWO_PI_F * (float)(cycles - floor(cycles));
+      float s = sinf(phase);
+      accel[0] += 1.0f * s;
+      accel[2] += 3.0f * s;
+      gyro[1] = 0.2f * cosf(phase);
+      break;
+    }
+    default:
+      break;
+  }
+  for (int i = 0; i < 3; i++) {
+    out->accel[i] = accel[i] + noise(rng, sigmaAccel);
+    out->gyro[i] = gyro[i] + noise(rng, sigmaGyro);
+  }
+  out->temperature = REST_IMU_TEMP + noise(rng, 0.05f);
+}
+
+void synthEnv(SynthGenerator* gen, uint64_t nowUs, EnvSample* out) {
+  uint32_t& rng = gen->rng[CH_ENV];
+  float t = (nowUs - gen->startUs) / 1e6f;
+  bool strong = gen->scenario == SYNTH_NOISE;
+
+  float pressure = REST_PRESSURE;
+  if (gen->scenario == SYNTH_PRESSURE_LEAK && t > 2.0f) {
+    float drop = 2.0f * (t - 2.0f);
+    pressure -= (drop < 30.0f) ? drop : 30.0f;
+  }
+  out->temperature = REST_TEMP + noise(rng, strong ? 0.5f : 0.02f);
+  out->pressure = pressure + noise(rng, strong ? 0.5f : 0.02f);
+  out->humidity = REST_HUMIDITY + noise(rng, strong ? 2.0f : 0.1f);
+}
+
+void synthPower(SynthGenerator* gen, uint64_t nowUs, PowerSample* out) {
+  (void)nowUs;
+  uint32_t& rng = gen->rng[CH_POWER];
+  bool strong = gen->scenario == SYNTH_NOISE;
+  out->vbat = REST_VBAT + noise(rng, strong ? 0.1f : 0.005f);
+  out->usb = REST_USB + noise(rng, strong ? 0.2f : 0.01f);
+}
@@ -2,6 +2,9 @@
 #include <Arduino.h>
 #include "FreeRTOS.h"
 #include "task.h"
+#include "TaskTable.h"
+#include "sensors/SensorSource.h"
+#include "diagnostics/Trace.h"
 
 // -------------------
 // Pin Definitions
@@ -20,9 +23,23 @@
 #define VBAT_DIVIDER_RATIO 4.133f
 #define USB_DIVIDER_RATIO  1.468f
 
-// We'll store the measured voltages in these static variables.
+// We'll store the measured voltages in these static variables, written and read
+// under sampleMux.
 static float vbatVoltage = 0.0f;
 static float usbVoltage  = 0.0f;
+static uint32_t sampleTimeMs = 0;
+static portMUX_TYPE sampleMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Store a sample for the getters and pass it to the recorder.
+static void storeSample(const PowerSample& sample, uint32_t now)
+{
+    portENTER_CRITICAL(&sampleMux);
+    vbatVoltage  = sample.vbat;
+    usbVoltage   = sample.usb;
+    sampleTimeMs = now;
+    portEXIT_CRITICAL(&sampleMux);
+    sensorRecordPower(sample, now);
+}
 
 // -------------------
 // FreeRTOS Task
@@ -33,18 +50,29 @@ static void VoltageTask(void *pvParameters)
 
     for (;;)
     {
-        // Read raw ADC values
-        uint16_t vbatRaw = analogRead(VBAT_PIN);
-        uint16_t usbRaw  = analogRead(USB_PIN);
-
-        // Convert raw ADC values to voltage
-        // Using the maximum voltage for each attenuation level.
-        // (The Arduino core accounts for internal reference scaling.)
-        vbatVoltage = (vbatRaw / 4095.0f) * ADC_2_5db_MAX * VBAT_DIVIDER_RATIO;
-        usbVoltage  = (usbRaw  / 4095.0f) * ADC_11db_MAX  * USB_DIVIDER_RATIO;
-
-        // Delay for ~1 second
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        uint32_t now = millis();
+        traceEvent(TRACE_SENSOR_READ_BEGIN, TRACE_SENSOR_VOLTAGE);
+        PowerSample sample;
+        SensorSample source = sensorSourcePower(now, &sample);
+        if (source == SENSOR_SAMPLE_LIVE) {
+            // Read raw ADC values
+            uint16_t vbatRaw = analogRead(VBAT_PIN);
+            uint16_t usbRaw  = analogRead(USB_PIN);
+
+            // Convert raw ADC values to voltage
+            // Using the maximum voltage for each attenuation level.
+            // (The Arduino core accounts for internal reference scaling.)
+            sample.vbat = (vbatRaw / 4095.0f) * ADC_2_5db_MAX * VBAT_DIVIDER_RATIO;
+            sample.usb  = (usbRaw  / 4095.0f) * ADC_11db_MAX  * USB_DIVIDER_RATIO;
+        }
+        // No sample while the replay feeds them.
+        if (source != SENSOR_SAMPLE_NONE) {
+            storeSample(sample, now);
+        }
+        traceEvent(TRACE_SENSOR_READ_END, TRACE_SENSOR_VOLTAGE);
+
+        // Delay for the task period (~1 second)
+        vTaskDelay(pdMS_TO_TICKS(TASK_PERIOD_MS(TASK_VOLTAGE)));
     }
 }
 
@@ -61,20 +89,44 @@ void initVoltageMeasurement(void)
     analogSetPinAttenuation(USB_PIN, ADC_11db);
 }
 
+// Take a sample in place of the voltage task.
+void feedVoltageSample(float vbat, float usb, uint32_t timestampMs)
+{
+    PowerSample sample;
+    sample.vbat = vbat;
+    sample.usb  = usb;
+    storeSample(sample, timestampMs);
+}
+
 // Start the task that updates voltages every second.
 void startVoltageMeasurementTask(void)
 {
-    xTaskCreate(VoltageTask, "VoltageTask", 2048, NULL, 1, NULL);
+    createTableTask(TASK_VOLTAGE, VoltageTask, NULL);
 }
 
 // Return the most recently measured VBAT voltage.
 float getVbatVoltage(void)
 {
-    return vbatVoltage;
+    portENTER_CRITICAL(&sampleMux);
+    float voltage = vbatVoltage;
+    portEXIT_CRITICAL(&sampleMux);
+    return voltage;
 }
 
 // Return the most recently measured USB voltage.
 float getUsbVoltage(void)
 {
-    return usbVoltage;
+    portENTER_CRITICAL(&sampleMux);
+    float voltage = usbVoltage;
+    portEXIT_CRITICAL(&sampleMux);
+    return voltage;
+}
+
+// Return the time of the latest measurement.
+uint32_t getVoltageSampleTime(void)
+{
+    portENTER_CRITICAL(&sampleMux);
+    uint32_t timeMs = sampleTimeMs;
+    portEXIT_CRITICAL(&sampleMux);
+    return timeMs;
 }
@@ -0,0 +1,129 @@
+#include "state/StateRegistry.h"
+#include "FreeRTOS.h"
+#include <atomic>
+#include <string.h>
+#include "modes/Mode.h"       // MODE_COUNT
+#include "modes/mode4.h"      // ROLLING_PLOT_SOURCES
+#include "hardware/Touch.h"   // ButtonEvent_t
+#include "ChannelTable.h"     // CH_GROUP_ALL
+
+struct StateSpec {
+  const char* name;
+  StateType type;
+  float initial;
+  float min;
+  float max;
+};
+
+static const StateSpec specs[STATE_COUNT] = {
+#define STATE_TABLE_SPEC(id, name, type, initial, min, max) \
+  {name, type, (float)(initial), (float)(min), (float)(max)},
+  STATE_TABLE(STATE_TABLE_SPEC)
+#undef STATE_TABLE_SPEC
+};
+
+// Values are kept as raw 32-bit patterns (int32_t or float), so every field is a
+// single lock-free atomic.
+struct StateField {
+  std::atomic<uint32_t> bits;
+  std::atomic<uint32_t> version;
+};
+
+static StateField fields[STATE_COUNT];
+
+struct StateSubscription {
+  StateId id;
+  StateListener listener;
+  void* arg;
+};
+
+// Filled once before being published by listenerCount, never removed.
+static StateSubscription listeners[STATE_MAX_LISTENERS];
+static std::atomic<uint32_t> listenerCount(0);
+static portMUX_TYPE listenerMux = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t floatBits(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static float bitsFloat(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Stores a validated value; on change, bumps the version and calls the listeners.
+static void store(StateId id, uint32_t bits) {
+  if (fields[id].bits.exchange(bits) == bits) {
+    return;
+  }
+  uint32_t version = fields[id].version.fetch_add(1) + 1;
+  uint32_t count = listenerCount.load(std::memory_order_acquire);
+  for (uint32_t i = 0; i < count; i++) {
+    if (listeners[i].id == id) {
+      listeners[i].listener(id, version, listeners[i].arg);
+    }
+  }
+}
+
+void stateInit(void) {
+  for (int i = 0; i < STATE_COUNT; i++) {
+    if (specs[i].type == STATE_FLOAT) {
+      fields[i].bits.store(floatBits(specs[i].initial));
+    } else {
+      fields[i].bits.store((uint32_t)(int32_t)specs[i].initial);
+    }
+    fields[i].version.store(0);
+  }
+}
+
+int32_t stateGetInt(StateId id) {
+  if (id >= STATE_COUNT) return 0;
+  return (int32_t)fields[id].bits.load();
+}
+
+float stateGetFloat(StateId id) {
+  if (id >= STATE_COUNT) return NAN;
+  return bitsFloat(fields[id].bits.load());
+}
+
+bool stateSetInt(StateId id, int32_t value) {
+  if (id >= STATE_COUNT || specs[id].type != STATE_INT) return false;
+  if (value < (int32_t)specs[id].min || value > (int32_t)specs[id].max) return false;
+  store(id, (uint32_t)value);
+  return true;
+}
+
+bool stateSetFloat(StateId id, float value) {
+  if (id >= STATE_COUNT || specs[id].type != STATE_FLOAT) return false;
+  // Written so that NaN fails the check.
+  if (!(value >= specs[id].min && value <= specs[id].max)) return false;
+  store(id, floatBits(value));
+  return true;
+}
+
+uint32_t stateVersion(StateId id) {
+  if (id >= STATE_COUNT) return 0;
+  return fields[id].version.load();
+}
+
+const char* stateName(StateId id) {
+  if (id >= STATE_COUNT) return "";
+  return specs[id].name;
+}
+
+bool stateSubscribe(StateId id, StateListener listener, void* arg) {
+  if (id >= STATE_COUNT || listener == NULL) return false;
+  bool added = false;
+  portENTER_CRITICAL(&listenerMux);
+  uint32_t count = listenerCount.load(std::memory_order_relaxed);
+  if (count < STATE_MAX_LISTENERS) {
+    listeners[count] = {id, listener, arg};
+    listenerCount.store(count + 1, std::memory_order_release);
+    added = true;
+  }
+  portEXIT_CRITICAL(&listenerMux);
+  return added;
+}
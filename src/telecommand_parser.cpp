@@ -0,0 +1,112 @@
+#include "telecommand_parser.h"
+#include <string.h>
+
+uint32_t djb2Hash(const uint8_t* data, size_t length, uint32_t seed) {
+  uint32_t hash = seed;
+  for (size_t i = 0; i < length; i++) {
+    hash = ((hash << 5) + hash) + data[i]; // hash * 33 + current byte
+  }
+  return hash;
+}
+
+// True if the message starts with the given prefix.
+static bool hasPrefix(const uint8_t* msg, size_t length, const char* prefix) {
+  size_t n = strlen(prefix);
+  return length >= n && memcmp(msg, prefix, n) == 0;
+}
+
+static bool isSpace(uint8_t c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Reads a decimal integer from [begin, end) like String::toInt(): leading whitespace
+// and an optional sign, then digits up to the first other character; 0 if none.
+static int32_t parseInt(const uint8_t* begin, const uint8_t* end) {
+  while (begin < end && isSpace(*begin)) begin++;
+  bool negative = false;
+  if (begin < end && (*begin == '-' || *begin == '+')) {
+    negative = (*begin == '-');
+    begin++;
+  }
+  int64_t value = 0;
+  while (begin < end && *begin >= '0' && *begin <= '9') {
+    value = value * 10 + (*begin - '0');
+    if (value > INT32_MAX) value = INT32_MAX;
+    begin++;
+  }
+  return (int32_t)(negative ? -value : value);
+}
+
+// Reads "<value>[:<arg>]" from [begin, end) into out->value and out->arg.
+static void parseValueArg(const uint8_t* begin, const uint8_t* end, Telecommand* out) {
+  const uint8_t* colon = (const uint8_t*)memchr(begin, ':', end - begin);
+  out->value = parseInt(begin, colon != NULL ? colon : end);
+  if (colon != NULL) {
+    out->arg = parseInt(colon + 1, end);
+  }
+}
+
+bool parseTelecommand(const uint8_t* msg, size_t length, Telecommand* out) {
+  const uint8_t* end = msg + length;
+  out->type = TC_UNKNOWN;
+  out->value = 0;
+  out->arg = 0;
+  out->data = NULL;
+  out->dataLength = 0;
+  out->hash = djb2Hash(msg, length);
+
+  if (hasPrefix(msg, length, "SetMode:")) {
+    out->type = TC_SET_MODE;
+    out->value = parseInt(msg + strlen("SetMode:"), end);
+  } else if (hasPrefix(msg, length, "SetDefaultMode:")) {
+    out->type = TC_SET_DEFAULT_MODE;
+    out->value = parseInt(msg + strlen("SetDefaultMode:"), end);
+  } else if (hasPrefix(msg, length, "PacketID:")) {
+    // "PacketID:<id>:<data>", the data may be binary.
+    const uint8_t* id = msg + strlen("PacketID:");
+    const uint8_t* colon = (const uint8_t*)memchr(id, ':', end - id);
+    if (colon == NULL) {
+      return false;
+    }
+    out->type = TC_PACKET;
+    out->value = parseInt(id, colon);
+    out->data = colon + 1;
+    out->dataLength = end - (colon + 1);
+  } else if (hasPrefix(msg, length, "SetProfile:")) {
+    out->type = TC_SET_PROFILE;
+    out->value = parseInt(msg + strlen("SetProfile:"), end);
+  } else if (hasPrefix(msg, length, "DumpFrame")) {
+    out->type = TC_DUMP_FRAME;
+  } else if (hasPrefix(msg, length, "Record:")) {
+    out->type = TC_RECORD;
+    out->value = parseInt(msg + strlen("Record:"), end);
+  } else if (hasPrefix(msg, length, "Replay")) {
+    out->type = TC_REPLAY;
+  } else if (hasPrefix(msg, length, "Synth:")) {
+    out->type = TC_SYNTH;
+    out->value = parseInt(msg + strlen("Synth:"), end);
+  } else if (hasPrefix(msg, length, "Bench")) {
+    out->type = TC_BENCH;
+  } else if (hasPrefix(msg, length, "Fault:")) {
+    // "Fault:<kind>[:<ms>]"
+    out->type = TC_FAULT;
+    parseValueArg(msg + strlen("Fault:"), end, out);
+  } else if (hasPrefix(msg, length, "Trace:")) {
+    out->type = TC_TRACE;
+    out->value = parseInt(msg + strlen("Trace:"), end);
+  } else if (hasPrefix(msg, length, "AllocGuard:")) {
+    out->type = TC_ALLOC_GUARD;
+    out->value = parseInt(msg + strlen("AllocGuard:"), end);
+  } else if (hasPrefix(msg, length, "SetKeyframe:")) {
+    out->type = TC_SET_KEYFRAME;
+    out->value = parseInt(msg + strlen("SetKeyframe:"), end);
+  } else if (hasPrefix(msg, length, "SetRate:")) {
+    // "SetRate:<group>:<ms>"
+    out->type = TC_SET_RATE;
+    parseValueArg(msg + strlen("SetRate:"), end, out);
+  } else if (hasPrefix(msg, length, "Subscribe:")) {
+    out->type = TC_SUBSCRIBE;
+    out->value = parseInt(msg + strlen("Subscribe:"), end);
+  }
+  return out->type != TC_UNKNOWN;
+}
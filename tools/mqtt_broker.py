@@ -0,0 +1,264 @@
+#!/usr/bin/env python3
+"""Local MQTT broker stand-in for host runs and soak tests of the firmware.
+
+Speaks the part of MQTT 3.1.1 the firmware uses: CONNECT, SUBSCRIBE and UNSUBSCRIBE
+with + and # wildcards, PUBLISH at QoS 0 (QoS 1 is acknowledged and forwarded at
+QoS 0), PINGREQ and DISCONNECT. No retained messages, sessions or authentication:
+credentials are accepted as they are. Clients silent for 1.5 keepalive periods are
+dropped.
+
+For soak tests the broker can misbehave on request: delay its acks (CONNACK, SUBACK,
+UNSUBACK, PUBACK, PINGRESP), drop every client connection, and publish payloads of
+any size. mqtt_soak.py drives these through the Broker class.
+
+Standalone it prints every message published to it and every connection; each line
+"<topic> <payload>" typed on stdin is published, e.g. to send telecommands to the host
+build started with FIRMWARE_MQTT_BROKER=127.0.0.1:1883:
+
+    **/2024/240/tc SetMode:3
+
+Usage: mqtt_broker.py [--host 127.0.0.1] [--port 1883] [--ack-delay-ms N]
+"""
+
+import argparse
+import asyncio
+import struct
+import sys
+import time
+
+# Packet types (MQTT 3.1.1, section 2.2.1).
+CONNECT, CONNACK, PUBLISH, PUBACK = 1, 2, 3, 4
+SUBSCRIBE, SUBACK, UNSUBSCRIBE, UNSUBACK = 8, 9, 10, 11
+PINGREQ, PINGRESP, DISCONNECT = 12, 13, 14
+
+# A client must send CONNECT within this time.
+CONNECT_TIMEOUT_S = 10
+# Silent clients are dropped after this many keepalive periods.
+KEEPALIVE_GRACE = 1.5
+
+
+class ProtocolError(Exception):
+    pass
+
+
+def topic_matches(pattern, topic):
+    """True if the topic matches the subscription filter (+ and # wildcards)."""
+    levels = topic.split("/")
+    filters = pattern.split("/")
+    for i, level in enumerate(filters):
+        if level == "#":
+            return True
+        if i >= len(levels) or (level != "+" and level != levels[i]):
+            return False
+    return len(filters) == len(levels)
+
+
+def encode_packet(packet_type, flags, body):
+    """Fixed header (type, flags, remaining length) followed by the body."""
+    header = bytearray([packet_type << 4 | flags])
+    length = len(body)
+    while True:
+        digit = length % 128
+        length //= 128
+        header.append(digit | (0x80 if length else 0))
+        if not length:
+            return bytes(header) + body
+
+
+def encode_string(text):
+    data = text.encode()
+    return struct.pack(">H", len(data)) + data
+
+
+def decode_string(body, pos):
+    """Returns (string, position after it)."""
+    if pos + 2 > len(body):
+        raise ProtocolError("truncated string")
+    length, = struct.unpack_from(">H", body, pos)
+    end = pos + 2 + length
+    if end > len(body):
+        raise ProtocolError("truncated string")
+    return body[pos + 2:end].decode(errors="replace"), end
+
+
+async def read_packet(reader):
+    """Returns (type, flags, body) of the next packet."""
+    first = (await reader.readexactly(1))[0]
+    length = 0
+    for shift in range(0, 28, 7):
+        digit = (await reader.readexactly(1))[0]
+        length |= (digit & 0x7F) << shift
+        if not digit & 0x80:
+            break
+    else:
+        raise ProtocolError("malformed remaining length")
+    body = await reader.readexactly(length)
+    return first >> 4, first & 0x0F, body
+
+
+class Client:
+    def __init__(self, writer):
+        self.writer = writer
+        self.client_id = ""
+        self.keepalive = 0
+        self.subscriptions = set()
+
+
+class Broker:
+    """Broker state and fault knobs.
+
+    Callbacks, called in the event loop:
+    on_publish(client_id, topic, payload) for every PUBLISH received,
+    on_client(client_id, event) with event "connect", "subscribe" or "disconnect".
+    """
+
+    def __init__(self, ack_delay_s=0.0):
+        self.ack_delay_s = ack_delay_s
+        self.clients = set()
+        self.on_publish = []
+        self.on_client = []
+        self.server = None
+
+    async def start(self, host="127.0.0.1", port=1883):
+        """Starts listening; returns the port (useful with port 0)."""
+        self.server = await asyncio.start_server(self._serve, host, port)
+        return self.server.sockets[0].getsockname()[1]
+
+    async def close(self):
+        self.drop_clients()
+        self.server.close()
+        await self.server.wait_closed()
+
+    def drop_clients(self):
+        """Closes every client connection without a DISCONNECT, like a broker crash."""
+        for client in list(self.clients):
+            client.writer.transport.abort()
+
+    def publish(self, topic, payload):
+        """Sends a message to the matching subscribers; returns how many got it."""
+        data = encode_packet(PUBLISH, 0, encode_string(topic) + payload)
+        receivers = 0
+        for client in self.clients:
+            if any(topic_matches(pattern, topic) for pattern in client.subscriptions):
+                client.writer.write(data)
+                receivers += 1
+        return receivers
+
+    def _notify(self, client, event):
+        for callback in self.on_client:
+            callback(client.client_id, event)
+
+    async def _ack(self, client, packet_type, body):
+        if self.ack_delay_s > 0:
+            await asyncio.sleep(self.ack_delay_s)
+        client.writer.write(encode_packet(packet_type, 0, body))
+
+    async def _serve(self, reader, writer):
+        client = Client(writer)
+        try:
+            packet_type, _, body = await asyncio.wait_for(read_packet(reader), CONNECT_TIMEOUT_S)
+            if packet_type != CONNECT:
+                raise ProtocolError("first packet is not CONNECT")
+            protocol, pos = decode_string(body, 0)
+            if protocol != "MQTT" or pos + 4 > len(body):
+                raise ProtocolError("not MQTT 3.1.1")
+            client.keepalive, = struct.unpack_from(">H", body, pos + 2)
+            client.client_id, _ = decode_string(body, pos + 4)
+            self.clients.add(client)
+            self._notify(client, "connect")
+            await self._ack(client, CONNACK, b"\x00\x00")
+
+            while True:
+                timeout = client.keepalive * KEEPALIVE_GRACE if client.keepalive else None
+                packet_type, flags, body = await asyncio.wait_for(read_packet(reader), timeout)
+                if packet_type == PUBLISH:
+                    await self._receive_publish(client, flags, body)
+                elif packet_type == SUBSCRIBE:
+                    pos = 2
+                    granted = bytearray()
+                    while pos < len(body):
+                        pattern, pos = decode_string(body, pos)
+                        pos += 1   # requested QoS; QoS 0 is granted
+                        client.subscriptions.add(pattern)
+                        granted.append(0)
+                    await self._ack(client, SUBACK, body[:2] + bytes(granted))
+                    self._notify(client, "subscribe")
+                elif packet_type == UNSUBSCRIBE:
+                    pos = 2
+                    while pos < len(body):
+                        pattern, pos = decode_string(body, pos)
+                        client.subscriptions.discard(pattern)
+                    await self._ack(client, UNSUBACK, body[:2])
+                elif packet_type == PINGREQ:
+                    await self._ack(client, PINGRESP, b"")
+                elif packet_type == DISCONNECT:
+                    break
+                else:
+                    raise ProtocolError("unexpected packet type %d" % packet_type)
+        except (asyncio.IncompleteReadError, asyncio.TimeoutError, ConnectionError, ProtocolError,
+                asyncio.CancelledError):
+            # Cancelled: the broker is closing while an ack is delayed.
+            pass
+        finally:
+            if client in self.clients:
+                self.clients.discard(client)
+                self._notify(client, "disconnect")
+            writer.close()
+
+    async def _receive_publish(self, client, flags, body):
+        qos = (flags >> 1) & 3
+        if qos > 1:
+            raise ProtocolError("QoS 2 is not supported")
+        topic, pos = decode_string(body, 0)
+        packet_id = body[pos:pos + 2]
+        if qos == 1:
+            pos += 2
+        payload = body[pos:]
+        for callback in self.on_publish:
+            callback(client.client_id, topic, payload)
+        self.publish(topic, payload)
+        if qos == 1:
+            await self._ack(client, PUBACK, packet_id)
+
+
+def publish_stdin_line(broker):
+    line = sys.stdin.readline()
+    if not line:
+        asyncio.get_running_loop().remove_reader(sys.stdin)
+        return
+    topic, _, payload = line.rstrip("\n").partition(" ")
+    if topic:
+        receivers = broker.publish(topic, payload.encode())
+        print("%.3f sent to %d client(s)" % (time.time(), receivers), flush=True)
+
+
+async def serve(args):
+    broker = Broker(args.ack_delay_ms / 1000.0)
+    broker.on_client.append(lambda client_id, event:
+                            print("%.3f %s %s" % (time.time(), client_id, event), flush=True))
+    broker.on_publish.append(lambda client_id, topic, payload:
+                             print("%.3f %s %s" % (time.time(), topic,
+                                                   payload.decode(errors="replace")), flush=True))
+    port = await broker.start(args.host, args.port)
+    print("listening on %s:%d" % (args.host, port), flush=True)
+    asyncio.get_running_loop().add_reader(sys.stdin, publish_stdin_line, broker)
+    await broker.server.serve_forever()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Local MQTT 3.1.1 broker stand-in.")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--ack-delay-ms", type=int, default=0,
+                        help="delay of every CONNACK, SUBACK, PUBACK and PINGRESP")
+    args = parser.parse_args()
+    try:
+        asyncio.run(serve(args))
+    except KeyboardInterrupt:
+        pass
+    except OSError as err:
+        sys.exit("cannot listen on %s:%d: %s" % (args.host, args.port, err))
+
+
+if __name__ == "__main__":
+    main()
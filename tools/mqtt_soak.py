@@ -0,0 +1,395 @@
+#!/usr/bin/env python3
+"""Soak test of the firmware's network path against the local broker stand-in.
+
+Runs mqtt_broker.Broker in-process and, with --firmware, the host build of the
+firmware connected to it (FIRMWARE_MQTT_BROKER). Telecommands and PacketID uploads
+are sent at a rate that ramps up step by step (--rates, one step per --step-s, the
+ramp repeated until --duration-h is over). Halfway through each step a fault is
+injected, in turn:
+
+  drop      the broker drops the connection
+  slow-ack  the broker delays its acks by --slow-ack-ms for two keepalive periods,
+            starting with a dropped connection (slow CONNACK and SUBACK)
+  oversize  a telecommand just over MQTT_MSG_MAX_LEN and one over the client's
+            packet buffer
+  stall     the Fault:2 telecommand stalls the firmware's connection for --stall-ms
+
+Every step reports the telecommand round trip, measured with a SetMode probe that
+takes a load slot every PROBE_INTERVAL_S, until the mode shows in the telemetry
+(p50/p95/p99/max; probes not seen within PROBE_TIMEOUT_S are lost, e.g. dropped as an
+overrun by the firmware), the telemetry rate and its longest gap, the
+broker-side reconnect time, and from the firmware's Profile messages the publish time
+percentiles, drop, overrun and oversize counts, reconnect time and the free heap.
+The summary gives the heap trend over the run in bytes per hour.
+
+PacketID uploads restart at 1 every PACKET_WRAP packets, which clears the upload file,
+so hours of uploads do not fill the flash.
+
+Usage: mqtt_soak.py [--firmware build-host/firmware_host] [--duration-h 4]
+                    [--rates 0.5,1,2,5,10] [--step-s 300] [--csv steps.csv]
+"""
+
+import argparse
+import asyncio
+import csv
+import json
+import os
+import sys
+import tempfile
+import time
+
+from mqtt_broker import Broker
+
+# Topics of the board in include/arduino_secrets.h.
+TM_TOPIC = "**/2024/25/tm"
+TC_TOPIC = "**/2024/240/tc"
+
+MQTT_MSG_MAX_LEN = 170        # include/MqttTask.h
+MQTT_TM_BUFFER_SIZE = 1536    # client packet buffer, include/MqttTask.h
+KEEPALIVE_S = 15              # MQTT_KEEPALIVE of the client
+
+PROBE_INTERVAL_S = 2.0
+PROBE_TIMEOUT_S = 10.0
+PROBE_MODES = (0, 3)          # Idle and Horizon: no alarms, no sensor period changes
+STATUS_PERIOD_MS = 50         # status group (mode) published at 20 Hz: probe resolution
+PACKET_WRAP = 100
+PACKET_DATA = "0123456789abcdef" * 6
+CONNECT_TIMEOUT_S = 120
+FAULTS = ("drop", "slow-ack", "oversize", "stall")
+
+# Firmware Net counters reported per step as increments.
+NET_COUNTERS = ("pub", "pubFail", "pubDrop", "rx", "rxOversize", "rxOverrun", "reconnects")
+
+COLUMNS = ("step", "rate", "sent", "probes", "lost", "rtt_p50_ms", "rtt_p95_ms",
+           "rtt_p99_ms", "rtt_max_ms", "tm_per_s", "tm_gap_ms", "reconnect_ms",
+           "pub_p99_us", "pubDrop", "pubFail", "rxOverrun", "rxOversize", "reconnects",
+           "fw_reconnect_ms", "free_heap", "min_free_heap", "rss_kb", "fault")
+
+
+def percentile(values, p):
+    """Nearest-rank percentile, None without values."""
+    if not values:
+        return None
+    ordered = sorted(values)
+    rank = max(1, int(-(-p * len(ordered) // 100)))
+    return ordered[rank - 1]
+
+
+def slope_per_hour(samples):
+    """Least-squares slope of (seconds, value) samples, per hour; None if undefined."""
+    if len(samples) < 2:
+        return None
+    n = len(samples)
+    mean_t = sum(t for t, _ in samples) / n
+    mean_v = sum(v for _, v in samples) / n
+    var = sum((t - mean_t) ** 2 for t, _ in samples)
+    if var == 0:
+        return None
+    cov = sum((t - mean_t) * (v - mean_v) for t, v in samples)
+    return cov / var * 3600
+
+
+def process_rss_kb(pid):
+    try:
+        with open("/proc/%d/status" % pid) as status:
+            for line in status:
+                if line.startswith("VmRSS:"):
+                    return int(line.split()[1])
+    except OSError:
+        pass
+    return None
+
+
+def fmt(value, spec="%.0f"):
+    return "-" if value is None else spec % value
+
+
+class Step:
+    def __init__(self, index, rate):
+        self.index = index
+        self.rate = rate
+        self.start = time.monotonic()
+        self.sent = 0
+        self.probes = 0
+        self.lost = 0
+        self.rtt_ms = []
+        self.telemetry = 0
+        self.last_tm = None
+        self.gap_ms = 0.0
+        self.reconnect_ms = []
+        self.fault = ""
+
+
+class Soak:
+    def __init__(self, args, broker):
+        self.args = args
+        self.broker = broker
+        self.subscribed = asyncio.Event()
+        self.step = Step(0, 0)
+        self.mode = None
+        self.probe = None             # (target mode, time sent)
+        self.last_probe = 0.0
+        self.packet_id = 0
+        self.net = None               # latest Net counters of the firmware
+        self.net_at_step = None
+        self.heap = None              # latest (FreeHeap, MinFreeHeap)
+        self.heap_samples = []        # (seconds since start, FreeHeap)
+        self.start = time.monotonic()
+        self.lost_at = None
+        broker.on_publish.append(self.on_publish)
+        broker.on_client.append(self.on_client)
+
+    def send(self, payload):
+        self.broker.publish(TC_TOPIC, payload.encode() if isinstance(payload, str) else payload)
+
+    def on_client(self, client_id, event):
+        now = time.monotonic()
+        if event == "disconnect":
+            self.subscribed.clear()
+            if self.lost_at is None:
+                self.lost_at = now
+        elif event == "subscribe":
+            self.subscribed.set()
+            if self.lost_at is not None:
+                self.step.reconnect_ms.append((now - self.lost_at) * 1000)
+                self.lost_at = None
+
+    def on_publish(self, client_id, topic, payload):
+        if topic != TM_TOPIC:
+            return
+        now = time.monotonic()
+        step = self.step
+        step.telemetry += 1
+        if step.last_tm is not None:
+            step.gap_ms = max(step.gap_ms, (now - step.last_tm) * 1000)
+        step.last_tm = now
+        try:
+            message = json.loads(payload)
+        except ValueError:
+            return
+        if "mode" in message:
+            self.mode = message["mode"]
+            if self.probe is not None and self.mode == self.probe[0]:
+                step.rtt_ms.append((now - self.probe[1]) * 1000)
+                self.probe = None
+        profile = message.get("Profile")
+        if profile is not None:
+            self.net = profile.get("Net", self.net)
+            self.heap = (profile.get("FreeHeap"), profile.get("MinFreeHeap"))
+            if self.heap[0] is not None:
+                self.heap_samples.append((now - self.start, self.heap[0]))
+
+    def send_probe(self, now):
+        """Sends a SetMode probe if one is due; returns whether it did."""
+        if self.probe is not None and now - self.probe[1] > PROBE_TIMEOUT_S:
+            self.step.lost += 1
+            self.probe = None
+        if self.probe is not None or now - self.last_probe < PROBE_INTERVAL_S:
+            return False
+        target = PROBE_MODES[1] if self.mode == PROBE_MODES[0] else PROBE_MODES[0]
+        self.probe = (target, now)
+        self.last_probe = now
+        self.send("SetMode:%d" % target)
+        self.step.probes += 1
+        return True
+
+    async def load(self, rate):
+        """Telecommands at `rate` per second: probes, PacketID uploads and a harmless
+        SetRate. Nothing is sent while the firmware is not subscribed."""
+        interval = 1.0 / rate
+        due = time.monotonic()
+        count = 0
+        while True:
+            now = time.monotonic()
+            if self.subscribed.is_set() and not self.send_probe(now):
+                if count % 4 == 3:
+                    self.send("SetRate:3:1000")
+                else:
+                    self.packet_id = self.packet_id % PACKET_WRAP + 1
+                    self.send("PacketID:%d:%s" % (self.packet_id, PACKET_DATA))
+                count += 1
+            if self.subscribed.is_set():
+                self.step.sent += 1
+            due += interval
+            await asyncio.sleep(max(0.0, due - time.monotonic()))
+
+    async def inject(self, fault):
+        self.step.fault = fault
+        if fault == "drop":
+            self.broker.drop_clients()
+        elif fault == "slow-ack":
+            self.broker.ack_delay_s = self.args.slow_ack_ms / 1000.0
+            self.broker.drop_clients()
+            await asyncio.sleep(2 * KEEPALIVE_S)
+            self.broker.ack_delay_s = 0.0
+        elif fault == "oversize":
+            self.send(b"X" * (MQTT_MSG_MAX_LEN + 1))
+            self.send(b"X" * (MQTT_TM_BUFFER_SIZE + 1))
+        elif fault == "stall":
+            self.send("Fault:2:%d" % self.args.stall_ms)
+
+    def finish_step(self, rss_kb):
+        step = self.step
+        elapsed = time.monotonic() - step.start
+        row = dict.fromkeys(COLUMNS)
+        row.update(step=step.index, rate=step.rate, sent=step.sent, probes=step.probes,
+                   lost=step.lost, rtt_p50_ms=percentile(step.rtt_ms, 50),
+                   rtt_p95_ms=percentile(step.rtt_ms, 95), rtt_p99_ms=percentile(step.rtt_ms, 99),
+                   rtt_max_ms=max(step.rtt_ms) if step.rtt_ms else None,
+                   tm_per_s=step.telemetry / elapsed if elapsed > 0 else None,
+                   tm_gap_ms=step.gap_ms,
+                   reconnect_ms=max(step.reconnect_ms) if step.reconnect_ms else None,
+                   rss_kb=rss_kb, fault=step.fault)
+        if self.net is not None:
+            before = self.net_at_step or {}
+            for name in NET_COUNTERS:
+                if name in row:
+                    row[name] = self.net.get(name, 0) - before.get(name, 0)
+            row["reconnects"] = self.net.get("reconnects", 0) - before.get("reconnects", 0)
+            row["pub_p99_us"] = self.net.get("pubP99")
+            row["fw_reconnect_ms"] = self.net.get("reconnectMs") if row["reconnects"] else None
+            self.net_at_step = dict(self.net)
+        if self.heap is not None:
+            row["free_heap"], row["min_free_heap"] = self.heap
+        return row
+
+
+def print_header():
+    print("%4s %6s %6s %6s %5s  %-23s %6s %7s %8s %7s %6s %6s %6s %8s %8s  %s" % (
+        "step", "rate/s", "sent", "probes", "lost", "rtt p50/p95/p99/max ms", "tm/s",
+        "gap ms", "recon ms", "pub µs", "drop", "ovrun", "ovsize", "heap", "minheap", "fault"),
+        flush=True)
+
+
+def print_row(row):
+    rtt = "/".join(fmt(row[k]) for k in ("rtt_p50_ms", "rtt_p95_ms", "rtt_p99_ms", "rtt_max_ms"))
+    print("%4d %6g %6d %6d %5d  %-23s %6s %7s %8s %7s %6s %6s %6s %8s %8s  %s" % (
+        row["step"], row["rate"], row["sent"], row["probes"], row["lost"], rtt,
+        fmt(row["tm_per_s"], "%.1f"), fmt(row["tm_gap_ms"]), fmt(row["reconnect_ms"]),
+        fmt(row["pub_p99_us"]), fmt(row["pubDrop"], "%d"), fmt(row["rxOverrun"], "%d"),
+        fmt(row["rxOversize"], "%d"), fmt(row["free_heap"], "%d"),
+        fmt(row["min_free_heap"], "%d"), row["fault"]), flush=True)
+
+
+async def run(args):
+    broker = Broker()
+    port = await broker.start(args.host, args.port)
+    soak = Soak(args, broker)
+    # Whole steps only: the duration is rounded to a multiple of --step-s.
+    steps = max(1, int(round(args.duration_h * 3600 / args.step_s)))
+
+    firmware = None
+    log = None
+    if args.firmware:
+        env = dict(os.environ)
+        env["FIRMWARE_MQTT_BROKER"] = "%s:%d" % (args.host, port)
+        env["FIRMWARE_RUN_SECONDS"] = str(int(steps * args.step_s + CONNECT_TIMEOUT_S + 60))
+        env.setdefault("FIRMWARE_FS_DIR", tempfile.mkdtemp(prefix="soak_spiffs_"))
+        log = open(args.log, "wb")
+        firmware = await asyncio.create_subprocess_exec(
+            args.firmware, stdin=asyncio.subprocess.DEVNULL, stdout=log,
+            stderr=asyncio.subprocess.STDOUT, env=env)
+        print("firmware pid %d, log %s" % (firmware.pid, args.log), flush=True)
+    else:
+        print("waiting for the firmware on %s:%d" % (args.host, port), flush=True)
+
+    try:
+        await asyncio.wait_for(soak.subscribed.wait(), CONNECT_TIMEOUT_S)
+    except asyncio.TimeoutError:
+        sys.exit("no client subscribed within %d s" % CONNECT_TIMEOUT_S)
+    # Spaced out: the firmware takes one telecommand per inbound period (500 ms).
+    soak.send("SetProfile:%d" % args.profile_s)
+    await asyncio.sleep(1.0)
+    soak.send("SetRate:0:%d" % STATUS_PERIOD_MS)
+    await asyncio.sleep(1.0)
+    soak.start = time.monotonic()
+
+    writer = None
+    csv_file = None
+    if args.csv:
+        csv_file = open(args.csv, "w", newline="")
+        writer = csv.DictWriter(csv_file, COLUMNS)
+        writer.writeheader()
+
+    print_header()
+    failed = False
+    index = 0
+    while index < steps:
+        rate = args.rates[index % len(args.rates)]
+        step_s = args.step_s
+        soak.step = Step(index, rate)
+        load = asyncio.ensure_future(soak.load(rate))
+        fault = None
+        if not args.no_faults:
+            async def delayed_fault(name):
+                await asyncio.sleep(step_s / 2)
+                await soak.inject(name)
+            fault = asyncio.ensure_future(delayed_fault(FAULTS[index % len(FAULTS)]))
+        await asyncio.sleep(step_s)
+        for task in (load, fault):
+            if task is not None:
+                task.cancel()
+        broker.ack_delay_s = 0.0
+
+        row = soak.finish_step(process_rss_kb(firmware.pid) if firmware else None)
+        print_row(row)
+        if writer is not None:
+            writer.writerow(row)
+            csv_file.flush()
+        if firmware is not None and firmware.returncode is not None:
+            print("firmware exited with %d" % firmware.returncode, flush=True)
+            failed = True
+            break
+        index += 1
+
+    hours = (time.monotonic() - soak.start) / 3600
+    # The first step is boot and warm-up; the heap trend starts after it.
+    settled = [s for s in soak.heap_samples if s[0] >= args.step_s] or soak.heap_samples
+    trend = slope_per_hour(settled)
+    print("%.2f h, %d steps; free heap trend %s B/h%s" % (
+        hours, index, fmt(trend, "%+.0f"),
+        ", min free heap %d" % soak.heap[1] if soak.heap and soak.heap[1] is not None else ""))
+
+    if csv_file is not None:
+        csv_file.close()
+    if firmware is not None:
+        if firmware.returncode is None:
+            firmware.terminate()
+        await firmware.wait()
+        log.close()
+    await broker.close()
+    return 1 if failed else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Soak test of the firmware's network path.")
+    parser.add_argument("--firmware", help="host firmware to start (build-host/firmware_host)")
+    parser.add_argument("--log", default="soak_firmware.log", help="output of the firmware")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=1883, help="broker port (0: any free)")
+    parser.add_argument("--duration-h", type=float, default=1.0)
+    parser.add_argument("--step-s", type=float, default=300.0, help="duration of a rate step")
+    parser.add_argument("--rates", default="0.5,1,2,5,10",
+                        help="telecommands per second of the steps, comma separated")
+    parser.add_argument("--profile-s", type=int, default=10, help="SetProfile period")
+    parser.add_argument("--slow-ack-ms", type=int, default=5000)
+    parser.add_argument("--stall-ms", type=int, default=5000)
+    parser.add_argument("--no-faults", action="store_true")
+    parser.add_argument("--csv", help="write the step rows to this file")
+    args = parser.parse_args()
+    try:
+        args.rates = [float(r) for r in args.rates.split(",")]
+    except ValueError:
+        sys.exit("invalid --rates %s" % args.rates)
+    if not args.rates or min(args.rates) <= 0:
+        sys.exit("rates must be positive")
+    try:
+        sys.exit(asyncio.run(run(args)))
+    except KeyboardInterrupt:
+        pass
+    except OSError as err:
+        sys.exit(str(err))
+
+
+if __name__ == "__main__":
+    main()
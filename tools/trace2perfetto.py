@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""Converts a firmware event trace dump to Chrome/Perfetto trace JSON.
+
+The input is a serial log containing the output of the Trace:2 telecommand, or the
+{"Trace":"..."} messages of Trace:3 captured from the telemetry topic, one per line.
+Other lines are ignored. Open the result in https://ui.perfetto.dev or chrome://tracing.
+
+Usage: trace2perfetto.py <dump.txt> [trace.json]
+"""
+
+import json
+import struct
+import sys
+
+FORMAT_VERSION = 1
+RECORD = struct.Struct("<IHHII")  # TraceRecord: timestampUs, event, task, arg0, arg1
+
+# TraceEvent values (diagnostics/Trace.h).
+SENSOR_READ_BEGIN, SENSOR_READ_END, PUBLISH_BEGIN, PUBLISH_END, \
+    DISPLAY_FLUSH_BEGIN, DISPLAY_FLUSH_END, QUEUE_SEND, TASK_SWITCH_IN, MARK = range(9)
+
+SENSORS = ["IMU", "BME280", "Voltage"]
+QUEUES = ["button", "mode", "buzzer", "sensor log"]
+
+# Task switches are drawn on one extra track per core.
+CORE_TRACK_BASE = 1000
+
+
+def dump_lines(stream):
+    """Yields the dump lines, from serial output or captured MQTT messages."""
+    for raw in stream:
+        line = raw.strip()
+        if line.startswith("{") and '"Trace"' in line:
+            try:
+                line = json.loads(line)["Trace"]
+            except (ValueError, KeyError):
+                continue
+        yield line
+
+
+def parse(stream):
+    """Returns (task names by number, records as (core, ts, event, task, arg0, arg1))."""
+    tasks = {0: "other"}
+    records = []
+    inside = False
+    for line in dump_lines(stream):
+        words = line.split()
+        if not words:
+            continue
+        if words[0] == "trace":
+            if int(words[1]) != FORMAT_VERSION:
+                sys.exit("unsupported trace format %s" % words[1])
+            inside = True
+        elif not inside:
+            continue
+        elif words[0] == "task":
+            tasks[int(words[1])] = words[2]
+        elif words[0] == "rec":
+            core = int(words[1])
+            data = bytes.fromhex(words[2])
+            for fields in RECORD.iter_unpack(data):
+                records.append((core,) + fields)
+        elif words[0] == "end":
+            inside = False
+    return tasks, records
+
+
+def unwrap(records):
+    """Orders records by time, undoing a micros() wrap within the dump."""
+    if not records:
+        return records
+    stamps = [r[1] for r in records]
+    if max(stamps) - min(stamps) > 1 << 31:
+        records = [(r[0], r[1] + (1 << 32) if r[1] < 1 << 31 else r[1]) + r[2:] for r in records]
+    return sorted(records, key=lambda r: r[1])
+
+
+def convert(tasks, records):
+    events = [{"ph": "M", "pid": 0, "name": "process_name", "args": {"name": "ESP32-S3"}}]
+    for number, name in tasks.items():
+        events.append({"ph": "M", "pid": 0, "tid": number, "name": "thread_name",
+                       "args": {"name": name}})
+    for core in (0, 1):
+        events.append({"ph": "M", "pid": 0, "tid": CORE_TRACK_BASE + core, "name": "thread_name",
+                       "args": {"name": "core %d" % core}})
+
+    running = {}  # core -> (task, start)
+    for core, ts, event, task, arg0, arg1 in records:
+        base = {"pid": 0, "tid": task, "ts": ts}
+        if event in (SENSOR_READ_BEGIN, SENSOR_READ_END):
+            name = "%s read" % (SENSORS[arg0] if arg0 < len(SENSORS) else arg0)
+            events.append(dict(base, ph="B" if event == SENSOR_READ_BEGIN else "E", name=name))
+        elif event == PUBLISH_BEGIN:
+            events.append(dict(base, ph="B", name="publish", args={"bytes": arg0}))
+        elif event == PUBLISH_END:
+            events.append(dict(base, ph="E", name="publish", args={"sent": bool(arg0)}))
+        elif event in (DISPLAY_FLUSH_BEGIN, DISPLAY_FLUSH_END):
+            events.append(dict(base, ph="B" if event == DISPLAY_FLUSH_BEGIN else "E",
+                               name="display flush", args={"mode": arg0}))
+        elif event == QUEUE_SEND:
+            queue = QUEUES[arg0] if arg0 < len(QUEUES) else str(arg0)
+            events.append(dict(base, ph="i", s="t", name="send " + queue,
+                               args={"accepted": bool(arg1)}))
+        elif event == TASK_SWITCH_IN:
+            if core in running:
+                prev, start = running[core]
+                events.append({"ph": "X", "pid": 0, "tid": CORE_TRACK_BASE + core, "ts": start,
+                               "dur": ts - start, "name": tasks.get(prev, "task %d" % prev)})
+            running[core] = (task, ts)
+        elif event == MARK:
+            events.append(dict(base, ph="i", s="t", name="mark", args={"arg0": arg0, "arg1": arg1}))
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        sys.exit(__doc__)
+    with open(sys.argv[1], encoding="utf-8", errors="replace") as stream:
+        tasks, records = parse(stream)
+    trace = convert(tasks, unwrap(records))
+    out = open(sys.argv[2], "w") if len(sys.argv) == 3 else sys.stdout
+    json.dump(trace, out)
+    if out is not sys.stdout:
+        out.close()
+    print("%d records converted" % len(records), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()